@@ -57,6 +57,7 @@
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/Platform/errorhandler.h"
+#include "System/Threading/ThreadPool.h"
 
 #include <string>
 #include <vector>
@@ -782,7 +783,7 @@ float CAICallback::GetPathNodeCost(unsigned int x, unsigned int z) {
 
 
 
-static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int maxUnitIds, bool (*includeUnit)(const CUnit*) = nullptr)
+static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int maxUnitIds, int allyTeam, bool (*includeUnit)(const CUnit*, int) = nullptr)
 {
 	int a = 0;
 
@@ -796,7 +797,7 @@ static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int
 		if (!CHECK_UNITID(u->id))
 			continue;
 
-		if ((includeUnit == nullptr) || (*includeUnit)(u)) {
+		if ((includeUnit == nullptr) || (*includeUnit)(u, allyTeam)) {
 			if (unitIds != nullptr)
 				unitIds[a] = u->id;
 
@@ -808,59 +809,49 @@ static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int
 }
 
 
-static int myAllyTeamId = -1;
-
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsEnemy(const CUnit* unit) {
-	return (!teamHandler.Ally(unit->allyteam, myAllyTeamId) && !unit->IsNeutral());
+// the predicates take the caller's allyteam, AIs may call them concurrently
+static inline bool unit_IsEnemy(const CUnit* unit, int allyTeam) {
+	return (!teamHandler.Ally(unit->allyteam, allyTeam) && !unit->IsNeutral());
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsFriendly(const CUnit* unit) {
-	return (teamHandler.Ally(unit->allyteam, myAllyTeamId) && !unit->IsNeutral());
+static inline bool unit_IsFriendly(const CUnit* unit, int allyTeam) {
+	return (teamHandler.Ally(unit->allyteam, allyTeam) && !unit->IsNeutral());
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsInSensor(const CUnit* unit, const unsigned short losFlags) {
+static inline bool unit_IsInSensor(const CUnit* unit, int allyTeam, const unsigned short losFlags) {
 	// Skip in-sensor-range test if the unit is allied with our team.
 	// This prevents errors where an allied unit is starting to build,
 	// but is not yet (technically) in LOS, because LOS was not yet updated,
 	// and thus would be invisible for us, without the ally check.
-	return (teamHandler.Ally(myAllyTeamId, unit->allyteam) || ((unit->losStatus[myAllyTeamId] & losFlags) != 0));
+	return (teamHandler.Ally(allyTeam, unit->allyteam) || ((unit->losStatus[allyTeam] & losFlags) != 0));
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsInLos(const CUnit* unit) {
-	return unit_IsInSensor(unit, LOS_INLOS);
+static inline bool unit_IsInLos(const CUnit* unit, int allyTeam) {
+	return unit_IsInSensor(unit, allyTeam, LOS_INLOS);
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsEnemyAndInLos(const CUnit* unit) {
-	return (unit_IsEnemy(unit) && unit_IsInLos(unit));
+static inline bool unit_IsEnemyAndInLos(const CUnit* unit, int allyTeam) {
+	return (unit_IsEnemy(unit, allyTeam) && unit_IsInLos(unit, allyTeam));
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsEnemyAndInLosOrRadar(const CUnit* unit) {
-	return (unit_IsEnemy(unit) && ((unit->losStatus[myAllyTeamId] & (LOS_INLOS | LOS_INRADAR)) != 0));
+static inline bool unit_IsEnemyAndInLosOrRadar(const CUnit* unit, int allyTeam) {
+	return (unit_IsEnemy(unit, allyTeam) && ((unit->losStatus[allyTeam] & (LOS_INLOS | LOS_INRADAR)) != 0));
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
-static inline bool unit_IsNeutralAndInLosOrRadar(const CUnit* unit) {
-	return (unit->IsNeutral() && (unit_IsInSensor(unit, LOS_INLOS | LOS_INRADAR)));
+static inline bool unit_IsNeutralAndInLosOrRadar(const CUnit* unit, int allyTeam) {
+	return (unit->IsNeutral() && (unit_IsInSensor(unit, allyTeam, LOS_INLOS | LOS_INRADAR)));
 }
 
 int CAICallback::GetEnemyUnits(int* unitIds, int unitIds_max)
 {
 	verify();
-	myAllyTeamId = teamHandler.AllyTeam(team);
-	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, &unit_IsEnemyAndInLos);
+	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, teamHandler.AllyTeam(team), &unit_IsEnemyAndInLos);
 }
 
 int CAICallback::GetEnemyUnitsInRadarAndLos(int* unitIds, int unitIds_max)
 {
 	verify();
-	myAllyTeamId = teamHandler.AllyTeam(team);
-	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, &unit_IsEnemyAndInLosOrRadar);
+	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, teamHandler.AllyTeam(team), &unit_IsEnemyAndInLosOrRadar);
 }
 
 int CAICallback::GetEnemyUnits(int* unitIds, const float3& pos, float radius, bool spherical,
@@ -868,17 +859,16 @@ int CAICallback::GetEnemyUnits(int* unitIds, const float3& pos, float radius, bo
 {
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
-	myAllyTeamId = teamHandler.AllyTeam(team);
-	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsEnemyAndInLos);
+	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, teamHandler.AllyTeam(team), &unit_IsEnemyAndInLos);
 }
 
 
 int CAICallback::GetFriendlyUnits(int* unitIds, int unitIds_max)
 {
 	verify();
-	myAllyTeamId = teamHandler.AllyTeam(team);
-	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, &unit_IsFriendly);
+	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, teamHandler.AllyTeam(team), &unit_IsFriendly);
 }
 
 int CAICallback::GetFriendlyUnits(int* unitIds, const float3& pos, float radius, bool spherical,
@@ -886,17 +876,16 @@ int CAICallback::GetFriendlyUnits(int* unitIds, const float3& pos, float radius,
 {
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
-	myAllyTeamId = teamHandler.AllyTeam(team);
-	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsFriendly);
+	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, teamHandler.AllyTeam(team), &unit_IsFriendly);
 }
 
 
 int CAICallback::GetNeutralUnits(int* unitIds, int unitIds_max)
 {
 	verify();
-	myAllyTeamId = teamHandler.AllyTeam(team);
-	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, &unit_IsNeutralAndInLosOrRadar);
+	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, teamHandler.AllyTeam(team), &unit_IsNeutralAndInLosOrRadar);
 }
 
 int CAICallback::GetNeutralUnits(int* unitIds, const float3& pos, float radius, bool spherical,
@@ -904,9 +893,9 @@ int CAICallback::GetNeutralUnits(int* unitIds, const float3& pos, float radius,
 {
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
-	myAllyTeamId = teamHandler.AllyTeam(team);
-	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsNeutralAndInLosOrRadar);
+	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, teamHandler.AllyTeam(team), &unit_IsNeutralAndInLosOrRadar);
 }
 
 
@@ -1105,7 +1094,7 @@ bool CAICallback::CanBuildAt(const UnitDef* unitDef, const float3& pos, int faci
 	CFeature* blockingF = nullptr;
 	BuildInfo bi(unitDef, pos, facing);
 	bi.pos = CGameHelper::Pos2BuildPos(bi, false);
-	return !!CGameHelper::TestUnitBuildSquare(bi, blockingF, teamHandler.AllyTeam(team), false);
+	return !!CGameHelper::TestUnitBuildSquare(bi, blockingF, teamHandler.AllyTeam(team), false, nullptr, nullptr, nullptr, nullptr, ThreadPool::GetThreadNum());
 }
 
 
@@ -1235,6 +1224,7 @@ int CAICallback::GetFeatures(int* featureIds, int maxFeatureIDs, const float3& p
 
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetFeaturesExact(qfQuery, pos, radius, spherical);
 	const int allyteam = teamHandler.AllyTeam(team);
 
@@ -1442,9 +1432,7 @@ int CAICallback::HandleCommand(int commandId, void* data)
 					const float realLen = TraceRay::TraceRay(cmdData->rayPos, cmdData->rayDir, cmdData->rayLen, cmdData->flags, srcUnit, hitUnit, hitFeature);
 
 					if (hitUnit != nullptr) {
-						myAllyTeamId = teamHandler.AllyTeam(team);
-
-						if (unit_IsInLos(hitUnit)) {
+						if (unit_IsInLos(hitUnit, teamHandler.AllyTeam(team))) {
 							cmdData->rayLen = realLen;
 							cmdData->hitUID = hitUnit->id;
 						}
@@ -1602,10 +1590,8 @@ bool CAICallback::GetProperty(int unitId, int property, void* data)
 		const CUnit* unit = unitHandler.GetUnit(unitId);
 		const int allyTeam = teamHandler.AllyTeam(team);
 
-		myAllyTeamId = allyTeam;
-
 		// the unit does not exist or can not be seen
-		if (unit == nullptr || !unit_IsInLos(unit))
+		if (unit == nullptr || !unit_IsInLos(unit, allyTeam))
 			return false;
 
 		switch (property) {
@@ -16,6 +16,7 @@
 #include "Net/GameServer.h"
 #include "Game/GameSetup.h"
 #include "System/SpringMath.h"
+#include "System/Threading/ThreadPool.h"
 
 #include <vector>
 
@@ -121,7 +122,7 @@ float3 CAICheats::GetUnitVelocity(int unitId) const
 }
 
 
-static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int unitIds_max, bool (*includeUnit)(CUnit*) = nullptr)
+static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int unitIds_max, int allyTeam, bool (*includeUnit)(const CUnit*, int) = nullptr)
 {
 	int a = 0;
 
@@ -131,11 +132,11 @@ static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int
 	}
 
 	for (auto ui = units.begin(); (ui != units.end()) && (a < unitIds_max); ++ui) {
-		CUnit* u = *ui;
+		const CUnit* u = *ui;
 		if (!CHECK_UNITID(u->id))
 			continue;
 
-		if ((includeUnit == nullptr) || (*includeUnit)(u)) {
+		if ((includeUnit == nullptr) || (*includeUnit)(u, allyTeam)) {
 			if (unitIds != nullptr)
 				unitIds[a] = u->id;
 
@@ -146,44 +147,41 @@ static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int
 	return a;
 }
 
-static inline bool unit_IsNeutral(CUnit* unit) {
+static inline bool unit_IsNeutral(const CUnit* unit, int allyTeam) {
 	return unit->IsNeutral();
 }
 
-static int myAllyTeamId = -1;
-
-/// You have to set myAllyTeamId before callign this function. NOT thread safe!
-static inline bool unit_IsEnemy(CUnit* unit) {
-	return (!teamHandler.Ally(unit->allyteam, myAllyTeamId) && !unit_IsNeutral(unit));
+static inline bool unit_IsEnemy(const CUnit* unit, int allyTeam) {
+	return (!teamHandler.Ally(unit->allyteam, allyTeam) && !unit->IsNeutral());
 }
 
 
 int CAICheats::GetEnemyUnits(int* unitIds, int unitIds_max)
 {
-	myAllyTeamId = teamHandler.AllyTeam(ai->GetTeamId());
-	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, &unit_IsEnemy);
+	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, teamHandler.AllyTeam(ai->GetTeamId()), &unit_IsEnemy);
 }
 
 int CAICheats::GetEnemyUnits(int* unitIds, const float3& pos, float radius, bool spherical,
 		int unitIds_max)
 {
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
-	myAllyTeamId = teamHandler.AllyTeam(ai->GetTeamId());
-	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsEnemy);
+	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, teamHandler.AllyTeam(ai->GetTeamId()), &unit_IsEnemy);
 }
 
 int CAICheats::GetNeutralUnits(int* unitIds, int unitIds_max)
 {
-	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, &unit_IsNeutral);
+	return FilterUnitsVector(unitHandler.GetActiveUnits(), unitIds, unitIds_max, -1, &unit_IsNeutral);
 }
 
 int CAICheats::GetNeutralUnits(int* unitIds, const float3& pos, float radius, bool spherical,
 		int unitIds_max)
 {
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
-	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsNeutral);
+	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, -1, &unit_IsNeutral);
 }
 
 int CAICheats::GetFeatures(int* features, int max) const {
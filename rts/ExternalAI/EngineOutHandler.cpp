@@ -6,6 +6,7 @@
 #include "ExternalAI/SkirmishAIData.h"
 #include "ExternalAI/SkirmishAIHandler.h"
 #include "ExternalAI/AILibraryManager.h"
+#include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/Interface/AISCommands.h"
 #include "Game/GlobalUnsynced.h"
 #include "Game/Players/Player.h"
@@ -19,9 +20,15 @@
 #include "Sim/Units/CommandAI/Command.h"
 #include "Sim/Weapons/WeaponDef.h"
 #include "Net/Protocol/NetProtocol.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
 #include "System/SafeUtil.h"
+#include "System/Threading/ThreadPool.h"
+
+CONFIG(bool, ParallelSkirmishAIs)
+	.defaultValue(false)
+	.description("Update native Skirmish AIs in parallel with each other. The simulation still waits for all of them every frame; their events are queued and arrive one frame late.");
 
 
 CR_BIND(CEngineOutHandler, )
@@ -29,6 +36,9 @@ CR_REG_METADATA(CEngineOutHandler, (
 	CR_IGNORED(hostSkirmishAIs),
 	CR_IGNORED(teamSkirmishAIs),
 	CR_IGNORED(activeSkirmishAIs),
+	CR_IGNORED(parallelSkirmishAIs),
+	CR_IGNORED(parallelUpdates),
+	CR_IGNORED(concurrentUpdate),
 
 	CR_POSTLOAD(PostLoad)
 ))
@@ -65,6 +75,13 @@ void CEngineOutHandler::Create() {
 	numInstances += 1;
 }
 
+void CEngineOutHandler::Init() {
+	activeSkirmishAIs.reserve(16);
+	parallelSkirmishAIs.reserve(16);
+
+	parallelUpdates = configHandler->GetBool("ParallelSkirmishAIs");
+}
+
 void CEngineOutHandler::Destroy() {
 	if (numInstances != 1)
 		return;
@@ -127,7 +144,39 @@ void CEngineOutHandler::Save(std::ostream* s, const uint8_t skirmishAIId) {
 
 void CEngineOutHandler::Update() {
 	AI_SCOPED_TIMER();
-	DO_FOR_SKIRMISH_AIS(Update(gs->frameNum))
+
+	if (!parallelUpdates) {
+		DO_FOR_SKIRMISH_AIS(Update(gs->frameNum))
+		return;
+	}
+
+	// AIs only read simulation state while handling events, and their
+	// commands either go through the network or are serialized by the
+	// callback; cheating AIs modify the simulation directly and are run
+	// exclusively
+	parallelSkirmishAIs.clear();
+
+	for (uint8_t aiID: activeSkirmishAIs) {
+		if (skirmishAiCallback_Cheats_isEnabled(aiID))
+			continue;
+
+		parallelSkirmishAIs.push_back(aiID);
+	}
+
+	concurrentUpdate = true;
+
+	for_mt(0, parallelSkirmishAIs.size(), [&](const int i) {
+		hostSkirmishAIs[ parallelSkirmishAIs[i] ].UpdateDeferred(gs->frameNum);
+	});
+
+	concurrentUpdate = false;
+
+	for (uint8_t aiID: activeSkirmishAIs) {
+		if (!skirmishAiCallback_Cheats_isEnabled(aiID))
+			continue;
+
+		hostSkirmishAIs[aiID].UpdateDeferred(gs->frameNum);
+	}
 }
 
 
@@ -537,6 +586,7 @@ void CEngineOutHandler::CreateSkirmishAI(const uint8_t skirmishAIId, bool savedG
 	}
 
 	aiInst.PreInit(skirmishAIId);
+	aiInst.SetDeferEvents(parallelUpdates);
 
 	teamSkirmishAIs[ aiInst.GetTeamId() ].push_back(skirmishAIId);
 	activeSkirmishAIs.push_back(skirmishAIId);
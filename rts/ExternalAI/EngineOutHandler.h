@@ -31,7 +31,7 @@ public:
 	static void Create();
 	static void Destroy();
 
-	void Init() { activeSkirmishAIs.reserve(16); }
+	void Init();
 	void Kill() {
 		PreDestroy();
 
@@ -47,8 +47,16 @@ public:
 	/** Called just before all the units are destroyed. */
 	void PreDestroy();
 
+	/**
+	 * Updates every AI; the simulation waits for all of them. With
+	 * ParallelSkirmishAIs the AIs run in parallel with each other and
+	 * receive the events of the previous frame first.
+	 */
 	void Update();
 
+	/// true while Update runs AIs on ThreadPool workers
+	bool InConcurrentUpdate() const { return concurrentUpdate; }
+
 	/** Group should return false if it doenst want the unit for some reason. */
 	bool UnitAddedToGroup(const CUnit& unit, const CGroup& group);
 	/** No way to refuse giving up a unit. */
@@ -117,6 +125,12 @@ private:
 	std::array<std::vector<uint8_t>, MAX_TEAMS> teamSkirmishAIs;
 
 	std::vector<uint8_t> activeSkirmishAIs;
+	/// scratch-buffer for Update, AIs that can run concurrently
+	std::vector<uint8_t> parallelSkirmishAIs;
+
+	/// if true, AI events are queued until the next Update, which runs the AIs in parallel
+	bool parallelUpdates = false;
+	bool concurrentUpdate = false;
 };
 
 #define eoh CEngineOutHandler::GetInstance()
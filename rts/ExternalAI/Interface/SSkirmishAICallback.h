@@ -2256,6 +2256,56 @@ struct SSkirmishAICallback {
 
 	bool              (CALLING_CONV *Debug_GraphDrawer_isEnabled)(int skirmishAIId);
 
+	/**
+	 * Fetches the state of many units in a single call, which is the same
+	 * as calling Unit_getPos, Unit_getVel, Unit_getHealth, Unit_getTeam and
+	 * Unit_getDef for each of them.
+	 * Any of the output arrays may be NULL, in which case that part of the
+	 * state is skipped; otherwise they must have room for unitIds_size
+	 * entries (three floats per entry for positions and velocities).
+	 *
+	 * @return the number of units whose state was written, unitIds_size
+	 */
+	int               (CALLING_CONV *getUnitStates)(int skirmishAIId, const int* unitIds, int unitIds_size, float* positions, float* velocities, float* healths, int* teams, int* unitDefIds);
+
+	/**
+	 * Returns the parts of the height-map that changed during or after the
+	 * given frame, as four values (x1, z1, x2, z2) per rectangle, in height-map
+	 * squares and with inclusive bounds. The rectangles can overlap.
+	 * If the changes are not known that far back (e.g. because the frame is
+	 * too old, or the game was loaded), a single rectangle covering the whole
+	 * map is returned.
+	 *
+	 * - pass the frame this was last called in to fetch the changes made since;
+	 *   this includes those made later during that frame, so a rectangle may
+	 *   be returned by two consecutive calls
+	 * - the slope-map changes accordingly, at half the resolution
+	 *
+	 * @see getHeightMapRect()
+	 */
+	int               (CALLING_CONV *Map_getHeightMapChanges)(int skirmishAIId, int frame, int* rects, int rects_sizeMax); //$ ARRAY:rects
+
+	/**
+	 * Returns the part of the height-map within the given rectangle (inclusive
+	 * bounds, in height-map squares, clamped to the map), row by row.
+	 * Only complete rows are written.
+	 *
+	 * @see getHeightMap()
+	 * @see getHeightMapChanges()
+	 */
+	int               (CALLING_CONV *Map_getHeightMapRect)(int skirmishAIId, int x1, int z1, int x2, int z2, float* heights, int heights_sizeMax); //$ ARRAY:heights
+
+	/**
+	 * Returns the part of the slope-map within the given rectangle (inclusive
+	 * bounds, in slope-map squares, i.e. height-map squares / 2, clamped to the
+	 * map), row by row.
+	 * Only complete rows are written.
+	 *
+	 * @see getSlopeMap()
+	 * @see getHeightMapChanges()
+	 */
+	int               (CALLING_CONV *Map_getSlopeMapRect)(int skirmishAIId, int x1, int z1, int x2, int z2, float* slopes, int slopes_sizeMax); //$ ARRAY:slopes
+
 };
 
 #if	defined(__cplusplus)
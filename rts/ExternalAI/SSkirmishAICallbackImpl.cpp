@@ -3,6 +3,7 @@
 #include "ExternalAI/AICallback.h"
 #include "ExternalAI/AICheats.h"
 #include "ExternalAI/AILibraryManager.h"
+#include "ExternalAI/EngineOutHandler.h"
 #include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/SkirmishAILibraryInfo.h"
 #include "ExternalAI/SkirmishAIWrapper.h"
@@ -47,6 +48,8 @@
 #include "System/SpringMath.h"
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/Log/ILog.h"
+#include "System/Threading/SpringThreading.h"
+#include "System/Threading/ThreadPool.h"
 
 
 static std::array<std::pair<CAICallback, CAICheats>, MAX_AIS> AI_LEGACY_CALLBACKS;
@@ -61,6 +64,11 @@ static std::vector<LineMarker> AI_TMP_LINE_MARKERS[MAX_AIS];
 
 static constexpr size_t MAX_NUM_MARKERS = 16384;
 
+// serializes engine-side command handling for AIs that run
+// concurrently (see ParallelSkirmishAIs); recursive because a
+// command can trigger events which issue further commands
+static spring::recursive_mutex AI_COMMAND_MUTEX;
+
 
 static inline CAICallback* GetCallBack(int skirmishAIId) { return &AI_LEGACY_CALLBACKS[skirmishAIId].first; }
 static inline CAICheats* GetCheatCallBack(int skirmishAIId) { return &AI_LEGACY_CALLBACKS[skirmishAIId].second; }
@@ -645,13 +653,17 @@ EXPORT(int) skirmishAiCallback_Engine_handleCommand(
 	int commandTopic,
 	void* commandData
 ) {
+	std::lock_guard<spring::recursive_mutex> lock(AI_COMMAND_MUTEX);
+
 	int ret = 0;
 
 	CAICallback* clb = GetCallBack(skirmishAIId);
 	// if this is not NULL, cheating is enabled
 	CAICheats* clbCheat = nullptr;
 
-	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId))
+	// cheats modify the simulation directly, which other AIs may be reading
+	// concurrently; cheating AIs are updated exclusively from the next frame
+	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId) && !eoh->InConcurrentUpdate())
 		clbCheat = GetCheatCallBack(skirmishAIId);
 
 	switch (commandTopic) {
@@ -1847,6 +1859,81 @@ EXPORT(int) skirmishAiCallback_Map_getSlopeMap(int skirmishAIId,
 	return slopesSize;
 }
 
+static int copyMapRect(
+	const float* map,
+	int mapWidth,
+	int mapHeight,
+	int x1,
+	int z1,
+	int x2,
+	int z2,
+	float* values,
+	int valuesMaxSize
+) {
+	x1 = std::clamp(x1, 0, mapWidth - 1);
+	z1 = std::clamp(z1, 0, mapHeight - 1);
+	x2 = std::clamp(x2, 0, mapWidth - 1);
+	z2 = std::clamp(z2, 0, mapHeight - 1);
+
+	if (x2 < x1 || z2 < z1)
+		return 0;
+
+	const int rowSize = x2 - x1 + 1;
+	const int valuesRealSize = rowSize * (z2 - z1 + 1);
+
+	if (values == nullptr)
+		return valuesRealSize;
+
+	int valuesSize = 0;
+
+	for (int z = z1; z <= z2 && (valuesSize + rowSize) <= valuesMaxSize; ++z) {
+		std::copy_n(&map[z * mapWidth + x1], rowSize, &values[valuesSize]);
+		valuesSize += rowSize;
+	}
+
+	return valuesSize;
+}
+
+EXPORT(int) skirmishAiCallback_Map_getHeightMapChanges(int skirmishAIId, int frame,
+		int* rects, int rectsMaxSize) {
+
+	std::vector<SRectangle> changes;
+
+	if (!readMap->GetSyncedHeightMapChanges(frame, changes)) {
+		changes.clear();
+		changes.push_back({0, 0, mapDims.mapxm1, mapDims.mapym1});
+	}
+
+	const int rectsRealSize = changes.size() * 4;
+
+	int rectsSize = rectsRealSize;
+
+	if (rects != nullptr) {
+		rectsSize = std::min(rectsRealSize, rectsMaxSize) & ~3;
+
+		for (int i = 0; i < rectsSize; i += 4) {
+			const SRectangle& rect = changes[i >> 2];
+
+			rects[i + 0] = rect.x1;
+			rects[i + 1] = rect.z1;
+			rects[i + 2] = rect.x2;
+			rects[i + 3] = rect.z2;
+		}
+	}
+
+	return rectsSize;
+}
+
+EXPORT(int) skirmishAiCallback_Map_getHeightMapRect(int skirmishAIId,
+		int x1, int z1, int x2, int z2, float* heights, int heightsMaxSize) {
+	return copyMapRect(GetCallBack(skirmishAIId)->GetHeightMap(), mapDims.mapx, mapDims.mapy, x1, z1, x2, z2, heights, heightsMaxSize);
+}
+
+EXPORT(int) skirmishAiCallback_Map_getSlopeMapRect(int skirmishAIId,
+		int x1, int z1, int x2, int z2, float* slopes, int slopesMaxSize) {
+	return copyMapRect(GetCallBack(skirmishAIId)->GetSlopeMap(), mapDims.hmapx, mapDims.hmapy, x1, z1, x2, z2, slopes, slopesMaxSize);
+}
+
 #define GET_SENSOR_MAP(name, sensor)	\
 EXPORT(int) skirmishAiCallback_Map_get##name##Map(int skirmishAIId,	\
 		int* sensor##Values, int sensor##ValuesMaxSize) {	\
@@ -1925,6 +2012,8 @@ EXPORT(int) skirmishAiCallback_Map_getResourceMapRaw(
 }
 
 static inline const CResourceMapAnalyzer* getResourceMapAnalyzer(int resourceId) {
+	// analyzers are initialized on first access
+	std::lock_guard<spring::recursive_mutex> lock(AI_COMMAND_MUTEX);
 	return resourceHandler->GetResourceMapAnalyzer(resourceId);
 }
 
@@ -3657,6 +3746,36 @@ EXPORT(void) skirmishAiCallback_Unit_getVel(int skirmishAIId, int unitId, float*
 	GetCallBack(skirmishAIId)->GetUnitVelocity(unitId).copyInto(return_posF3_out);
 }
 
+EXPORT(int) skirmishAiCallback_getUnitStates(
+	int skirmishAIId,
+	const int* unitIds,
+	int unitIds_size,
+	float* positions,
+	float* velocities,
+	float* healths,
+	int* teams,
+	int* unitDefIds
+) {
+	// saves the AI one call per unit and attribute, which is
+	// expensive for wrapped (e.g. Java) AIs managing many units
+	for (int i = 0; i < unitIds_size; ++i) {
+		const int unitId = unitIds[i];
+
+		if (positions != nullptr)
+			skirmishAiCallback_Unit_getPos(skirmishAIId, unitId, &positions[i * 3]);
+		if (velocities != nullptr)
+			skirmishAiCallback_Unit_getVel(skirmishAIId, unitId, &velocities[i * 3]);
+		if (healths != nullptr)
+			healths[i] = skirmishAiCallback_Unit_getHealth(skirmishAIId, unitId);
+		if (teams != nullptr)
+			teams[i] = skirmishAiCallback_Unit_getTeam(skirmishAIId, unitId);
+		if (unitDefIds != nullptr)
+			unitDefIds[i] = skirmishAiCallback_Unit_getDef(skirmishAIId, unitId);
+	}
+
+	return unitIds_size;
+}
+
 
 //EXPORT(int) skirmishAiCallback_Unit_0MULTI1SIZE0ResourceInfo(int skirmishAIId, int unitId) {
 //	return skirmishAiCallback_0MULTI1SIZE0Resource(skirmishAIId);
@@ -4095,6 +4214,7 @@ EXPORT(int) skirmishAiCallback_getFeaturesIn(int skirmishAIId, float* pos_posF3,
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		// cheating
 		QuadFieldQuery qfQuery;
+		qfQuery.threadOwner = ThreadPool::GetThreadNum();
 		quadField.GetFeaturesExact(qfQuery, pos_posF3, radius, spherical);
 		const int featureIdsRealSize = qfQuery.features->size();
 
@@ -5525,6 +5645,10 @@ static void skirmishAiCallback_init(SSkirmishAICallback* callback) {
 	callback->Unit_Weapon_isShieldEnabled = &skirmishAiCallback_Unit_Weapon_isShieldEnabled;
 	callback->Unit_Weapon_getShieldPower = &skirmishAiCallback_Unit_Weapon_getShieldPower;
 	callback->Debug_GraphDrawer_isEnabled = &skirmishAiCallback_Debug_GraphDrawer_isEnabled;
+	callback->getUnitStates = &skirmishAiCallback_getUnitStates;
+	callback->Map_getHeightMapChanges = &skirmishAiCallback_Map_getHeightMapChanges;
+	callback->Map_getHeightMapRect = &skirmishAiCallback_Map_getHeightMapRect;
+	callback->Map_getSlopeMapRect = &skirmishAiCallback_Map_getSlopeMapRect;
 }
 
 SSkirmishAICallback* skirmishAiCallback_GetInstance(CSkirmishAIWrapper* ai)
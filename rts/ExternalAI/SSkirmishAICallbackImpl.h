@@ -1263,6 +1263,14 @@ EXPORT(float            ) skirmishAiCallback_Unit_Weapon_getShieldPower(int skir
 
 EXPORT(bool             ) skirmishAiCallback_Debug_GraphDrawer_isEnabled(int skirmishAIId);
 
+EXPORT(int              ) skirmishAiCallback_getUnitStates(int skirmishAIId, const int* unitIds, int unitIds_size, float* positions, float* velocities, float* healths, int* teams, int* unitDefIds);
+
+EXPORT(int              ) skirmishAiCallback_Map_getHeightMapChanges(int skirmishAIId, int frame, int* rects, int rects_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_Map_getHeightMapRect(int skirmishAIId, int x1, int z1, int x2, int z2, float* heights, int heights_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_Map_getSlopeMapRect(int skirmishAIId, int x1, int z1, int x2, int z2, float* slopes, int slopes_sizeMax);
+
 #if	defined(__cplusplus)
 } // extern "C"
 #endif
@@ -0,0 +1,73 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SKIRMISH_AI_EVENT_QUEUE_H
+#define SKIRMISH_AI_EVENT_QUEUE_H
+
+#include "System/Threading/SpringThreading.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Events queued for a Skirmish AI while ParallelSkirmishAIs is enabled.
+ * Events can be pushed from any thread (e.g. by another AI's commands),
+ * they are delivered in the order they were pushed.
+ * Each event has to own copies of its arguments.
+ */
+class CSkirmishAIEventQueue {
+public:
+	template<typename E> void Push(E&& event) {
+		std::lock_guard<spring::mutex> lock(mutex);
+		queuedEvents.emplace_back(std::forward<E>(event));
+	}
+
+	/**
+	 * Delivers the events pushed before this call, followed by <post>.
+	 * Events raised meanwhile on this thread (e.g. by the AI's own cheat
+	 * commands) are not queued, see IsDelivering.
+	 */
+	template<typename F> void Deliver(F&& post) {
+		const CSkirmishAIEventQueue* prevQueue = std::exchange(deliveringQueue, this);
+
+		{
+			std::lock_guard<spring::mutex> lock(mutex);
+			std::swap(queuedEvents, deliveredEvents);
+		}
+
+		for (const auto& event: deliveredEvents) {
+			event();
+		}
+
+		deliveredEvents.clear();
+		post();
+
+		deliveringQueue = prevQueue;
+	}
+
+	void Deliver() { Deliver([]() {}); }
+
+	void Clear() {
+		std::lock_guard<spring::mutex> lock(mutex);
+		queuedEvents.clear();
+		deliveredEvents.clear();
+	}
+
+	size_t Size() {
+		std::lock_guard<spring::mutex> lock(mutex);
+		return queuedEvents.size();
+	}
+
+	/// true while this thread is inside Deliver of this queue
+	bool IsDelivering() const { return (deliveringQueue == this); }
+
+private:
+	std::vector<std::function<void()>> queuedEvents;
+	std::vector<std::function<void()>> deliveredEvents;
+
+	spring::mutex mutex;
+
+	static inline thread_local const CSkirmishAIEventQueue* deliveringQueue = nullptr;
+};
+
+#endif // SKIRMISH_AI_EVENT_QUEUE_H
@@ -201,7 +201,8 @@ private:
 	spring::unordered_set<std::string> luaAIShortNames;
 
 	// the current local AI ID that is executing, MAX_AIS if none (e.g. LuaUI)
-	uint8_t currentAIId = MAX_AIS;
+	// thread-local since AIs can run concurrently, see ParallelSkirmishAIs
+	static thread_local uint8_t currentAIId;
 	uint8_t numSkirmishAIs = 0;
 
 	bool gameInitialized = false;
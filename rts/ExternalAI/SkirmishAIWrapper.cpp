@@ -14,6 +14,7 @@
 #include "Interface/SSkirmishAILibrary.h"
 
 #include "Sim/Units/Unit.h"
+#include "Sim/Units/CommandAI/Command.h"
 #include "Sim/Units/UnitHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 
@@ -41,6 +42,8 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 
 	CR_MEMBER(timerName),
 
+	CR_IGNORED(deferredEvents),
+
 	CR_MEMBER(skirmishAIId),
 	CR_MEMBER(teamId),
 
@@ -51,6 +54,7 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 
 	CR_MEMBER(cheatEvents),
 	CR_MEMBER(blockEvents),
+	CR_IGNORED(deferEvents),
 
 	CR_SERIALIZER(Serialize),
 	CR_POSTLOAD(PostLoad)
@@ -74,6 +78,9 @@ void CSkirmishAIWrapper::PreInit(int aiID)
 
 		cheatEvents = false;
 		blockEvents = false;
+		deferEvents = false;
+
+		deferredEvents.Clear();
 	}
 	{
 		const std::string& kn = key.GetShortName();
@@ -165,6 +172,8 @@ void CSkirmishAIWrapper::Kill()
 	{
 		library = nullptr;
 		callback = nullptr;
+
+		deferredEvents.Clear();
 	}
 	{
 		// mark as inactive for EngineOutHandler::{Load,Save}; AI data
@@ -286,6 +295,8 @@ void CSkirmishAIWrapper::Save(std::ostream* saveStream)
 	const SSaveEvent evtData = {tmpFile.c_str()};
 
 	assert(Active());
+	// the AI's saved state must include everything that happened up to now
+	deferredEvents.Deliver();
 	HandleEvent(EVENT_SAVE, &evtData);
 
 	if (!FileSystem::FileExists(tmpFile))
@@ -305,21 +316,33 @@ void CSkirmishAIWrapper::Save(std::ostream* saveStream)
 
 
 void CSkirmishAIWrapper::UnitIdle(int unitId) {
+	if (DeferEvent([=, this]() { UnitIdle(unitId); }))
+		return;
+
 	const SUnitIdleEvent evtData = {unitId};
 	HandleEvent(EVENT_UNIT_IDLE, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitCreated(int unitId, int builderId) {
+	if (DeferEvent([=, this]() { UnitCreated(unitId, builderId); }))
+		return;
+
 	const SUnitCreatedEvent evtData = {unitId, builderId};
 	HandleEvent(EVENT_UNIT_CREATED, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitFinished(int unitId) {
+	if (DeferEvent([=, this]() { UnitFinished(unitId); }))
+		return;
+
 	const SUnitFinishedEvent evtData = {unitId};
 	HandleEvent(EVENT_UNIT_FINISHED, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitDestroyed(int unitId, int attackerUnitId, int weaponDefID) {
+	if (DeferEvent([=, this]() { UnitDestroyed(unitId, attackerUnitId, weaponDefID); }))
+		return;
+
 	const SUnitDestroyedEvent evtData = {unitId, attackerUnitId, weaponDefID};
 	HandleEvent(EVENT_UNIT_DESTROYED, &evtData);
 }
@@ -332,6 +355,9 @@ void CSkirmishAIWrapper::UnitDamaged(
 	int weaponDefId,
 	bool paralyzer
 ) {
+	if (DeferEvent([=, this, cpyDir = dir]() { UnitDamaged(unitId, attackerUnitId, damage, cpyDir, weaponDefId, paralyzer); }))
+		return;
+
 	float3 cpyDir = dir;
 	const SUnitDamagedEvent evtData = {unitId, attackerUnitId, damage, &cpyDir[0], weaponDefId, paralyzer};
 
@@ -339,52 +365,82 @@ void CSkirmishAIWrapper::UnitDamaged(
 }
 
 void CSkirmishAIWrapper::UnitMoveFailed(int unitId) {
+	if (DeferEvent([=, this]() { UnitMoveFailed(unitId); }))
+		return;
+
 	const SUnitMoveFailedEvent evtData = {unitId};
 	HandleEvent(EVENT_UNIT_MOVE_FAILED, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitGiven(int unitId, int oldTeam, int newTeam) {
+	if (DeferEvent([=, this]() { UnitGiven(unitId, oldTeam, newTeam); }))
+		return;
+
 	const SUnitGivenEvent evtData = {unitId, oldTeam, newTeam};
 	HandleEvent(EVENT_UNIT_GIVEN, &evtData);
 }
 
 void CSkirmishAIWrapper::UnitCaptured(int unitId, int oldTeam, int newTeam) {
+	if (DeferEvent([=, this]() { UnitCaptured(unitId, oldTeam, newTeam); }))
+		return;
+
 	const SUnitCapturedEvent evtData = {unitId, oldTeam, newTeam};
 	HandleEvent(EVENT_UNIT_CAPTURED, &evtData);
 }
 
 
 void CSkirmishAIWrapper::EnemyCreated(int unitId) {
+	if (DeferEvent([=, this]() { EnemyCreated(unitId); }))
+		return;
+
 	const SEnemyCreatedEvent evtData = {unitId};
 	HandleEvent(EVENT_ENEMY_CREATED, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyFinished(int unitId) {
+	if (DeferEvent([=, this]() { EnemyFinished(unitId); }))
+		return;
+
 	const SEnemyFinishedEvent evtData = {unitId};
 	HandleEvent(EVENT_ENEMY_FINISHED, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyEnterLOS(int unitId) {
+	if (DeferEvent([=, this]() { EnemyEnterLOS(unitId); }))
+		return;
+
 	const SEnemyEnterLOSEvent evtData = {unitId};
 	HandleEvent(EVENT_ENEMY_ENTER_LOS, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyLeaveLOS(int unitId) {
+	if (DeferEvent([=, this]() { EnemyLeaveLOS(unitId); }))
+		return;
+
 	const SEnemyLeaveLOSEvent evtData = {unitId};
 	HandleEvent(EVENT_ENEMY_LEAVE_LOS, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyEnterRadar(int unitId) {
+	if (DeferEvent([=, this]() { EnemyEnterRadar(unitId); }))
+		return;
+
 	const SEnemyEnterRadarEvent evtData = {unitId};
 	HandleEvent(EVENT_ENEMY_ENTER_RADAR, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyLeaveRadar(int unitId) {
+	if (DeferEvent([=, this]() { EnemyLeaveRadar(unitId); }))
+		return;
+
 	const SEnemyLeaveRadarEvent evtData = {unitId};
 	HandleEvent(EVENT_ENEMY_LEAVE_RADAR, &evtData);
 }
 
 void CSkirmishAIWrapper::EnemyDestroyed(int enemyUnitId, int attackerUnitId) {
+	if (DeferEvent([=, this]() { EnemyDestroyed(enemyUnitId, attackerUnitId); }))
+		return;
+
 	const SEnemyDestroyedEvent evtData = {enemyUnitId, attackerUnitId};
 	HandleEvent(EVENT_ENEMY_DESTROYED, &evtData);
 }
@@ -397,6 +453,9 @@ void CSkirmishAIWrapper::EnemyDamaged(
 	int weaponDefId,
 	bool paralyzer
 ) {
+	if (DeferEvent([=, this, cpyDir = dir]() { EnemyDamaged(enemyUnitId, attackerUnitId, damage, cpyDir, weaponDefId, paralyzer); }))
+		return;
+
 	float3 cpyDir = dir;
 	const SEnemyDamagedEvent evtData = {enemyUnitId, attackerUnitId, damage, &cpyDir[0], weaponDefId, paralyzer};
 
@@ -408,17 +467,33 @@ void CSkirmishAIWrapper::Update(int frame) {
 	HandleEvent(EVENT_UPDATE, &evtData);
 }
 
+void CSkirmishAIWrapper::UpdateDeferred(int frame) {
+	// events raised meanwhile (e.g. by this AI's own cheat commands)
+	// are handled immediately, as they would be without deferring
+	deferredEvents.Deliver([&]() { Update(frame); });
+}
+
 void CSkirmishAIWrapper::SendChatMessage(const char* msg, int fromPlayerId) {
+	if (DeferEvent([=, this, cpyMsg = std::string(msg)]() { SendChatMessage(cpyMsg.c_str(), fromPlayerId); }))
+		return;
+
 	const SMessageEvent evtData = {fromPlayerId, msg};
 	HandleEvent(EVENT_MESSAGE, &evtData);
 }
 
 void CSkirmishAIWrapper::SendLuaMessage(const char* inData, const char** outData) {
+	// outData is not filled in by AIs, so this can be delivered later as well
+	if (DeferEvent([this, cpyData = std::string(inData)]() { SendLuaMessage(cpyData.c_str(), nullptr); }))
+		return;
+
 	const SLuaMessageEvent evtData = {inData /*outData*/};
 	HandleEvent(EVENT_LUA_MESSAGE, &evtData);
 }
 
 void CSkirmishAIWrapper::WeaponFired(int unitId, int weaponDefId) {
+	if (DeferEvent([=, this]() { WeaponFired(unitId, weaponDefId); }))
+		return;
+
 	const SWeaponFiredEvent evtData = {unitId, weaponDefId};
 	HandleEvent(EVENT_WEAPON_FIRED, &evtData);
 }
@@ -428,6 +503,9 @@ void CSkirmishAIWrapper::PlayerCommandGiven(
 	const Command& c,
 	int playerId
 ) {
+	if (DeferEvent([=, this, cpyCmd = c]() { PlayerCommandGiven(playerSelectedUnits, cpyCmd, playerId); }))
+		return;
+
 	std::vector<int> unitIds = playerSelectedUnits;
 
 	const int cCommandId = extractAICommandTopic(&c, unitHandler.MaxUnits());
@@ -437,6 +515,9 @@ void CSkirmishAIWrapper::PlayerCommandGiven(
 }
 
 void CSkirmishAIWrapper::CommandFinished(int unitId, int commandId, int commandTopicId) {
+	if (DeferEvent([=, this]() { CommandFinished(unitId, commandId, commandTopicId); }))
+		return;
+
 	const SCommandFinishedEvent evtData = {unitId, commandId, commandTopicId};
 	HandleEvent(EVENT_COMMAND_FINISHED, &evtData);
 }
@@ -447,6 +528,9 @@ void CSkirmishAIWrapper::SeismicPing(
 	const float3& pos,
 	float strength
 ) {
+	if (DeferEvent([=, this, cpyPos = pos]() { SeismicPing(allyTeam, unitId, cpyPos, strength); }))
+		return;
+
 	/*const*/ float3 cpyPos = pos;
 	const SSeismicPingEvent evtData = {&cpyPos[0], strength};
 
@@ -455,12 +539,17 @@ void CSkirmishAIWrapper::SeismicPing(
 
 
 int CSkirmishAIWrapper::HandleEvent(int topic, const void* data) const {
-	ScopedTimer timer(GetTimerNameHash());
+	// to prevent log error spam, signal: OK
+	if (blockEvents && (topic != EVENT_RELEASE))
+		return 0;
 
-	if (!blockEvents || (topic == EVENT_RELEASE))
+	// ScopedTimer is not thread-safe, deferred events are delivered by ThreadPool workers
+	if (deferredEvents.IsDelivering()) {
+		ScopedMtTimer timer(GetTimerNameHash());
 		return library->HandleEvent(skirmishAIId, topic, data);
+	}
 
-	// to prevent log error spam, signal: OK
-	return 0;
+	ScopedTimer timer(GetTimerNameHash());
+	return library->HandleEvent(skirmishAIId, topic, data);
 }
 
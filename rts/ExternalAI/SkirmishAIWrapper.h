@@ -4,6 +4,7 @@
 #define SKIRMISH_AI_WRAPPER_H
 
 #include "SkirmishAIKey.h"
+#include "SkirmishAIEventQueue.h"
 
 class CSkirmishAILibrary;
 struct SSkirmishAICallback;
@@ -71,6 +72,11 @@ public:
 	void EnemyDestroyed(int enemyUnitId, int attackerUnitId);
 	void EnemyDamaged(int enemyUnitId, int attackerUnitId, float damage, const float3& dir, int weaponDefId, bool paralyzer);
 	void Update(int frame);
+	/**
+	 * Delivers the events queued since the previous call, followed by
+	 * the update event for <frame>. May be called from a worker thread.
+	 */
+	void UpdateDeferred(int frame);
 	void SendChatMessage(const char* msg, int fromPlayerId);
 	void SendLuaMessage(const char* inData, const char** outData);
 	void WeaponFired(int unitId, int weaponDefId);
@@ -92,6 +98,11 @@ public:
 	 */
 	void SetBlockEvents(bool enable) { blockEvents = enable; }
 	void SetCheatEvents(bool enable) { cheatEvents = enable; }
+	/**
+	 * Queue events instead of handling them immediately;
+	 * they are delivered by the next UpdateDeferred call.
+	 */
+	void SetDeferEvents(bool enable) { deferEvents = enable; }
 
 	bool CheatEventsEnabled() const { return cheatEvents; }
 
@@ -111,6 +122,15 @@ private:
 	 */
 	int HandleEvent(int topic, const void* data) const;
 
+	/// returns true if <event> was queued for UpdateDeferred
+	template<typename E> bool DeferEvent(E&& event) {
+		if (!deferEvents || deferredEvents.IsDelivering())
+			return false;
+
+		deferredEvents.Push(std::forward<E>(event));
+		return true;
+	}
+
 	uint32_t GetTimerNameHash() const { return *reinterpret_cast<const uint32_t*>(&timerName[0]); }
 
 	const char* GetTimerName() const { return (timerName + sizeof(uint32_t)); }
@@ -125,6 +145,8 @@ private:
 	// first 4 bytes store hash(timerName + 4)
 	char timerName[sizeof(uint32_t) + 60] = {0};
 
+	CSkirmishAIEventQueue deferredEvents;
+
 
 	int skirmishAIId = -1;
 	int teamId = -1;
@@ -134,6 +156,7 @@ private:
 	bool libraryInit = false; // CSkirmishAILibrary::Init retval
 	bool cheatEvents = false;
 	bool blockEvents = false;
+	bool deferEvents = false;
 };
 
 #endif // SKIRMISH_AI_WRAPPER_H
@@ -773,27 +773,6 @@ float3 CCamera::GetMoveVectorFromState(bool fromKeyState) const
 	return v;
 }
 
-// http://www.lighthouse3d.com/tutorials/view-frustum-culling/geometric-approach-testing-points-and-spheres/
-bool CCamera::Frustum::IntersectSphere(float3 p, float radius, uint8_t testMask) const
-{
-	RECOIL_DETAILED_TRACY_ZONE;
-	for (size_t i = 0; i < FRUSTUM_PLANE_CNT; ++i) {
-		if ((testMask & (1 << i)) == 0)
-			continue;
-
-		const auto& plane = planes[i];
-		const float dist = plane.dot(p) + plane.w;
-		if (dist < -radius)
-			return false; // outside
-		/*
-		else if (dist < radius)
-			return true;  // intersect
-		*/
-	}
-
-	return true; // inside or intersect
-}
-
 /*
 bool CCamera::Frustum::IntersectAABB(const AABB& b) const
 {
@@ -78,7 +78,24 @@ public:
 
 	struct Frustum {
 	public:
-		bool IntersectSphere(float3 p, float radius, uint8_t testMask) const;
+		// http://www.lighthouse3d.com/tutorials/view-frustum-culling/geometric-approach-testing-points-and-spheres/
+		bool IntersectSphere(float3 p, float radius, uint8_t testMask) const {
+			for (size_t i = 0; i < FRUSTUM_PLANE_CNT; ++i) {
+				if ((testMask & (1 << i)) == 0)
+					continue;
+
+				const auto& plane = planes[i];
+				const float dist = plane.dot(p) + plane.w;
+				if (dist < -radius)
+					return false; // outside
+				/*
+				else if (dist < radius)
+					return true;  // intersect
+				*/
+			}
+
+			return true; // inside or intersect
+		}
 		bool IntersectAABB(const AABB& b, uint8_t testMask = 0x3F) const;
 
 	public:
@@ -233,6 +250,7 @@ public:
 
 	uint32_t GetCamType() const { return camType; }
 	uint32_t GetProjType() const { return projType; }
+	uint8_t GetInViewPlanesMask() const { return inViewPlanesMask; }
 	void SetCamType(uint32_t ct);
 	void SetProjType(uint32_t pt) { projType = pt; }
 	void InitConfigNotify();
@@ -0,0 +1,202 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "DefsSnapshot.h"
+#include "DefsSnapshotFile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include "Game/GameSetup.h"
+#include "Game/GameVersion.h"
+#include "Lua/LuaParser.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/CRC.h"
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+#include "System/StringUtil.h"
+#include "System/Sync/SHA512.hpp"
+
+#include "System/Misc/TracyDefs.h"
+
+CONFIG(bool, DefsSnapshotCache)
+	.defaultValue(true)
+	.description("Cache the tables returned by gamedata/defs.lua, so that later games with the same game, map and options skip running it.");
+
+
+CDefsSnapshot defsSnapshot;
+
+
+namespace {
+	void AppendKeyData(std::vector<std::uint8_t>& keyData, const std::string& str) {
+		keyData.insert(keyData.end(), str.begin(), str.end());
+		keyData.push_back(0);
+	}
+
+	void AppendKeyData(std::vector<std::uint8_t>& keyData, const spring::unordered_map<std::string, std::string>& options) {
+		std::vector<std::pair<std::string, std::string>> sortedOptions(options.begin(), options.end());
+		std::sort(sortedOptions.begin(), sortedOptions.end());
+
+		for (const auto& [key, value]: sortedOptions) {
+			AppendKeyData(keyData, key);
+			AppendKeyData(keyData, value);
+		}
+
+		keyData.push_back(0);
+	}
+
+	std::string GetSnapshotCacheDir() {
+		return (FileSystem::GetCacheDir() + FileSystemAbstraction::GetNativePathSeparator() + "defs" + FileSystemAbstraction::GetNativePathSeparator());
+	}
+}
+
+
+bool CDefsSnapshot::Load(LuaParser* defsParser)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	cacheKey.clear();
+	checksum = 0;
+	setupDependent = false;
+	cached = false;
+
+	if (!configHandler->GetBool("DefsSnapshotCache"))
+		return false;
+
+	std::vector<std::uint8_t> keyData;
+	std::vector<std::uint8_t> tblData;
+
+	AppendKeyData(keyData, IntToString(DefsSnapshotFile::VERSION));
+	AppendKeyData(keyData, SpringVersion::GetSync());
+
+	sha512::raw_digest modChecksum;
+	sha512::raw_digest mapChecksum;
+
+	// an archive still hashed by StartChecksums is new or changed since it was
+	// last scanned, so there would be nothing cached for it anyway; not worth
+	// stalling the load for
+	if (!archiveScanner->TryGetArchiveCompleteChecksumBytes(gameSetup->modName, modChecksum) || !archiveScanner->TryGetArchiveCompleteChecksumBytes(gameSetup->mapName, mapChecksum)) {
+		LOG("[DefsSnapshot::%s] archive checksums not known yet, not using the cache", __func__);
+		return false;
+	}
+
+	keyData.insert(keyData.end(), modChecksum.begin(), modChecksum.end());
+	keyData.insert(keyData.end(), mapChecksum.begin(), mapChecksum.end());
+
+	AppendKeyData(keyData, CGameSetup::GetModOptions());
+	AppendKeyData(keyData, CGameSetup::GetMapOptions());
+
+	// constants visible to defs.lua, some of which depend on the setup (e.g. Game.maxUnits)
+	for (const char* tblName: {"Game", "Engine"}) {
+		if (!defsParser->SerializeGlobal(tblName, tblData))
+			return false;
+
+		keyData.insert(keyData.end(), tblData.begin(), tblData.end());
+	}
+
+	sha512::raw_digest keyDigest;
+	sha512::hex_digest keyHexDigest;
+	sha512::calc_digest(keyData.data(), keyData.size(), keyDigest.data());
+	sha512::dump_digest(keyDigest, keyHexDigest);
+
+	cacheKey = keyHexDigest.data();
+
+	const std::string cacheFileName = GetCacheFileName();
+
+	if (!FileSystem::FileExists(cacheFileName))
+		return false;
+
+	CFileHandler fh(cacheFileName, SPRING_VFS_RAW);
+
+	std::vector<std::uint8_t> fileData(std::max(fh.FileSize(), 0));
+	std::vector<std::uint8_t> rawData;
+	std::uint32_t fileChecksum = 0;
+
+	if (fh.Read(fileData.data(), fileData.size()) != static_cast<int>(fileData.size()) || !DefsSnapshotFile::Unpack(fileData, keyDigest, rawData, fileChecksum)) {
+		LOG_L(L_WARNING, "[DefsSnapshot::%s] removing invalid cache-file \"%s\"", __func__, cacheFileName.c_str());
+		RemoveCacheFile();
+		return false;
+	}
+
+	if (!defsParser->ExecuteSnapshot(rawData)) {
+		RemoveCacheFile();
+		return false;
+	}
+
+	LOG("[DefsSnapshot::%s] loaded gamedata definitions from \"%s\" (checksum %08x)", __func__, cacheFileName.c_str(), fileChecksum);
+
+	checksum = fileChecksum;
+	cached = true;
+	return true;
+}
+
+void CDefsSnapshot::Save(LuaParser* defsParser, bool cacheable)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	if (cached)
+		return;
+
+	std::vector<std::uint8_t> rawData;
+
+	if (!defsParser->SerializeRoot(rawData)) {
+		LOG("[DefsSnapshot::%s] gamedata definitions contain non-data values, not cached", __func__);
+		return;
+	}
+
+	// the def handlers must see the same tables (incl. their iteration
+	// order) regardless of whether they were loaded from the cache, so
+	// rebuild them in canonical form
+	if (!defsParser->ExecuteSnapshot(rawData))
+		return;
+
+	checksum = CRC::CalcDigest(rawData.data(), rawData.size());
+
+	if (cacheKey.empty())
+		return;
+
+	if (!cacheable || setupDependent) {
+		LOG("[DefsSnapshot::%s] gamedata definitions depend on the game setup or synced RNG, not cached", __func__);
+		return;
+	}
+
+	if (!FileSystem::CreateDirectory(GetSnapshotCacheDir()))
+		return;
+
+	sha512::raw_digest keyDigest;
+	sha512::read_digest(cacheKey, keyDigest);
+
+	const std::string cacheFileName = GetCacheFileName();
+	const std::vector<std::uint8_t> fileData = DefsSnapshotFile::Pack(keyDigest, rawData);
+
+	if (fileData.empty())
+		return;
+
+	std::ofstream ofs(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE), std::ios::binary);
+	ofs.write(reinterpret_cast<const char*>(fileData.data()), fileData.size());
+
+	if (!ofs.good()) {
+		ofs.close();
+		RemoveCacheFile();
+		return;
+	}
+
+	LOG("[DefsSnapshot::%s] cached gamedata definitions in \"%s\" (%u bytes, checksum %08x)", __func__, cacheFileName.c_str(), uint32_t(fileData.size()), checksum);
+}
+
+void CDefsSnapshot::RemoveCacheFile()
+{
+	if (cacheKey.empty())
+		return;
+
+	FileSystem::Remove(GetCacheFileName());
+}
+
+std::string CDefsSnapshot::GetCacheFileName() const
+{
+	return (GetSnapshotCacheDir() + cacheKey.substr(0, 32) + ".sds");
+}
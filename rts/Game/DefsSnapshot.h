@@ -0,0 +1,55 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEFS_SNAPSHOT_H
+#define DEFS_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+
+class LuaParser;
+
+/**
+ * @brief Cache of the tables returned by gamedata/defs.lua
+ *
+ * The executed defs are stored as a LuaParser snapshot in the cache dir,
+ * keyed by engine version, game and map checksums, mod- and map-options
+ * and the Game constants table. On a hit the snapshot replaces running
+ * defs.lua; on a miss the executed tables are rebuilt from the snapshot
+ * as well, so both paths hand identical tables to the def handlers.
+ *
+ * Defs that query the team/player/AI setup or draw from the synced RNG
+ * are never cached. The checksum of the snapshot is exchanged between
+ * clients (like the path checksum); a client whose cached defs do not match
+ * those of a client that ran defs.lua removes its cache and quits.
+ */
+class CDefsSnapshot {
+public:
+	/// must be called before defsParser is executed; true if it was loaded from the cache
+	bool Load(LuaParser* defsParser);
+	/// must be called after defsParser was executed
+	void Save(LuaParser* defsParser, bool cacheable);
+
+	void RemoveCacheFile();
+
+	/// called from the setup-dependent callouts of defs.lua
+	void MarkSetupDependent() { setupDependent = true; }
+
+	/// 0 if the defs could not be represented as a snapshot
+	std::uint32_t GetChecksum() const { return checksum; }
+	bool IsCached() const { return cached; }
+
+private:
+	std::string GetCacheFileName() const;
+
+private:
+	std::string cacheKey;
+
+	std::uint32_t checksum = 0;
+
+	bool setupDependent = false;
+	bool cached = false;
+};
+
+extern CDefsSnapshot defsSnapshot;
+
+#endif // DEFS_SNAPSHOT_H
@@ -0,0 +1,72 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "DefsSnapshotFile.h"
+
+#include <cstring>
+
+#include <zlib.h>
+
+#include "System/CRC.h"
+
+
+namespace {
+	constexpr char SNAPSHOT_MAGIC[8] = {'D', 'E', 'F', 'S', 'N', 'A', 'P', '\0'};
+
+	struct SnapshotFileHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t checksum; // CRC of the uncompressed snapshot
+		std::uint32_t rawSize;
+		sha512::raw_digest key;
+	};
+}
+
+
+std::vector<std::uint8_t> DefsSnapshotFile::Pack(const sha512::raw_digest& key, const std::vector<std::uint8_t>& rawData)
+{
+	SnapshotFileHeader header;
+	std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = VERSION;
+	header.checksum = CRC::CalcDigest(rawData.data(), rawData.size());
+	header.rawSize = rawData.size();
+	header.key = key;
+
+	std::vector<std::uint8_t> fileData(sizeof(header) + compressBound(rawData.size()));
+	uLongf deflSize = fileData.size() - sizeof(header);
+
+	if (compress(fileData.data() + sizeof(header), &deflSize, rawData.data(), rawData.size()) != Z_OK)
+		return {};
+
+	std::memcpy(fileData.data(), &header, sizeof(header));
+	fileData.resize(sizeof(header) + deflSize);
+	return fileData;
+}
+
+bool DefsSnapshotFile::Unpack(const std::vector<std::uint8_t>& fileData, const sha512::raw_digest& key, std::vector<std::uint8_t>& rawData, std::uint32_t& checksum)
+{
+	SnapshotFileHeader header;
+
+	if (fileData.size() <= sizeof(header))
+		return false;
+
+	std::memcpy(&header, fileData.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != VERSION || header.key != key)
+		return false;
+	// deflate does not compress better than ~1:1032, anything claiming more is corrupt
+	if (header.rawSize > (fileData.size() - sizeof(header)) * 1032)
+		return false;
+
+	rawData.clear();
+	rawData.resize(header.rawSize);
+
+	uLongf inflSize = rawData.size();
+
+	if (uncompress(rawData.data(), &inflSize, fileData.data() + sizeof(header), fileData.size() - sizeof(header)) != Z_OK)
+		return false;
+	if (inflSize != header.rawSize || CRC::CalcDigest(rawData.data(), rawData.size()) != header.checksum)
+		return false;
+
+	checksum = header.checksum;
+	return true;
+}
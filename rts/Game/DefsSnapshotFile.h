@@ -0,0 +1,26 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEFS_SNAPSHOT_FILE_H
+#define DEFS_SNAPSHOT_FILE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "System/Sync/SHA512.hpp"
+
+/**
+ * @brief Format of the CDefsSnapshot cache-files
+ *
+ * A fixed header (magic, format version, CRC and size of the snapshot and
+ * the full cache key) followed by the deflated LuaParser snapshot.
+ */
+namespace DefsSnapshotFile {
+	constexpr std::uint32_t VERSION = 1;
+
+	std::vector<std::uint8_t> Pack(const sha512::raw_digest& key, const std::vector<std::uint8_t>& rawData);
+
+	/// false if <fileData> is not an intact snapshot stored under <key>
+	bool Unpack(const std::vector<std::uint8_t>& fileData, const sha512::raw_digest& key, std::vector<std::uint8_t>& rawData, std::uint32_t& checksum);
+}
+
+#endif // DEFS_SNAPSHOT_FILE_H
@@ -10,10 +10,12 @@
 #include "ChatMessage.h"
 #include "CommandMessage.h"
 #include "ConsoleHistory.h"
+#include "DefsSnapshot.h"
 #include "GameHelper.h"
 #include "GameSetup.h"
 #include "GlobalUnsynced.h"
 #include "LoadScreen.h"
+#include "PreGame.h"
 #include "SelectedUnitsHandler.h"
 #include "WaitCommandsAI.h"
 #include "WordCompletion.h"
@@ -132,6 +134,7 @@
 #include "System/Sound/ISound.h"
 #include "System/Sound/ISoundChannels.h"
 #include "System/Sync/DumpState.h"
+#include "System/Sync/SubsystemChecksums.h"
 #include "System/TimeProfiler.h"
 #include "System/LoadLock.h"
 
@@ -571,31 +574,41 @@ void CGame::LoadDefs(LuaParser* defsParser)
 		defsParser->SetupLua(true, true);
 		// customize the defs environment; LuaParser has no access to LuaSyncedRead
 		#define LSR_ADDFUNC(f) defsParser->AddFunc(#f, LuaSyncedRead::f)
+		// the team/player setup is not part of the defs snapshot key, so defs using it are not cached
+		#define LSR_ADDFUNC_SETUP(f) defsParser->AddFunc(#f, [](lua_State* L) { defsSnapshot.MarkSetupDependent(); return LuaSyncedRead::f(L); })
 		defsParser->GetTable("Spring");
 
 		LSR_ADDFUNC(GetModOptions);
 		LSR_ADDFUNC(GetModOption);
 		LSR_ADDFUNC(GetMapOptions);
 		LSR_ADDFUNC(GetMapOption);
-		LSR_ADDFUNC(GetTeamLuaAI);
-		LSR_ADDFUNC(GetTeamList);
-		LSR_ADDFUNC(GetGaiaTeamID);
-		LSR_ADDFUNC(GetPlayerList);
-		LSR_ADDFUNC(GetAllyTeamList);
-		LSR_ADDFUNC(GetTeamInfo);
-		LSR_ADDFUNC(GetAllyTeamInfo);
-		LSR_ADDFUNC(GetAIInfo);
-		LSR_ADDFUNC(GetTeamAllyTeamID);
-		LSR_ADDFUNC(AreTeamsAllied);
-		LSR_ADDFUNC(ArePlayersAllied);
+		LSR_ADDFUNC_SETUP(GetTeamLuaAI);
+		LSR_ADDFUNC_SETUP(GetTeamList);
+		LSR_ADDFUNC_SETUP(GetGaiaTeamID);
+		LSR_ADDFUNC_SETUP(GetPlayerList);
+		LSR_ADDFUNC_SETUP(GetAllyTeamList);
+		LSR_ADDFUNC_SETUP(GetTeamInfo);
+		LSR_ADDFUNC_SETUP(GetAllyTeamInfo);
+		LSR_ADDFUNC_SETUP(GetAIInfo);
+		LSR_ADDFUNC_SETUP(GetTeamAllyTeamID);
+		LSR_ADDFUNC_SETUP(AreTeamsAllied);
+		LSR_ADDFUNC_SETUP(ArePlayersAllied);
 		LSR_ADDFUNC(GetSideData);
 
 		defsParser->EndTable();
+		#undef LSR_ADDFUNC_SETUP
 		#undef LSR_ADDFUNC
 
-		// run the parser
-		if (!defsParser->Execute())
-			throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+		// run the parser, unless its result is cached
+		if (!defsSnapshot.Load(defsParser)) {
+			// math.random in defs draws from the synced RNG, which a cache hit would skip
+			const auto rngState = gsRNG.GetGenState();
+
+			if (!defsParser->Execute())
+				throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+
+			defsSnapshot.Save(defsParser, gsRNG.GetGenState() == rngState);
+		}
 
 		const LuaTable& root = defsParser->GetRoot();
 
@@ -679,6 +692,11 @@ void CGame::PostLoadSimulation(LuaParser* defsParser)
 		loadscreen->SetLoadMessage("Loading Feature Definitions");
 		featureDefHandler->Init(defsParser);
 	}
+	{
+		SCOPED_ONCE_TIMER("Game::PostLoadSim (Sounds)");
+		loadscreen->SetLoadMessage("Decoding Sounds");
+		CommonDefHandler::LoadSoundFiles();
+	}
 
 	CUnit::InitStatic();
 	CCommandAI::InitCommandDescriptionCache();
@@ -912,6 +930,10 @@ void CGame::LoadSkirmishAIs()
 void CGame::LoadFinalize()
 {
 	ZoneScoped;
+	{
+		loadscreen->SetLoadMessage("[" + std::string(__func__) + "] checking archives");
+		CPreGame::FinishArchiveChecksums();
+	}
 	{
 		loadscreen->SetLoadMessage("[" + std::string(__func__) + "] finalizing PFS");
 
@@ -1938,6 +1960,18 @@ void CGame::SimFrame() {
 	// useful for desync-debugging (enter instead of -1 start & end frame of the range you want to debug)
 	DumpState(-1, -1, 1, std::nullopt);
 
+#ifdef SYNCCHECK
+	// only hashed for the frame the server asked about after a desync
+	if (CSubsystemChecksums::IsRequested(gs->frameNum)) {
+		SCOPED_TIMER("Sim::SubsystemChecksums");
+		CSubsystemChecksums::Update(gs->frameNum);
+		CSubsystemChecksums::Request(-1);
+
+		const CSubsystemChecksums::Record* record = CSubsystemChecksums::GetRecord(gs->frameNum);
+		clientNet->Send(CBaseNetProtocol::Get().SendSyncSubsystems(gu->myPlayerNum, CSubsystemChecksums::Pack(*record)));
+	}
+#endif
+
 	ASSERT_SYNCED(gsRNG.GetGenState());
 	LEAVE_SYNCED_CODE();
 }
@@ -40,6 +40,7 @@
 #include "System/EventHandler.h"
 #include "System/SpringMath.h"
 #include "System/Sound/ISoundChannels.h"
+#include "System/Threading/ThreadPool.h"
 
 #include "System/Misc/TracyDefs.h"
 
@@ -1119,7 +1120,7 @@ float3 CGameHelper::ClosestBuildPos(
 		BuildInfo bi(unitDef, {wxpos, 0.0f, wzpos}, buildFacing);
 		bi.pos = Pos2BuildPos(bi, false);
 
-		if (!TestUnitBuildSquare(bi, feature, allyTeam, synced) && (feature == nullptr || feature->allyteam != allyTeam))
+		if (!TestUnitBuildSquare(bi, feature, allyTeam, synced, nullptr, nullptr, nullptr, nullptr, ThreadPool::GetThreadNum()) && (feature == nullptr || feature->allyteam != allyTeam))
 			continue;
 
 		const int xsqr  = static_cast<int>(wxpos / SQUARE_SIZE);
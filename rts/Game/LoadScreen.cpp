@@ -6,6 +6,7 @@
 #include "Rendering/GL/myGL.h"
 #include "LoadScreen.h"
 #include "Game.h"
+#include "DefsSnapshot.h"
 #include "GlobalUnsynced.h"
 #include "Game/Players/Player.h"
 #include "Game/Players/PlayerHandler.h"
@@ -184,6 +185,7 @@ static void FinishedLoading()
 	clientNet->Send(CBaseNetProtocol::Get().SendPlayerName(gu->myPlayerNum, p->name));
 	#ifdef SYNCCHECK
 	clientNet->Send(CBaseNetProtocol::Get().SendPathCheckSum(gu->myPlayerNum, pathManager->GetPathCheckSum()));
+	clientNet->Send(CBaseNetProtocol::Get().SendDefsCheckSum(gu->myPlayerNum, defsSnapshot.GetChecksum(), defsSnapshot.IsCached()));
 	#endif
 	mouse->ShowMouse();
 
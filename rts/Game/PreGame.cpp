@@ -62,10 +62,20 @@
 
 CONFIG(bool, DemoFromDemo).defaultValue(false).description("Enable recording a demo while playing back a demo.");
 CONFIG(bool, LoadBadSaves).defaultValue(false);
+CONFIG(bool, PipelinedArchiveChecksums)
+	.defaultValue(false)
+	.description("Hash the map and game archives in the background while the game loads, instead of before. The comparison with the host's checksums then happens once loading is done.");
 
 static char mapChecksumMsgBuf[1024] = {0};
 static char modChecksumMsgBuf[1024] = {0};
 
+// what GameData said the checksums should be, kept for FinishArchiveChecksums
+static sha512::raw_digest gdMapChecksum;
+static sha512::raw_digest gdModChecksum;
+static std::string checkedMapName;
+static std::string checkedModName;
+static bool pendingChecksumCheck = false;
+
 CPreGame* pregame = nullptr;
 
 CPreGame::CPreGame(std::shared_ptr<ClientSetup> setup)
@@ -464,8 +474,11 @@ void CPreGame::UpdateClientNet()
 				clientNet->Send(CBaseNetProtocol::Get().SendClientData(playerNum, ClientData::GetCompressed()));
 
 				LOG("[PreGame::%s] received local player number %i (team %i, allyteam %i), creating LoadScreen", __func__, gu->myPlayerNum, gu->myTeam, gu->myAllyTeam);
-				CLIENT_NETLOG(gu->myPlayerNum, LOG_LEVEL_INFO, mapChecksumMsgBuf);
-				CLIENT_NETLOG(gu->myPlayerNum, LOG_LEVEL_INFO, modChecksumMsgBuf);
+
+				if (!pendingChecksumCheck) {
+					CLIENT_NETLOG(gu->myPlayerNum, LOG_LEVEL_INFO, mapChecksumMsgBuf);
+					CLIENT_NETLOG(gu->myPlayerNum, LOG_LEVEL_INFO, modChecksumMsgBuf);
+				}
 
 				CLoadScreen::CreateDeleteInstance(gameSetup->MapFileName(), std::move(modFileName), saveFileHandler);
 
@@ -613,47 +626,17 @@ void CPreGame::GameDataReceived(std::shared_ptr<const netcode::RawPacket> packet
 	AddMapArchivesToVFS(gameSetup);
 	AddModArchivesToVFS(gameSetup);
 
-	{
-		// check checksums of map & game
-		// mismatches happen on dedicated servers between host and clients
-		// we want to know whether the *locally calculated* checksums also
-		// differ among clients so use the opportunity
-		// NOTE: gu->myPlayerNum is not valid yet, GameData arrives first
-		sha512::raw_digest gdMapChecksum;
-		sha512::raw_digest asMapChecksum;
-		sha512::raw_digest gdModChecksum;
-		sha512::raw_digest asModChecksum;
-		sha512::hex_digest gdMapChecksumHex;
-		sha512::hex_digest asMapChecksumHex;
-		sha512::hex_digest gdModChecksumHex;
-		sha512::hex_digest asModChecksumHex;
-
-		std::copy(gameData->GetMapChecksum(), gameData->GetMapChecksum() + sha512::SHA_LEN, gdMapChecksum.begin());
-		std::copy(gameData->GetModChecksum(), gameData->GetModChecksum() + sha512::SHA_LEN, gdModChecksum.begin());
-		std::fill(asMapChecksum.begin(), asMapChecksum.end(), 0);
-		std::fill(asModChecksum.begin(), asModChecksum.end(), 0);
-
-		try {
-			// gameSetup->MapFileName()
-			archiveScanner->CheckArchive(gameSetup->mapName, gdMapChecksum, asMapChecksum);
-		} catch (const content_error& ex) {
-			LOG_L(L_WARNING, "[PreGame::%s] %s", __func__, ex.what());
-		}
-		try {
-			archiveScanner->CheckArchive(modFileName, gdModChecksum, asModChecksum);
-		} catch (const content_error& ex) {
-			LOG_L(L_WARNING, "[PreGame::%s] %s", __func__, ex.what());
-		}
+	std::copy(gameData->GetMapChecksum(), gameData->GetMapChecksum() + sha512::SHA_LEN, gdMapChecksum.begin());
+	std::copy(gameData->GetModChecksum(), gameData->GetModChecksum() + sha512::SHA_LEN, gdModChecksum.begin());
 
-		sha512::dump_digest(gdMapChecksum, gdMapChecksumHex);
-		sha512::dump_digest(gdModChecksum, gdModChecksumHex);
-		sha512::dump_digest(asMapChecksum, asMapChecksumHex);
-		sha512::dump_digest(asModChecksum, asModChecksumHex);
+	checkedMapName = gameSetup->mapName; // gameSetup->MapFileName()
+	checkedModName = modFileName;
 
-		std::memset(mapChecksumMsgBuf, 0, sizeof(mapChecksumMsgBuf));
-		std::memset(modChecksumMsgBuf, 0, sizeof(modChecksumMsgBuf));
-		std::snprintf(mapChecksumMsgBuf, sizeof(mapChecksumMsgBuf), "[PreGame::%s][map-checksums]\n\tserver=%s\n\tclient=%s", __func__, gdMapChecksumHex.data(), asMapChecksumHex.data());
-		std::snprintf(modChecksumMsgBuf, sizeof(modChecksumMsgBuf), "[PreGame::%s][mod-checksums]\n\tserver=%s\n\tclient=%s", __func__, gdModChecksumHex.data(), asModChecksumHex.data());
+	if ((pendingChecksumCheck = configHandler->GetBool("PipelinedArchiveChecksums"))) {
+		// hashed alongside loading, checked by CGame::LoadFinalize
+		archiveScanner->StartChecksums({checkedMapName, checkedModName});
+	} else {
+		CheckArchiveChecksums();
 	}
 
 	// script.txt allows to disable demo file recording (host only, used for menu)
@@ -676,6 +659,59 @@ void CPreGame::GameDataReceived(std::shared_ptr<const netcode::RawPacket> packet
 	LEAVE_SYNCED_CODE();
 }
 
+void CPreGame::CheckArchiveChecksums()
+{
+	// check checksums of map & game
+	// mismatches happen on dedicated servers between host and clients
+	// we want to know whether the *locally calculated* checksums also
+	// differ among clients so use the opportunity
+	sha512::raw_digest asMapChecksum;
+	sha512::raw_digest asModChecksum;
+	sha512::hex_digest gdMapChecksumHex;
+	sha512::hex_digest asMapChecksumHex;
+	sha512::hex_digest gdModChecksumHex;
+	sha512::hex_digest asModChecksumHex;
+
+	std::fill(asMapChecksum.begin(), asMapChecksum.end(), 0);
+	std::fill(asModChecksum.begin(), asModChecksum.end(), 0);
+
+	try {
+		archiveScanner->CheckArchive(checkedMapName, gdMapChecksum, asMapChecksum);
+	} catch (const content_error& ex) {
+		LOG_L(L_WARNING, "[PreGame::%s] %s", __func__, ex.what());
+	}
+	try {
+		archiveScanner->CheckArchive(checkedModName, gdModChecksum, asModChecksum);
+	} catch (const content_error& ex) {
+		LOG_L(L_WARNING, "[PreGame::%s] %s", __func__, ex.what());
+	}
+
+	sha512::dump_digest(gdMapChecksum, gdMapChecksumHex);
+	sha512::dump_digest(gdModChecksum, gdModChecksumHex);
+	sha512::dump_digest(asMapChecksum, asMapChecksumHex);
+	sha512::dump_digest(asModChecksum, asModChecksumHex);
+
+	std::memset(mapChecksumMsgBuf, 0, sizeof(mapChecksumMsgBuf));
+	std::memset(modChecksumMsgBuf, 0, sizeof(modChecksumMsgBuf));
+	std::snprintf(mapChecksumMsgBuf, sizeof(mapChecksumMsgBuf), "[PreGame::GameDataReceived][map-checksums]\n\tserver=%s\n\tclient=%s", gdMapChecksumHex.data(), asMapChecksumHex.data());
+	std::snprintf(modChecksumMsgBuf, sizeof(modChecksumMsgBuf), "[PreGame::GameDataReceived][mod-checksums]\n\tserver=%s\n\tclient=%s", gdModChecksumHex.data(), asModChecksumHex.data());
+}
+
+void CPreGame::FinishArchiveChecksums()
+{
+	if (!pendingChecksumCheck)
+		return;
+
+	pendingChecksumCheck = false;
+
+	// also rethrows errors from hashing, CheckArchive would do the same
+	CheckArchiveChecksums();
+
+	// gu->myPlayerNum is valid by now, unlike in GameDataReceived
+	CLIENT_NETLOG(gu->myPlayerNum, LOG_LEVEL_INFO, mapChecksumMsgBuf);
+	CLIENT_NETLOG(gu->myPlayerNum, LOG_LEVEL_INFO, modChecksumMsgBuf);
+}
+
 bool CPreGame::HasPendingAsyncTask()
 {
 	if (!pendingTask.valid())
@@ -53,6 +53,9 @@ public:
 
 	using AsyncExecFuncType = void (CPreGame::*)(const std::string&);
 	void AsyncExecute(AsyncExecFuncType execFunc, const std::string& argument);
+
+	/// compares the map and game checksums with the host's if that was deferred (PipelinedArchiveChecksums)
+	static void FinishArchiveChecksums();
 private:
 	void AddMapArchivesToVFS(const CGameSetup* setup);
 	void AddModArchivesToVFS(const CGameSetup* setup);
@@ -69,6 +72,8 @@ private:
 	void GameDataReceived(std::shared_ptr<const netcode::RawPacket> packet);
 
 	bool HasPendingAsyncTask();
+
+	static void CheckArchiveChecksums();
 private:
 	/**
 	@brief GameData we received from server
@@ -301,6 +301,12 @@ public:
 
 	bool Execute(const SyncedAction& action) const final {
 		InverseOrSetBool(gs->editDefsEnabled, action.GetArgs());
+
+		// materialized copies would hide edits from all handles,
+		// none are made again until editing is disabled
+		if (gs->editDefsEnabled)
+			CLuaHandle::DropMaterializedDefs();
+
 		LogSystemStatus("Unit-, Feature- & Weapon-Def editing", gs->editDefsEnabled);
 		return true;
 	}
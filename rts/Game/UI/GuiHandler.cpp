@@ -1181,7 +1181,7 @@ bool CGuiHandler::TryTarget(const SCommandDescription& cmdDesc) const
 			if (u->immobile) {
 				// immobile unit
 				// check range and weapon target properties
-				if (w->TryTarget(wtrg)) {
+				if (w->TryTarget(wtrg, false)) {
 					return true;
 				}
 			} else {
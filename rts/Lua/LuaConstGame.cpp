@@ -23,6 +23,8 @@
 #include "System/FileSystem/FileSystem.h"
 #include "System/StringUtil.h"
 
+#include <cstring>
+
 /******************************************************************************
  * Game constants
  * @see rts/Lua/LuaConstGame.cpp
@@ -115,6 +117,46 @@
  * @field textColorCodes TextColorCode Table containing keys that represent the color code operations during font rendering
  */
 
+static bool GetChecksumHexDigest(const std::string& archiveName, bool wait, sha512::hex_digest& hexDigest)
+{
+	sha512::raw_digest rawDigest;
+
+	if (wait) {
+		rawDigest = archiveScanner->GetArchiveCompleteChecksumBytes(archiveName);
+	} else if (!archiveScanner->TryGetArchiveCompleteChecksumBytes(archiveName, rawDigest)) {
+		return false;
+	}
+
+	sha512::dump_digest(rawDigest, hexDigest);
+	return true;
+}
+
+// Game.__index while the archives are still hashed by StartChecksums,
+// upvalues are the map and game names; fills in both on first access
+static int LazyArchiveChecksums(lua_State* L)
+{
+	if (lua_type(L, 2) != LUA_TSTRING)
+		return 0;
+
+	const char* key = lua_tostring(L, 2);
+
+	if (strcmp(key, "mapChecksum") != 0 && strcmp(key, "modChecksum") != 0)
+		return 0;
+
+	sha512::hex_digest mapHexDigest;
+	sha512::hex_digest modHexDigest;
+	GetChecksumHexDigest(lua_tostring(L, lua_upvalueindex(1)), true, mapHexDigest);
+	GetChecksumHexDigest(lua_tostring(L, lua_upvalueindex(2)), true, modHexDigest);
+
+	lua_pushvalue(L, 1);
+	LuaPushNamedString(L, "mapChecksum", mapHexDigest.data());
+	LuaPushNamedString(L, "modChecksum", modHexDigest.data());
+	lua_pop(L, 1);
+
+	lua_rawget(L, 1);
+	return 1;
+}
+
 bool LuaConstGame::PushEntries(lua_State* L)
 {
 	{
@@ -218,14 +260,23 @@ bool LuaConstGame::PushEntries(lua_State* L)
 	}
 
 	if (archiveScanner != nullptr && mapInfo != nullptr) {
-		// archive checksums
+		// archive checksums; with PipelinedArchiveChecksums they might not be
+		// known yet, do not block the loading thread (or LuaIntro) over them
 		sha512::hex_digest mapHexDigest;
 		sha512::hex_digest modHexDigest;
-		sha512::dump_digest(archiveScanner->GetArchiveCompleteChecksumBytes(mapInfo->map.name), mapHexDigest);
-		sha512::dump_digest(archiveScanner->GetArchiveCompleteChecksumBytes(modInfo.filename), modHexDigest);
 
-		LuaPushNamedString(L, "mapChecksum", mapHexDigest.data());
-		LuaPushNamedString(L, "modChecksum", modHexDigest.data());
+		if (GetChecksumHexDigest(mapInfo->map.name, false, mapHexDigest) && GetChecksumHexDigest(modInfo.filename, false, modHexDigest)) {
+			LuaPushNamedString(L, "mapChecksum", mapHexDigest.data());
+			LuaPushNamedString(L, "modChecksum", modHexDigest.data());
+		} else {
+			lua_createtable(L, 0, 1);
+			lua_pushliteral(L, "__index");
+			lua_pushsstring(L, mapInfo->map.name);
+			lua_pushsstring(L, modInfo.filename);
+			lua_pushcclosure(L, LazyArchiveChecksums, 2);
+			lua_rawset(L, -3);
+			lua_setmetatable(L, -2);
+		}
 	}
 
 	{
@@ -25,18 +25,19 @@ typedef int (*AccessFunc)(lua_State* L, const void* data);
 struct DataElement {
 	public:
 		DataElement()
-		: type(ERROR_TYPE), offset(0), func(NULL), deprecated(true) {}
+		: type(ERROR_TYPE), offset(0), func(NULL), deprecated(true), dynamic(false) {}
 		DataElement(DataType t)
-		: type(t), offset(0), func(NULL), deprecated(false) {}
+		: type(t), offset(0), func(NULL), deprecated(false), dynamic(false) {}
 		DataElement(DataType t, int o)
-		: type(t), offset(o), func(NULL), deprecated(false) {}
+		: type(t), offset(o), func(NULL), deprecated(false), dynamic(false) {}
 		DataElement(DataType t, int o, AccessFunc f, bool d=false)
-		: type(t), offset(o), func(f), deprecated(d) {}
+		: type(t), offset(o), func(f), deprecated(d), dynamic(false) {}
 	public:
 		DataType type;
 		int offset;
 		AccessFunc func;
 		bool deprecated;
+		bool dynamic; // changed by the engine at runtime, never materialized
 };
 
 
@@ -82,6 +83,10 @@ namespace {
 #define ADD_DEPRECATED_LUADEF_KEY(lua) \
 	paramMap[lua] = DataElement();
 
+// marks a key added above as changing at runtime
+#define SET_DYNAMIC(lua) \
+	paramMap[lua].dynamic = true
+
 
 
 
@@ -14,6 +14,7 @@
 #include "Sim/Features/FeatureDefHandler.h"
 #include "Sim/Misc/CollisionVolume.h"
 #include "Sim/Misc/GlobalSynced.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
 
 
@@ -43,6 +44,8 @@ bool LuaFeatureDefs::PushEntries(lua_State* L)
 {
 	InitParamMap();
 
+	const bool materialize = configHandler->GetBool("LuaMaterializeDefs");
+
 	typedef int (*IndxFuncType)(lua_State*);
 	typedef int (*IterFuncType)(lua_State*);
 
@@ -67,7 +70,7 @@ bool LuaFeatureDefs::PushEntries(lua_State* L)
 		if (def == nullptr)
 			continue;
 
-		PushObjectDefProxyTable(L, indxOpers, iterOpers, indxFuncs, iterFuncs, def);
+		PushObjectDefProxyTable(L, indxOpers, iterOpers, indxFuncs, iterFuncs, def, materialize);
 	}
 
 	return true;
@@ -118,6 +121,10 @@ bool LuaFeatureDefs::PushEntries(lua_State* L)
 
 static int FeatureDefIndex(lua_State* L)
 {
+	// /editdefs drops all caches (CLuaHandle::DropMaterializedDefs) and holds off new ones
+	if (!gs->editDefsEnabled && LuaUtils::MaterializeObjectDef(paramMap, L))
+		return 1;
+
 	// not a default value
 	if (!lua_isstring(L, 2)) {
 		lua_rawget(L, 1);
@@ -62,6 +62,7 @@
 
 CONFIG(float, LuaGarbageCollectionMemLoadMult).defaultValue(1.33f).minimumValue(1.0f).maximumValue(100.0f).description("How much the amount of Lua memory in use increases the rate of garbage collection.");
 CONFIG(float, LuaGarbageCollectionRunTimeMult).defaultValue(5.0f).minimumValue(1.0f).description("How many milliseconds the garbage collected can run for in each GC cycle");
+CONFIG(bool, LuaMaterializeDefs).defaultValue(false).description("Copy the plain fields of a UnitDefs, WeaponDefs or FeatureDefs entry into a raw table on first access, which makes later reads of them cheaper. Fields the engine changes at runtime, and all fields while /editdefs is enabled, are still read through the proxy.");
 
 
 static spring::unsynced_set<const luaContextData*>    SYNCED_LUAHANDLE_CONTEXTS;
@@ -2323,6 +2324,18 @@ void CLuaHandle::SetDevMode(bool value)
 	}
 }
 
+void CLuaHandle::DropMaterializedDefs()
+{
+	for (const auto* lcd : LUAHANDLE_CONTEXTS) {
+		for (const auto* lc : *lcd) {
+			if (!lc || !lc->owner || !lc->owner->GetLuaState())
+				continue;
+
+			LuaUtils::DematerializeObjectDefs(lc->owner->GetLuaState());
+		}
+	}
+}
+
 
 /* Toggles between empty table and filling it with lua module functions. 
  */
@@ -4003,6 +4016,10 @@ void CLuaHandle::CollectGarbage(bool forced)
 	// don't collect garbage outside of CollectGarbage
 	lua_gc(L_GC, LUA_GCSTOP, 0);
 	SetHandleRunning(L_GC, false);
+
+	// garbage of this frame is gone, arena can be recycled if nothing survived
+	GetLuaContextData(L_GC)->memPool->ReleaseFrameArena();
+
 	lua_unlock(L_GC);
 
 
@@ -382,6 +382,8 @@ class CLuaHandle : public CEventClient
 #endif
 		static void SetDevMode(bool value);
 		static bool GetDevMode() { return devMode; }
+		// makes every handle read defs through their proxies again (LuaMaterializeDefs)
+		static void DropMaterializedDefs();
 
 		static void HandleLuaMsg(int playerID, int script, int mode, const std::vector<std::uint8_t>& msg);
 
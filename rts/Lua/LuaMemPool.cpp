@@ -1,8 +1,10 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include <algorithm> // std::min
+#include <bit> // std::bit_width
 #include <cstdint> // std::uint8_t
 #include <cstring> // std::mem{cpy,set}
+#include <limits>
 #include <new>
 
 #include "LuaMemPool.h"
@@ -16,8 +18,10 @@
 
 // global, affects all pool instances
 bool LuaMemPool::enabled = false;
+bool LuaMemPool::trackSizeClasses = false;
 
 static LuaMemPool* gSharedPool = nullptr;
+static size_t gArenaSize = 0;
 
 static std::array<uint8_t, sizeof(LuaMemPool)> gSharedPoolMem;
 static std::vector<LuaMemPool*> gPools;
@@ -74,7 +78,12 @@ void LuaMemPool::ReleasePtr(LuaMemPool* p, const CLuaHandle* o)
 }
 
 void LuaMemPool::FreeShared() { gSharedPool->Clear(); }
-void LuaMemPool::InitStatic(bool enable) { gSharedPool = new (gSharedPoolMem.data()) LuaMemPool(LuaMemPool::enabled = enable); }
+void LuaMemPool::InitStatic(bool enable, size_t arenaSize, bool trackSizes)
+{
+	gArenaSize = arenaSize;
+	trackSizeClasses = trackSizes;
+	gSharedPool = new (gSharedPoolMem.data()) LuaMemPool(LuaMemPool::enabled = enable);
+}
 void LuaMemPool::KillStatic()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -98,17 +107,122 @@ LuaMemPool::LuaMemPool(size_t lmpIndex): globalIndex(lmpIndex)
 		return;
 
 	luaMemPoolImpl = std::make_unique<LuaMemPool::LuaMemPoolImpl>();
+
+	if (gArenaSize == 0)
+		return;
+
+	frameArena.mem = std::make_unique<uint8_t[]>(frameArena.size = gArenaSize);
+	frameArena.segmentSize = (gArenaSize / NUM_ARENA_SEGMENTS) & ~size_t(BUCKET_STEP - 1);
+}
+
+
+size_t LuaMemPool::GetSizeClassBytes(uint32_t i)
+{
+	// [0, 32) covers the pool buckets in 16-byte steps, then powers of two
+	if (i < NUM_BUCKETS)
+		return ((i + 1) * BUCKET_STEP);
+
+	if (i < (NUM_SIZE_CLASSES - 1))
+		return (size_t(1024) << (i - NUM_BUCKETS));
+
+	return std::numeric_limits<size_t>::max();
+}
+
+uint32_t LuaMemPool::GetSizeClass(size_t size)
+{
+	if (size <= (NUM_BUCKETS * BUCKET_STEP))
+		return ((std::max(size, size_t(1)) - 1) / BUCKET_STEP);
+
+	// (512, 1024] maps to NUM_BUCKETS, each further power of two to the next class
+	const uint32_t i = NUM_BUCKETS + static_cast<uint32_t>(std::bit_width(size - 1)) - 10;
+
+	return std::min(i, NUM_SIZE_CLASSES - 1);
 }
 
+
 void LuaMemPool::Clear()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	//allocStats = {};
+
+	// no allocations from the previous owner can still be alive
+	frameArena.segments = {};
+	frameArena.curSegment = 0;
+	frameArena.active = true;
+}
+
+void* LuaMemPool::AllocArena(size_t size)
+{
+	const size_t alignedSize = (size + (BUCKET_STEP - 1)) & ~size_t(BUCKET_STEP - 1);
+
+	auto& segment = frameArena.segments[frameArena.curSegment];
+
+	if (!frameArena.active || size > MAX_ARENA_ALLOC || (segment.offset + alignedSize) > frameArena.segmentSize)
+		return nullptr;
+
+	void* ptr = frameArena.mem.get() + frameArena.curSegment * frameArena.segmentSize + segment.offset;
+
+	segment.offset += alignedSize;
+	segment.numLive += 1;
+
+	allocStats[STAT_NAA] += 1;
+	allocStats[STAT_NBA] += size;
+	return ptr;
+}
+
+void LuaMemPool::ReleaseFrameArena()
+{
+	if (frameArena.mem == nullptr)
+		return;
+
+	// prefer the current segment, then the next one nothing survived in
+	for (uint32_t i = 0; i < NUM_ARENA_SEGMENTS; i++) {
+		const uint32_t segmentIdx = (frameArena.curSegment + i) % NUM_ARENA_SEGMENTS;
+		auto& segment = frameArena.segments[segmentIdx];
+
+		if (segment.numLive != 0)
+			continue;
+
+		frameArena.numResets += (segment.offset != 0);
+		frameArena.curSegment = segmentIdx;
+		frameArena.active = true;
+
+		segment.offset = 0;
+		return;
+	}
+
+	frameArena.active = false;
+}
+
+size_t LuaMemPool::GetArenaUsedBytes() const
+{
+	size_t numBytes = 0;
+
+	for (const auto& segment: frameArena.segments) {
+		numBytes += segment.offset;
+	}
+
+	return numBytes;
+}
+
+size_t LuaMemPool::GetArenaLiveAllocs() const
+{
+	size_t numLive = 0;
+
+	for (const auto& segment: frameArena.segments) {
+		numLive += segment.numLive;
+	}
+
+	return numLive;
 }
 
+
 void* LuaMemPool::Alloc(size_t size)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	if (trackSizeClasses)
+		sizeClassCounts[GetSizeClass(size)] += 1;
+
 	if (!LuaMemPool::enabled) {
 		allocStats[STAT_NAE] += 1 * (size > 0);
 		allocStats[STAT_NBE] += size;
@@ -118,9 +232,16 @@ void* LuaMemPool::Alloc(size_t size)
 		return ptr;
 	}
 
+	if (frameArena.mem != nullptr) {
+		void* ptr = AllocArena(size);
+
+		if (ptr != nullptr)
+			return ptr;
+	}
+
 	auto t0 = spring_now();
 	auto* ptr = luaMemPoolImpl->allocMem(size);
-	
+
 	if (size > NUM_BUCKETS * BUCKET_STEP) {
 		allocStats[STAT_NAE] += 1 * (size > 0);
 		allocStats[STAT_NBE] += size;
@@ -162,6 +283,21 @@ void* LuaMemPool::Realloc(void* ptr, size_t nsize, size_t osize)
 		return newPtr;
 	}
 
+	if (IsArenaPtr(ptr)) {
+		// arena memory can not grow in-place, move it out (or into a new slot)
+		void* newPtr = Alloc(nsize);
+
+		if (newPtr == nullptr)
+			return nullptr;
+
+		std::memcpy(newPtr, ptr, std::min(nsize, osize));
+		Free(ptr, osize);
+		return newPtr;
+	}
+
+	if (trackSizeClasses)
+		sizeClassCounts[GetSizeClass(nsize)] += 1;
+
 	auto t0 = spring_now();
 	auto* ret = luaMemPoolImpl->reAllocMem(ptr, nsize);
 	if (nsize > NUM_BUCKETS * BUCKET_STEP) {
@@ -190,6 +326,14 @@ void LuaMemPool::Free(void* ptr, size_t size)
 		return;
 	}
 
+	if (IsArenaPtr(ptr)) {
+		auto& segment = frameArena.segments[(static_cast<uint8_t*>(ptr) - frameArena.mem.get()) / frameArena.segmentSize];
+
+		assert(segment.numLive > 0);
+		segment.numLive -= 1;
+		return;
+	}
+
 	luaMemPoolImpl->freeMem(ptr);
 }
 
@@ -222,5 +366,37 @@ void LuaMemPool::LogStats(const char* handle, const char* lctype)
 		allocStats[STAT_NTE]
 	);
 	LOG("%s", msg.c_str());
+
+	if (frameArena.mem != nullptr) {
+		LOG("[LuaMemPool::%s][handle=%s (%s)] frameArena{allocs, bytes, resets, size}={%u, %u, %u, %u}",
+			__func__, handle, lctype,
+			static_cast<uint32_t>(allocStats[STAT_NAA]),
+			static_cast<uint32_t>(allocStats[STAT_NBA]),
+			static_cast<uint32_t>(frameArena.numResets),
+			static_cast<uint32_t>(frameArena.size)
+		);
+	}
+
+	// size-class histogram, only non-empty classes
+	if (trackSizeClasses) {
+		msg = fmt::sprintf("[LuaMemPool::%s][handle=%s (%s)] sizeClasses{maxBytes:numAllocs}={", __func__, handle, lctype);
+
+		for (uint32_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+			if (sizeClassCounts[i] == 0)
+				continue;
+
+			if (i < (NUM_SIZE_CLASSES - 1)) {
+				msg += fmt::sprintf(" %u:%u", GetSizeClassBytes(i), sizeClassCounts[i]);
+			} else {
+				msg += fmt::sprintf(" inf:%u", sizeClassCounts[i]);
+			}
+		}
+
+		msg += " }";
+		LOG("%s", msg.c_str());
+	}
+
 	allocStats = {};
+	sizeClassCounts = {};
+	frameArena.numResets = 0;
 }
@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -40,9 +42,14 @@ public:
 	static void ReleasePtr(LuaMemPool* p, const CLuaHandle* o);
 
 	static void FreeShared();
-	static void InitStatic(bool enable);
+	static void InitStatic(bool enable, size_t arenaSize = 0, bool trackSizes = false);
 	static void KillStatic();
 
+	static constexpr uint32_t NUM_SIZE_CLASSES = 40;
+
+	/// upper bound (in bytes) of the allocation sizes counted in class <i>
+	static size_t GetSizeClassBytes(uint32_t i);
+
 public:
 	void Clear();
 	void* Alloc(size_t size);
@@ -51,18 +58,70 @@ public:
 
 	void LogStats(const char* handle, const char* lctype);
 
+	/**
+	 * Moves the frame-arena on to its next segment without any live
+	 * allocations and recycles that; should be called by the owning
+	 * handle at the end of each (garbage-collection) frame. Allocations
+	 * that survive a frame only pin their own segment, if all segments
+	 * are pinned requests fall through to the buckets until one drains.
+	 */
+	void ReleaseFrameArena();
+
+	uint64_t GetNumAllocs() const { return (allocStats[STAT_NAI] + allocStats[STAT_NAF] + allocStats[STAT_NAE] + allocStats[STAT_NAA]); }
+	uint64_t GetNumAllocedBytes() const { return (allocStats[STAT_NBI] + allocStats[STAT_NBF] + allocStats[STAT_NBE] + allocStats[STAT_NBA]); }
+	uint64_t GetNumArenaAllocs() const { return allocStats[STAT_NAA]; }
+	uint64_t GetNumArenaResets() const { return frameArena.numResets; }
+	size_t GetArenaUsedBytes() const;
+	size_t GetArenaLiveAllocs() const;
+
+	const std::array<uint64_t, NUM_SIZE_CLASSES>& GetSizeClassCounts() const { return sizeClassCounts; }
+
 	size_t  GetGlobalIndex() const { return globalIndex; }
 	size_t  GetSharedCount() const { return sharedCount; }
 	size_t& GetSharedCount()       { return sharedCount; }
 
 public:
 	static bool enabled;
+	// count requests per size-class (LogStats, Spring.GetLuaMemUsage)
+	static bool trackSizeClasses;
 private:
 	static constexpr uint32_t NUM_BUCKETS = 32;
 	static constexpr uint32_t BUCKET_STEP = 16;
+	// largest request that is served from the frame-arena
+	static constexpr uint32_t MAX_ARENA_ALLOC = 256;
+	static constexpr uint32_t NUM_ARENA_SEGMENTS = 4;
 	using LuaMemPoolImpl = PassThroughPool<NUM_BUCKETS, 4 * (1024 * 1024)>;
 	std::unique_ptr<LuaMemPoolImpl> luaMemPoolImpl;
 
+	static uint32_t GetSizeClass(size_t size);
+
+	void* AllocArena(size_t size);
+	bool IsArenaPtr(const void* ptr) const {
+		return (frameArena.mem != nullptr && ptr >= frameArena.mem.get() && ptr < (frameArena.mem.get() + frameArena.size));
+	}
+
+	// bump-allocator for small short-lived objects (most Lua garbage)
+	struct FrameArena {
+		struct Segment {
+			size_t offset = 0;
+			size_t numLive = 0;
+		};
+
+		std::unique_ptr<uint8_t[]> mem;
+		std::array<Segment, NUM_ARENA_SEGMENTS> segments;
+
+		size_t size = 0;
+		size_t segmentSize = 0;
+
+		uint32_t curSegment = 0;
+		// false while every segment is pinned by survivors
+		bool active = true;
+
+		uint64_t numResets = 0;
+	};
+
+	FrameArena frameArena;
+
 	enum {
 		STAT_NAI = 0, // number of internal allocs
 		STAT_NAF = 1, // number of int fail allocs
@@ -73,9 +132,12 @@ private:
 		STAT_NTI = 6, // cumulative time spent on internal allocs
 		STAT_NTF = 7, // cumulative time spent on int fail allocs
 		STAT_NTE = 8, // cumulative time spent on external allocs
+		STAT_NAA = 9, // number of frame-arena allocs
+		STAT_NBA = 10, // number of bytes alloced (frame-arena)
 	};
 
-	std::array<uint64_t, 9> allocStats = { 0, 0, 0, 0, 0 };
+	std::array<uint64_t, 11> allocStats = {};
+	std::array<uint64_t, NUM_SIZE_CLASSES> sizeClassCounts = {};
 
 	size_t globalIndex = 0;
 	size_t sharedCount = 0;
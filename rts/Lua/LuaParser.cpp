@@ -4,7 +4,9 @@
 #include "LuaParser.h"
 
 #include <algorithm>
+#include <cassert>
 #include <climits>
+#include <cstring>
 
 #include "lib/streflop/streflop_cond.h"
 
@@ -292,6 +294,292 @@ bool LuaParser::Execute()
 }
 
 
+/******************************************************************************/
+//
+//  Snapshots
+//
+
+namespace {
+	enum SnapshotTag: std::uint8_t {
+		SNAPSHOT_NUMBER  = 1,
+		SNAPSHOT_STRING  = 2,
+		SNAPSHOT_BOOLEAN = 3,
+		SNAPSHOT_TABLE   = 4,
+	};
+
+	// deeper nesting is treated as a cycle
+	constexpr int MAX_SNAPSHOT_DEPTH = 64;
+
+	struct SnapshotKey {
+		int type;
+		lua_Number number;
+		const char* str;
+		size_t len;
+
+		bool operator < (const SnapshotKey& k) const {
+			if (type != k.type)
+				return (type < k.type);
+
+			switch (type) {
+				case LUA_TNUMBER : return (number < k.number);
+				case LUA_TBOOLEAN: return (number < k.number);
+				default: break;
+			}
+
+			const int cmp = memcmp(str, k.str, std::min(len, k.len));
+			return ((cmp < 0) || (cmp == 0 && len < k.len));
+		}
+	};
+
+
+	template<typename T> void WriteSnapshotData(std::vector<std::uint8_t>& buffer, const T& data) {
+		const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(&data);
+		buffer.insert(buffer.end(), p, p + sizeof(T));
+	}
+
+	bool SerializeValue(lua_State* L, int index, std::vector<std::uint8_t>& buffer, int depth)
+	{
+		switch (lua_type(L, index)) {
+			case LUA_TNUMBER: {
+				WriteSnapshotData(buffer, SNAPSHOT_NUMBER);
+				WriteSnapshotData(buffer, lua_tonumber(L, index));
+				return true;
+			} break;
+			case LUA_TSTRING: {
+				size_t len = 0;
+				const char* str = lua_tolstring(L, index, &len);
+
+				WriteSnapshotData(buffer, SNAPSHOT_STRING);
+				WriteSnapshotData(buffer, static_cast<std::uint32_t>(len));
+				buffer.insert(buffer.end(), str, str + len);
+				return true;
+			} break;
+			case LUA_TBOOLEAN: {
+				WriteSnapshotData(buffer, SNAPSHOT_BOOLEAN);
+				WriteSnapshotData(buffer, static_cast<std::uint8_t>(lua_toboolean(L, index)));
+				return true;
+			} break;
+			case LUA_TTABLE: {
+			} break;
+			default: {
+				return false;
+			} break;
+		}
+
+		if (depth >= MAX_SNAPSHOT_DEPTH || !lua_checkstack(L, 4))
+			return false;
+
+		// metatables can not be represented
+		if (lua_getmetatable(L, index)) {
+			lua_pop(L, 1);
+			return false;
+		}
+
+		const int table = (index < 0)? (lua_gettop(L) + index + 1): index;
+
+		std::vector<SnapshotKey> keys;
+		std::uint32_t numArrayKeys = 0;
+
+		for (lua_pushnil(L); lua_next(L, table) != 0; lua_pop(L, 1)) {
+			SnapshotKey key = {lua_type(L, -2), 0.0f, nullptr, 0};
+
+			switch (key.type) {
+				case LUA_TNUMBER : { key.number = lua_tonumber(L, -2); numArrayKeys += 1; } break;
+				case LUA_TBOOLEAN: { key.number = lua_toboolean(L, -2); } break;
+				// the string is kept alive by the table
+				case LUA_TSTRING : { key.str = lua_tolstring(L, -2, &key.len); } break;
+				default: {
+					lua_pop(L, 2);
+					return false;
+				} break;
+			}
+
+			keys.push_back(key);
+		}
+
+		std::sort(keys.begin(), keys.end());
+
+		WriteSnapshotData(buffer, SNAPSHOT_TABLE);
+		WriteSnapshotData(buffer, numArrayKeys);
+		WriteSnapshotData(buffer, static_cast<std::uint32_t>(keys.size()));
+
+		for (const SnapshotKey& key: keys) {
+			switch (key.type) {
+				case LUA_TNUMBER : { lua_pushnumber(L, key.number); } break;
+				case LUA_TBOOLEAN: { lua_pushboolean(L, key.number != 0.0f); } break;
+				case LUA_TSTRING : { lua_pushlstring(L, key.str, key.len); } break;
+				default: assert(false);
+			}
+
+			SerializeValue(L, -1, buffer, depth + 1);
+			lua_rawget(L, table);
+
+			if (!SerializeValue(L, -1, buffer, depth + 1)) {
+				lua_pop(L, 1);
+				return false;
+			}
+
+			lua_pop(L, 1);
+		}
+
+		return true;
+	}
+
+
+	class SnapshotReader {
+	public:
+		SnapshotReader(const std::vector<std::uint8_t>& buffer): pos(buffer.data()), end(buffer.data() + buffer.size()) {}
+
+		template<typename T> bool Read(T& data) {
+			if ((pos + sizeof(T)) > end)
+				return false;
+
+			memcpy(&data, pos, sizeof(T));
+			pos += sizeof(T);
+			return true;
+		}
+
+		const char* ReadString(size_t len) {
+			if ((pos + len) > end)
+				return nullptr;
+
+			const char* str = reinterpret_cast<const char*>(pos);
+			pos += len;
+			return str;
+		}
+
+		bool AtEnd() const { return (pos == end); }
+
+	private:
+		const std::uint8_t* pos;
+		const std::uint8_t* end;
+	};
+
+	bool PushSnapshotValue(lua_State* L, SnapshotReader& reader, int depth, bool isKey)
+	{
+		std::uint8_t tag = 0;
+
+		if (!reader.Read(tag))
+			return false;
+
+		switch (tag) {
+			case SNAPSHOT_NUMBER: {
+				lua_Number number = 0.0f;
+
+				if (!reader.Read(number))
+					return false;
+
+				lua_pushnumber(L, number);
+				return true;
+			} break;
+			case SNAPSHOT_STRING: {
+				std::uint32_t len = 0;
+				const char* str = nullptr;
+
+				if (!reader.Read(len) || (str = reader.ReadString(len)) == nullptr)
+					return false;
+
+				lua_pushlstring(L, str, len);
+				return true;
+			} break;
+			case SNAPSHOT_BOOLEAN: {
+				std::uint8_t value = 0;
+
+				if (!reader.Read(value))
+					return false;
+
+				lua_pushboolean(L, value);
+				return true;
+			} break;
+			case SNAPSHOT_TABLE: {
+			} break;
+			default: {
+				return false;
+			} break;
+		}
+
+		if (isKey || depth >= MAX_SNAPSHOT_DEPTH || !lua_checkstack(L, 4))
+			return false;
+
+		std::uint32_t numArrayKeys = 0;
+		std::uint32_t numKeys = 0;
+
+		if (!reader.Read(numArrayKeys) || !reader.Read(numKeys) || numArrayKeys > numKeys)
+			return false;
+
+		lua_createtable(L, numArrayKeys, numKeys - numArrayKeys);
+
+		for (std::uint32_t i = 0; i < numKeys; i++) {
+			if (!PushSnapshotValue(L, reader, depth + 1, true))
+				return false;
+			if (!PushSnapshotValue(L, reader, depth + 1, false))
+				return false;
+
+			lua_rawset(L, -3);
+		}
+
+		return true;
+	}
+}
+
+
+bool LuaParser::SerializeRoot(std::vector<std::uint8_t>& buffer)
+{
+	if (!IsValid() || rootRef == LUA_NOREF)
+		return false;
+
+	buffer.clear();
+	lua_rawgeti(L, LUA_REGISTRYINDEX, rootRef);
+
+	const bool ret = lua_istable(L, -1) && SerializeValue(L, -1, buffer, 0);
+
+	lua_settop(L, 0);
+	return ret;
+}
+
+bool LuaParser::SerializeGlobal(const std::string& name, std::vector<std::uint8_t>& buffer)
+{
+	if (!IsValid())
+		return false;
+
+	const int top = lua_gettop(L);
+
+	buffer.clear();
+	lua_getglobal(L, name.c_str());
+
+	const bool ret = SerializeValue(L, -1, buffer, 0);
+
+	lua_settop(L, top);
+	return ret;
+}
+
+bool LuaParser::ExecuteSnapshot(const std::vector<std::uint8_t>& buffer)
+{
+	if (!IsValid())
+		return false;
+
+	assert(rootRef != LUA_NOREF || initDepth == 0);
+
+	SnapshotReader reader(buffer);
+
+	const int top = lua_gettop(L);
+
+	if (!PushSnapshotValue(L, reader, 0, false) || !reader.AtEnd() || !lua_istable(L, -1)) {
+		lua_settop(L, top);
+		return false;
+	}
+
+	if (rootRef != LUA_NOREF)
+		luaL_unref(L, LUA_REGISTRYINDEX, rootRef);
+
+	initDepth = -1;
+	rootRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	lua_settop(L, 0);
+
+	return (valid = true);
+}
+
+
 void LuaParser::AddTable(LuaTable* tbl) { spring::VectorInsertUnique(tables, tbl); }
 void LuaParser::RemoveTable(LuaTable* tbl) { spring::VectorErase(tables, tbl); }
 
@@ -748,6 +1036,296 @@ int LuaParser::DontMessWithMyCase(lua_State* L)
 //  LuaTable
 //
 
+// lua_State-free copies of LuaParser tables, see LuaTable::Detach; every value
+// keeps the results of the Lua API conversions LuaTable's accessors rely on so
+// that reading a detached table gives exactly the same results
+struct LuaDetachedValue {
+	std::string str; // lua_tostring (numbers and strings)
+
+	lua_Number num = 0.0f; // lua_tonumber
+	int toInt = 0; // lua_toint
+	int length = 0; // lua_objlen
+	int luaType = LUA_TNIL;
+
+	bool isNumber = false; // lua_isnumber (includes numeric strings)
+	bool isString = false; // lua_isstring (includes numbers)
+	bool boolean = false; // lua_toboolean
+
+	const LuaDetachedNode* table = nullptr;
+};
+
+struct LuaDetachedNode {
+	struct NumEntry {
+		lua_Number key;
+		int intKey; // lua_toint
+		LuaDetachedValue value;
+	};
+
+	const LuaDetachedValue* Find(lua_Number key) const {
+		// array-like tables are traversed in index order by lua_next
+		if (key >= 1.0f && key <= numEntries.size()) {
+			const size_t idx = static_cast<size_t>(key) - 1;
+
+			if (numEntries[idx].key == key)
+				return &numEntries[idx].value;
+		}
+
+		const auto it = numIndices.find(key);
+
+		if (it == numIndices.end())
+			return nullptr;
+
+		return &numEntries[it->second].value;
+	}
+	const LuaDetachedValue* Find(const std::string& key) const {
+		const auto it = strIndices.find(key);
+
+		if (it == strIndices.end())
+			return nullptr;
+
+		return &strEntries[it->second].second;
+	}
+
+	// raw number and string keys, in lua_next order
+	std::vector<NumEntry> numEntries;
+	std::vector<std::pair<std::string, LuaDetachedValue>> strEntries;
+
+	// number keys not stored at their array index (the hash part)
+	spring::unsynced_map<lua_Number, size_t> numIndices;
+	spring::unordered_map<std::string, size_t> strIndices;
+
+	int length = 0;
+};
+
+struct LuaDetachedTree {
+	std::vector<std::unique_ptr<LuaDetachedNode>> nodes;
+
+	bool lowerCppKeys = false;
+};
+
+
+namespace {
+	constexpr int MAX_DETACH_DEPTH = 256;
+
+	using DetachedNodeMap = spring::unordered_map<const void*, const LuaDetachedNode*>;
+
+	const LuaDetachedNode* DetachTable(lua_State* L, int index, LuaDetachedTree& tree, DetachedNodeMap& visited, int depth);
+
+	bool DetachValue(lua_State* L, int index, LuaDetachedTree& tree, DetachedNodeMap& visited, int depth, LuaDetachedValue& value)
+	{
+		value.luaType  = lua_type(L, index);
+		value.isNumber = lua_isnumber(L, index);
+		value.isString = lua_isstring(L, index);
+		value.boolean  = lua_toboolean(L, index);
+		value.num      = lua_tonumber(L, index);
+		value.toInt    = lua_toint(L, index);
+
+		if (value.isString) {
+			// convert a copy, lua_tostring changes numbers in-place
+			lua_pushvalue(L, index);
+			value.str = lua_tostring(L, -1);
+			value.length = lua_objlen(L, -1);
+			lua_pop(L, 1);
+			return true;
+		}
+
+		if (value.luaType != LUA_TTABLE)
+			return true;
+
+		if ((value.table = DetachTable(L, index, tree, visited, depth + 1)) == nullptr)
+			return false;
+
+		value.length = value.table->length;
+		return true;
+	}
+
+	const LuaDetachedNode* DetachTable(lua_State* L, int index, LuaDetachedTree& tree, DetachedNodeMap& visited, int depth)
+	{
+		if (depth > MAX_DETACH_DEPTH || !lua_checkstack(L, 4))
+			return nullptr;
+
+		// metamethods would make lookups differ from lua_next traversal
+		if (lua_getmetatable(L, index)) {
+			lua_pop(L, 1);
+			return nullptr;
+		}
+
+		// tables shared between defs (or cyclic references) are detached once
+		const void* ptr = lua_topointer(L, index);
+		const auto it = visited.find(ptr);
+
+		if (it != visited.end())
+			return it->second;
+
+		LuaDetachedNode* node = tree.nodes.emplace_back(std::make_unique<LuaDetachedNode>()).get();
+
+		visited.emplace(ptr, node);
+		node->length = lua_objlen(L, index);
+
+		for (lua_pushnil(L); lua_next(L, index) != 0; lua_pop(L, 1)) {
+			LuaDetachedValue value;
+
+			if (!DetachValue(L, lua_gettop(L), tree, visited, depth, value)) {
+				lua_pop(L, 2);
+				return nullptr;
+			}
+
+			switch (lua_type(L, -2)) {
+				case LUA_TNUMBER: {
+					const lua_Number key = lua_tonumber(L, -2);
+
+					if (key != (node->numEntries.size() + 1))
+						node->numIndices.emplace(key, node->numEntries.size());
+
+					node->numEntries.push_back({key, lua_toint(L, -2), std::move(value)});
+				} break;
+				case LUA_TSTRING: {
+					size_t len = 0;
+					const char* key = lua_tolstring(L, -2, &len);
+
+					node->strIndices.emplace(std::string(key, len), node->strEntries.size());
+					node->strEntries.emplace_back(std::string(key, len), std::move(value));
+				} break;
+				default: {
+				} break;
+			}
+		}
+
+		return node;
+	}
+
+
+	bool ParseDetachedFloat(const LuaDetachedNode* table, int index, float& value)
+	{
+		const LuaDetachedValue* v = table->Find(index);
+
+		if (v == nullptr) {
+			value = 0.0f;
+			return false;
+		}
+
+		value = v->num;
+		return (value != 0.0f || v->isNumber || v->isString);
+	}
+
+	bool ParseDetachedFloat3(const LuaDetachedValue* v, float3& value)
+	{
+		if (v->table != nullptr) {
+			return
+				ParseDetachedFloat(v->table, 1, value.x) &&
+				ParseDetachedFloat(v->table, 2, value.y) &&
+				ParseDetachedFloat(v->table, 3, value.z);
+		}
+		if (v->isString)
+			return (sscanf(v->str.c_str(), "%f %f %f", &value.x, &value.y, &value.z) == 3);
+
+		return false;
+	}
+
+	bool ParseDetachedFloat4(const LuaDetachedValue* v, float4& value)
+	{
+		if (v->table != nullptr) {
+			return
+				ParseDetachedFloat(v->table, 1, value.x) &&
+				ParseDetachedFloat(v->table, 2, value.y) &&
+				ParseDetachedFloat(v->table, 3, value.z) &&
+				ParseDetachedFloat(v->table, 4, value.w);
+		}
+		if (v->isString)
+			return (sscanf(v->str.c_str(), "%f %f %f %f", &value.x, &value.y, &value.z, &value.w) == 4);
+
+		return false;
+	}
+
+	bool ParseDetachedBoolean(const LuaDetachedValue* v, bool& value)
+	{
+		if (v->luaType == LUA_TBOOLEAN) {
+			value = v->boolean;
+			return true;
+		}
+		if (v->isNumber) {
+			value = (v->num != 0.0f);
+			return true;
+		}
+		if (v->isString) {
+			const std::string str = StringToLower(v->str);
+
+			if ((str == "1") || (str == "true")) {
+				value = true;
+				return true;
+			}
+			if ((str == "0") || (str == "false")) {
+				value = false;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	int GetDetached(const LuaDetachedValue* v, int def) {
+		if (v == nullptr || (v->toInt == 0 && !v->isNumber && !v->isString))
+			return def;
+
+		return v->toInt;
+	}
+
+	float GetDetached(const LuaDetachedValue* v, float def) {
+		if (v == nullptr || (v->num == 0.0f && !v->isNumber && !v->isString))
+			return def;
+
+		return v->num;
+	}
+
+	bool GetDetached(const LuaDetachedValue* v, bool def) {
+		bool value;
+
+		if (v == nullptr || !ParseDetachedBoolean(v, value))
+			return def;
+
+		return value;
+	}
+
+	float3 GetDetached(const LuaDetachedValue* v, const float3& def) {
+		float3 value;
+
+		if (v == nullptr || !ParseDetachedFloat3(v, value))
+			return def;
+
+		return value;
+	}
+
+	float4 GetDetached(const LuaDetachedValue* v, const float4& def) {
+		float4 value;
+
+		if (v == nullptr || !ParseDetachedFloat4(v, value))
+			return def;
+
+		return value;
+	}
+
+	std::string GetDetached(const LuaDetachedValue* v, const std::string& def) {
+		if (v == nullptr || !v->isString)
+			return def;
+
+		return v->str;
+	}
+
+	LuaTable::DataType GetDetachedType(const LuaDetachedValue* v) {
+		if (v == nullptr)
+			return LuaTable::NIL;
+
+		switch (v->luaType) {
+			case LUA_TBOOLEAN: return LuaTable::BOOLEAN;
+			case LUA_TNUMBER:  return LuaTable::NUMBER;
+			case LUA_TSTRING:  return LuaTable::STRING;
+			case LUA_TTABLE:   return LuaTable::TABLE;
+			default:           return LuaTable::NIL;
+		}
+	}
+}
+
+
 LuaTable::LuaTable()
 : path(""),
   isValid(false),
@@ -785,6 +1363,14 @@ LuaTable::LuaTable(const LuaTable& tbl)
 	parser = tbl.parser;
 	L      = tbl.L;
 	path   = tbl.path;
+	tree   = tbl.tree;
+	node   = tbl.node;
+
+	if (node != nullptr) {
+		refnum  = LUA_NOREF;
+		isValid = true;
+		return;
+	}
 
 	if (parser != nullptr)
 		parser->AddTable(this);
@@ -821,6 +1407,14 @@ LuaTable& LuaTable::operator=(const LuaTable& tbl)
 
 	L    = tbl.L;
 	path = tbl.path;
+	tree = tbl.tree;
+	node = tbl.node;
+
+	if (node != nullptr) {
+		refnum  = LUA_NOREF;
+		isValid = true;
+		return *this;
+	}
 
 	if (tbl.PushTable()) {
 		lua_pushvalue(L, -1); // copy
@@ -842,6 +1436,18 @@ LuaTable LuaTable::SubTable(int key) const
 	SNPRINTF(buf, 32, "[%i]", key);
 	subTable.path = path + buf;
 
+	if (node != nullptr) {
+		const LuaDetachedValue* value = GetDetachedValue(key);
+
+		if (value == nullptr || value->table == nullptr)
+			return subTable;
+
+		subTable.tree    = tree;
+		subTable.node    = value->table;
+		subTable.isValid = true;
+		return subTable;
+	}
+
 	if (!PushTable())
 		return subTable;
 
@@ -864,11 +1470,24 @@ LuaTable LuaTable::SubTable(int key) const
 
 LuaTable LuaTable::SubTable(const std::string& mixedKey) const
 {
-	const std::string key = !((parser != nullptr)? parser->lowerCppKeys : true) ? mixedKey : StringToLower(mixedKey);
+	const std::string key = !((parser != nullptr)? parser->lowerCppKeys : ((tree != nullptr)? tree->lowerCppKeys : true)) ? mixedKey : StringToLower(mixedKey);
 
 	LuaTable subTable;
 	subTable.path = path + "." + key;
 
+	if (node != nullptr) {
+		// no nested-key lookup, same as for attached tables
+		const LuaDetachedValue* value = node->Find(key);
+
+		if (value == nullptr || value->table == nullptr)
+			return subTable;
+
+		subTable.tree    = tree;
+		subTable.node    = value->table;
+		subTable.isValid = true;
+		return subTable;
+	}
+
 	if (!PushTable())
 		return subTable;
 
@@ -927,6 +1546,39 @@ LuaTable LuaTable::SubTableExpr(const std::string& expr) const
 }
 
 
+LuaTable LuaTable::Detach() const
+{
+	if (node != nullptr)
+		return *this;
+
+	LuaTable detached;
+	detached.path = path;
+
+	if (!PushTable())
+		return detached;
+
+	const int top = lua_gettop(L);
+
+	std::shared_ptr<LuaDetachedTree> detachedTree = std::make_shared<LuaDetachedTree>();
+	DetachedNodeMap visited;
+
+	detachedTree->lowerCppKeys = parser->lowerCppKeys;
+
+	const LuaDetachedNode* detachedNode = DetachTable(L, top, *detachedTree, visited, 0);
+
+	// PushTable expects our table to remain on top
+	lua_settop(L, top);
+
+	if (detachedNode == nullptr)
+		return detached;
+
+	detached.tree    = std::move(detachedTree);
+	detached.node    = detachedNode;
+	detached.isValid = true;
+	return detached;
+}
+
+
 LuaTable::~LuaTable()
 {
 	if (parser != nullptr)
@@ -1072,6 +1724,57 @@ bool LuaTable::PushValue(const std::string& mixedKey) const
 }
 
 
+const LuaDetachedValue* LuaTable::GetDetachedValue(int key) const
+{
+	assert(node != nullptr);
+	return (node->Find(key));
+}
+
+
+const LuaDetachedValue* LuaTable::GetDetachedValue(const std::string& mixedKey) const
+{
+	assert(node != nullptr);
+
+	// mirrors PushValue
+	const std::string key = !tree->lowerCppKeys ? mixedKey : StringToLower(mixedKey);
+
+	if (key.find('.') == std::string::npos)
+		return (node->Find(key));
+
+	// nested key (e.g. "subtable.subsub.mahkey")
+	const LuaDetachedNode* table = node;
+
+	size_t lastpos = 0;
+	size_t dotpos = key.find('.');
+
+	do {
+		const LuaDetachedValue* value = table->Find(key.substr(lastpos, dotpos));
+
+		if (value == nullptr || value->table == nullptr)
+			return nullptr;
+
+		table = value->table;
+
+		lastpos = dotpos + 1;
+		dotpos = key.find('.', lastpos);
+	} while (dotpos != std::string::npos);
+
+	const std::string keyname = key.substr(lastpos);
+	const LuaDetachedValue* value = table->Find(keyname);
+
+	if (value != nullptr)
+		return value;
+
+	bool failed;
+	const int i = StringToInt(keyname, &failed);
+
+	if (failed)
+		return nullptr;
+
+	return (table->Find(i));
+}
+
+
 /******************************************************************************/
 /******************************************************************************/
 //
@@ -1080,6 +1783,9 @@ bool LuaTable::PushValue(const std::string& mixedKey) const
 
 bool LuaTable::KeyExists(int key) const
 {
+	if (node != nullptr)
+		return (GetDetachedValue(key) != nullptr);
+
 	if (!PushValue(key))
 		return false;
 
@@ -1090,6 +1796,9 @@ bool LuaTable::KeyExists(int key) const
 
 bool LuaTable::KeyExists(const std::string& key) const
 {
+	if (node != nullptr)
+		return (GetDetachedValue(key) != nullptr);
+
 	if (!PushValue(key))
 		return false;
 
@@ -1106,6 +1815,9 @@ bool LuaTable::KeyExists(const std::string& key) const
 
 LuaTable::DataType LuaTable::GetType(int key) const
 {
+	if (node != nullptr)
+		return (GetDetachedType(GetDetachedValue(key)));
+
 	if (!PushValue(key))
 		return NIL;
 
@@ -1124,6 +1836,9 @@ LuaTable::DataType LuaTable::GetType(int key) const
 
 LuaTable::DataType LuaTable::GetType(const std::string& key) const
 {
+	if (node != nullptr)
+		return (GetDetachedType(GetDetachedValue(key)));
+
 	if (!PushValue(key))
 		return NIL;
 
@@ -1148,6 +1863,9 @@ LuaTable::DataType LuaTable::GetType(const std::string& key) const
 
 int LuaTable::GetLength() const
 {
+	if (node != nullptr)
+		return node->length;
+
 	if (!PushTable())
 		return 0;
 
@@ -1157,6 +1875,11 @@ int LuaTable::GetLength() const
 
 int LuaTable::GetLength(int key) const
 {
+	if (node != nullptr) {
+		const LuaDetachedValue* value = GetDetachedValue(key);
+		return ((value != nullptr)? value->length: 0);
+	}
+
 	if (!PushValue(key))
 		return 0;
 
@@ -1168,6 +1891,11 @@ int LuaTable::GetLength(int key) const
 
 int LuaTable::GetLength(const std::string& key) const
 {
+	if (node != nullptr) {
+		const LuaDetachedValue* value = GetDetachedValue(key);
+		return ((value != nullptr)? value->length: 0);
+	}
+
 	if (!PushValue(key))
 		return 0;
 
@@ -1185,6 +1913,15 @@ int LuaTable::GetLength(const std::string& key) const
 
 bool LuaTable::GetKeys(std::vector<int>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->numEntries) {
+			data.push_back(e.intKey);
+		}
+
+		std::stable_sort(data.begin(), data.end());
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1202,6 +1939,15 @@ bool LuaTable::GetKeys(std::vector<int>& data) const
 
 bool LuaTable::GetKeys(std::vector<std::string>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->strEntries) {
+			data.emplace_back(e.first);
+		}
+
+		std::stable_sort(data.begin(), data.end());
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1220,6 +1966,19 @@ bool LuaTable::GetKeys(std::vector<std::string>& data) const
 
 bool LuaTable::GetPairs(std::vector<std::pair<int, std::string>>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->numEntries) {
+			if (e.value.isString)
+				data.emplace_back(e.intKey, e.value.str);
+		}
+
+		using T = std::remove_reference<decltype(data)>::type;
+		using P = T::value_type;
+
+		std::stable_sort(data.begin(), data.end(), [](const P& a, const P& b) { return (a.first < b.first); });
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1248,6 +2007,19 @@ bool LuaTable::GetPairs(std::vector<std::pair<int, std::string>>& data) const
 
 bool LuaTable::GetPairs(std::vector<std::pair<std::string, float>>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->strEntries) {
+			if (e.second.isNumber)
+				data.emplace_back(e.first, e.second.num);
+		}
+
+		using T = std::remove_reference<decltype(data)>::type;
+		using P = T::value_type;
+
+		std::stable_sort(data.begin(), data.end(), [](const P& a, const P& b) { return (a.first < b.first); });
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1269,6 +2041,25 @@ bool LuaTable::GetPairs(std::vector<std::pair<std::string, float>>& data) const
 
 bool LuaTable::GetPairs(std::vector<std::pair<std::string, std::string>>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->strEntries) {
+			if (e.second.isString) {
+				data.emplace_back(e.first, e.second.str);
+				continue;
+			}
+			if (e.second.luaType == LUA_TBOOLEAN) {
+				data.emplace_back(e.first, e.second.boolean ? "1" : "0");
+				continue;
+			}
+		}
+
+		using T = std::remove_reference<decltype(data)>::type;
+		using P = T::value_type;
+
+		std::stable_sort(data.begin(), data.end(), [](const P& a, const P& b) { return (a.first < b.first); });
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1304,6 +2095,15 @@ bool LuaTable::GetPairs(std::vector<std::pair<std::string, std::string>>& data)
 
 bool LuaTable::GetMap(spring::unordered_map<int, float>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->numEntries) {
+			if (e.value.isNumber)
+				data[e.intKey] = e.value.num;
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1321,6 +2121,15 @@ bool LuaTable::GetMap(spring::unordered_map<int, float>& data) const
 
 bool LuaTable::GetMap(spring::unordered_map<int, std::string>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->numEntries) {
+			if (e.value.isString)
+				data[e.intKey] = e.value.str;
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1345,6 +2154,15 @@ bool LuaTable::GetMap(spring::unordered_map<int, std::string>& data) const
 
 bool LuaTable::GetMap(spring::unordered_map<std::string, float>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->strEntries) {
+			if (e.second.isNumber)
+				data[e.first] = e.second.num;
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1362,6 +2180,21 @@ bool LuaTable::GetMap(spring::unordered_map<std::string, float>& data) const
 
 bool LuaTable::GetMap(spring::unordered_map<std::string, std::string>& data) const
 {
+	if (node != nullptr) {
+		for (const auto& e: node->strEntries) {
+			if (e.second.isString) {
+				data[e.first] = e.second.str;
+				continue;
+			}
+			if (e.second.luaType == LUA_TBOOLEAN) {
+				data[e.first] = e.second.boolean ? "1" : "0";
+				continue;
+			}
+		}
+
+		return true;
+	}
+
 	if (!PushTable())
 		return false;
 
@@ -1478,6 +2311,9 @@ static bool ParseBoolean(lua_State* L, int index, bool& value)
 
 int LuaTable::Get(const std::string& key, int def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1493,6 +2329,9 @@ int LuaTable::Get(const std::string& key, int def) const
 
 bool LuaTable::Get(const std::string& key, bool def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1508,6 +2347,9 @@ bool LuaTable::Get(const std::string& key, bool def) const
 
 float LuaTable::Get(const std::string& key, float def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1524,6 +2366,9 @@ float LuaTable::Get(const std::string& key, float def) const
 
 float3 LuaTable::Get(const std::string& key, const float3& def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1538,6 +2383,9 @@ float3 LuaTable::Get(const std::string& key, const float3& def) const
 
 float4 LuaTable::Get(const std::string& key, const float4& def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1554,6 +2402,9 @@ float4 LuaTable::Get(const std::string& key, const float4& def) const
 
 std::string LuaTable::Get(const std::string& key, const std::string& def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1575,6 +2426,9 @@ std::string LuaTable::Get(const std::string& key, const std::string& def) const
 
 int LuaTable::Get(int key, int def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1590,6 +2444,9 @@ int LuaTable::Get(int key, int def) const
 
 bool LuaTable::Get(int key, bool def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1605,6 +2462,9 @@ bool LuaTable::Get(int key, bool def) const
 
 float LuaTable::Get(int key, float def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1621,6 +2481,9 @@ float LuaTable::Get(int key, float def) const
 
 float3 LuaTable::Get(int key, const float3& def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
@@ -1635,6 +2498,9 @@ float3 LuaTable::Get(int key, const float3& def) const
 
 float4 LuaTable::Get(int key, const float4& def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key)) {
 		return def;
 	}
@@ -1651,6 +2517,9 @@ float4 LuaTable::Get(int key, const float4& def) const
 
 std::string LuaTable::Get(int key, const std::string& def) const
 {
+	if (node != nullptr)
+		return (GetDetached(GetDetachedValue(key), def));
+
 	if (!PushValue(key))
 		return def;
 
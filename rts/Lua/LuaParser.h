@@ -3,6 +3,8 @@
 #ifndef LUA_PARSER_H
 #define LUA_PARSER_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,6 +17,9 @@ class float3;
 struct float4;
 class LuaTable;
 class LuaParser;
+struct LuaDetachedTree;
+struct LuaDetachedNode;
+struct LuaDetachedValue;
 struct lua_State;
 
 
@@ -33,7 +38,13 @@ public:
 	LuaTable SubTable(const std::string& key) const;
 	LuaTable SubTableExpr(const std::string& expr) const;
 
-	bool IsValid() const { return (parser != nullptr); }
+	// returns a copy of this table (and all tables reachable from it) that
+	// does not refer to the parser's lua_State and can therefore be read
+	// from any thread; invalid if any of the tables has a metatable
+	LuaTable Detach() const;
+
+	bool IsValid() const { return (parser != nullptr || node != nullptr); }
+	bool IsDetached() const { return (node != nullptr); }
 
 	const std::string& GetPath() const { return path; }
 
@@ -106,12 +117,19 @@ private:
 	bool PushValue(int key) const;
 	bool PushValue(const std::string& key) const;
 
+	const LuaDetachedValue* GetDetachedValue(int key) const;
+	const LuaDetachedValue* GetDetachedValue(const std::string& key) const;
+
 private:
 	std::string path;
 	mutable bool isValid;
 	LuaParser* parser;
 	lua_State* L;
 	int refnum;
+
+	// set instead of parser if detached
+	std::shared_ptr<const LuaDetachedTree> tree;
+	const LuaDetachedNode* node = nullptr;
 };
 
 
@@ -133,6 +151,15 @@ public:
 
 	bool Execute();
 	bool IsValid() const { return (L != nullptr); } // true if nothing failed during Execute
+
+	// binary snapshots of plain (number/string/boolean/table) data, keys in
+	// canonical order s.t. equal tables always produce identical snapshots;
+	// fail on anything else (functions, metatables, cycles)
+	bool SerializeRoot(std::vector<std::uint8_t>& buffer);
+	bool SerializeGlobal(const std::string& name, std::vector<std::uint8_t>& buffer);
+	// sets the root table from a snapshot instead of running the code, or
+	// replaces it if the parser was already executed
+	bool ExecuteSnapshot(const std::vector<std::uint8_t>& buffer);
 	bool NoTable() const { return (errorLog.find("no return table") == 0); } // parser is still valid if true
 
 	LuaTable GetRoot();
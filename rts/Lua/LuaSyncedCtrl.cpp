@@ -803,6 +803,8 @@ static int SetSolidObjectPieceCollisionVolumeData(lua_State* L, CSolidObject* ob
 	// piece volumes are not allowed to use discrete hit-testing
 	vol->InitShape(scales, offset, vType, CollisionVolume::COLVOL_HITTEST_CONT, pAxis);
 	vol->SetIgnoreHits(!luaL_checkboolean(L, 3));
+
+	obj->localModel.SetPieceBVHNeedsRefit();
 	return 0;
 }
 
@@ -4608,6 +4610,8 @@ int LuaSyncedCtrl::SetFeatureResources(lua_State* L)
 	if (feature == nullptr)
 		return 0;
 
+	const unsigned int featureCats = CQuadField::GetFeatureCategoryBits(feature);
+
 	feature->defResources.metal  = std::max(0.0f, luaL_optfloat(L, 6, feature->defResources.metal));
 	feature->defResources.energy = std::max(0.0f, luaL_optfloat(L, 7, feature->defResources.energy));
 
@@ -4616,6 +4620,8 @@ int LuaSyncedCtrl::SetFeatureResources(lua_State* L)
 
 	feature->reclaimTime = std::clamp(luaL_optnumber(L, 4, feature->reclaimTime), 1.0f, 1000000.0f);
 	feature->reclaimLeft = std::clamp(luaL_optnumber(L, 5, feature->reclaimLeft), 0.0f,       1.0f);
+
+	quadField.ChangedFeature(feature, featureCats);
 	return 0;
 }
 
@@ -4644,8 +4650,12 @@ int LuaSyncedCtrl::SetFeatureResurrect(lua_State* L)
 		else if (lua_israwstring(L, 2))
 			ud = unitDefHandler->GetUnitDefByName(lua_tostring(L, 2));
 
+		const unsigned int featureCats = CQuadField::GetFeatureCategoryBits(feature);
+
 		// nullptr is also accepted, allows unsetting the target via id=-1
 		feature->udef = ud;
+
+		quadField.ChangedFeature(feature, featureCats);
 	}
 
 	if (!lua_isnoneornil(L, 3))
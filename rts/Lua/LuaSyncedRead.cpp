@@ -5433,7 +5433,7 @@ int LuaSyncedRead::GetUnitWeaponTryTarget(lua_State* L)
 			return 0;
 	}
 
-	lua_pushboolean(L, weapon->TryTarget(SWeaponTarget(enemy, pos, true)));
+	lua_pushboolean(L, weapon->TryTarget(SWeaponTarget(enemy, pos, true), CLuaHandle::GetHandleSynced(L)));
 	return 1;
 }
 
@@ -5576,7 +5576,12 @@ int LuaSyncedRead::GetUnitWeaponHaveFreeLineOfFire(lua_State* L)
 		} break;
 	}
 
-	lua_pushboolean(L, weapon->HaveFreeLineOfFire(srcPos, tgtPos, SWeaponTarget(enemy, tgtPos, true)));
+	// only synced handles may share results with the simulation
+	if (CLuaHandle::GetHandleSynced(L)) {
+		lua_pushboolean(L, weapon->HaveFreeLineOfFireCached(srcPos, tgtPos, SWeaponTarget(enemy, tgtPos, true)));
+	} else {
+		lua_pushboolean(L, weapon->HaveFreeLineOfFire(srcPos, tgtPos, SWeaponTarget(enemy, tgtPos, true)));
+	}
 	return 1;
 }
 
@@ -21,6 +21,7 @@
 #include "Sim/Units/UnitDef.h"
 #include "Sim/Units/UnitDefHandler.h"
 #include "Sim/Weapons/WeaponDef.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/FileSystem/SimpleParser.h"
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
@@ -57,6 +58,8 @@ bool LuaUnitDefs::PushEntries(lua_State* L)
 {
 	InitParamMap();
 
+	const bool materialize = configHandler->GetBool("LuaMaterializeDefs");
+
 	typedef int (*IndxFuncType)(lua_State*);
 	typedef int (*IterFuncType)(lua_State*);
 
@@ -82,7 +85,7 @@ bool LuaUnitDefs::PushEntries(lua_State* L)
 		if (def == nullptr)
 			continue;
 
-		PushObjectDefProxyTable(L, indxOpers, iterOpers, indxFuncs, iterFuncs, def);
+		PushObjectDefProxyTable(L, indxOpers, iterOpers, indxFuncs, iterFuncs, def, materialize);
 	}
 
 	return true;
@@ -94,6 +97,10 @@ bool LuaUnitDefs::PushEntries(lua_State* L)
 
 static int UnitDefIndex(lua_State* L)
 {
+	// /editdefs drops all caches (CLuaHandle::DropMaterializedDefs) and holds off new ones
+	if (!gs->editDefsEnabled && LuaUtils::MaterializeObjectDef(paramMap, L))
+		return 1;
+
 	// not a default value
 	if (!lua_isstring(L, 2)) {
 		lua_rawget(L, 1);
@@ -697,6 +704,14 @@ ADD_BOOL("canAttackWater",  canAttackWater); // CUSTOM
 	ADD_FLOAT("metalCost",      ud.cost.metal);
 	ADD_FLOAT("energyCost",     ud.cost.energy);
 	ADD_FLOAT("buildTime",      ud.buildTime);
+
+	// toggled by the nocost cheat
+	SET_DYNAMIC("metalUpkeep");
+	SET_DYNAMIC("energyUpkeep");
+	SET_DYNAMIC("metalCost");
+	SET_DYNAMIC("energyCost");
+	SET_DYNAMIC("buildTime");
+
 	ADD_FLOAT("buildeeBuildRadius", ud.buildeeBuildRadius);
 	ADD_FLOAT("extractsMetal",  ud.extractsMetal);
 	ADD_FLOAT("extractRange",   ud.extractRange);
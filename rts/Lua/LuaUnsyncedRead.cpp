@@ -591,6 +591,8 @@ int LuaUnsyncedRead::GetProfilerRecordNames(lua_State* L)
  *
  * @function Spring.GetLuaMemUsage
  *
+ * @param poolStats boolean? (Default: `false`) whether to also return the memory-pool statistics of this handle
+ *
  * @return number luaHandleAllocedMem in kilobytes
  * @return number luaHandleNumAllocs divided by 1000
  * @return number luaGlobalAllocedMem in kilobytes
@@ -599,6 +601,11 @@ int LuaUnsyncedRead::GetProfilerRecordNames(lua_State* L)
  * @return number luaUnsyncedGlobalNumAllocs divided by 1000
  * @return number luaSyncedGlobalAllocedMem in kilobytes
  * @return number luaSyncedGlobalNumAllocs divided by 1000
+ * @return nil|{numAllocs=number,allocedBytes=number,arenaAllocs=number,arenaResets=number,arenaUsedBytes=number,arenaLiveAllocs=number,sizeClasses={[number]=number,...}} poolStats
+ *   only if `poolStats` is true; counters accumulate since the last pool-stats log,
+ *   `sizeClasses` maps the upper size-bound (in bytes, -1 for the last class) of each
+ *   non-empty allocation size-class to its number of requests (empty unless
+ *   LuaMemPoolTrackSizeClasses is enabled)
  */
 int LuaUnsyncedRead::GetLuaMemUsage(lua_State* L)
 {
@@ -634,7 +641,34 @@ int LuaUnsyncedRead::GetLuaMemUsage(lua_State* L)
 		lua_pushnumber(L, lgs.numLuaAllocs / 1000.0f);
 	}
 
-	return 8;
+	if (!luaL_optboolean(L, 1, false))
+		return 8;
+
+	const LuaMemPool* pool = GetLuaContextData(L)->memPool;
+	const auto& sizeClassCounts = pool->GetSizeClassCounts();
+
+	lua_createtable(L, 0, 7);
+	LuaPushNamedNumber(L, "numAllocs", pool->GetNumAllocs());
+	LuaPushNamedNumber(L, "allocedBytes", pool->GetNumAllocedBytes());
+	LuaPushNamedNumber(L, "arenaAllocs", pool->GetNumArenaAllocs());
+	LuaPushNamedNumber(L, "arenaResets", pool->GetNumArenaResets());
+	LuaPushNamedNumber(L, "arenaUsedBytes", pool->GetArenaUsedBytes());
+	LuaPushNamedNumber(L, "arenaLiveAllocs", pool->GetArenaLiveAllocs());
+
+	lua_pushliteral(L, "sizeClasses");
+	lua_createtable(L, 0, LuaMemPool::NUM_SIZE_CLASSES);
+
+	for (uint32_t i = 0; i < LuaMemPool::NUM_SIZE_CLASSES; i++) {
+		if (sizeClassCounts[i] == 0)
+			continue;
+
+		lua_pushnumber(L, (i < (LuaMemPool::NUM_SIZE_CLASSES - 1))? LuaMemPool::GetSizeClassBytes(i): -1);
+		lua_pushnumber(L, sizeClassCounts[i]);
+		lua_rawset(L, -3);
+	}
+
+	lua_rawset(L, -3);
+	return 9;
 }
 
 
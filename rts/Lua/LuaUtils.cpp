@@ -1325,6 +1325,136 @@ int LuaUtils::Next(const ParamMap& paramMap, lua_State* L)
 }
 
 
+static bool PushScalarDataElement(lua_State* L, const DataElement& elem, const void* objectDef)
+{
+	const void* p = static_cast<const char*>(objectDef) + elem.offset;
+
+	switch (elem.type) {
+		case INT_TYPE: {
+			lua_pushnumber(L, *reinterpret_cast<const int*>(p));
+		} break;
+		case BOOL_TYPE: {
+			lua_pushboolean(L, *reinterpret_cast<const bool*>(p));
+		} break;
+		case FLOAT_TYPE: {
+			lua_pushnumber(L, *reinterpret_cast<const float*>(p));
+		} break;
+		case STRING_TYPE: {
+			lua_pushsstring(L, *reinterpret_cast<const std::string*>(p));
+		} break;
+		default: {
+			return false;
+		} break;
+	}
+
+	return true;
+}
+
+// registry key of the table mapping materialized proxy metatables to their original __index
+static char MATERIALIZED_DEFS_KEY = 0;
+
+bool LuaUtils::MaterializeObjectDef(const ParamMap& paramMap, lua_State* L)
+{
+	// set to false for proxies that should be materialized but are not yet
+	if (lua_type(L, lua_upvalueindex(2)) != LUA_TBOOLEAN || lua_toboolean(L, lua_upvalueindex(2)))
+		return false;
+
+	const void* objectDef = lua_touserdata(L, lua_upvalueindex(1));
+
+	// proxy metatable (bypasses __metatable)
+	if (!lua_getmetatable(L, 1))
+		return false;
+
+	const int metaTable = lua_gettop(L);
+
+	lua_createtable(L, 0, paramMap.size());
+
+	const int cacheTable = lua_gettop(L);
+
+	for (const auto& [key, elem]: paramMap) {
+		if (elem.deprecated || elem.dynamic)
+			continue;
+
+		lua_pushsstring(L, key);
+
+		if (!PushScalarDataElement(L, elem, objectDef)) {
+			lua_pop(L, 1);
+			continue;
+		}
+
+		lua_rawset(L, cacheTable);
+	}
+
+	// keys not in the cache fall through to a copy of this closure
+	// that is marked as materialized, the proxy itself stays empty
+	// such that __newindex still guards all writes
+	lua_createtable(L, 0, 1);
+	lua_pushliteral(L, "__index");
+	lua_pushliteral(L, "__index");
+	lua_rawget(L, metaTable);
+	const lua_CFunction indexFunc = lua_tocfunction(L, -1);
+	lua_pop(L, 1);
+	lua_pushlightuserdata(L, const_cast<void*>(objectDef));
+	lua_pushboolean(L, true);
+	lua_pushcclosure(L, indexFunc, 2);
+	lua_rawset(L, -3);
+	lua_setmetatable(L, cacheTable);
+
+	// remember the original closure for DematerializeObjectDefs
+	lua_pushlightuserdata(L, &MATERIALIZED_DEFS_KEY);
+	lua_rawget(L, LUA_REGISTRYINDEX);
+
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushlightuserdata(L, &MATERIALIZED_DEFS_KEY);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, LUA_REGISTRYINDEX);
+	}
+
+	lua_pushvalue(L, metaTable);
+	lua_pushliteral(L, "__index");
+	lua_rawget(L, metaTable);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+
+	lua_pushliteral(L, "__index");
+	lua_pushvalue(L, cacheTable);
+	lua_rawset(L, metaTable);
+
+	// answer the current lookup through the new chain
+	lua_pushvalue(L, 2);
+	lua_gettable(L, cacheTable);
+	return true;
+}
+
+void LuaUtils::DematerializeObjectDefs(lua_State* L)
+{
+	lua_pushlightuserdata(L, &MATERIALIZED_DEFS_KEY);
+	lua_rawget(L, LUA_REGISTRYINDEX);
+
+	if (!lua_istable(L, -1)) {
+		lua_pop(L, 1);
+		return;
+	}
+
+	const int defsTable = lua_gettop(L);
+
+	// <proxy metatable, original __index> pairs
+	for (lua_pushnil(L); lua_next(L, defsTable) != 0; lua_pop(L, 1)) {
+		lua_pushliteral(L, "__index");
+		lua_pushvalue(L, -2);
+		lua_rawset(L, -4);
+	}
+
+	lua_pop(L, 1);
+
+	lua_pushlightuserdata(L, &MATERIALIZED_DEFS_KEY);
+	lua_pushnil(L);
+	lua_rawset(L, LUA_REGISTRYINDEX);
+}
+
+
 /******************************************************************************/
 /******************************************************************************/
 
@@ -3,6 +3,7 @@
 #ifndef LUA_UTILS_H
 #define LUA_UTILS_H
 
+#include <cstring>
 #include <string>
 
 #include "lib/fmt/printf.h"
@@ -146,6 +147,14 @@ class LuaUtils {
 		// (helper for the Next() iteration routine)
 		static int Next(const ParamMap& paramMap, lua_State* L);
 
+		// from LuaFeatureDefs.cpp / LuaUnitDefs.cpp / LuaWeaponDefs.cpp
+		// (helper for the __index metamethod of proxies pushed with
+		// materialize=true)
+		static bool MaterializeObjectDef(const ParamMap& paramMap, lua_State* L);
+		// restores the original __index of every proxy materialized in <L>,
+		// such that the next access copies the (possibly edited) def again
+		static void DematerializeObjectDefs(lua_State* L);
+
 		// from LuaParser.cpp / LuaUnsyncedCtrl.cpp
 		// (implementation copied from lua/src/lib/lbaselib.c)
 		static int Echo(lua_State* L);
@@ -219,7 +228,8 @@ static void PushObjectDefProxyTable(
 	const std::array<const LuaHashString, iterFuncsSize>& iterOpers,
 	const std::array<const lua_CFunction, indxFuncsSize>& indxFuncs,
 	const std::array<const lua_CFunction, iterFuncsSize>& iterFuncs,
-	const ObjectDefType* def
+	const ObjectDefType* def,
+	bool materialize = false
 ) {
 	lua_pushnumber(L, def->id);
 	lua_createtable(L, 0, iterFuncsSize); { // the proxy table
@@ -227,9 +237,16 @@ static void PushObjectDefProxyTable(
 		lua_createtable(L, 0, indxFuncsSize); // the metatable
 
 		for (size_t n = 0; n < indxFuncsSize; n++) {
+			// the second upvalue tells __index to materialize the def on first access
+			const bool materializeIndex = materialize && (strcmp(indxOpers[n].GetString(), "__index") == 0);
+
 			indxOpers[n].Push(L);
 			lua_pushlightuserdata(L, (void*) def);
-			lua_pushcclosure(L, indxFuncs[n], 1);
+
+			if (materializeIndex)
+				lua_pushboolean(L, false);
+
+			lua_pushcclosure(L, indxFuncs[n], 1 + materializeIndex);
 			lua_rawset(L, -3); // closure
 		}
 
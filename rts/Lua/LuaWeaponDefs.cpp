@@ -18,6 +18,7 @@
 #include "Sim/Projectiles/Projectile.h"
 #include "Sim/Weapons/Weapon.h"
 #include "Sim/Weapons/WeaponDefHandler.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/FileSystem/SimpleParser.h"
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
@@ -58,6 +59,8 @@ bool LuaWeaponDefs::PushEntries(lua_State* L)
 {
 	InitParamMap();
 
+	const bool materialize = configHandler->GetBool("LuaMaterializeDefs");
+
 	typedef int (*IndxFuncType)(lua_State*);
 	typedef int (*IterFuncType)(lua_State*);
 
@@ -83,7 +86,7 @@ bool LuaWeaponDefs::PushEntries(lua_State* L)
 		if (def == nullptr)
 			continue;
 
-		PushObjectDefProxyTable(L, indxOpers, iterOpers, indxFuncs, iterFuncs, def);
+		PushObjectDefProxyTable(L, indxOpers, iterOpers, indxFuncs, iterFuncs, def, materialize);
 	}
 
 	return true;
@@ -94,6 +97,10 @@ bool LuaWeaponDefs::PushEntries(lua_State* L)
 
 static int WeaponDefIndex(lua_State* L)
 {
+	// /editdefs drops all caches (CLuaHandle::DropMaterializedDefs) and holds off new ones
+	if (!gs->editDefsEnabled && LuaUtils::MaterializeObjectDef(paramMap, L))
+		return 1;
+
 	// not a default value
 	if (!lua_isstring(L, 2)) {
 		lua_rawget(L, 1);
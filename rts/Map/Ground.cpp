@@ -2,6 +2,7 @@
 
 
 #include "Ground.h"
+#include "HeightBoundsPyramid.h"
 #include "ReadMap.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
@@ -190,6 +191,120 @@ void CGround::CheckColSquare(CProjectile* p, int x, int y)
 }
 */
 
+// blocks are only skipped when the ray passes at least this far above their
+// maximum height, absorbs rounding in the per-square intersection tests
+static constexpr float HEIGHT_BOUNDS_EPS = 1.0f;
+
+// inclusive square-space rectangle that contains no squares
+static const SRectangle EMPTY_SQUARE_RECT = {0, 0, -1, -1};
+
+static inline bool InSquareRect(const SRectangle& r, int sx, int sz)
+{
+	return ((sx >= r.x1 && sx <= r.x2) && (sz >= r.z1 && sz <= r.z2));
+}
+
+// world-space extent of a block grown by <pad> (shrunk if negative); edge blocks
+// extend outward indefinitely since out-of-map positions are clamped onto them
+static inline float BlockMinPosX(const SRectangle& r, float pad) { return (r.x1 == 0             )? std::numeric_limits<float>::lowest(): (r.x1    ) * SQUARE_SIZE - pad; }
+static inline float BlockMinPosZ(const SRectangle& r, float pad) { return (r.z1 == 0             )? std::numeric_limits<float>::lowest(): (r.z1    ) * SQUARE_SIZE - pad; }
+static inline float BlockMaxPosX(const SRectangle& r, float pad) { return (r.x2 == mapDims.mapxm1)? std::numeric_limits<float>::max()   : (r.x2 + 1) * SQUARE_SIZE + pad; }
+static inline float BlockMaxPosZ(const SRectangle& r, float pad) { return (r.z2 == mapDims.mapym1)? std::numeric_limits<float>::max()   : (r.z2 + 1) * SQUARE_SIZE + pad; }
+
+// clips the parameter range [tmin, tmax] of p + t * d to the slab [s1, s2]
+static inline bool ClipParamToSlab(float p, float d, float s1, float s2, float& tmin, float& tmax)
+{
+	if (d == 0.0f)
+		return (p >= s1 && p <= s2);
+
+	float t1 = (s1 - p) / d;
+	float t2 = (s2 - p) / d;
+
+	if (t1 > t2)
+		std::swap(t1, t2);
+
+	tmin = std::max(tmin, t1);
+	tmax = std::min(tmax, t2);
+	return (tmin <= tmax);
+}
+
+// minimum height of the (infinite) line through <from> along <dir> over the
+// xz-extent of a block of squares; edge blocks extend outward indefinitely
+static float LineMinHeightInBlock(const float3& from, const float3& dir, const SRectangle& r)
+{
+	float tmin = std::numeric_limits<float>::lowest();
+	float tmax = std::numeric_limits<float>::max();
+
+	if (!ClipParamToSlab(from.x, dir.x, BlockMinPosX(r, HEIGHT_BOUNDS_EPS), BlockMaxPosX(r, HEIGHT_BOUNDS_EPS), tmin, tmax))
+		return std::numeric_limits<float>::max();
+	if (!ClipParamToSlab(from.z, dir.z, BlockMinPosZ(r, HEIGHT_BOUNDS_EPS), BlockMaxPosZ(r, HEIGHT_BOUNDS_EPS), tmin, tmax))
+		return std::numeric_limits<float>::max();
+
+	if (dir.y == 0.0f)
+		return from.y;
+
+	const float t = (dir.y < 0.0f)? tmax: tmin;
+
+	if (t == std::numeric_limits<float>::lowest() || t == std::numeric_limits<float>::max())
+		return std::numeric_limits<float>::lowest();
+
+	return (from.y + dir.y * t);
+}
+
+// finds the largest pyramid block around square (sx, sz) that the line through
+// <from> along <dir> passes entirely above; if even the level-0 block does not
+// qualify its extent is returned in <testRect> so it is not re-checked per square
+static bool FindClearedLineBlock(
+	const CHeightBoundsPyramid& hbp,
+	const float3& from,
+	const float3& dir,
+	int sx,
+	int sz,
+	SRectangle& clearRect,
+	SRectangle& testRect
+) {
+	if (sx < 0 || sz < 0 || sx > mapDims.mapxm1 || sz > mapDims.mapym1)
+		return false;
+
+	bool cleared = false;
+
+	for (int level = 0, numLevels = hbp.GetNumLevels(); level < numLevels; level++) {
+		const SRectangle blockRect = hbp.GetBlockRect(level, sx, sz);
+		const float2& blockBounds = hbp.GetBlockBounds(level, sx, sz);
+
+		if (LineMinHeightInBlock(from, dir, blockRect) <= (blockBounds.y + HEIGHT_BOUNDS_EPS)) {
+			if (level == 0)
+				testRect = blockRect;
+
+			break;
+		}
+
+		clearRect = blockRect;
+		cleared = true;
+	}
+
+	return cleared;
+}
+
+// same for a single point, returns the height above which <clearRect> can be skipped
+static bool FindClearedPointBlock(const CHeightBoundsPyramid& hbp, float y, int sx, int sz, SRectangle& clearRect, float& clearHgt)
+{
+	bool cleared = false;
+
+	for (int level = 0, numLevels = hbp.GetNumLevels(); level < numLevels; level++) {
+		const float2& blockBounds = hbp.GetBlockBounds(level, sx, sz);
+
+		if (y <= (blockBounds.y + HEIGHT_BOUNDS_EPS))
+			break;
+
+		clearRect = hbp.GetBlockRect(level, sx, sz);
+		clearHgt = blockBounds.y + HEIGHT_BOUNDS_EPS;
+		cleared = true;
+	}
+
+	return cleared;
+}
+
+
 inline static bool ClampInMapHeight(float3& from, float3& to)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -218,6 +333,8 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 	const float* hm  = readMap->GetSharedCornerHeightMap(synced);
 	const float3* nm = readMap->GetSharedFaceNormals(synced);
 
+	const CHeightBoundsPyramid& hbp = readMap->GetSharedHeightBoundsPyramid(synced);
+
 	const float3 pfrom = from;
 
 	// only for performance -> skip part that can impossibly collide
@@ -266,6 +383,12 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 
 	bool stopTrace = false;
 
+	// blocks of squares the ray passes entirely above (which need no tests), and
+	// the last level-0 block known not to qualify (so it is not re-checked for
+	// every square inside it)
+	SRectangle clearRect = EMPTY_SQUARE_RECT;
+	SRectangle testRect = EMPTY_SQUARE_RECT;
+
 	if ((fsx == tsx) && (fsz == tsz)) {
 		// <from> and <to> are the same
 		const float ret = LineGroundSquareCol(hm, nm,  from, to,  fsx, fsz);
@@ -281,6 +404,16 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 		int zp = fsz;
 
 		for (unsigned int i = 0, n = Square(mapDims.mapyp1); (Square(i) <= n && zp != tsz); i++) {
+			if (!InSquareRect(testRect, fsx, zp) && FindClearedLineBlock(hbp, from, to - from, fsx, zp, clearRect, testRect)) {
+				zp = (dirz > 0)? clearRect.z2 + 1: clearRect.z1 - 1;
+
+				// tsz itself is never tested
+				if ((zp - tsz) * dirz >= 0)
+					return -1.0f;
+
+				continue;
+			}
+
 			const float ret = LineGroundSquareCol(hm, nm,  from, to,  fsx, zp);
 
 			if (ret >= 0.0f)
@@ -297,6 +430,16 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 		int xp = fsx;
 
 		for (unsigned int i = 0, n = Square(mapDims.mapxp1); (Square(i) <= n && xp != tsx); i++) {
+			if (!InSquareRect(testRect, xp, fsz) && FindClearedLineBlock(hbp, from, to - from, xp, fsz, clearRect, testRect)) {
+				xp = (dirx > 0)? clearRect.x2 + 1: clearRect.x1 - 1;
+
+				// tsx itself is never tested
+				if ((xp - tsx) * dirx >= 0)
+					return -1.0f;
+
+				continue;
+			}
+
 			const float ret = LineGroundSquareCol(hm, nm,  from, to,  xp, fsz);
 
 			if (ret >= 0.0f)
@@ -334,11 +477,59 @@ float CGround::LineGroundCol(float3 from, float3 to, bool synced)
 		int curz = fsz;
 
 		for (unsigned int i = 0, n = Square(mapDims.mapxp1) + Square(mapDims.mapyp1); !stopTrace; i++) {
+			if (!InSquareRect(clearRect, curx, curz) && !InSquareRect(testRect, curx, curz)) {
+				if (FindClearedLineBlock(hbp, from, to - from, curx, curz, clearRect, testRect)) {
+					// jump to the first square past the block; the stepping below merges the
+					// (monotonic) x- and z-edge crossing parameters with ties going to z, so
+					// the exit square follows from the parameters of the block's far edges
+					const int exitx = (dirx > 0)? clearRect.x2 + 1: clearRect.x1 - 1;
+					const int exitz = (dirz > 0)? clearRect.z2 + 1: clearRect.z1 - 1;
+
+					const bool xBeyondEnd = ((exitx - tsx) * dirx > 0);
+					const bool zBeyondEnd = ((exitz - tsz) * dirz > 0);
+
+					// remainder of the ray lies inside the block
+					if (xBeyondEnd && zBeyondEnd)
+						return -1.0f;
+
+					const float exitxn = xBeyondEnd? 1337.0f: (exitx + testposx - ffsx) * rdsx;
+					const float exitzn = zBeyondEnd? 1337.0f: (exitz + testposz - ffsz) * rdsz;
+
+					// near the end of the ray the stepping has extra special cases, so only
+					// jump when the block is left before it (otherwise just skip the tests)
+					if (std::min(exitxn, exitzn) < 1.0f) {
+						const int prevx = curx;
+						const int prevz = curz;
+
+						if (exitxn < exitzn) {
+							for (int nextz = curz + dirz; (nextz - tsz) * dirz <= 0 && (nextz + testposz - ffsz) * rdsz <= exitxn; nextz += dirz) {
+								curz = nextz;
+							}
+
+							curx = exitx;
+						} else {
+							for (int nextx = curx + dirx; (nextx - tsx) * dirx <= 0 && (nextx + testposx - ffsx) * rdsx < exitzn; nextx += dirx) {
+								curx = nextx;
+							}
+
+							curz = exitz;
+						}
+
+						// count the skipped squares towards the iteration limit (minus the one
+						// added by the loop itself)
+						i += (std::abs(curx - prevx) + std::abs(curz - prevz) - 1);
+						continue;
+					}
+				}
+			}
+
 			// test for collision with the ground-square triangles
-			const float ret = LineGroundSquareCol(hm, nm,  from, to,  curx, curz);
+			if (!InSquareRect(clearRect, curx, curz)) {
+				const float ret = LineGroundSquareCol(hm, nm,  from, to,  curx, curz);
 
-			if (ret >= 0.0f)
-				return (ret + skippedDist);
+				if (ret >= 0.0f)
+					return (ret + skippedDist);
+			}
 
 			// check if we reached the end already and need to stop the loop
 			const bool endReached = ((curx == tsx && curz == tsz) || (Square(i) > n));
@@ -576,7 +767,25 @@ float CGround::SimTrajectoryGroundColDist(const float3& trajStartPos, const floa
 		vel += acc;
 		pos += vel;
 	}
-	while (pos.y >= GetHeightReal(pos)) {
+
+	const CHeightBoundsPyramid& hbp = readMap->GetSharedHeightBoundsPyramid(true);
+
+	// block that <pos> is known to be above (while higher than clearHgt)
+	SRectangle clearRect = EMPTY_SQUARE_RECT;
+	float clearHgt = std::numeric_limits<float>::max();
+
+	while (true) {
+		// same square InterpolateCornerHeight reads from
+		const int sx = std::clamp(pos.x, 0.0f, float3::maxxpos) / SQUARE_SIZE;
+		const int sz = std::clamp(pos.z, 0.0f, float3::maxzpos) / SQUARE_SIZE;
+
+		if (!InSquareRect(clearRect, sx, sz) || pos.y <= clearHgt) {
+			if (pos.y < GetHeightReal(pos))
+				break;
+
+			FindClearedPointBlock(hbp, pos.y, sx, sz, clearRect, clearHgt);
+		}
+
 		vel += acc;
 		pos += vel;
 	}
@@ -587,6 +796,62 @@ float CGround::SimTrajectoryGroundColDist(const float3& trajStartPos, const floa
 	return (math::sqrt(pos.SqDistance2D(trajStartPos)));
 }
 
+// finds the largest pyramid block around square (sx, sz) that the trajectory
+// y(d) = start.y + dir.y * d + qdrCoeff * d * d passes above from <minDist>
+// until it leaves the block; returns that exit distance in <clearDist>
+static bool FindClearedTrajectoryBlock(
+	const CHeightBoundsPyramid& hbp,
+	const float3& start,
+	const float3& dir,
+	float qdrCoeff,
+	float minDist,
+	float maxDist,
+	int sx,
+	int sz,
+	float& clearDist,
+	SRectangle& testRect
+) {
+	bool cleared = false;
+
+	for (int level = 0, numLevels = hbp.GetNumLevels(); level < numLevels; level++) {
+		const SRectangle blockRect = hbp.GetBlockRect(level, sx, sz);
+		const float2& blockBounds = hbp.GetBlockBounds(level, sx, sz);
+
+		float dmin = minDist;
+		float dmax = maxDist;
+
+		// samples are looked up by square, so only count those strictly inside
+		ClipParamToSlab(start.x, dir.x, BlockMinPosX(blockRect, -HEIGHT_BOUNDS_EPS), BlockMaxPosX(blockRect, -HEIGHT_BOUNDS_EPS), dmin, dmax);
+		ClipParamToSlab(start.z, dir.z, BlockMinPosZ(blockRect, -HEIGHT_BOUNDS_EPS), BlockMaxPosZ(blockRect, -HEIGHT_BOUNDS_EPS), dmin, dmax);
+
+		dmax = std::max(dmax, minDist);
+
+		float minHgt = std::min(
+			start.y + dir.y * minDist + qdrCoeff * minDist * minDist,
+			start.y + dir.y * dmax    + qdrCoeff * dmax    * dmax
+		);
+
+		// convex trajectory, lowest point can be in between
+		if (qdrCoeff > 0.0f) {
+			const float dv = std::clamp(-dir.y / (2.0f * qdrCoeff), minDist, dmax);
+			minHgt = std::min(minHgt, start.y + dir.y * dv + qdrCoeff * dv * dv);
+		}
+
+		if (minHgt <= (blockBounds.y + HEIGHT_BOUNDS_EPS)) {
+			if (level == 0)
+				testRect = blockRect;
+
+			break;
+		}
+
+		clearDist = dmax;
+		cleared = true;
+	}
+
+	return cleared;
+}
+
+
 float CGround::TrajectoryGroundCol(const float3& trajStartPos, const float3& trajTargetDir, float length, float linCoeff, float qdrCoeff)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -604,9 +869,26 @@ float CGround::TrajectoryGroundCol(const float3& trajStartPos, const float3& tra
 	const float minDist = length * std::max(0.0f, ips.x);
 	const float maxDist = length * std::min(1.0f, ips.y);
 
+	const CHeightBoundsPyramid& hbp = readMap->GetSharedHeightBoundsPyramid(true);
+
+	// samples before clearDist lie above every height they could read
+	float clearDist = minDist;
+
+	SRectangle testRect = EMPTY_SQUARE_RECT;
+
 	for (float dist = minDist; dist < maxDist; dist += SQUARE_SIZE) {
+		if (dist < clearDist)
+			continue;
+
 		const float3 pos = (trajStartPos + dir * dist) + (alt * dist * dist);
 
+		// same square GetApproximateHeight reads from
+		const int sx = std::clamp(int(pos.x) / SQUARE_SIZE, 0, mapDims.mapxm1);
+		const int sz = std::clamp(int(pos.z) / SQUARE_SIZE, 0, mapDims.mapym1);
+
+		if (!InSquareRect(testRect, sx, sz) && FindClearedTrajectoryBlock(hbp, trajStartPos, dir, qdrCoeff, dist, maxDist, sx, sz, clearDist, testRect))
+			continue;
+
 		#if 1
 		if (GetApproximateHeight(pos) > pos.y)
 			return dist;
@@ -0,0 +1,98 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "HeightBoundsPyramid.h"
+#include "System/Threading/ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "System/Misc/TracyDefs.h"
+
+
+void CHeightBoundsPyramid::Init(int mapx_, int mapy_)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	mapx = mapx_;
+	mapy = mapy_;
+
+	levels.clear();
+
+	for (int level = 0; ; level++) {
+		const int blockSize = 1 << GetBlockShift(level);
+
+		Level& lvl = levels.emplace_back();
+		lvl.sizex = (mapx + blockSize - 1) / blockSize;
+		lvl.sizez = (mapy + blockSize - 1) / blockSize;
+		lvl.bounds.resize(lvl.sizex * lvl.sizez, {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()});
+
+		if (lvl.sizex == 1 && lvl.sizez == 1)
+			break;
+	}
+}
+
+void CHeightBoundsPyramid::Update(const float* cornerHeightMap, const SRectangle& cornerRect)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (levels.empty())
+		return;
+
+	const int mapxp1 = mapx + 1;
+
+	// a corner on a block edge is shared by the blocks on both sides
+	int bx1 = std::max((cornerRect.x1 - 1) >> BASE_BLOCK_SHIFT, 0);
+	int bz1 = std::max((cornerRect.z1 - 1) >> BASE_BLOCK_SHIFT, 0);
+	int bx2 = std::min( cornerRect.x2      >> BASE_BLOCK_SHIFT, levels[0].sizex - 1);
+	int bz2 = std::min( cornerRect.z2      >> BASE_BLOCK_SHIFT, levels[0].sizez - 1);
+
+	{
+		Level& lvl = levels[0];
+
+		for_mt_chunk(bz1, bz2 + 1, [&](const int bz) {
+			const int cz1 = bz << BASE_BLOCK_SHIFT;
+			const int cz2 = std::min((bz + 1) << BASE_BLOCK_SHIFT, mapy);
+
+			for (int bx = bx1; bx <= bx2; bx++) {
+				const int cx1 = bx << BASE_BLOCK_SHIFT;
+				const int cx2 = std::min((bx + 1) << BASE_BLOCK_SHIFT, mapx);
+
+				float2 bounds = {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+
+				for (int cz = cz1; cz <= cz2; cz++) {
+					const float* row = &cornerHeightMap[cz * mapxp1];
+
+					for (int cx = cx1; cx <= cx2; cx++) {
+						bounds.x = std::min(bounds.x, row[cx]);
+						bounds.y = std::max(bounds.y, row[cx]);
+					}
+				}
+
+				lvl.bounds[bz * lvl.sizex + bx] = bounds;
+			}
+		}, 16);
+	}
+
+	for (size_t level = 1; level < levels.size(); level++) {
+		const Level& src = levels[level - 1];
+		      Level& dst = levels[level    ];
+
+		bx1 >>= 1; bx2 >>= 1;
+		bz1 >>= 1; bz2 >>= 1;
+
+		for (int bz = bz1; bz <= bz2; bz++) {
+			for (int bx = bx1; bx <= bx2; bx++) {
+				float2 bounds = {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+
+				for (int sz = bz * 2, ez = std::min(bz * 2 + 2, src.sizez); sz < ez; sz++) {
+					for (int sx = bx * 2, ex = std::min(bx * 2 + 2, src.sizex); sx < ex; sx++) {
+						const float2& sb = src.bounds[sz * src.sizex + sx];
+
+						bounds.x = std::min(bounds.x, sb.x);
+						bounds.y = std::max(bounds.y, sb.y);
+					}
+				}
+
+				dst.bounds[bz * dst.sizex + bx] = bounds;
+			}
+		}
+	}
+}
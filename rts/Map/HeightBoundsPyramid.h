@@ -0,0 +1,63 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef HEIGHT_BOUNDS_PYRAMID_H
+#define HEIGHT_BOUNDS_PYRAMID_H
+
+#include <algorithm>
+#include <vector>
+
+#include "System/Rectangle.h"
+#include "System/type2.h"
+
+/**
+ * Hierarchical (min, max) corner-height bounds over blocks of heightmap squares.
+ * Level 0 blocks span 8x8 squares, every further level doubles the block size
+ * until a single block covers the whole map. Used to let ray and trajectory
+ * ground tests skip spans of squares that lie entirely below them.
+ */
+class CHeightBoundsPyramid {
+public:
+	static constexpr int BASE_BLOCK_SHIFT = 3;
+
+	void Init(int mapx, int mapy);
+	void Kill() { levels.clear(); }
+
+	/// recalculates every block touching the given (inclusive, corner-space) rectangle
+	void Update(const float* cornerHeightMap, const SRectangle& cornerRect);
+
+	int GetNumLevels() const { return (static_cast<int>(levels.size())); }
+
+	static int GetBlockShift(int level) { return (BASE_BLOCK_SHIFT + level); }
+
+	/// bounds (x=min, y=max) of the level-block containing square (sx, sz)
+	const float2& GetBlockBounds(int level, int sx, int sz) const {
+		const Level& lvl = levels[level];
+		const int shift = GetBlockShift(level);
+
+		return lvl.bounds[(sz >> shift) * lvl.sizex + (sx >> shift)];
+	}
+
+	/// inclusive square-space extent of the level-block containing square (sx, sz)
+	SRectangle GetBlockRect(int level, int sx, int sz) const {
+		const int shift = GetBlockShift(level);
+		const int x1 = (sx >> shift) << shift;
+		const int z1 = (sz >> shift) << shift;
+
+		return {x1, z1, std::min(x1 + (1 << shift), mapx) - 1, std::min(z1 + (1 << shift), mapy) - 1};
+	}
+
+private:
+	struct Level {
+		int sizex = 0;
+		int sizez = 0;
+
+		std::vector<float2> bounds;
+	};
+
+	std::vector<Level> levels;
+
+	int mapx = 0;
+	int mapy = 0;
+};
+
+#endif
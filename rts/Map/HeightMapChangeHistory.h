@@ -0,0 +1,69 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef HEIGHTMAP_CHANGE_HISTORY_H
+#define HEIGHTMAP_CHANGE_HISTORY_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "System/Rectangle.h"
+
+/**
+ * Bounded record of the synced heightmap rectangles changed per frame, for
+ * consumers (i.e. skirmish AIs) that poll for changes instead of receiving
+ * the UnsyncedHeightMapUpdate events.
+ */
+class CHeightMapChangeHistory {
+public:
+	static constexpr size_t MAX_CHANGES = 4096;
+
+	/// forgets every change, those made during or before <frame> become unknown
+	void Reset(int frame) {
+		changes.clear();
+		lostFrame = frame;
+	}
+
+	void Add(int frame, const SRectangle& rect) {
+		// consumers that fall behind fetch the entire map
+		if (changes.size() >= MAX_CHANGES) {
+			const auto dropEnd = changes.begin() + (MAX_CHANGES >> 1);
+
+			lostFrame = (dropEnd - 1)->first;
+			changes.erase(changes.begin(), dropEnd);
+		}
+
+		changes.emplace_back(frame, rect);
+	}
+
+	/**
+	 * Appends the rectangles changed during or after <frame> to <rects>;
+	 * passing the frame of the previous call thus also returns what was
+	 * changed later during that frame (and possibly some rectangles twice).
+	 * Returns false if those changes are no longer fully known.
+	 */
+	bool Get(int frame, std::vector<SRectangle>& rects) const {
+		if (frame <= lostFrame)
+			return false;
+
+		const auto pred = [](const std::pair<int, SRectangle>& change, int f) { return (change.first < f); };
+		const auto iter = std::lower_bound(changes.begin(), changes.end(), frame, pred);
+
+		for (auto it = iter; it != changes.end(); ++it) {
+			rects.push_back(it->second);
+		}
+
+		return true;
+	}
+
+	size_t Size() const { return changes.size(); }
+
+private:
+	/// (frame, center-rectangle) pairs, oldest first
+	std::vector<std::pair<int, SRectangle>> changes;
+
+	/// changes made during or before this frame were dropped
+	int lostFrame = -1;
+};
+
+#endif // HEIGHTMAP_CHANGE_HISTORY_H
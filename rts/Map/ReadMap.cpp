@@ -1,6 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring> // memcpy
 
@@ -65,6 +66,7 @@ CR_REG_METADATA(CReadMap, (
 	CR_IGNORED(unsyncedHeightInfo),
 	CR_IGNORED(boundingRadius),
 	CR_IGNORED(mapChecksum),
+	CR_IGNORED(syncedHeightMapChanges),
 
 	CR_IGNORED(heightMapSyncedPtr),
 	CR_IGNORED(heightMapUnsyncedPtr),
@@ -92,6 +94,7 @@ CR_REG_METADATA(CReadMap, (
 	CR_IGNORED(sharedFaceNormals),
 	CR_IGNORED(sharedCenterNormals),
 	CR_IGNORED(sharedSlopeMaps),
+	CR_IGNORED(heightBoundsPyramids),
 
 	CR_IGNORED(unsyncedHeightMapUpdates),
 
@@ -263,6 +266,9 @@ void CReadMap::SerializeTypeMap(creg::ISerializer* s)
 void CReadMap::PostLoad()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	// changes made before the save are not known
+	syncedHeightMapChanges.Reset(gs->frameNum);
+
 	sharedCornerHeightMaps[0] = &(*heightMapUnsyncedPtr)[0];
 	sharedCornerHeightMaps[1] = &(*heightMapSyncedPtr)[0];
 
@@ -399,6 +405,13 @@ void CReadMap::Initialize()
 
 	InitHeightBounds();
 
+	// the unsynced heightmap starts out identical, later updates arrive via UpdateDraw
+	for (CHeightBoundsPyramid& pyramid: heightBoundsPyramids) {
+		pyramid.Init(mapDims.mapx, mapDims.mapy);
+	}
+
+	heightBoundsPyramids[false].Update(GetCornerHeightMapUnsynced(), {0, 0, mapDims.mapx, mapDims.mapy});
+
 	syncedHeightMapDigests.clear();
 	unsyncedHeightMapDigests.clear();
 
@@ -503,6 +516,7 @@ void CReadMap::UpdateDraw(bool firstCall)
 
 	for (int i = 0; i < N; i++) {
 		UpdateHeightMapUnsynced(*(unsyncedHeightMapUpdates.begin() + i));
+		heightBoundsPyramids[false].Update(GetCornerHeightMapUnsynced(), *(unsyncedHeightMapUpdates.begin() + i));
 	};
 	UpdateHeightMapUnsyncedPost();
 
@@ -537,6 +551,8 @@ void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect)
 	UpdateFaceNormals(centerRect, initialize);
 	UpdateSlopemap(centerRect, initialize); // must happen after UpdateFaceNormals()!
 
+	heightBoundsPyramids[true].Update(GetCornerHeightMapSynced(), cornerRect);
+
 	// push the unsynced update; initial one without LOS check
 	if (initialize) {
 		unsyncedHeightMapUpdates.push_back(cornerRect);
@@ -559,6 +575,8 @@ void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect)
 		#endif
 
 		HeightMapUpdateLOSCheck(cornerRect);
+
+		syncedHeightMapChanges.Add(gs->frameNum, centerRect);
 	}
 }
 
@@ -914,6 +932,7 @@ void CReadMap::CopySyncedToUnsynced()
 	CopySyncedToUnsyncedImpl(*heightMapSyncedPtr, *heightMapUnsyncedPtr);
 	CopySyncedToUnsyncedImpl(faceNormalsSynced, faceNormalsUnsynced);
 	CopySyncedToUnsyncedImpl(centerNormalsSynced, centerNormalsUnsynced);
+	heightBoundsPyramids[false].Update(GetCornerHeightMapUnsynced(), {0, 0, mapDims.mapx, mapDims.mapy});
 	eventHandler.UnsyncedHeightMapUpdate(SRectangle{ 0, 0, mapDims.mapx, mapDims.mapy });
 }
 
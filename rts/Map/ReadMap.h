@@ -8,6 +8,8 @@
 
 #include "MapTexture.h"
 #include "MapDimensions.h"
+#include "HeightBoundsPyramid.h"
+#include "HeightMapChangeHistory.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "System/float3.h"
@@ -187,6 +189,7 @@ public:
 
 	/// shared interface
 	const float* GetSharedCornerHeightMap(bool synced) const { return sharedCornerHeightMaps[synced]; }
+	const CHeightBoundsPyramid& GetSharedHeightBoundsPyramid(bool synced) const { return heightBoundsPyramids[synced]; }
 	const float* GetSharedCenterHeightMap(bool synced) const { return sharedCenterHeightMaps[synced]; }
 	const float3* GetSharedFaceNormals(bool synced) const { return sharedFaceNormals[synced]; }
 	const float3* GetSharedCenterNormals(bool synced) const { return sharedCenterNormals[synced]; }
@@ -225,6 +228,16 @@ public:
 
 	bool GetHeightMapUpdated() const { return hmUpdated; }
 
+	/**
+	 * Appends the synced heightmap rectangles (in center-heightmap squares,
+	 * inclusive) that were changed during or after <frame> to <rects>.
+	 * Returns false if those changes are no longer fully known, in which
+	 * case the caller has to assume the entire map changed.
+	 */
+	bool GetSyncedHeightMapChanges(int frame, std::vector<SRectangle>& rects) const {
+		return syncedHeightMapChanges.Get(frame, rects);
+	}
+
 	virtual int2 GetPatch(int hmx, int hmz) const = 0;
 	virtual const float3& GetUnsyncedHeightInfo(int patchX, int patchZ) const = 0;
 private:
@@ -292,6 +305,9 @@ private:
 	const float3* sharedCenterNormals[2];
 	const float* sharedSlopeMaps[2];
 
+	/// min/max corner-height hierarchies over the shared corner heightmaps
+	CHeightBoundsPyramid heightBoundsPyramids[2];
+
 	/// these are not "digests", just simple rolling counters
 	/// for each LOS-map square the counter value indicates how many times
 	/// the synced heightmap block of squares corresponding to it has been
@@ -299,6 +315,9 @@ private:
 	static std::vector<uint8_t>   syncedHeightMapDigests;
 	static std::vector<uint8_t> unsyncedHeightMapDigests;
 
+	/// center-rectangles passed to UpdateHeightMapSynced
+	CHeightMapChangeHistory syncedHeightMapChanges;
+
 	uint32_t mapChecksum = 0;
 
 	bool processingHeightBounds = false;
@@ -4,6 +4,7 @@
 #define _GAME_PARTICIPANT_H
 
 #include <memory>
+#include <vector>
 
 #include "Game/Players/PlayerBase.h"
 #include "Game/Players/PlayerStatistics.h"
@@ -47,6 +48,8 @@ public:
 	bool isLocal = false;
 	bool isReconn = false;
 	bool isMidgameJoin = false;
+	/// receives broadcasts in delayed batches, see CGameServer::FlushSpecRelay
+	bool isRelayed = false;
 
 	PlayerStatistics lastStats;
 
@@ -69,6 +72,7 @@ public:
 
 	#ifdef SYNCCHECK
 	spring::unordered_map<int, unsigned int> syncResponse; // syncResponse[frameNum] = checksum
+	std::vector<uint32_t> syncSubsystems; // packed CSubsystemChecksums record, if requested
 	#endif
 
 private:
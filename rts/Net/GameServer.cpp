@@ -3,6 +3,7 @@
 #include "System/Net/UDPListener.h"
 #include "System/Net/UDPConnection.h"
 
+#include <algorithm>
 #include <functional>
 
 #if defined DEDICATED || defined DEBUG
@@ -55,6 +56,7 @@
 #include "System/Log/ILog.h"
 #include "System/Platform/errorhandler.h"
 #include "System/Platform/Threading.h"
+#include "System/Sync/SubsystemChecksums.h"
 #include "System/Threading/SpringThreading.h"
 
 #ifndef DEDICATED
@@ -76,6 +78,8 @@ CONFIG(bool, ServerRecordDemos).defaultValue(false).dedicatedValue(true);
 CONFIG(bool, ServerLogInfoMessages).defaultValue(false);
 CONFIG(bool, ServerLogDebugMessages).defaultValue(false);
 CONFIG(std::string, AutohostIP).defaultValue("127.0.0.1");
+CONFIG(int, SpectatorRelayInterval).defaultValue(0).minimumValue(0)
+	.description("If greater than zero, remote spectators receive the game stream in compressed batches sent every this many milliseconds instead of packet by packet. Relayed spectators are excluded from sync checks.");
 
 
 // use the specific section for all LOG*() calls in this source file
@@ -95,6 +99,9 @@ static constexpr unsigned SYNCCHECK_TIMEOUT = 300;
 /// used to prevent msg spam
 static constexpr unsigned SYNCCHECK_MSG_TIMEOUT = 400;
 
+/// frames to wait for the subsystem checksums of a desynced frame before giving up on missing clients
+static constexpr unsigned SYNCCHECK_SUBSYS_TIMEOUT = GAME_SPEED * 4;
+
 /// The time interval in msec for sending player statistics to each client
 static const spring_time playerInfoTime = spring_secs(2);
 
@@ -163,6 +170,7 @@ void CGameServer::Initialize()
 	whiteListAdditionalPlayers = configHandler->GetBool("WhiteListAdditionalPlayers");
 	logInfoMessages = configHandler->GetBool("ServerLogInfoMessages");
 	logDebugMessages = configHandler->GetBool("ServerLogDebugMessages");
+	specRelayInterval = spring_msecs(configHandler->GetInt("SpectatorRelayInterval"));
 
 	rng.Seed((myGameData->GetSetupText()).length());
 
@@ -550,9 +558,15 @@ bool CGameServer::SendDemoData(int targetFrameNum)
 void CGameServer::Broadcast(std::shared_ptr<const netcode::RawPacket> packet)
 {
 	for (GameParticipant& p: players) {
+		if (p.isRelayed)
+			continue;
+
 		p.SendData(packet);
 	}
 
+	if (numRelayedSpecs > 0)
+		specRelay.Append(packet);
+
 	if (canReconnect || allowSpecJoin || !gameHasStarted)
 		packetCache.push_back(packet);
 
@@ -560,6 +574,43 @@ void CGameServer::Broadcast(std::shared_ptr<const netcode::RawPacket> packet)
 		demoRecorder->SaveToDemo(packet->data, packet->length, GetDemoTime());
 }
 
+
+bool CGameServer::IsSpecRelayCandidate(const GameParticipant& p) const
+{
+	if (!specRelayInterval.isDuration() || demoReader != nullptr)
+		return false;
+
+	return (p.spectator && !p.isLocal && !p.isFromDemo && p.clientLink != nullptr);
+}
+
+void CGameServer::SetSpecRelayed(GameParticipant& p, bool relayed)
+{
+	if (p.isRelayed == relayed)
+		return;
+
+	// everyone already relayed gets the pending batch first, so
+	// <p> neither misses nor receives any broadcast twice
+	FlushSpecRelay();
+
+	p.isRelayed = relayed;
+	numRelayedSpecs += (relayed? 1: -1);
+}
+
+void CGameServer::SendToRelayedSpecs(std::shared_ptr<const netcode::RawPacket> packet)
+{
+	for (GameParticipant& p: players) {
+		if (p.isRelayed)
+			p.SendData(packet);
+	}
+}
+
+void CGameServer::FlushSpecRelay()
+{
+	lastSpecRelayFlush = spring_gettime();
+	specRelay.Flush();
+}
+
+
 void CGameServer::Message(const std::string& message, bool broadcast, bool internal)
 {
 	if (!internal) {
@@ -580,6 +631,10 @@ void CGameServer::Message(const std::string& message, bool broadcast, bool inter
 }
 
 void CGameServer::PrivateMessage(int playerNum, const std::string& message) {
+	// must not overtake broadcasts still waiting in the relay batch
+	if (players[playerNum].isRelayed)
+		FlushSpecRelay();
+
 	players[playerNum].SendData(CBaseNetProtocol::Get().SendSystemMessage(SERVER_PLAYER, message));
 }
 
@@ -621,7 +676,7 @@ void CGameServer::CheckSync()
 			checksums.reserve(players.size());
 
 			for (const GameParticipant& p: players) {
-				if (p.clientLink == nullptr || p.myState == GameParticipant::State::DISCONNECTING)
+				if (p.clientLink == nullptr || p.myState == GameParticipant::State::DISCONNECTING || p.isRelayed)
 					continue;
 
 				const auto pChecksumIt = p.syncResponse.find(outstandingSyncFrame);
@@ -673,7 +728,8 @@ void CGameServer::CheckSync()
 		desyncSpecs.clear();
 
 		for (GameParticipant& p: players) {
-			if (p.clientLink == nullptr || p.myState == GameParticipant::State::DISCONNECTING)
+			// relayed spectators run behind by up to a batch interval
+			if (p.clientLink == nullptr || p.myState == GameParticipant::State::DISCONNECTING || p.isRelayed)
 				continue;
 
 			const auto pChecksumIt = p.syncResponse.find(outstandingSyncFrame);
@@ -732,10 +788,20 @@ void CGameServer::CheckSync()
 			#endif
 
 				if (!desyncHasOccurred) {
-					if (globalConfig.dumpGameStateOnDesync) {
-						LOG("Desync detected. Requesting all clients to collect game state information.");
-						Broadcast(CBaseNetProtocol::Get().SendGameStateDump(syncErrorFrame));
+					// narrow the desync down first, CheckSyncSubsystems requests the state dump
+					// clients only hash the frame they are asked for, so this has to be one none of
+					// them has simulated yet; the request arrives ahead of its NETMSG_NEWFRAME
+					LOG("Desync detected in frame %d. Requesting subsystem checksums for frame %d.", syncErrorFrame, serverFrameNum + 1);
+
+					for (GameParticipant& p: players) {
+						p.syncSubsystems.clear();
 					}
+
+					syncSubsystemsFrame = serverFrameNum + 1;
+					syncSubsystemsDesyncFrame = syncErrorFrame;
+					syncSubsystemsTimeout = syncSubsystemsFrame + SYNCCHECK_SUBSYS_TIMEOUT;
+
+					Broadcast(CBaseNetProtocol::Get().SendSyncSubsystemsRequest(syncSubsystemsFrame));
 					desyncHasOccurred = true;
 				}
 
@@ -776,6 +842,8 @@ void CGameServer::CheckSync()
 		++outstandingSyncFrameIt;
 	}
 
+	CheckSyncSubsystems();
+
 #else
 
 	// Make it clear this build isn't suitable for release.
@@ -787,6 +855,108 @@ void CGameServer::CheckSync()
 }
 
 
+void CGameServer::CheckSyncSubsystems()
+{
+#ifdef SYNCCHECK
+	if (syncSubsystemsFrame < 0)
+		return;
+
+	std::vector< std::pair<int, CSubsystemChecksums::Record> > records; // <playerNum, record>
+	records.reserve(players.size());
+
+	for (const GameParticipant& p: players) {
+		if (p.clientLink == nullptr || p.myState == GameParticipant::State::DISCONNECTING || p.isRelayed)
+			continue;
+
+		CSubsystemChecksums::Record record;
+
+		if (!CSubsystemChecksums::Unpack(p.syncSubsystems, record) || record.frameNum != syncSubsystemsFrame) {
+			// keep waiting for this client unless it ran out of time
+			if (serverFrameNum < syncSubsystemsTimeout)
+				return;
+
+			continue;
+		}
+
+		records.emplace_back(p.id, record);
+	}
+
+	const auto SameRecord = [](const CSubsystemChecksums::Record& a, const CSubsystemChecksums::Record& b) {
+		return (CSubsystemChecksums::CompareSubsystems(a, b) == 0 && CSubsystemChecksums::CompareUnitBuckets(a, b) == 0);
+	};
+
+	// same baseline as CheckSync: the local client's record, or the one most clients agree on
+	const CSubsystemChecksums::Record* correctRecord = nullptr;
+	size_t maxRecordCount = 0;
+
+	for (const auto& [playerNum, record]: records) {
+		if (HasLocalClient()) {
+			if (playerNum != static_cast<int>(localClientNumber))
+				continue;
+
+			correctRecord = &record;
+			break;
+		}
+
+		const size_t recordCount = std::count_if(records.begin(), records.end(), [&](const auto& r) { return SameRecord(r.second, record); });
+
+		if (recordCount > maxRecordCount) {
+			maxRecordCount = recordCount;
+			correctRecord = &record;
+		}
+	}
+
+	uint32_t subsystemMask = 0;
+	uint64_t unitBucketMask = 0;
+
+	for (const auto& [playerNum, record]: records) {
+		if (correctRecord == nullptr)
+			break;
+
+		const uint32_t playerSubsystemMask = CSubsystemChecksums::CompareSubsystems(record, *correctRecord);
+		const uint64_t playerUnitBucketMask = CSubsystemChecksums::CompareUnitBuckets(record, *correctRecord);
+
+		if (playerSubsystemMask == 0 && playerUnitBucketMask == 0)
+			continue;
+
+		const std::string& subsystemNames = CSubsystemChecksums::GetSubsystemNames(playerSubsystemMask);
+		const auto unitIDRange = CSubsystemChecksums::GetUnitIDRange(playerUnitBucketMask, correctRecord->unitsPerBucket);
+
+		LOG_L(L_ERROR, "[GameServer::%s] player %s diverged in frame %d: %s (unit IDs %d to %d)", __func__, players[playerNum].name.c_str(), syncSubsystemsFrame, subsystemNames.c_str(), unitIDRange.first, unitIDRange.second);
+
+		subsystemMask |= playerSubsystemMask;
+		unitBucketMask |= playerUnitBucketMask;
+	}
+
+	int32_t minUnitID = -1;
+	int32_t maxUnitID = -1;
+
+	if (subsystemMask != 0) {
+		Message(spring::format(SyncSubsystemsError, syncSubsystemsFrame, CSubsystemChecksums::GetSubsystemNames(subsystemMask).c_str()));
+	} else {
+		// nothing covered by the subsystem checksums diverged (or nobody answered), dump everything
+		subsystemMask = -1u;
+	}
+
+	if (unitBucketMask != 0) {
+		std::tie(minUnitID, maxUnitID) = CSubsystemChecksums::GetUnitIDRange(unitBucketMask, correctRecord->unitsPerBucket);
+		Message(spring::format(SyncSubsystemsUnitIDs, syncSubsystemsFrame, minUnitID, maxUnitID));
+	}
+
+	if (globalConfig.dumpGameStateOnDesync) {
+		LOG("Requesting all clients to collect game state information.");
+		Broadcast(CBaseNetProtocol::Get().SendGameStateDump(syncSubsystemsDesyncFrame, minUnitID, maxUnitID, subsystemMask));
+	}
+
+	for (GameParticipant& p: players) {
+		p.syncSubsystems.clear();
+	}
+
+	syncSubsystemsFrame = -1;
+#endif
+}
+
+
 float CGameServer::GetDemoTime() const {
 	if (!gameHasStarted) return gameTime;
 	return (startTime + serverFrameNum * INV_GAME_SPEED);
@@ -844,6 +1014,9 @@ void CGameServer::Update()
 	else if (!PreSimFrame() || demoReader != nullptr)
 		CreateNewFrame(true, false);
 
+	if (numRelayedSpecs > 0 && spring_gettime() >= (lastSpecRelayFlush + specRelayInterval))
+		FlushSpecRelay();
+
 	if (hostif != nullptr) {
 		const std::string msg = hostif->GetChatMessage();
 
@@ -1106,6 +1279,7 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 		case NETMSG_QUIT: {
 			Message(spring::format(PlayerLeft, players[a].GetType(), players[a].name.c_str(), " normal quit"));
 			Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(a, 1));
+			SetSpecRelayed(players[a], false);
 			players[a].Kill("[GameServer] user exited", true);
 			if (hostif != nullptr)
 				hostif->SendPlayerLeft(a, 1);
@@ -1144,6 +1318,17 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			Broadcast(CBaseNetProtocol::Get().SendPathCheckSum(playerNum, playerCheckSum));
 		} break;
 
+		case NETMSG_DEFS_CHECKSUM: {
+			const unsigned char playerNum = inbuf[1];
+			const std::uint32_t playerCheckSum = *(std::uint32_t*) &inbuf[2];
+			const std::uint8_t playerCached = inbuf[6];
+			if (playerNum != a) {
+				Message(spring::format(WrongPlayer, msgCode, a, playerNum));
+				break;
+			}
+			Broadcast(CBaseNetProtocol::Get().SendDefsCheckSum(playerNum, playerCheckSum, playerCached));
+		} break;
+
 		case NETMSG_CHAT: {
 			try {
 				ChatMessage msg(packet);
@@ -1362,7 +1547,7 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 			assert(a == playerNum);
 			GameParticipant& p = players[a];
 
-			if (outstandingSyncFrames.find(frameNum) != outstandingSyncFrames.end())
+			if (!p.isRelayed && outstandingSyncFrames.find(frameNum) != outstandingSyncFrames.end())
 				p.syncResponse[frameNum] = checkSum;
 
 			// update player's ping (if !defined(SYNCCHECK) this is done in NETMSG_KEYFRAME)
@@ -1378,6 +1563,30 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 #endif
 		} break;
 
+		case NETMSG_SYNC_SUBSYSTEMS: {
+#ifdef SYNCCHECK
+			try {
+				netcode::UnpackPacket pckt(packet, sizeof(uint8_t) + sizeof(uint16_t));
+
+				uint8_t playerNum;
+				pckt >> playerNum;
+
+				if (playerNum != a) {
+					Message(spring::format(WrongPlayer, msgCode, a, (unsigned)playerNum));
+					break;
+				}
+
+				std::vector<uint32_t>& checksums = players[a].syncSubsystems;
+
+				checksums.resize(CSubsystemChecksums::PACKED_SIZE);
+				pckt >> checksums;
+			} catch (const netcode::UnpackPacketException& ex) {
+				players[a].syncSubsystems.clear();
+				Message(spring::format("[GameServer::%s][NETMSG_SYNC_SUBSYSTEMS] exception \"%s\" from player \"%s\"", __func__, ex.what(), players[a].name.c_str()));
+			}
+#endif
+		} break;
+
 		case NETMSG_SHARE:
 			if (inbuf[1] != a) {
 				Message(spring::format(WrongPlayer, msgCode, a, (unsigned)inbuf[1]));
@@ -1578,6 +1787,8 @@ void CGameServer::ProcessPacket(const unsigned playerNum, std::shared_ptr<const
 					players[player].team      = newTeamID;
 					players[player].spectator = false;
 
+					SetSpecRelayed(players[player], false);
+
 					if (!teams[newTeamID].HasLeader())
 						teams[newTeamID].SetLeader(player);
 
@@ -1965,6 +2176,7 @@ void CGameServer::ServerReadNet()
 			Message(spring::format(PlayerLeft, player.GetType(), player.name.c_str(), " timeout"));
 			Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(player.id, 0));
 
+			SetSpecRelayed(player, false);
 			player.Kill("User timeout");
 
 			if (hostif != nullptr)
@@ -2734,6 +2946,7 @@ void CGameServer::UpdateLoop()
 		LOG("%s: thread affinity %x", __func__, Threading::GetAffinity());
 
 		Broadcast(CBaseNetProtocol::Get().SendQuit("Server shutdown"));
+		FlushSpecRelay();
 
 		// this is to make sure the Flush has any effect at all (we don't want a forced flush)
 		// when reloading, we can assume there is only a local client and skip the sleep()'s
@@ -2765,6 +2978,7 @@ void CGameServer::KickPlayer(int playerNum)
 	Message(spring::format(PlayerLeft, players[playerNum].GetType(), players[playerNum].name.c_str(), "kicked"));
 	Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(playerNum, 2));
 
+	SetSpecRelayed(players[playerNum], false);
 	players[playerNum].Kill("Kicked from the battle", true);
 
 	if (hostif != nullptr)
@@ -3021,6 +3235,9 @@ unsigned CGameServer::BindConnection(
 		return newPlayerNumber;
 	}
 
+	// a new link starts from the packet cache, not from the pending relay batch
+	SetSpecRelayed(newPlayer, false);
+
 	newPlayer.Connected(clientLink, isLocal);
 	newPlayer.SendData(std::shared_ptr<const RawPacket>(myGameData->Pack()));
 	newPlayer.SendData(CBaseNetProtocol::Get().SendSetPlayerNum((unsigned char)newPlayerNumber));
@@ -3045,6 +3262,8 @@ unsigned CGameServer::BindConnection(
 	for (const std::shared_ptr<const netcode::RawPacket>& p: packetCache)
 		newPlayer.SendData(p);
 
+	SetSpecRelayed(newPlayer, IsSpecRelayCandidate(newPlayer));
+
 	// new connection established
 	Message(spring::format(" -> Connection established (given id %i)", newPlayerNumber));
 	clientLink->SetLossFactor(netloss);
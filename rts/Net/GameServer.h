@@ -20,6 +20,7 @@
 #include "System/float3.h"
 #include "System/GlobalRNG.h"
 #include "System/Misc/SpringTime.h"
+#include "System/Net/RelayBatch.h"
 #include "System/Threading/SpringThreading.h"
 
 /**
@@ -161,6 +162,7 @@ private:
 	void Update();
 	void ProcessPacket(const unsigned playerNum, std::shared_ptr<const netcode::RawPacket> packet);
 	void CheckSync();
+	void CheckSyncSubsystems();
 	void HandleConnectionAttempts();
 	void ServerReadNet();
 
@@ -175,6 +177,23 @@ private:
 
 	void Broadcast(std::shared_ptr<const netcode::RawPacket> packet);
 
+	/**
+	 * @brief spectator relay
+	 *
+	 * Relayed spectators do not get broadcasts individually; the packets are
+	 * appended once to specRelay which is deflated and sent to all of them
+	 * every specRelayInterval. Membership only changes at batch bounds.
+	 *
+	 * Anything sent to a relayed spectator directly (SendData) bypasses the
+	 * batch and arrives ahead of the broadcasts still pending in it. Messages
+	 * whose order matters flush the batch first (PrivateMessage, Kill via
+	 * SetSpecRelayed); pings and frame-progress updates are not ordered.
+	 */
+	bool IsSpecRelayCandidate(const GameParticipant& p) const;
+	void SetSpecRelayed(GameParticipant& p, bool relayed);
+	void SendToRelayedSpecs(std::shared_ptr<const netcode::RawPacket> packet);
+	void FlushSpecRelay();
+
 	/**
 	 * @brief skip frames
 	 *
@@ -223,9 +242,17 @@ private:
 
 	std::deque< std::shared_ptr<const netcode::RawPacket> > packetCache;
 
+	/// broadcasts not yet sent to relayed spectators
+	netcode::RelayBatch specRelay{[this](std::shared_ptr<const netcode::RawPacket> packet) { SendToRelayedSpecs(packet); }};
+
 	/////////////////// sync stuff ///////////////////
 #ifdef SYNCCHECK
 	std::set<int> outstandingSyncFrames;
+
+	// frame whose subsystem checksums have been requested, the desync that caused it, and the server frame to stop waiting at
+	int syncSubsystemsFrame = -1;
+	int syncSubsystemsDesyncFrame = -1;
+	int syncSubsystemsTimeout = 0;
 #endif
 
 	/////////////////// game status variables ///////////////////
@@ -236,6 +263,9 @@ private:
 	spring_time lastPlayerInfo = spring_notime;
 	spring_time lastUpdate = spring_notime;
 	spring_time lastBandwidthUpdate = spring_notime;
+	spring_time lastSpecRelayFlush = spring_notime;
+	/// zero if spectators are not relayed
+	spring_time specRelayInterval = spring_notime;
 
 	float modGameTime = 0.0f;
 	float gameTime = 0.0f;
@@ -258,6 +288,7 @@ private:
 	bool desyncHasOccurred = false;
 
 	int linkMinPacketSize = 1;
+	int numRelayedSpecs = 0;
 
 	unsigned localClientNumber = -1u;
 
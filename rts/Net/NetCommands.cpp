@@ -9,6 +9,7 @@
 #include "ExternalAI/SkirmishAIHandler.h"
 #include "Game/ClientData.h"
 #include "Game/CommandMessage.h"
+#include "Game/DefsSnapshot.h"
 #include "Game/GameSetup.h"
 #include "Game/GlobalUnsynced.h"
 #include "Game/SelectedUnitsHandler.h"
@@ -38,6 +39,7 @@
 #include "System/Sound/ISound.h"
 #include "System/Sync/DumpState.h"
 #include "System/Sync/DumpHistory.h"
+#include "System/Sync/SubsystemChecksums.h"
 
 #include "System/Misc/TracyDefs.h"
 
@@ -590,6 +592,53 @@ void CGame::ClientReadNet()
 				}
 			} break;
 
+			case NETMSG_DEFS_CHECKSUM: {
+				ZoneScopedN("Net::DefsChecksum");
+				const uint8_t playerNum = inbuf[1];
+
+				if (!playerHandler.IsValidPlayer(playerNum)) {
+					LOG_L(L_ERROR, "[Game::%s][NETMSG_DEFS_CHECKSUM] invalid player-number %i", __func__, playerNum);
+					break;
+				}
+
+				const std::uint32_t playerCheckSum = *reinterpret_cast<const std::uint32_t*>(&inbuf[2]);
+				const std::uint32_t localCheckSum = defsSnapshot.GetChecksum();
+				const bool playerCached = inbuf[6];
+
+				// zero means the defs were not representable as a snapshot on that side
+				if (playerCheckSum == 0 || localCheckSum == 0)
+					break;
+				if (playerCheckSum == localCheckSum)
+					break;
+
+				const CPlayer* player = playerHandler.Player(playerNum);
+				const char* pType = player->IsSpectator()? "spectator": "player";
+
+				if (defsSnapshot.IsCached() && !playerCached) {
+					// the other side ran defs.lua, so ours came from a stale or corrupt
+					// cache and the sim is running on the wrong definitions; drop the
+					// cache so that the next start runs defs.lua again, and leave
+					LOG_L(L_ERROR,
+						"[Game::%s][NETMSG_DEFS_CHECKSUM] defs-checksum %08x for %s %d (%s) does not match cached local checksum %08x; removed the stale defs-cache, restart to rejoin",
+						__func__, playerCheckSum, pType, playerNum, player->name.c_str(), localCheckSum
+					);
+					defsSnapshot.RemoveCacheFile();
+					gu->globalQuit = true;
+					break;
+				}
+
+				// either the other side loaded a stale cache (and leaves by itself), or
+				// both did and there is no telling which one is wrong
+				LOG_L(L_WARNING,
+					"[DESYNC WARNING] defs-checksum %08x for %s %d (%s) does not match local checksum %08x%s",
+					playerCheckSum, pType, playerNum, player->name.c_str(), localCheckSum,
+					playerCached? "; stale defs-cache?": ""
+				);
+
+				if (defsSnapshot.IsCached())
+					defsSnapshot.RemoveCacheFile();
+			} break;
+
 			case NETMSG_KEYFRAME: {
 				ZoneScopedN("Net::KeyFrame");
 				if (!gameOver) {
@@ -1572,11 +1621,52 @@ void CGame::ClientReadNet()
 			case NETMSG_GAMESTATE_DUMP: {
 				ZoneScopedN("Net::GamestateDump");
 				LOG("Collecting current game state information.");
-				const uint32_t desyncFrameNum = *reinterpret_cast<const uint32_t*>(inbuf + 1);
-				DumpState(gs->frameNum, gs->frameNum, 1, true, desyncFrameNum, true);
+
+				try {
+					netcode::UnpackPacket pckt(packet, 1);
+
+					uint32_t desyncFrameNum;
+					int32_t minUnitID;
+					int32_t maxUnitID;
+					uint32_t subsystemMask;
+
+					pckt >> desyncFrameNum;
+					pckt >> minUnitID;
+					pckt >> maxUnitID;
+					pckt >> subsystemMask;
+
+					DumpStateFilter filter;
+					filter.subsystemMask = subsystemMask;
+
+					if (minUnitID >= 0) {
+						filter.minUnitID = minUnitID;
+						filter.maxUnitID = maxUnitID;
+					}
+
+					DumpState(gs->frameNum, gs->frameNum, 1, true, desyncFrameNum, true, filter);
+				} catch (const netcode::UnpackPacketException& ex) {
+					LOG_L(L_ERROR, "[Game::%s][NETMSG_GAMESTATE_DUMP] exception \"%s\"", __func__, ex.what());
+				}
 				break;
 			}
 
+			case NETMSG_SYNC_SUBSYSTEMS_REQUEST: {
+#ifdef SYNCCHECK
+				ZoneScopedN("Net::SyncSubsystemsRequest");
+
+				// the server asks for a frame past any it has sent, SimFrame answers once there
+				const int32_t requestFrameNum = *reinterpret_cast<const int32_t*>(inbuf + 1);
+
+				if (requestFrameNum <= gs->frameNum) {
+					LOG_L(L_WARNING, "[Game::%s] subsystem checksums requested for past frame %d (current frame %d)", __func__, requestFrameNum, gs->frameNum);
+					break;
+				}
+
+				CSubsystemChecksums::Request(requestFrameNum);
+#endif
+				AddTraffic(-1, packetCode, dataLength);
+			} break;
+
 			default: {
 #ifdef SYNCDEBUG
 				if (!CSyncDebugger::GetInstance()->ClientReceived(inbuf))
@@ -7,7 +7,9 @@
 #include "System/Net/RawPacket.h"
 #include "System/Net/PackPacket.h"
 #include "System/Net/ProtocolDef.h"
+#include <cassert>
 #include <cinttypes>
+#include <limits>
 
 using netcode::PackPacket;
 typedef std::shared_ptr<const netcode::RawPacket> PacketType;
@@ -94,6 +96,15 @@ PacketType CBaseNetProtocol::SendPathCheckSum(uint8_t playerNum, uint32_t checks
 	return PacketType(packet);
 }
 
+PacketType CBaseNetProtocol::SendDefsCheckSum(uint8_t playerNum, uint32_t checksum, uint8_t cached)
+{
+	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(playerNum) + sizeof(uint32_t) + sizeof(cached), NETMSG_DEFS_CHECKSUM);
+	*packet << playerNum;
+	*packet << checksum;
+	*packet << cached;
+	return PacketType(packet);
+}
+
 
 PacketType CBaseNetProtocol::SendSelect(uint8_t playerNum, const std::vector<int16_t>& selectedUnitIDs)
 {
@@ -605,13 +616,44 @@ PacketType CBaseNetProtocol::SendSdBlockresponse(uint8_t playerNum, std::vector<
 }
 #endif // SYNCDEBUG
 
-PacketType CBaseNetProtocol::SendGameStateDump(uint32_t frameNum)
+PacketType CBaseNetProtocol::SendGameStateDump(uint32_t frameNum, int32_t minUnitID, int32_t maxUnitID, uint32_t subsystemMask)
+{
+	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(frameNum) + sizeof(minUnitID) + sizeof(maxUnitID) + sizeof(subsystemMask), NETMSG_GAMESTATE_DUMP);
+	*packet << frameNum << minUnitID << maxUnitID << subsystemMask;
+	return PacketType(packet);
+}
+
+PacketType CBaseNetProtocol::SendSyncSubsystemsRequest(int32_t frameNum)
 {
-	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(frameNum), NETMSG_GAMESTATE_DUMP);
+	PackPacket* packet = new PackPacket(sizeof(uint8_t) + sizeof(frameNum), NETMSG_SYNC_SUBSYSTEMS_REQUEST);
 	*packet << frameNum;
 	return PacketType(packet);
 }
 
+PacketType CBaseNetProtocol::SendSyncSubsystems(uint8_t playerNum, const std::vector<uint32_t>& checksums)
+{
+	const uint32_t payloadSize = sizeof(playerNum) + (checksums.size() * sizeof(uint32_t));
+	const uint32_t headerSize = sizeof(uint8_t) + sizeof(uint16_t);
+	const uint32_t packetSize = headerSize + payloadSize;
+
+	PackPacket* packet = new PackPacket(packetSize, NETMSG_SYNC_SUBSYSTEMS);
+	*packet << static_cast<uint16_t>(packetSize) << playerNum << checksums;
+	return PacketType(packet);
+}
+
+PacketType CBaseNetProtocol::SendRelayedPackets(const std::vector<uint8_t>& deflData)
+{
+	const uint32_t payloadSize = deflData.size();
+	const uint32_t headerSize = sizeof(uint8_t) + sizeof(uint16_t);
+	const uint32_t packetSize = headerSize + payloadSize;
+
+	assert(packetSize <= std::numeric_limits<uint16_t>::max());
+
+	PackPacket* packet = new PackPacket(packetSize, NETMSG_RELAYED_PACKETS);
+	*packet << static_cast<uint16_t>(packetSize) << deflData;
+	return PacketType(packet);
+}
+
 CBaseNetProtocol::CBaseNetProtocol()
 {
 	netcode::ProtocolDef* proto = netcode::ProtocolDef::GetInstance();
@@ -672,6 +714,8 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_AI_STATE_CHANGED, 4);
 	proto->AddType(NETMSG_GAME_FRAME_PROGRESS, 5);
 	proto->AddType(NETMSG_PING, 1 + (1 + 1 + 4));
+	proto->AddType(NETMSG_RELAYED_PACKETS, -2);
+	proto->AddType(NETMSG_DEFS_CHECKSUM, 1 + 1 + sizeof(uint32_t) + 1);
 
 #ifdef SYNCDEBUG
 	proto->AddType(NETMSG_SD_CHKREQUEST, 5);
@@ -681,6 +725,8 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_SD_BLKRESPONSE, -2);
 #endif // SYNCDEBUG
 
-	proto->AddType(NETMSG_GAMESTATE_DUMP, 1 + sizeof(uint32_t));
+	proto->AddType(NETMSG_GAMESTATE_DUMP, 1 + 4 * sizeof(uint32_t));
+	proto->AddType(NETMSG_SYNC_SUBSYSTEMS_REQUEST, 1 + sizeof(int32_t));
+	proto->AddType(NETMSG_SYNC_SUBSYSTEMS, -2);
 }
 
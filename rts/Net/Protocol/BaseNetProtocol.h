@@ -51,6 +51,7 @@ public:
 	PacketType SendRandSeed(uint32_t randSeed);
 	PacketType SendGameID(const uint8_t* buf);
 	PacketType SendPathCheckSum(uint8_t playerNum, uint32_t checksum);
+	PacketType SendDefsCheckSum(uint8_t playerNum, uint32_t checksum, uint8_t cached);
 	PacketType SendSelect(uint8_t playerNum, const std::vector<int16_t>& selectedUnitIDs);
 	PacketType SendPause(uint8_t playerNum, uint8_t bPaused);
 
@@ -118,7 +119,11 @@ public:
 	PacketType SendSdBlockresponse(uint8_t playerNum, std::vector<uint32_t> checksums);
 #endif
 
-	PacketType SendGameStateDump(uint32_t frameNum);
+	PacketType SendGameStateDump(uint32_t frameNum, int32_t minUnitID = -1, int32_t maxUnitID = -1, uint32_t subsystemMask = -1u);
+	PacketType SendSyncSubsystemsRequest(int32_t frameNum);
+	PacketType SendSyncSubsystems(uint8_t playerNum, const std::vector<uint32_t>& checksums);
+
+	PacketType SendRelayedPackets(const std::vector<uint8_t>& deflData);
 
 private:
 	CBaseNetProtocol();
@@ -66,7 +66,9 @@ enum NETMSG {
 	NETMSG_SD_RESET         = 45,
 #endif // SYNCDEBUG
 
-	NETMSG_GAMESTATE_DUMP	= 46, // no arguments
+	NETMSG_GAMESTATE_DUMP	= 46, // uint32_t frameNum; int32_t minUnitID, maxUnitID; uint32_t subsystemMask;
+	NETMSG_SYNC_SUBSYSTEMS_REQUEST = 47, // int32_t frameNum;
+	NETMSG_SYNC_SUBSYSTEMS  = 48, // uint16_t messageSize; uint8_t playerNum; std::vector<uint32_t> checksums (see CSubsystemChecksums::Pack)
 
 	NETMSG_LOGMSG           = 49, // uint8_t playerNum, uint8_t logMsgLvl, std::string strData
 	NETMSG_LUAMSG           = 50, // /* uint16_t messageSize */, uint8_t playerNum, uint16_t script, uint8_t mode, std::vector<uint8_t> rawData
@@ -95,6 +97,10 @@ enum NETMSG {
 
 	NETMSG_PING = 78, // uint8_t playerNum, uint8_t pingTag, float localTime
 
+	NETMSG_RELAYED_PACKETS = 79, // uint16_t messageSize, std::vector<uint8_t> deflData # zlib-compressed concatenation of broadcast messages, sent to relayed spectators; unpacked by UDPConnection #
+
+	NETMSG_DEFS_CHECKSUM   = 80, // uint8_t playerNum, uint32_t checksum, uint8_t cached
+
 	NETMSG_LAST //max types of netmessages, internal only
 };
 
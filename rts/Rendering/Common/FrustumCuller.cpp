@@ -0,0 +1,92 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "FrustumCuller.h"
+
+#include "xsimd/xsimd.hpp"
+
+#include "System/Misc/TracyDefs.h"
+
+void CFrustumCuller::SetCameras(
+	uint32_t camTypeMask,
+	const std::array<FrustumPlanes, MAX_CAMERAS>& planes,
+	const std::array<uint8_t, MAX_CAMERAS>& planesMasks
+) {
+	RECOIL_DETAILED_TRACY_ZONE;
+	numCameras = 0;
+
+	for (uint32_t camType = 0; camType < MAX_CAMERAS; ++camType) {
+		if ((camTypeMask & (1 << camType)) == 0)
+			continue;
+
+		CameraPlanes& cp = cameras[numCameras++];
+		cp.numPlanes = 0;
+		cp.camType = camType;
+
+		for (uint32_t i = 0; i < CCamera::FRUSTUM_PLANE_CNT; ++i) {
+			if ((planesMasks[camType] & (1 << i)) == 0)
+				continue;
+
+			cp.planes[cp.numPlanes++] = planes[camType][i];
+		}
+	}
+}
+
+void CFrustumCuller::Resize(size_t numObjs)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const size_t paddedSize = ((numObjs + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE;
+
+	numObjects = numObjs;
+
+	// padding lanes stay zero, their results are never read
+	posX.resize(paddedSize, 0.0f);
+	posY.resize(paddedSize, 0.0f);
+	posZ.resize(paddedSize, 0.0f);
+	radii.resize(paddedSize, 0.0f);
+
+	inViewMasks.resize(paddedSize, 0);
+}
+
+void CFrustumCuller::CullBlock(size_t block)
+{
+	using BatchType = xsimd::simd_type<float>;
+	constexpr size_t BATCH_SIZE = xsimd::simd_traits<float>::size;
+
+	static_assert((BLOCK_SIZE % BATCH_SIZE) == 0);
+
+	const size_t beg = GetBlockBeg(block);
+	const size_t end = beg + BLOCK_SIZE;
+
+	for (size_t i = beg; i < end; i += BATCH_SIZE) {
+		const BatchType x = xsimd::load_unaligned(&posX[i]);
+		const BatchType y = xsimd::load_unaligned(&posY[i]);
+		const BatchType z = xsimd::load_unaligned(&posZ[i]);
+		const BatchType r = xsimd::load_unaligned(&radii[i]);
+
+		// bits are accumulated as (exact) floats so one store yields all masks
+		BatchType maskBits(0.0f);
+
+		for (size_t c = 0; c < numCameras; ++c) {
+			const CameraPlanes& cp = cameras[c];
+
+			xsimd::simd_bool_type<float> inView(true);
+
+			for (uint32_t p = 0; p < cp.numPlanes; ++p) {
+				const float4& plane = cp.planes[p];
+				const BatchType dist = x * BatchType(plane.x) + y * BatchType(plane.y) + z * BatchType(plane.z) + BatchType(plane.w);
+
+				// same comparison as Frustum::IntersectSphere, NaN counts as inside
+				inView = inView && !(dist < -r);
+			}
+
+			maskBits = xsimd::select(inView, maskBits + BatchType(static_cast<float>(1 << cp.camType)), maskBits);
+		}
+
+		std::array<float, BATCH_SIZE> masks;
+		xsimd::store_unaligned(masks.data(), maskBits);
+
+		for (size_t j = 0; j < BATCH_SIZE; ++j) {
+			inViewMasks[i + j] = static_cast<uint8_t>(masks[j]);
+		}
+	}
+}
@@ -0,0 +1,88 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Game/Camera.h"
+#include "System/float3.h"
+#include "System/float4.h"
+
+/**
+ * @brief Batched sphere-vs-frustum culling for the draw-flag updates
+ *
+ * Keeps the draw-spheres (drawMidPos, radius) of all objects of one kind
+ * as SoA arrays and tests a whole batch of them per SIMD iteration against
+ * the frustum planes of every camera selected in SetCameras. The result is
+ * a mask per object with bit (1 << CCamera::CAMTYPE_*) set when the object
+ * is in view of that camera, identical to what CCamera::InView returns.
+ *
+ * Objects are written and culled in blocks of BLOCK_SIZE, so different
+ * threads can fill and cull disjoint blocks concurrently.
+ */
+class CFrustumCuller {
+public:
+	// multiple of every SIMD batch width
+	static constexpr size_t BLOCK_SIZE = 64;
+
+	// the drawers only cull against the player, reflection and shadow cameras
+	static constexpr size_t MAX_CAMERAS = CCamera::CAMTYPE_ENVMAP;
+
+	using FrustumPlanes = std::array<float4, CCamera::FRUSTUM_PLANE_CNT>;
+
+	/**
+	 * camTypeMask selects the CAMTYPE_* cameras to test, planes[camType] are
+	 * copied; only those set in planesMasks[camType] are tested, as done by
+	 * CCamera::InView (see CCamera::GetInViewPlanesMask)
+	 */
+	void SetCameras(
+		uint32_t camTypeMask,
+		const std::array<FrustumPlanes, MAX_CAMERAS>& planes,
+		const std::array<uint8_t, MAX_CAMERAS>& planesMasks
+	);
+	void Resize(size_t numObjects);
+
+	size_t GetNumBlocks() const { return ((numObjects + BLOCK_SIZE - 1) / BLOCK_SIZE); }
+	size_t GetBlockBeg(size_t block) const { return (block * BLOCK_SIZE); }
+	size_t GetBlockEnd(size_t block) const { return std::min(numObjects, (block + 1) * BLOCK_SIZE); }
+
+	void SetSphere(size_t i, const float3& pos, float radius) {
+		posX[i] = pos.x;
+		posY[i] = pos.y;
+		posZ[i] = pos.z;
+		radii[i] = radius;
+	}
+
+	/// culls all spheres in [GetBlockBeg(block), GetBlockEnd(block))
+	void CullBlock(size_t block);
+
+	uint8_t GetInViewMask(size_t i) const { return inViewMasks[i]; }
+	bool InView(size_t i, uint32_t camType) const { return ((inViewMasks[i] & (1 << camType)) != 0); }
+
+private:
+	struct CameraPlanes {
+		FrustumPlanes planes;
+
+		uint32_t numPlanes = 0;
+		uint32_t camType = 0;
+	};
+
+	std::array<CameraPlanes, MAX_CAMERAS> cameras;
+	size_t numCameras = 0;
+	size_t numObjects = 0;
+
+	// padded to a multiple of BLOCK_SIZE
+	std::vector<float> posX;
+	std::vector<float> posY;
+	std::vector<float> posZ;
+	std::vector<float> radii;
+
+	std::vector<uint8_t> inViewMasks;
+};
+
+#endif // FRUSTUM_CULLER_H
@@ -16,6 +16,8 @@
 #include "Rendering/Models/ModelsMemStorage.h"
 #include "Rendering/Models/ModelRenderContainer.h"
 #include "Rendering/Models/3DModel.h"
+#include "Rendering/Common/FrustumCuller.h"
+#include "Rendering/Common/ModelDrawerHelpers.h"
 #include "Rendering/Env/IWater.h"
 #include "Map/ReadMap.h"
 #include "Game/Camera.h"
@@ -58,8 +60,11 @@ protected:
 	void DelObject(const T* co, bool del);
 	void UpdateObject(const T* co, bool init);
 protected:
-	void UpdateCommon(T* o);
-	virtual void UpdateObjectDrawFlags(CSolidObject* o) const = 0;
+	template<typename PreCullFunc>
+	void UpdateObjects(PreCullFunc&& preCullFunc);
+	void UpdateCommon(T* o, uint8_t inViewMask);
+	/// inViewMask has bit (1 << CAMTYPE_*) set for each camera the object's draw-sphere is in view of
+	virtual void UpdateObjectDrawFlags(CSolidObject* o, uint8_t inViewMask) const = 0;
 private:
 	void UpdateObjectSMMA(const T* o);
 	void UpdateObjectUniforms(const T* o);
@@ -82,6 +87,9 @@ protected:
 	std::vector<T*> unsortedObjects;
 	std::unordered_map<T*, ScopedMatricesMemAlloc> matricesMemAllocs;
 
+	// draw-spheres of unsortedObjects, culled in blocks during UpdateObjects
+	CFrustumCuller frustumCuller;
+
 	bool& mtModelDrawer;
 };
 
@@ -199,11 +207,45 @@ inline void CModelDrawerDataBase<T>::UpdateObjectUniforms(const T* o)
 }
 
 template<typename T>
-inline void CModelDrawerDataBase<T>::UpdateCommon(T* o)
+template<typename PreCullFunc>
+inline void CModelDrawerDataBase<T>::UpdateObjects(PreCullFunc&& preCullFunc)
+{
+	CModelDrawerHelper::SetCullerCameras(frustumCuller, CModelDrawerHelper::GetDrawFlagsCamTypes(CShadowHandler::SHADOWGEN_BIT_MODEL));
+	frustumCuller.Resize(unsortedObjects.size());
+
+	// preCullFunc must update drawMidPos and anything else UpdateObjectDrawFlags depends on
+	const auto updateBlock = [this, &preCullFunc](const int block) {
+		const size_t beg = frustumCuller.GetBlockBeg(block);
+		const size_t end = frustumCuller.GetBlockEnd(block);
+
+		for (size_t i = beg; i < end; ++i) {
+			T* o = unsortedObjects[i];
+			preCullFunc(o);
+			frustumCuller.SetSphere(i, o->drawMidPos, o->GetDrawRadius());
+		}
+
+		frustumCuller.CullBlock(block);
+
+		for (size_t i = beg; i < end; ++i) {
+			UpdateCommon(unsortedObjects[i], frustumCuller.GetInViewMask(i));
+		}
+	};
+
+	if (mtModelDrawer) {
+		for_mt_chunk(0, frustumCuller.GetNumBlocks(), updateBlock, MT_CHUNK_OR_MIN_CHUNK_SIZE_UPDT / CFrustumCuller::BLOCK_SIZE);
+	}
+	else {
+		for (size_t block = 0, numBlocks = frustumCuller.GetNumBlocks(); block < numBlocks; ++block)
+			updateBlock(block);
+	}
+}
+
+template<typename T>
+inline void CModelDrawerDataBase<T>::UpdateCommon(T* o, uint8_t inViewMask)
 {
 	assert(o);
 	o->previousDrawFlag = o->drawFlag;
-	UpdateObjectDrawFlags(o);
+	UpdateObjectDrawFlags(o, inViewMask);
 
 	if (o->alwaysUpdateMat || (o->drawFlag > DrawFlags::SO_NODRAW_FLAG && o->drawFlag < DrawFlags::SO_DRICON_FLAG))
 		UpdateObjectSMMA(o);
@@ -3,10 +3,13 @@
 #include "System/float3.h"
 #include "Map/Ground.h"
 #include "Game/Camera.h"
+#include "Game/CameraHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/Team.h"
 #include "Sim/Objects/SolidObject.h"
 #include "Rendering/ShadowHandler.h"
+#include "Rendering/Common/FrustumCuller.h"
+#include "Rendering/Env/IWater.h"
 #include "Rendering/Textures/3DOTextureHandler.h"
 #include "Rendering/Env/CubeMapHandler.h"
 
@@ -37,6 +40,41 @@ bool CModelDrawerHelper::ObjectVisibleReflection(const float3& objPos, const flo
 #endif
 }
 
+uint32_t CModelDrawerHelper::GetDrawFlagsCamTypes(uint32_t shadowGenBit)
+{
+	uint32_t camTypes = (1 << CCamera::CAMTYPE_PLAYER);
+
+	if (IWater::GetWater()->CanDrawReflectionPass())
+		camTypes |= (1 << CCamera::CAMTYPE_UWREFL);
+
+	if ((shadowHandler.shadowGenBits & shadowGenBit) != 0)
+		camTypes |= (1 << CCamera::CAMTYPE_SHADOW);
+
+	return camTypes;
+}
+
+void CModelDrawerHelper::SetCullerCameras(CFrustumCuller& culler, uint32_t camTypes)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::array<CFrustumCuller::FrustumPlanes, CFrustumCuller::MAX_CAMERAS> planes;
+	std::array<uint8_t, CFrustumCuller::MAX_CAMERAS> planesMasks = {};
+
+	for (uint32_t camType = CCamera::CAMTYPE_PLAYER; camType < CFrustumCuller::MAX_CAMERAS; ++camType) {
+		if ((camTypes & (1 << camType)) == 0)
+			continue;
+
+		const CCamera* cam = CCameraHandler::GetCamera(camType);
+
+		for (uint32_t i = 0; i < CCamera::FRUSTUM_PLANE_CNT; ++i) {
+			planes[camType][i] = cam->GetFrustumPlane(i);
+		}
+
+		planesMasks[camType] = cam->GetInViewPlanesMask();
+	}
+
+	culler.SetCameras(camTypes, planes, planesMasks);
+}
+
 void CModelDrawerHelper::EnableTexturesCommon()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -8,6 +8,7 @@
 
 class float3;
 class CCamera;
+class CFrustumCuller;
 
 class CModelDrawerHelper {
 public:
@@ -34,6 +35,11 @@ public:
 	// Auxilary
 	static bool ObjectVisibleReflection(const float3& objPos, const float3& camPos, float maxRadius);
 
+	/// CAMTYPE_* bits of the cameras draw-flags are computed for, shadowGenBit is the CShadowHandler::SHADOWGEN_BIT_* of the drawn objects
+	static uint32_t GetDrawFlagsCamTypes(uint32_t shadowGenBit);
+	/// hands the current frustums of the camTypes cameras to culler
+	static void SetCullerCameras(CFrustumCuller& culler, uint32_t camTypes);
+
 	static void EnableTexturesCommon();
 	static void DisableTexturesCommon();
 
@@ -0,0 +1,138 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef PARTICLE_SORTER_H
+#define PARTICLE_SORTER_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Back-to-front ordering of the sorted (transparent) particles.
+ *
+ * Produces exactly the order of a comparison sort by ascending draw-order
+ * (optional), then descending sort-distance, then descending address, but
+ * as an LSD radix sort over integer keys built from the first two. Digits
+ * shared by all keys (e.g. the draw-order when every particle uses the
+ * default) are skipped, so typically only the distance bytes are sorted.
+ * Ties in the key are rare and resolved by sorting each run on addresses.
+ */
+template<typename T>
+class CParticleSorter {
+public:
+	/// DrawOrderFunc: int(const T*), SortDistFunc: float(const T*)
+	template<typename DrawOrderFunc, typename SortDistFunc>
+	void Sort(std::vector<T*>& items, bool useDrawOrder, DrawOrderFunc&& drawOrderFunc, SortDistFunc&& sortDistFunc) {
+		if (items.size() < 2)
+			return;
+
+		auto& srcItems = sortItems[0];
+		auto& dstItems = sortItems[1];
+
+		srcItems.resize(items.size());
+		dstItems.resize(items.size());
+
+		for (size_t i = 0, n = items.size(); i < n; i++) {
+			const uint64_t orderKey = useDrawOrder? GetDrawOrderKey(drawOrderFunc(items[i])): 0;
+			const uint64_t distKey = GetSortDistKey(sortDistFunc(items[i]));
+
+			srcItems[i] = {(orderKey << 32) | distKey, items[i]};
+		}
+
+		if (items.size() < MIN_RADIX_SORT_SIZE) {
+			std::sort(srcItems.begin(), srcItems.end(), SortItemPredicate);
+		} else {
+			RadixSort();
+			SortTies();
+		}
+
+		for (size_t i = 0, n = items.size(); i < n; i++) {
+			items[i] = srcItems[i].item;
+		}
+	}
+
+private:
+	struct SortItem {
+		uint64_t key;
+		T* item;
+	};
+
+	static bool SortItemPredicate(const SortItem& a, const SortItem& b) {
+		if (a.key != b.key)
+			return (a.key < b.key);
+
+		return std::greater<const T*>()(a.item, b.item);
+	}
+
+	// ascending
+	static uint32_t GetDrawOrderKey(int drawOrder) { return (static_cast<uint32_t>(drawOrder) ^ 0x80000000u); }
+
+	// descending; -0 is mapped to +0 since the two compare equal
+	static uint32_t GetSortDistKey(float sortDist) {
+		const uint32_t bits = std::bit_cast<uint32_t>(sortDist + 0.0f);
+		const uint32_t ascendingKey = (bits & 0x80000000u)? ~bits: (bits | 0x80000000u);
+
+		return ~ascendingKey;
+	}
+
+	void RadixSort() {
+		std::array<std::array<uint32_t, RADIX_SIZE>, NUM_RADIX_PASSES> histograms = {};
+
+		for (const SortItem& si: sortItems[0]) {
+			for (size_t pass = 0; pass < NUM_RADIX_PASSES; pass++) {
+				histograms[pass][(si.key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+			}
+		}
+
+		const uint32_t numItems = sortItems[0].size();
+
+		for (size_t pass = 0; pass < NUM_RADIX_PASSES; pass++) {
+			auto& histogram = histograms[pass];
+
+			// all keys share this digit, nothing to reorder
+			if (histogram[(sortItems[0][0].key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)] == numItems)
+				continue;
+
+			uint32_t offset = 0;
+
+			for (uint32_t& count: histogram) {
+				offset += std::exchange(count, offset);
+			}
+
+			for (const SortItem& si: sortItems[0]) {
+				sortItems[1][histogram[(si.key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++] = si;
+			}
+
+			std::swap(sortItems[0], sortItems[1]);
+		}
+	}
+
+	void SortTies() {
+		auto& items = sortItems[0];
+
+		for (auto beg = items.begin(), end = beg; beg != items.end(); beg = end) {
+			end = std::find_if(beg + 1, items.end(), [&](const SortItem& si) { return (si.key != beg->key); });
+
+			if ((end - beg) < 2)
+				continue;
+
+			std::sort(beg, end, SortItemPredicate);
+		}
+	}
+
+private:
+	static constexpr size_t RADIX_BITS = 8;
+	static constexpr size_t RADIX_SIZE = 1 << RADIX_BITS;
+	static constexpr size_t NUM_RADIX_PASSES = 64 / RADIX_BITS;
+
+	// below this a comparison sort on the keys is cheaper than the histograms
+	static constexpr size_t MIN_RADIX_SORT_SIZE = 256;
+
+	std::array<std::vector<SortItem>, 2> sortItems;
+};
+
+#endif // PARTICLE_SORTER_H
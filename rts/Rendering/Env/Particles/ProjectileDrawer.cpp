@@ -3,7 +3,6 @@
 
 #include "ProjectileDrawer.h"
 
-#include <tuple>
 #include <bit>
 
 #include "Game/Camera.h"
@@ -45,15 +44,6 @@
 
 CONFIG(int, SoftParticles).defaultValue(1).safemodeValue(0).description("Soften up CEG particles on clipping edges");
 
-static uint32_t sortCamType = 0;
-static bool CProjectileDrawOrderSortingPredicate(const CProjectile* p1, const CProjectile* p2) noexcept {
-	return std::forward_as_tuple(p2->drawOrder, p1->GetSortDist(sortCamType), p1) > std::forward_as_tuple(p1->drawOrder, p2->GetSortDist(sortCamType), p2);
-}
-
-static bool CProjectileSortingPredicate(const CProjectile* p1, const CProjectile* p2) noexcept {
-	return std::forward_as_tuple(p1->GetSortDist(sortCamType), p1) > std::forward_as_tuple(p2->GetSortDist(sortCamType), p2);
-};
-
 CProjectileDrawer* projectileDrawer = nullptr;
 
 // can not be a CProjectileDrawer; destruction in global
@@ -378,62 +368,78 @@ void CProjectileDrawer::Kill() {
 void CProjectileDrawer::UpdateDrawFlags()
 {
 	ZoneScopedN("ProjectileDrawer::UpdateDrawFlags");
+
+	const uint32_t camTypes = CModelDrawerHelper::GetDrawFlagsCamTypes(CShadowHandler::SHADOWGEN_BIT_PROJ);
+
 	for (auto& rp : renderProjectiles) {
 		if (rp.empty())
 			continue;
 
 		auto hasModel = (&rp == &renderProjectiles[true]);
-		for_mt(0, rp.size(), [&rp, hasModel](int i) {
-			CProjectile* p = rp[i];
-			assert((p->model != nullptr) == hasModel);
+		auto& culler = frustumCullers[hasModel];
 
-			p->drawPos = p->GetDrawPos(globalRendering->timeOffset);
+		CModelDrawerHelper::SetCullerCameras(culler, camTypes);
+		culler.Resize(rp.size());
 
-			p->previousDrawFlag = p->drawFlag;
-			p->ResetDrawFlag();
+		for_mt(0, culler.GetNumBlocks(), [&rp, &culler, hasModel](int block) {
+			const size_t beg = culler.GetBlockBeg(block);
+			const size_t end = culler.GetBlockEnd(block);
 
-			if (!CanDrawProjectile(p, p->GetAllyteamID()))
-				return;
+			for (size_t i = beg; i < end; ++i) {
+				CProjectile* p = rp[i];
+				assert((p->model != nullptr) == hasModel);
 
-			p->SetDrawFlag(DrawFlags::SO_DRICON_FLAG); //reuse as a minimap draw indication
+				p->drawPos = p->GetDrawPos(globalRendering->timeOffset);
+				culler.SetSphere(i, p->drawPos, p->GetDrawRadius());
+			}
 
-			for (uint32_t camType = CCamera::CAMTYPE_PLAYER; camType < CCamera::CAMTYPE_ENVMAP; ++camType) {
-				if (camType == CCamera::CAMTYPE_UWREFL && !IWater::GetWater()->CanDrawReflectionPass())
-					continue;
+			culler.CullBlock(block);
 
-				if (camType == CCamera::CAMTYPE_SHADOW && !p->castShadow)
-					continue;
+			for (size_t i = beg; i < end; ++i) {
+				CProjectile* p = rp[i];
 
-				if (camType == CCamera::CAMTYPE_SHADOW && ((shadowHandler.shadowGenBits & CShadowHandler::SHADOWGEN_BIT_PROJ) == 0))
-					continue;
+				p->previousDrawFlag = p->drawFlag;
+				p->ResetDrawFlag();
 
-				const CCamera* cam = CCameraHandler::GetCamera(camType);
-				if (!cam->InView(p->drawPos, p->GetDrawRadius()))
+				if (!CanDrawProjectile(p, p->GetAllyteamID()))
 					continue;
 
-				p->SetSortDist(camType, cam->ProjectedDistance(p->drawPos));
-
-				switch (camType)
-				{
-					case CCamera::CAMTYPE_PLAYER: {
-						if (hasModel)
-							p->AddDrawFlag(DrawFlags::SO_OPAQUE_FLAG);
-						else
-							p->AddDrawFlag(DrawFlags::SO_ALPHAF_FLAG);
-
-						if (p->drawPos.y - p->GetDrawRadius() < 0.0f)
-							p->AddDrawFlag(DrawFlags::SO_REFRAC_FLAG);
-					} break;
-					case CCamera::CAMTYPE_UWREFL: {
-						if (CModelDrawerHelper::ObjectVisibleReflection(p->drawPos, cam->GetPos(), p->GetDrawRadius()))
-							p->AddDrawFlag(DrawFlags::SO_REFLEC_FLAG);
-					} break;
-					case CCamera::CAMTYPE_SHADOW: {
-						if unlikely(hasModel)
-							p->AddDrawFlag(DrawFlags::SO_SHOPAQ_FLAG);
-						else
-							p->AddDrawFlag(DrawFlags::SO_SHTRAN_FLAG);
-					} break;
+				p->SetDrawFlag(DrawFlags::SO_DRICON_FLAG); //reuse as a minimap draw indication
+
+				for (uint32_t camType = CCamera::CAMTYPE_PLAYER; camType < CCamera::CAMTYPE_ENVMAP; ++camType) {
+					// also excludes the cameras that are not drawn this frame
+					if (!culler.InView(i, camType))
+						continue;
+
+					if (camType == CCamera::CAMTYPE_SHADOW && !p->castShadow)
+						continue;
+
+					const CCamera* cam = CCameraHandler::GetCamera(camType);
+
+					p->SetSortDist(camType, cam->ProjectedDistance(p->drawPos));
+
+					switch (camType)
+					{
+						case CCamera::CAMTYPE_PLAYER: {
+							if (hasModel)
+								p->AddDrawFlag(DrawFlags::SO_OPAQUE_FLAG);
+							else
+								p->AddDrawFlag(DrawFlags::SO_ALPHAF_FLAG);
+
+							if (p->drawPos.y - p->GetDrawRadius() < 0.0f)
+								p->AddDrawFlag(DrawFlags::SO_REFRAC_FLAG);
+						} break;
+						case CCamera::CAMTYPE_UWREFL: {
+							if (CModelDrawerHelper::ObjectVisibleReflection(p->drawPos, cam->GetPos(), p->GetDrawRadius()))
+								p->AddDrawFlag(DrawFlags::SO_REFLEC_FLAG);
+						} break;
+						case CCamera::CAMTYPE_SHADOW: {
+							if unlikely(hasModel)
+								p->AddDrawFlag(DrawFlags::SO_SHOPAQ_FLAG);
+							else
+								p->AddDrawFlag(DrawFlags::SO_SHTRAN_FLAG);
+						} break;
+					}
 				}
 			}
 		});
@@ -779,15 +785,16 @@ void CProjectileDrawer::DrawAlpha(bool drawAboveWater, bool drawBelowWater, bool
 		}
 	}
 
-	// set static variable to facilite sorting
-	sortCamType = camera->GetCamType();
-
 	{
 		ZoneScopedN("ProjectileDrawer::DrawAlpha(SO)");
-		if (wantDrawOrder)
-			std::sort(drawParticles[true].begin(), drawParticles[true].end(), CProjectileDrawOrderSortingPredicate);
-		else
-			std::sort(drawParticles[true].begin(), drawParticles[true].end(), CProjectileSortingPredicate);
+
+		const uint32_t sortCamType = camera->GetCamType();
+
+		const auto drawOrderFunc = [](const CProjectile* p) { return p->drawOrder; };
+		const auto sortDistFunc = [sortCamType](const CProjectile* p) { return p->GetSortDist(sortCamType); };
+
+		// ascending draw-order (if wanted), then back to front
+		particleSorter.Sort(drawParticles[true], wantDrawOrder, drawOrderFunc, sortDistFunc);
 	}
 
 	{
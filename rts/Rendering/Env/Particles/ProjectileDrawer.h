@@ -5,6 +5,7 @@
 #include <array>
 #include <memory>
 
+#include "ParticleSorter.h"
 #include "Sim/Projectiles/Projectile.h"
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/FBO.h"
@@ -12,6 +13,7 @@
 #include "Rendering/Shaders/Shader.h"
 #include "Rendering/Models/3DModel.h"
 #include "Rendering/Models/ModelRenderContainer.h"
+#include "Rendering/Common/FrustumCuller.h"
 #include "Rendering/DepthBufferCopy.h"
 #include "System/EventClient.h"
 #include "System/UnorderedSet.hpp"
@@ -160,6 +162,8 @@ private:
 
 	/// projectiles container {modelless, model}
 	std::array<std::vector<CProjectile*>, 2> renderProjectiles;
+	/// draw-spheres of renderProjectiles, culled during UpdateDrawFlags
+	std::array<CFrustumCuller, 2> frustumCullers;
 
 	/// projectiles with a model, binned by model type and textures
 	std::array<ModelRenderContainer<CProjectile>, MODELTYPE_CNT> modelRenderers;
@@ -167,6 +171,8 @@ private:
 	/// used to render particle effects in back-to-front order. {unsorted, sorted}
 	std::array<std::vector<CProjectile*>, 2> drawParticles;
 
+	CParticleSorter<CProjectile> particleSorter;
+
 	bool drawSorted = true;
 
 	std::array<Shader::IProgramObject*, 2> fxShaders = { nullptr };
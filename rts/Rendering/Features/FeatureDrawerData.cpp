@@ -90,19 +90,9 @@ void CFeatureDrawerData::ConfigNotify(const std::string& key, const std::string&
 void CFeatureDrawerData::Update()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	if (mtModelDrawer) {
-		for_mt_chunk(0, unsortedObjects.size(), [this](const int k) {
-			CFeature* f = unsortedObjects[k];
-			UpdateDrawPos(f);
-			UpdateCommon(f);
-		}, CModelDrawerDataConcept::MT_CHUNK_OR_MIN_CHUNK_SIZE_UPDT);
-	}
-	else {
-		for (CFeature* f : unsortedObjects) {
-			UpdateDrawPos(f);
-			UpdateCommon(f);
-		}
-	}
+	UpdateObjects([this](CFeature* f) {
+		UpdateDrawPos(f);
+	});
 }
 
 bool CFeatureDrawerData::IsAlpha(const CFeature* co) const
@@ -111,7 +101,7 @@ bool CFeatureDrawerData::IsAlpha(const CFeature* co) const
 	return (co->drawAlpha < 1.0f);
 }
 
-void CFeatureDrawerData::UpdateObjectDrawFlags(CSolidObject* o) const
+void CFeatureDrawerData::UpdateObjectDrawFlags(CSolidObject* o, uint8_t inViewMask) const
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 
@@ -119,10 +109,8 @@ void CFeatureDrawerData::UpdateObjectDrawFlags(CSolidObject* o) const
 	f->ResetDrawFlag();
 
 	for (uint32_t camType = CCamera::CAMTYPE_PLAYER; camType < CCamera::CAMTYPE_ENVMAP; ++camType) {
-		if (camType == CCamera::CAMTYPE_UWREFL && !IWater::GetWater()->CanDrawReflectionPass())
-			continue;
-
-		if (camType == CCamera::CAMTYPE_SHADOW && ((shadowHandler.shadowGenBits & CShadowHandler::SHADOWGEN_BIT_MODEL) == 0))
+		// also excludes the cameras that are not drawn this frame, see CModelDrawerHelper::GetDrawFlagsCamTypes
+		if ((inViewMask & (1 << camType)) == 0)
 			continue;
 
 		const CCamera* cam = CCameraHandler::GetCamera(camType);
@@ -136,9 +124,6 @@ void CFeatureDrawerData::UpdateObjectDrawFlags(CSolidObject* o) const
 		if (!f->IsInLosForAllyTeam(gu->myAllyTeam) && !gu->spectatingFullView)
 			continue;
 
-		if (!cam->InView(f->drawMidPos, f->GetDrawRadius()))
-			continue;
-
 		switch (camType)
 			{
 			case CCamera::CAMTYPE_PLAYER: {
@@ -27,7 +27,7 @@ public:
 	void Update() override;
 	bool IsAlpha(const CFeature* co) const override;
 protected:
-	void UpdateObjectDrawFlags(CSolidObject* o) const override;
+	void UpdateObjectDrawFlags(CSolidObject* o, uint8_t inViewMask) const override;
 private:
 	static void UpdateDrawPos(CFeature* f);
 public:
@@ -4,6 +4,7 @@
 #define ICON_HANDLER_H
 
 #include <array>
+#include <atomic>
 #include <string>
 
 #include "Icon.h"
@@ -31,7 +32,7 @@ namespace icon {
 			CIconData& operator = (CIconData&& id) {
 				std::swap(name, id.name);
 
-				std::swap(refCount, id.refCount);
+				refCount = id.refCount.exchange(refCount);
 				std::swap(texID, id.texID);
 
 				xsize = id.xsize;
@@ -81,7 +82,8 @@ namespace icon {
 		private:
 			std::string name;
 
-			int refCount = 123456;
+			// icons are referenced by UnitDefs, which are parsed in parallel
+			std::atomic_int refCount = 123456;
 			unsigned int texID = 0;
 			int xsize = 1;
 			int ysize = 1;
@@ -49,7 +49,11 @@ CR_REG_METADATA(LocalModel, (
 
 	CR_MEMBER(boundingVolume),
 	CR_IGNORED(luaMaterialData),
-	CR_MEMBER(needsBoundariesRecalc)
+	CR_MEMBER(needsBoundariesRecalc),
+
+	CR_IGNORED(pieceBVH),
+	CR_IGNORED(pieceBoxes),
+	CR_IGNORED(needsPieceBVHRefit)
 ))
 
 static_assert(sizeof(SVertexData) == (3 + 3 + 3 + 3 + 4 + 2 + 1) * 4);
@@ -344,6 +348,9 @@ void LocalModel::SetModel(const S3DModel* model, bool initialize)
 	pieces.clear();
 	pieces.reserve(model->numPieces);
 
+	pieceBVH.Clear();
+	needsPieceBVHRefit = true;
+
 	CreateLocalModelPieces(model->GetRootPiece());
 
 	// must recursively update matrices here too: for features
@@ -428,6 +435,58 @@ void LocalModel::UpdateBoundingVolume()
 	needsBoundariesRecalc = false;
 }
 
+void LocalModel::UpdatePieceBVH() const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::lock_guard<spring::spinlock> lock(pieceBVHMutex);
+
+	// refit by another thread while this one was waiting
+	if (!needsPieceBVHRefit.load(std::memory_order_relaxed))
+		return;
+
+	pieceBoxes.resize(pieces.size());
+
+	for (size_t n = 0; n < pieces.size(); n++) {
+		const LocalModelPiece& lmp = pieces[n];
+		const CollisionVolume* vol = lmp.GetCollisionVolume();
+		const CMatrix44f& mat = lmp.GetModelSpaceMatrix();
+
+		CPieceBVH::Box& box = pieceBoxes[n];
+
+		// per-piece raytraces assume rigid transforms (InvertAffine), with
+		// scaled or sheared matrices the volume can not be bounded reliably
+		if (!mat.IsOrthoNormal()) {
+			box.mins = float3(-std::numeric_limits<float>::max());
+			box.maxs = float3( std::numeric_limits<float>::max());
+			continue;
+		}
+
+		// every volume type fits inside the box spanned by its half-scales;
+		// pad it to absorb the precision lost by the (single) model-space
+		// transform of the ray versus the per-piece transforms in raytraces
+		const float3& hs = vol->GetHScales();
+		const float3 ctr = mat * vol->GetOffsets();
+		const float pad = std::max(hs.x, std::max(hs.y, hs.z)) * 0.02f + 1.0f;
+
+		const float3 ext = {
+			math::fabs(mat.m[0]) * hs.x + math::fabs(mat.m[4]) * hs.y + math::fabs(mat.m[ 8]) * hs.z + pad,
+			math::fabs(mat.m[1]) * hs.x + math::fabs(mat.m[5]) * hs.y + math::fabs(mat.m[ 9]) * hs.z + pad,
+			math::fabs(mat.m[2]) * hs.x + math::fabs(mat.m[6]) * hs.y + math::fabs(mat.m[10]) * hs.z + pad,
+		};
+
+		box.mins = ctr - ext;
+		box.maxs = ctr + ext;
+	}
+
+	if (pieceBVH.GetNumLeaves() != pieceBoxes.size()) {
+		pieceBVH.Build(pieceBoxes);
+	} else {
+		pieceBVH.Refit(pieceBoxes);
+	}
+
+	needsPieceBVHRefit.store(false, std::memory_order_release);
+}
+
 /** ****************************************************************************************************
  * LocalModelPiece
  */
@@ -461,6 +520,9 @@ void LocalModelPiece::SetDirty() {
 	dirty = true;
 	SetGetCustomDirty(true);
 
+	assert(localModel);
+	localModel->SetPieceBVHNeedsRefit();
+
 	for (LocalModelPiece* child: children) {
 		if (child->dirty)
 			continue;
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <vector>
 #include <string>
 #include <limits>
@@ -13,11 +14,13 @@
 #include "Lua/LuaObjectMaterial.h"
 #include "Rendering/GL/VBO.h"
 #include "Sim/Misc/CollisionVolume.h"
+#include "Sim/Misc/PieceBVH.h"
 #include "System/Matrix44f.h"
 #include "System/type2.h"
 #include "System/float4.h"
 #include "System/SafeUtil.h"
 #include "System/SpringMath.h"
+#include "System/Threading/SpringThreading.h"
 #include "System/creg/creg_cond.h"
 
 static constexpr int MAX_MODEL_OBJECTS  = 3840;
@@ -628,9 +631,23 @@ struct LocalModel
 
 	void SetBoundariesNeedsRecalc()       { needsBoundariesRecalc = true; }
 	bool GetBoundariesNeedsRecalc() const { return needsBoundariesRecalc; }
+
+	// model-space hierarchy over piece volumes; refit lazily after any piece
+	// matrix or volume changed (leaf indices are piece indices). Raytraces
+	// may run concurrently (e.g. from AI threads), so the first caller after
+	// a change refits under pieceBVHMutex and the others wait for it
+	const CPieceBVH& GetPieceBVH() const {
+		if (needsPieceBVHRefit.load(std::memory_order_acquire))
+			UpdatePieceBVH();
+
+		return pieceBVH;
+	}
+	void SetPieceBVHNeedsRefit() { needsPieceBVHRefit.store(true, std::memory_order_release); }
 private:
 	LocalModelPiece* CreateLocalModelPieces(const S3DModelPiece* mpParent);
 
+	void UpdatePieceBVH() const;
+
 	void DrawPieces() const;
 	void DrawPiecesLOD(unsigned int lod) const;
 
@@ -645,6 +662,11 @@ private:
 	LuaObjectMaterialData luaMaterialData;
 
 	bool needsBoundariesRecalc = true;
+
+	mutable CPieceBVH pieceBVH;
+	mutable std::vector<CPieceBVH::Box> pieceBoxes;
+	mutable spring::spinlock pieceBVHMutex;
+	mutable std::atomic<bool> needsPieceBVHRefit = {true};
 };
 
 #endif /* _3DMODEL_H */
@@ -191,27 +191,14 @@ void CUnitDrawerData::Update()
 
 	iconZoomDist = dist;
 
-	const auto updateBody = [this](CUnit* u) {
+	UpdateObjects([this](CUnit* u) {
 		UpdateDrawPos(u);
 
 		if (useScreenIcons)
 			UpdateUnitIconStateScreen(u);
 		else
 			UpdateUnitIconState(u);
-
-		UpdateCommon(u);
-	};
-
-	if (mtModelDrawer) {
-		for_mt_chunk(0, unsortedObjects.size(), [this, &updateBody](const int k) {
-			CUnit* unit = unsortedObjects[k];
-			updateBody(unit);
-		}, CModelDrawerDataConcept::MT_CHUNK_OR_MIN_CHUNK_SIZE_UPDT);
-	}
-	else {
-		for (CUnit* unit : unsortedObjects)
-			updateBody(unit);
-	}
+	});
 
 	if ((useDistToGroundForIcons = (camHandler->GetCurrentController()).GetUseDistToGroundForIcons())) {
 		const float3& camPos = camera->GetPos();
@@ -394,7 +381,7 @@ void CUnitDrawerData::UpdateDrawPos(CUnit* u)
 	u->drawMidPos = u->GetMdlDrawMidPos();
 }
 
-void CUnitDrawerData::UpdateObjectDrawFlags(CSolidObject* o) const
+void CUnitDrawerData::UpdateObjectDrawFlags(CSolidObject* o, uint8_t inViewMask) const
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	CUnit* u = static_cast<CUnit*>(o);
@@ -407,10 +394,8 @@ void CUnitDrawerData::UpdateObjectDrawFlags(CSolidObject* o) const
 	}
 
 	for (uint32_t camType = CCamera::CAMTYPE_PLAYER; camType < CCamera::CAMTYPE_ENVMAP; ++camType) {
-		if (camType == CCamera::CAMTYPE_UWREFL && !IWater::GetWater()->CanDrawReflectionPass())
-			continue;
-
-		if (camType == CCamera::CAMTYPE_SHADOW && ((shadowHandler.shadowGenBits & CShadowHandler::SHADOWGEN_BIT_MODEL) == 0))
+		// also excludes the cameras that are not drawn this frame, see CModelDrawerHelper::GetDrawFlagsCamTypes
+		if ((inViewMask & (1 << camType)) == 0)
 			continue;
 
 		const CCamera* cam = CCameraHandler::GetCamera(camType);
@@ -428,9 +413,6 @@ void CUnitDrawerData::UpdateObjectDrawFlags(CSolidObject* o) const
 		if (!(u->losStatus[gu->myAllyTeam] & LOS_INLOS) && !gu->spectatingFullView)
 			continue;
 
-		if (!cam->InView(u->drawMidPos, u->GetDrawRadius()))
-			continue;
-
 		switch (camType)
 		{
 			case CCamera::CAMTYPE_PLAYER: {
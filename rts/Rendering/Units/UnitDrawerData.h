@@ -146,7 +146,7 @@ public:
 
 	const spring::unsynced_map<icon::CIconData*, std::pair<std::vector<const CUnit*>, std::vector<const GhostSolidObject*> > >& GetUnitsByIcon() const { return unitsByIcon; }
 protected:
-	void UpdateObjectDrawFlags(CSolidObject* o) const override;
+	void UpdateObjectDrawFlags(CSolidObject* o, uint8_t inViewMask) const override;
 private:
 	const icon::CIconData* GetUnitIcon(const CUnit* unit);
 
@@ -6,10 +6,12 @@
 #include "Lua/LuaParser.h"
 #include "Map/ReadMap.h"
 #include "Sim/Misc/CollisionVolume.h"
+#include "Sim/Misc/CommonDefHandler.h"
 #include "Sim/Objects/SolidObject.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
+#include "System/UnorderedSet.hpp"
 
 #include "System/Misc/TracyDefs.h"
 
@@ -33,13 +35,8 @@ void CFeatureDefHandler::Init(LuaParser* defsParser)
 	featureDefsVector.reserve(keys.size());
 	featureDefsVector.emplace_back();
 
-	for (unsigned int i = 0; i < keys.size(); i++) {
-		const std::string& nameMixedCase = keys[i];
-		const std::string& nameLowerCase = StringToLower(nameMixedCase);
-		const LuaTable& fdTable = rootTable.SubTable(nameMixedCase);
+	CreateFeatureDefs(rootTable, keys);
 
-		AddFeatureDef(nameLowerCase, CreateFeatureDef(fdTable, nameLowerCase), false);
-	}
 	for (unsigned int i = 0; i < keys.size(); i++) {
 		const std::string& nameMixedCase = keys[i];
 		const std::string& nameLowerCase = StringToLower(nameMixedCase);
@@ -85,17 +82,52 @@ FeatureDef& CFeatureDefHandler::GetNewFeatureDef()
 }
 
 
-FeatureDef* CFeatureDefHandler::CreateFeatureDef(const LuaTable& fdTable, const std::string& mixedCase)
+void CFeatureDefHandler::CreateFeatureDefs(const LuaTable& rootTable, const std::vector<std::string>& keys)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	const std::string& name = StringToLower(mixedCase);
+	// ID's are assigned in key order, duplicates are skipped
+	std::vector<int> newDefIDs;
+	std::vector<std::string> newDefKeys;
+	spring::unordered_set<std::string> newDefNames;
 
-	if (featureDefIDs.find(name) != featureDefIDs.end())
-		return nullptr;
+	newDefIDs.reserve(keys.size());
+	newDefKeys.reserve(keys.size());
+	newDefNames.reserve(keys.size());
 
-	FeatureDef& fd = GetNewFeatureDef();
+	for (const std::string& nameMixedCase: keys) {
+		const std::string& nameLowerCase = StringToLower(nameMixedCase);
 
-	fd.name = name;
+		if (featureDefIDs.find(nameLowerCase) != featureDefIDs.end())
+			continue;
+		if (!newDefNames.insert(nameLowerCase).second)
+			continue;
+
+		FeatureDef& fd = GetNewFeatureDef();
+
+		fd.name = nameLowerCase;
+		newDefIDs.push_back(fd.id);
+		newDefKeys.push_back(nameMixedCase);
+	}
+
+	// no more defs are added until all are parsed, so references stay valid
+	const std::vector<std::exception_ptr>& newDefErrors = CommonDefHandler::ParseDefTables(rootTable, newDefKeys, [&](int i, const LuaTable& fdTable) {
+		ParseFeatureDef(featureDefsVector[newDefIDs[i]], fdTable);
+	});
+
+	for (const std::exception_ptr& newDefError: newDefErrors) {
+		if (newDefError != nullptr)
+			std::rethrow_exception(newDefError);
+	}
+
+	for (const int newDefID: newDefIDs) {
+		FeatureDef& fd = featureDefsVector[newDefID];
+		AddFeatureDef(fd.name, &fd, false);
+	}
+}
+
+void CFeatureDefHandler::ParseFeatureDef(FeatureDef& fd, const LuaTable& fdTable)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
 	fd.description = fdTable.GetString("description", "");
 
 	fd.collidable    =  fdTable.GetBool("blocking",        true);
@@ -152,8 +184,6 @@ FeatureDef* CFeatureDefHandler::CreateFeatureDef(const LuaTable& fdTable, const
 
 	// custom parameters table
 	fdTable.SubTable("customParams").GetMap(fd.customParams);
-
-	return &fd;
 }
 
 
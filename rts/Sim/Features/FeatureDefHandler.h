@@ -48,7 +48,9 @@ private:
 
 	FeatureDef* CreateDefaultTreeFeatureDef(const std::string& name);
 	FeatureDef* CreateDefaultGeoFeatureDef(const std::string& name);
-	FeatureDef* CreateFeatureDef(const LuaTable& luaTable, const std::string& name);
+	void CreateFeatureDefs(const LuaTable& rootTable, const std::vector<std::string>& keys);
+
+	static void ParseFeatureDef(FeatureDef& fd, const LuaTable& fdTable);
 
 	FeatureDef& GetNewFeatureDef();
 
@@ -12,6 +12,8 @@
 
 #include "System/Misc/TracyDefs.h"
 
+#include <array>
+
 unsigned int CCollisionHandler::numDiscTests = 0;
 unsigned int CCollisionHandler::numContTests = 0;
 
@@ -267,32 +269,35 @@ bool CCollisionHandler::IntersectPiecesHelper(
 	CollisionQuery* cq
 ) {
 	RECOIL_DETAILED_TRACY_ZONE;
+	const LocalModel& lm = o->localModel;
+
 	CMatrix44f volMat;
 
 	float minDistSq = std::numeric_limits<float>::max();
 	float curDistSq = minDistSq;
 
-	for (unsigned int n = 0; n < o->localModel.pieces.size(); n++) {
-		const LocalModelPiece* lmp = o->localModel.GetPiece(n);
+	// returns true iff the caller only wants to know a collision exists
+	const auto TestPiece = [&](unsigned int n) {
+		const LocalModelPiece* lmp = lm.GetPiece(n);
 		const CollisionVolume* lmpVol = lmp->GetCollisionVolume();
 
 		if (!lmp->GetScriptVisible() || lmpVol->IgnoreHits())
-			continue;
+			return false;
 
 		volMat = m * lmp->GetModelSpaceMatrix();
 		volMat.Translate(lmpVol->GetOffsets());
 
 		CollisionQuery cqn;
 		if (!CCollisionHandler::Intersect(lmpVol, volMat, p0, p1, &cqn))
-			continue;
+			return false;
 
 		// skip if neither an ingress nor an egress hit
 		if (!cqn.AnyHit())
-			continue;
+			return false;
 
 		// save the closest intersection (others are not needed)
 		if ((curDistSq = (cqn.GetHitPos()).SqDistance(p0)) >= minDistSq)
-			continue;
+			return false;
 
 		minDistSq = curDistSq;
 
@@ -302,6 +307,46 @@ bool CCollisionHandler::IntersectPiecesHelper(
 
 		*cq = cqn;
 		cq->SetHitPiece(lmp);
+		return false;
+	};
+
+	// pieces whose (model-space) bounds are crossed by the ray; tested
+	// in ascending index order so the closest hit and the tie-breaking
+	// between equally distant hits match a test of every single piece
+	std::array<uint32_t, 256> pieceIdcs;
+	size_t numPieceIdcs = pieceIdcs.size() + 1;
+
+	// the hierarchy is in model-space, moving the ray there once needs
+	// the same rigid-transform assumption as Intersect's InvertAffine
+	if (lm.pieces.size() > 1 && m.IsOrthoNormal()) {
+		const CMatrix44f mInv = m.InvertAffine();
+
+		// cylinders also report hits up to one segment-length behind p0
+		const float3 mp0 = mInv.Mul(p0 - (p1 - p0));
+		const float3 mp1 = mInv.Mul(p1);
+
+		numPieceIdcs = 0;
+
+		lm.GetPieceBVH().Traverse(mp0, mp1, [&](uint32_t n) {
+			if (numPieceIdcs < pieceIdcs.size())
+				pieceIdcs[numPieceIdcs] = n;
+
+			numPieceIdcs++;
+		});
+	}
+
+	if (numPieceIdcs <= pieceIdcs.size()) {
+		std::sort(pieceIdcs.begin(), pieceIdcs.begin() + numPieceIdcs);
+
+		for (size_t i = 0; i < numPieceIdcs; i++) {
+			if (TestPiece(pieceIdcs[i]))
+				return true;
+		}
+	} else {
+		for (unsigned int n = 0; n < lm.pieces.size(); n++) {
+			if (TestPiece(n))
+				return true;
+		}
 	}
 
 	// true iff at least one piece was intersected
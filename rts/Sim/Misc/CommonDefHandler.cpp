@@ -5,11 +5,13 @@
 
 #include "CommonDefHandler.h"
 
+#include "Lua/LuaParser.h"
 #include "Sim/Misc/GuiSoundSet.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileHandler.h"
 #include "System/Sound/ISound.h"
 #include "System/Log/ILog.h"
+#include "System/Threading/ThreadPool.h"
 
 #include "System/Misc/TracyDefs.h"
 
@@ -58,26 +60,93 @@ size_t CommonDefHandler::SoundSetDataCount()
 int CommonDefHandler::LoadSoundFile(const std::string& fileName)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	if (!fileName.empty()) {
-		const std::string soundExt = FileSystem::GetExtension(fileName);
+	if (fileName.empty())
+		return 0;
 
-		// unlike constructing a CFileHandler this does not read the data
-		// into memory; faster for large files and many small individually
-		// compressed sounds (e.g. in pool archives)
-		const bool foundExt = (std::find(soundExts.cbegin(), soundExts.cend(), soundExt) != soundExts.cend());
-		const bool haveFile = (foundExt && CFileHandler::FileExists(fileName, SPRING_VFS_RAW_FIRST));
-		const bool haveItem = (haveFile || sound->HasSoundItem(fileName));
+	const std::string soundName = GetSoundName(fileName);
 
-		if (haveItem)
-			return (sound->GetSoundId(fileName));
+	if (!soundName.empty())
+		return (sound->GetSoundId(soundName));
 
-		const std::string soundFile = "sounds/" + fileName + ((soundExt.empty())? ".wav": "");
+	LOG_L(L_WARNING, "[%s] could not load sound \"%s\" from {Unit,Weapon}Def", __func__, fileName.c_str());
+	return 0;
+}
+
+void CommonDefHandler::LoadSoundFiles()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<std::string> soundNames;
+	soundNames.reserve(soundSetData.size());
+
+	for (size_t i = 1; i < soundSetData.size(); i++) {
+		if (soundSetData[i].id != -1 || soundSetData[i].name.empty())
+			continue;
 
-		if (CFileHandler::FileExists(soundFile, SPRING_VFS_RAW_FIRST))
-			return (sound->GetSoundId(soundFile));
+		std::string soundName = GetSoundName(soundSetData[i].name);
 
-		LOG_L(L_WARNING, "[%s] could not load sound \"%s\" from {Unit,Weapon}Def", __func__, fileName.c_str());
+		if (soundName.empty())
+			continue;
+
+		soundNames.push_back(std::move(soundName));
 	}
 
-	return 0;
+	std::sort(soundNames.begin(), soundNames.end());
+	soundNames.erase(std::unique(soundNames.begin(), soundNames.end()), soundNames.end());
+
+	// ids are still assigned lazily by GuiSoundSet::getID, now without decoding
+	sound->PredecodeSounds(soundNames);
+}
+
+std::string CommonDefHandler::GetSoundName(const std::string& fileName)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const std::string soundExt = FileSystem::GetExtension(fileName);
+
+	// unlike constructing a CFileHandler this does not read the data
+	// into memory; faster for large files and many small individually
+	// compressed sounds (e.g. in pool archives)
+	const bool foundExt = (std::find(soundExts.cbegin(), soundExts.cend(), soundExt) != soundExts.cend());
+	const bool haveFile = (foundExt && CFileHandler::FileExists(fileName, SPRING_VFS_RAW_FIRST));
+	const bool haveItem = (haveFile || sound->HasSoundItem(fileName));
+
+	if (haveItem)
+		return fileName;
+
+	const std::string soundFile = "sounds/" + fileName + ((soundExt.empty())? ".wav": "");
+
+	if (CFileHandler::FileExists(soundFile, SPRING_VFS_RAW_FIRST))
+		return soundFile;
+
+	return "";
+}
+
+
+std::vector<std::exception_ptr> CommonDefHandler::ParseDefTables(
+	const LuaTable& rootTable,
+	const std::vector<std::string>& defNames,
+	const std::function<void(int, const LuaTable&)>& parseFunc
+) {
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<std::exception_ptr> defErrors(defNames.size());
+
+	const auto ParseDefTable = [&](const LuaTable& defsTable, int i) {
+		try {
+			parseFunc(i, defsTable.SubTable(defNames[i]));
+		} catch (...) {
+			defErrors[i] = std::current_exception();
+		}
+	};
+
+	// a detached copy can be read from any thread
+	const LuaTable& detachedTable = rootTable.Detach();
+
+	if (detachedTable.IsValid()) {
+		for_mt(0, defNames.size(), [&](const int i) { ParseDefTable(detachedTable, i); });
+	} else {
+		for (size_t i = 0; i < defNames.size(); i++) {
+			ParseDefTable(rootTable, i);
+		}
+	}
+
+	return defErrors;
 }
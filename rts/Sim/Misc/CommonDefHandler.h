@@ -3,8 +3,12 @@
 #ifndef COMMON_DEF_HANDLER_H
 #define COMMON_DEF_HANDLER_H
 
+#include <exception>
+#include <functional>
 #include <string>
+#include <vector>
 
+class LuaTable;
 struct GuiSoundSet;
 struct GuiSoundSetData;
 
@@ -19,8 +23,26 @@ public:
 
 	static size_t SoundSetDataCount();
 
+	/**
+	 * Calls parseFunc(i, defTable) for the subtable of each of <defNames>, on
+	 * worker threads if <rootTable> can be detached and serially if it can not
+	 * (some table has a metatable). parseFunc must only write to def <i>; what
+	 * it throws is returned at index <i>.
+	 */
+	static std::vector<std::exception_ptr> ParseDefTables(
+		const LuaTable& rootTable,
+		const std::vector<std::string>& defNames,
+		const std::function<void(int, const LuaTable&)>& parseFunc
+	);
+
 	// loads a soundfile, adds "sounds/" prefix and ".wav" extension if necessary
 	static int LoadSoundFile(const std::string& fileName);
+	// decodes and loads the files of all sound-sets added so far in one batch
+	static void LoadSoundFiles();
+
+private:
+	// name to pass to ISound::GetSoundId for fileName, empty if there is none
+	static std::string GetSoundName(const std::string& fileName);
 };
 
 #endif
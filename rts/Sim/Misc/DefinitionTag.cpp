@@ -17,6 +17,8 @@ using std::cout;
 	LOG_L(L_ERROR, "%s:%d: " fmt, (data)->GetDeclarationFile().Get().c_str(), (data)->GetDeclarationLine().Get(), ## __VA_ARGS__) \
 
 
+thread_local const LuaTable* DefType::luaTable = nullptr;
+
 DefType::DefType(const char* n): name(n) {
 	metaDataMem.fill(0);
 	defInitFuncs.fill(nullptr);
@@ -249,11 +251,13 @@ void DefType::ReportUnknownTags(const std::string& instanceName, const LuaTable&
 void DefType::Load(void* instance, const LuaTable& luaTable)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	this->luaTable = &luaTable;
+	const LuaTable* prevTable = DefType::luaTable;
+
+	DefType::luaTable = &luaTable;
 
 	for (unsigned int i = 0; i < defInitFuncCnt; i++) {
 		defInitFuncs[i](instance);
 	}
 
-	this->luaTable = nullptr;
+	DefType::luaTable = prevTable;
 }
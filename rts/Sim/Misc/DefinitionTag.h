@@ -313,7 +313,9 @@ private:
 	unsigned int metaDataMemIdx = 0;
 
 	const char* name = nullptr;
-	const LuaTable* luaTable = nullptr;
+
+	// per thread, defs of the same type can be loaded in parallel
+	static thread_local const LuaTable* luaTable;
 
 private:
 	static std::vector<const DefType*>& GetTypes() {
@@ -0,0 +1,129 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "PieceBVH.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "System/Misc/TracyDefs.h"
+
+
+void CPieceBVH::Build(const std::vector<Box>& leafBoxes)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	Clear();
+
+	if (leafBoxes.empty())
+		return;
+
+	leafIndices.resize(leafBoxes.size());
+	nodes.reserve(leafBoxes.size() * 2 - 1);
+	nodes.emplace_back();
+
+	for (uint32_t i = 0; i < leafIndices.size(); i++) {
+		leafIndices[i] = i;
+	}
+
+	BuildRec(0, 0, leafIndices.size(), leafBoxes);
+	assert(nodes.size() == (leafBoxes.size() * 2 - 1));
+}
+
+void CPieceBVH::BuildRec(uint32_t nodeIdx, uint32_t first, uint32_t count, const std::vector<Box>& leafBoxes)
+{
+	Box bounds;
+	Box centers;
+
+	bounds.Reset();
+	centers.Reset();
+
+	for (uint32_t i = first; i < first + count; i++) {
+		const Box& b = leafBoxes[leafIndices[i]];
+		const float3 c = b.GetCenter();
+
+		bounds.Merge(b);
+		centers.Merge({c, c});
+	}
+
+	nodes[nodeIdx].box = bounds;
+
+	if (count == 1) {
+		nodes[nodeIdx].index = first;
+		nodes[nodeIdx].leaf = true;
+		return;
+	}
+
+	// median split along the axis with the largest spread of leaf centers;
+	// ties are ordered by leaf index so the topology is fully deterministic
+	const float3 extents = centers.maxs - centers.mins;
+	const int axis = (extents.x >= extents.y && extents.x >= extents.z)? 0: ((extents.y >= extents.z)? 1: 2);
+
+	const auto pred = [&](uint32_t a, uint32_t b) {
+		const float ca = leafBoxes[a].GetCenter()[axis];
+		const float cb = leafBoxes[b].GetCenter()[axis];
+		return ((ca < cb) || (ca == cb && a < b));
+	};
+
+	const uint32_t half = count >> 1;
+	const uint32_t childIdx = nodes.size();
+
+	std::nth_element(leafIndices.begin() + first, leafIndices.begin() + first + half, leafIndices.begin() + first + count, pred);
+
+	nodes.emplace_back();
+	nodes.emplace_back();
+	nodes[nodeIdx].index = childIdx;
+
+	BuildRec(childIdx + 0, first       ,         half, leafBoxes);
+	BuildRec(childIdx + 1, first + half, count - half, leafBoxes);
+}
+
+void CPieceBVH::Refit(const std::vector<Box>& leafBoxes)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	assert(leafBoxes.size() == leafIndices.size());
+
+	// children are always stored after their parent
+	for (size_t n = nodes.size(); n > 0; n--) {
+		Node& node = nodes[n - 1];
+
+		if (node.IsLeaf()) {
+			node.box = leafBoxes[leafIndices[node.index]];
+			continue;
+		}
+
+		node.box = nodes[node.index + 0].box;
+		node.box.Merge(nodes[node.index + 1].box);
+	}
+}
+
+
+bool CPieceBVH::SegmentOverlapsBox(const float3& p0, const float3& dir, const Box& box)
+{
+	// slab test, clipping t to [0, 1]
+	float tn = 0.0f;
+	float tf = 1.0f;
+
+	for (int a = 0; a < 3; a++) {
+		if (dir[a] == 0.0f) {
+			if (p0[a] < box.mins[a] || p0[a] > box.maxs[a])
+				return false;
+
+			continue;
+		}
+
+		const float id = 1.0f / dir[a];
+
+		float t0 = (box.mins[a] - p0[a]) * id;
+		float t1 = (box.maxs[a] - p0[a]) * id;
+
+		if (t0 > t1)
+			std::swap(t0, t1);
+
+		tn = std::max(tn, t0);
+		tf = std::min(tf, t1);
+
+		if (tn > tf)
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,109 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef PIECE_BVH_H
+#define PIECE_BVH_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "System/float3.h"
+
+/**
+ * Binary AABB hierarchy over the collision volumes of a LocalModel's pieces
+ * (in model-space), used to limit the pieces tested by per-piece raytraces.
+ *
+ * Topology is built once from the initial leaf boxes; animation only refits
+ * node bounds bottom-up since pieces stay close to their initial layout.
+ */
+class CPieceBVH {
+public:
+	struct Box {
+		float3 mins;
+		float3 maxs;
+
+		void Reset() {
+			mins = float3( std::numeric_limits<float>::max());
+			maxs = float3(-std::numeric_limits<float>::max());
+		}
+		void Merge(const Box& b) {
+			mins = float3::min(mins, b.mins);
+			maxs = float3::max(maxs, b.maxs);
+		}
+
+		float3 GetCenter() const { return ((mins + maxs) * 0.5f); }
+	};
+
+public:
+	void Build(const std::vector<Box>& leafBoxes);
+	void Refit(const std::vector<Box>& leafBoxes);
+	void Clear() {
+		nodes.clear();
+		leafIndices.clear();
+	}
+
+	bool Empty() const { return nodes.empty(); }
+
+	size_t GetNumLeaves() const { return leafIndices.size(); }
+	size_t GetNumNodes() const { return nodes.size(); }
+
+	const Box& GetRootBox() const { return nodes[0].box; }
+
+	/**
+	 * Calls func(leafIndex) for every leaf whose box overlaps the segment
+	 * [p0, p1]; leaves are visited in no particular order, so callers that
+	 * need a deterministic result have to break ties themselves.
+	 */
+	template<typename F> void Traverse(const float3& p0, const float3& p1, F&& func) const {
+		if (nodes.empty())
+			return;
+
+		const float3 dir = p1 - p0;
+
+		// indices of nodes still to be visited; each level adds at most
+		// one entry and median splits keep the depth at log2(numLeaves)
+		uint32_t stack[MAX_DEPTH + 1];
+		uint32_t size = 0;
+
+		stack[size++] = 0;
+
+		while (size > 0) {
+			const Node& node = nodes[stack[--size]];
+
+			if (!SegmentOverlapsBox(p0, dir, node.box))
+				continue;
+
+			if (node.IsLeaf()) {
+				func(leafIndices[node.index]);
+				continue;
+			}
+
+			stack[size++] = node.index + 1;
+			stack[size++] = node.index;
+		}
+	}
+
+	static bool SegmentOverlapsBox(const float3& p0, const float3& dir, const Box& box);
+
+private:
+	struct Node {
+		Box box;
+
+		// first child for inner nodes (second child is at index + 1),
+		// position in leafIndices for leaves
+		uint32_t index = 0;
+		bool leaf = false;
+
+		bool IsLeaf() const { return leaf; }
+	};
+
+	void BuildRec(uint32_t nodeIdx, uint32_t first, uint32_t count, const std::vector<Box>& leafBoxes);
+
+	static constexpr uint32_t MAX_DEPTH = 64;
+
+private:
+	std::vector<Node> nodes;
+	std::vector<uint32_t> leafIndices;
+};
+
+#endif
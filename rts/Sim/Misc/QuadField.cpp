@@ -13,6 +13,7 @@
 
 #ifndef UNIT_TEST
 	#include "Sim/Features/Feature.h"
+	#include "Sim/Features/FeatureDef.h"
 	#include "Sim/Projectiles/Projectile.h"
 	#include "Sim/Units/Unit.h"
 	#include "Sim/Weapons/PlasmaRepulser.h"
@@ -43,6 +44,7 @@ CR_REG_METADATA_SUB(CQuadField, Quad, (
 	CR_MEMBER(features),
 	CR_MEMBER(projectiles),
 	CR_MEMBER(repulsers),
+	CR_MEMBER(featureCounts),
 
 	CR_POSTLOAD(PostLoad)
 ))
@@ -434,6 +436,8 @@ bool CQuadField::RemoveUnitIf(CUnit* unit, const float3& wpos)
 void CQuadField::MovedUnit(CUnit* unit)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	CSolidObject::SetObjectsMoved();
+
 	QuadFieldQuery qfQuery;
 	GetQuads(qfQuery, unit->pos, unit->radius);
 
@@ -459,6 +463,8 @@ void CQuadField::MovedUnit(CUnit* unit)
 void CQuadField::RemoveUnit(CUnit* unit)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	CSolidObject::SetObjectsMoved();
+
 	for (const int qi: unit->quads) {
 		spring::VectorErase(baseQuads[qi].units, unit);
 		spring::VectorErase(baseQuads[qi].teamUnits[unit->allyteam], unit);
@@ -522,25 +528,53 @@ void CQuadField::RemoveRepulser(CPlasmaRepulser* repulser)
 }
 
 
+unsigned int CQuadField::GetFeatureCategoryBits(const CFeature* feature)
+{
+	unsigned int bits = 0;
+
+	if (feature->def->reclaimable) {
+		bits |= FEATURE_CAT_RECLAIMABLE;
+		bits |= (FEATURE_CAT_AUTORECLAIMABLE    * (feature->def->autoreclaim));
+		bits |= (FEATURE_CAT_RECLAIMABLE_METAL  * (feature->defResources.metal  > 0.0f));
+		bits |= (FEATURE_CAT_RECLAIMABLE_ENERGY * (feature->defResources.energy > 0.0f));
+	}
+
+	bits |= (FEATURE_CAT_RESURRECTABLE * (feature->udef != nullptr));
+	return bits;
+}
+
+
 void CQuadField::AddFeature(CFeature* feature)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	CSolidObject::SetObjectsMoved();
+
 	QuadFieldQuery qfQuery;
 	GetQuads(qfQuery, feature->pos, feature->radius);
 
+	const unsigned int categoryBits = GetFeatureCategoryBits(feature);
+
 	for (const int qi: *qfQuery.quads) {
 		spring::VectorInsertUnique(baseQuads[qi].features, feature, false);
+		baseQuads[qi].AddFeatureCategories(categoryBits, 1);
 	}
 }
 
 void CQuadField::RemoveFeature(CFeature* feature)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	CSolidObject::SetObjectsMoved();
+
 	QuadFieldQuery qfQuery;
 	GetQuads(qfQuery, feature->pos, feature->radius);
 
+	const unsigned int categoryBits = GetFeatureCategoryBits(feature);
+
 	for (const int qi: *qfQuery.quads) {
-		spring::VectorErase(baseQuads[qi].features, feature);
+		if (!spring::VectorErase(baseQuads[qi].features, feature))
+			continue;
+
+		baseQuads[qi].AddFeatureCategories(categoryBits, -1);
 	}
 
 	#ifdef DEBUG_QUADFIELD
@@ -552,6 +586,28 @@ void CQuadField::RemoveFeature(CFeature* feature)
 	#endif
 }
 
+void CQuadField::ChangedFeature(CFeature* feature, unsigned int prevCategoryBits)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const unsigned int currCategoryBits = GetFeatureCategoryBits(feature);
+
+	if (currCategoryBits == prevCategoryBits)
+		return;
+
+	QuadFieldQuery qfQuery;
+	GetQuads(qfQuery, feature->pos, feature->radius);
+
+	for (const int qi: *qfQuery.quads) {
+		Quad& quad = baseQuads[qi];
+
+		if (std::find(quad.features.begin(), quad.features.end(), feature) == quad.features.end())
+			continue;
+
+		quad.AddFeatureCategories(prevCategoryBits, -1);
+		quad.AddFeatureCategories(currCategoryBits,  1);
+	}
+}
+
 
 
 void CQuadField::MovedProjectile(CProjectile* p)
@@ -697,6 +753,11 @@ void CQuadField::GetUnitsExact(QuadFieldQuery& qfq, const float3& mins, const fl
 
 
 void CQuadField::GetFeaturesExact(QuadFieldQuery& qfq, const float3& pos, float radius, bool spherical)
+{
+	GetFeaturesExact(qfq, pos, radius, spherical, 0);
+}
+
+void CQuadField::GetFeaturesExact(QuadFieldQuery& qfq, const float3& pos, float radius, bool spherical, unsigned int categoryBits)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	auto curThread = qfq.threadOwner;
@@ -707,6 +768,9 @@ void CQuadField::GetFeaturesExact(QuadFieldQuery& qfq, const float3& pos, float
 	qfq.features = tempFeatures[curThread].ReserveVector();
 
 	for (const int qi: *qfQuery.quads) {
+		if (categoryBits != 0 && !baseQuads[qi].HasFeatureCategories(categoryBits))
+			continue;
+
 		for (CFeature* f: baseQuads[qi].features) {
 			if (f->mtTempNum[curThread] == tempNum)
 				continue;
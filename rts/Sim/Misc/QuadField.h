@@ -80,7 +80,18 @@ class CQuadField : spring::noncopyable
 	CR_DECLARE_SUB(Quad)
 
 public:
+	// feature properties aggregated per quad, used to prune area searches
+	enum FeatureCategoryBits {
+		FEATURE_CAT_RECLAIMABLE        = 1 << 0,
+		FEATURE_CAT_AUTORECLAIMABLE    = 1 << 1, // reclaimable *and* autoreclaim
+		FEATURE_CAT_RECLAIMABLE_METAL  = 1 << 2, // reclaimable *and* metal > 0
+		FEATURE_CAT_RECLAIMABLE_ENERGY = 1 << 3, // reclaimable *and* energy > 0
+		FEATURE_CAT_RESURRECTABLE      = 1 << 4,
+	};
+
+	static constexpr unsigned int NUM_FEATURE_CATEGORIES = 5;
 
+	static unsigned int GetFeatureCategoryBits(const CFeature* feature);
 
 	void Init(int2 mapDims, int quadSize);
 	void Kill();
@@ -120,6 +131,12 @@ public:
 	 * and performs the search within a sphere or cylinder depending on @c spherical
 	 */
 	void GetFeaturesExact(QuadFieldQuery& qfq, const float3& pos, float radius, bool spherical = true);
+	/**
+	 * Same as above, but skips every quad that contains no features
+	 * belonging to at least one of the FEATURE_CAT_* in @c categoryBits
+	 * (returned features are not filtered, callers must still test them)
+	 */
+	void GetFeaturesExact(QuadFieldQuery& qfq, const float3& pos, float radius, bool spherical, unsigned int categoryBits);
 	/**
 	 * Returns all features within the rectangle defined by
 	 * mins and maxs, which extends infinitely along the y-axis
@@ -153,6 +170,8 @@ public:
 
 	void AddFeature(CFeature* feature);
 	void RemoveFeature(CFeature* feature);
+	/// must be called when a feature's category bits might have changed in-place
+	void ChangedFeature(CFeature* feature, unsigned int prevCategoryBits);
 
 	void MovedProjectile(CProjectile* projectile);
 	void AddProjectile(CProjectile* projectile);
@@ -184,6 +203,7 @@ public:
 			features = std::move(q.features);
 			projectiles = std::move(q.projectiles);
 			repulsers = std::move(q.repulsers);
+			featureCounts = q.featureCounts;
 			return *this;
 		}
 
@@ -199,6 +219,22 @@ public:
 			features.clear();
 			projectiles.clear();
 			repulsers.clear();
+			featureCounts.fill(0);
+		}
+
+		void AddFeatureCategories(unsigned int categoryBits, int delta) {
+			for (unsigned int i = 0; i < NUM_FEATURE_CATEGORIES; i++) {
+				featureCounts[i] += (delta * ((categoryBits >> i) & 1));
+				assert(featureCounts[i] >= 0);
+			}
+		}
+		bool HasFeatureCategories(unsigned int categoryBits) const {
+			for (unsigned int i = 0; i < NUM_FEATURE_CATEGORIES; i++) {
+				if (((categoryBits >> i) & 1) != 0 && featureCounts[i] > 0)
+					return true;
+			}
+
+			return false;
 		}
 
 	public:
@@ -207,6 +243,9 @@ public:
 		std::vector<CFeature*> features;
 		std::vector<CProjectile*> projectiles;
 		std::vector<CPlasmaRepulser*> repulsers;
+
+		// number of features in this quad per FEATURE_CAT_* bit
+		std::array<int, NUM_FEATURE_CATEGORIES> featureCounts = {};
 	};
 
 	const Quad& GetQuad(unsigned i) const {
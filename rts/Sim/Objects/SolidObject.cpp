@@ -16,6 +16,7 @@
 #include "System/Misc/TracyDefs.h"
 
 int CSolidObject::deletingRefID = -1;
+std::atomic<bool> CSolidObject::objectsMoved = {false};
 
 
 CR_BIND_DERIVED_INTERFACE(CSolidObject, CWorldObject)
@@ -414,6 +415,8 @@ void CSolidObject::UpdateDirVectors(const float3& uDir)
 	frontdir = quat * fDir;
 	rightdir = quat * rDir;
 	updir = uDir;
+
+	SetObjectsMoved();
 }
 
 void CSolidObject::ForcedSpin(const float3& zdir)
@@ -434,6 +437,8 @@ void CSolidObject::ForcedSpin(const float3& zdir)
 	rightdir = xdir;
 	   updir = ydir;
 
+	SetObjectsMoved();
+
 	SetHeadingFromDirection();
 	UpdateMidAndAimPos();
 }
@@ -448,6 +453,8 @@ void CSolidObject::ForcedSpin(const float3& newFrontDir, const float3& newRightD
 	rightdir = newRightDir;
 	   updir = (newRightDir.cross(newFrontDir)).Normalize();
 
+	SetObjectsMoved();
+
 	SetHeadingFromDirection();
 	UpdateMidAndAimPos();
 }
@@ -3,6 +3,7 @@
 #ifndef SOLID_OBJECT_H
 #define SOLID_OBJECT_H
 
+#include <atomic>
 #include <bit>
 
 #include "WorldObject.h"
@@ -149,6 +150,8 @@ public:
 		pos += dv;
 		midPos += dv;
 		aimPos += dv;
+
+		SetObjectsMoved();
 	}
 
 	// this should be called whenever the direction
@@ -169,6 +172,8 @@ public:
 		rightdir.x = -matrix[0]; updir.x = matrix[4]; frontdir.x = matrix[ 8];
 		rightdir.y = -matrix[1]; updir.y = matrix[5]; frontdir.y = matrix[ 9];
 		rightdir.z = -matrix[2]; updir.z = matrix[6]; frontdir.z = matrix[10];
+
+		SetObjectsMoved();
 	}
 
 	void AddHeading(short deltaHeading, bool useGroundNormal, bool useObjectNormal, float dirSmoothing) { SetHeading(heading + deltaHeading, useGroundNormal, useObjectNormal, dirSmoothing); }
@@ -457,6 +462,24 @@ public:
 	// returns the object (command reference) id of the object currently being deleted,
 	// for units this equals unit->id, and for features feature->id + unitHandler.MaxUnits()
 	static int GetDeletingRefID() { return deletingRefID; }
+
+	// set whenever a solid object moves, turns or enters or leaves the quadfield,
+	// polled (and cleared) by caches of collision queries such as line-of-fire
+	// tests; movetypes set it from worker threads, so only store when it changed
+	static void SetObjectsMoved() {
+		if (!objectsMoved.load(std::memory_order_relaxed))
+			objectsMoved.store(true, std::memory_order_relaxed);
+	}
+	static bool GetResetObjectsMoved() {
+		if (!objectsMoved.load(std::memory_order_relaxed))
+			return false;
+
+		objectsMoved.store(false, std::memory_order_relaxed);
+		return true;
+	}
+
+private:
+	static std::atomic<bool> objectsMoved;
 };
 
 #endif // SOLID_OBJECT_H
@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <cassert>
 #include <cinttypes>
+#include <cstring>
 
 #include "ExplosionGenerator.h"
 #include "ExpGenSpawner.h" //!!
@@ -600,124 +601,291 @@ bool CStdExplosionGenerator::Explosion(
 
 
 
-void CCustomExplosionGenerator::ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir)
+static inline float FoldConstantOp(int opcode, float val, float arg)
+{
+	switch (opcode) {
+		case CCustomExplosionGenerator::OP_ADD     : { return (val + arg); } break;
+		case CCustomExplosionGenerator::OP_SAWTOOTH: { return (val - arg * math::floor(val / arg)); } break;
+		case CCustomExplosionGenerator::OP_DISCRETE: { return (arg * math::floor(spring::SafeDivide(val, arg))); } break;
+		case CCustomExplosionGenerator::OP_SINE    : { return (arg * math::sin(val)); } break;
+		case CCustomExplosionGenerator::OP_POW     : { return (math::pow(val, arg)); } break;
+		default: { assert(false); } break;
+	}
+
+	return val;
+}
+
+static inline bool SameFloatBits(float a, float b)
+{
+	return (std::memcmp(&a, &b, sizeof(float)) == 0);
+}
+
+
+// translates the byte-code produced by ParseExplosionCode into an array of
+// pre-decoded ops; every run of operations that only depends on constants is
+// evaluated here (with the same arithmetic as ExecuteExplosionCode) so only
+// the random, damage-, index- and buffer-dependent parts remain per spawn
+void CCustomExplosionGenerator::CompileExplosionCode(ProjectileSpawnInfo* psi, const std::string& code)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const auto ReadU8  = [&](size_t& p) { std::uint8_t  v; std::memcpy(&v, &code[p], sizeof(v)); p += sizeof(v); return v; };
+	const auto ReadU16 = [&](size_t& p) { std::uint16_t v; std::memcpy(&v, &code[p], sizeof(v)); p += sizeof(v); return v; };
+	const auto ReadF32 = [&](size_t& p) { float         v; std::memcpy(&v, &code[p], sizeof(v)); p += sizeof(v); return v; };
+	const auto ReadI32 = [&](size_t& p) { int           v; std::memcpy(&v, &code[p], sizeof(v)); p += sizeof(v); return v; };
+	const auto ReadPtr = [&](size_t& p) { void*         v; std::memcpy(&v, &code[p], sizeof(v)); p += sizeof(v); return v; };
+
+	std::vector<SpawnOp>& ops = psi->ops;
+
+	// compile-time value of the val-register (if known), and the
+	// value the register will actually hold at this point at run-time
+	bool  constVal = true;
+	float constReg = 0.0f;
+	bool  knownReg = true;
+	float valueReg = 0.0f;
+
+	void* pendingPtr = nullptr;
+
+	// makes the run-time register agree with the folded value
+	const auto MaterializeVal = [&]() {
+		if (!constVal)
+			return;
+		if (knownReg && SameFloatBits(valueReg, constReg))
+			return;
+
+		SpawnOp op;
+		op.opcode = OP_LOADF;
+		op.arg.f = constReg;
+		ops.push_back(op);
+
+		knownReg = true;
+		valueReg = constReg;
+	};
+	const auto ResetVal = [&]() {
+		constVal = true;
+		constReg = 0.0f;
+		knownReg = true;
+		valueReg = 0.0f;
+	};
+
+	ops.clear();
+	ops.reserve(code.size() / 4);
+
+	psi->usesBuffer = false;
+
+	for (size_t p = 0, n = code.size(); p < n; ) {
+		SpawnOp op;
+
+		switch ((op.opcode = ReadU8(p))) {
+			case OP_END: {
+				p = n;
+			} break;
+
+			case OP_STOREI:
+			case OP_STOREF: {
+				op.size   = ReadU8(p);
+				op.offset = ReadU16(p);
+
+				if (constVal) {
+					op.opcode = (op.opcode == OP_STOREI)? OP_STOREIC: OP_STOREFC;
+					op.arg.f = constReg;
+					ops.push_back(op);
+
+					// run-time register is left untouched by constant stores
+					constVal = true;
+					constReg = 0.0f;
+				} else {
+					ops.push_back(op);
+					ResetVal();
+				}
+			} break;
+
+			case OP_ADD:
+			case OP_SAWTOOTH:
+			case OP_DISCRETE:
+			case OP_SINE:
+			case OP_POW: {
+				op.arg.f = ReadF32(p);
+
+				if (constVal) {
+					constReg = FoldConstantOp(op.opcode, constReg, op.arg.f);
+				} else {
+					ops.push_back(op);
+				}
+			} break;
+
+			case OP_RAND:
+			case OP_DAMAGE:
+			case OP_INDEX: {
+				op.arg.f = ReadF32(p);
+
+				MaterializeVal();
+				ops.push_back(op);
+
+				constVal = false;
+				knownReg = false;
+			} break;
+
+			case OP_YANK: {
+				op.arg.i = ReadI32(p);
+
+				MaterializeVal();
+				ops.push_back(op);
+				ResetVal();
+
+				psi->usesBuffer = true;
+			} break;
+
+			case OP_MULTIPLY:
+			case OP_ADDBUFF:
+			case OP_POWBUFF: {
+				op.arg.i = ReadI32(p);
+
+				MaterializeVal();
+				ops.push_back(op);
+
+				constVal = false;
+				knownReg = false;
+
+				psi->usesBuffer = true;
+			} break;
+
+			case OP_LOADP: {
+				pendingPtr = ReadPtr(p);
+			} break;
+			case OP_STOREP: {
+				op.offset = ReadU16(p);
+				op.arg.p = pendingPtr;
+				ops.push_back(op);
+
+				pendingPtr = nullptr;
+			} break;
+
+			case OP_DIR: {
+				op.offset = ReadU16(p);
+				ops.push_back(op);
+			} break;
+
+			default: {
+				assert(false);
+				p = n;
+			} break;
+		}
+	}
+
+	ops.shrink_to_fit();
+}
+
+void CCustomExplosionGenerator::ExecuteExplosionCode(const ProjectileSpawnInfo& psi, float damage, char* instance, int spawnIndex, const float3& dir)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	float val = 0.0f;
 	float buffer[16];
-	void* ptr = nullptr;
 
-	std::memset(&buffer[0], 0, sizeof(buffer));
+	if (psi.usesBuffer)
+		std::memset(&buffer[0], 0, sizeof(buffer));
 
-	for (;;) {
-		switch (*(code++)) {
-			case OP_END: {
-				return;
-			}
+	for (const SpawnOp& op: psi.ops) {
+		switch (op.opcode) {
 			case OP_STOREI: {
-				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
-				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
-				switch (size) {
-					case 1: { *(std::int8_t*)  (instance + offset) = (int) val; } break;
-					case 2: { *(std::int16_t*) (instance + offset) = (int) val; } break;
-					case 4: { *(std::int32_t*) (instance + offset) = (int) val; } break;
-					case 8: { *(std::int64_t*) (instance + offset) = (int) val; } break;
+				switch (op.size) {
+					case 1: { *(std::int8_t*)  (instance + op.offset) = (int) val; } break;
+					case 2: { *(std::int16_t*) (instance + op.offset) = (int) val; } break;
+					case 4: { *(std::int32_t*) (instance + op.offset) = (int) val; } break;
+					case 8: { *(std::int64_t*) (instance + op.offset) = (int) val; } break;
 					default: { /*no op*/ } break;
 				}
 				val = 0.0f;
 				break;
 			}
 			case OP_STOREF: {
-				std::uint8_t  size   = *(std::uint8_t*)  code; code++;
-				std::uint16_t offset = *(std::uint16_t*) code; code += 2;
-				switch (size) {
-					case 4: { *(float*)  (instance + offset) = val; } break;
-					case 8: { *(double*) (instance + offset) = val; } break;
+				switch (op.size) {
+					case 4: { *(float*)  (instance + op.offset) = val; } break;
+					case 8: { *(double*) (instance + op.offset) = val; } break;
 					default: { /*no op*/ } break;
 				}
 				val = 0.0f;
 				break;
 			}
+			case OP_STOREIC: {
+				switch (op.size) {
+					case 1: { *(std::int8_t*)  (instance + op.offset) = (int) op.arg.f; } break;
+					case 2: { *(std::int16_t*) (instance + op.offset) = (int) op.arg.f; } break;
+					case 4: { *(std::int32_t*) (instance + op.offset) = (int) op.arg.f; } break;
+					case 8: { *(std::int64_t*) (instance + op.offset) = (int) op.arg.f; } break;
+					default: { /*no op*/ } break;
+				}
+				break;
+			}
+			case OP_STOREFC: {
+				switch (op.size) {
+					case 4: { *(float*)  (instance + op.offset) = op.arg.f; } break;
+					case 8: { *(double*) (instance + op.offset) = op.arg.f; } break;
+					default: { /*no op*/ } break;
+				}
+				break;
+			}
+			case OP_LOADF: {
+				val = op.arg.f;
+				break;
+			}
 			case OP_ADD: {
-				val += *(float*) code;
-				code += 4;
+				val += op.arg.f;
 				break;
 			}
 			case OP_RAND: {
-				val += guRNG.NextFloat() * (*(float*) code);
-				code += 4;
+				val += guRNG.NextFloat() * op.arg.f;
 				break;
 			}
 			case OP_DAMAGE: {
-				val += damage * (*(float*) code);
-				code += 4;
+				val += damage * op.arg.f;
 				break;
 			}
 			case OP_INDEX: {
-				val += spawnIndex * (*(float*) code);
-				code += 4;
+				val += spawnIndex * op.arg.f;
 				break;
 			}
 
-			case OP_LOADP: {
-				ptr = *(void**) code;
-				code += sizeof(void*);
-				break;
-			}
 			case OP_STOREP: {
-				std::uint16_t offset = *(std::uint16_t*) code;
-				code += 2;
-				*(void**) (instance + offset) = ptr;
-				ptr = nullptr;
+				*(void**) (instance + op.offset) = op.arg.p;
 				break;
 			}
 
 			case OP_DIR: {
-				std::uint16_t offset = *(std::uint16_t*) code;
-				code += 2;
-				*reinterpret_cast<float3*>(instance + offset) = dir;
+				*reinterpret_cast<float3*>(instance + op.offset) = dir;
 				break;
 			}
 			case OP_SAWTOOTH: {
 				// this translates to modulo except it works with floats
-				val -= (*(float*) code) * math::floor(val / (*(float*) code));
-				code += 4;
+				val -= op.arg.f * math::floor(val / op.arg.f);
 				break;
 			}
 			case OP_DISCRETE: {
-				val = (*(float*) code) * math::floor(spring::SafeDivide(val, (*(float*) code)));
-				code += 4;
+				val = op.arg.f * math::floor(spring::SafeDivide(val, op.arg.f));
 				break;
 			}
 			case OP_SINE: {
-				val = (*(float*) code) * math::sin(val);
-				code += 4;
+				val = op.arg.f * math::sin(val);
 				break;
 			}
 			case OP_YANK: {
-				buffer[(*(int*) code)] = val;
+				buffer[op.arg.i] = val;
 				val = 0;
-				code += 4;
 				break;
 			}
 			case OP_MULTIPLY: {
-				val *= buffer[(*(int*) code)];
-				code += 4;
+				val *= buffer[op.arg.i];
 				break;
 			}
 			case OP_ADDBUFF: {
-				val += buffer[(*(int*) code)];
-				code += 4;
+				val += buffer[op.arg.i];
 				break;
 			}
 			case OP_POW: {
-				val = math::pow(val, (*(float*) code));
-				code += 4;
+				val = math::pow(val, op.arg.f);
 				break;
 			}
 			case OP_POWBUFF: {
-				val = math::pow(val, buffer[(*(int*) code)]);
-				code += 4;
+				val = math::pow(val, buffer[op.arg.i]);
 				break;
 			}
 			default: {
@@ -947,8 +1115,7 @@ bool CCustomExplosionGenerator::Load(CExplosionGeneratorHandler* handler, const
 		}
 
 		code += (char)OP_END;
-		psi.code.resize(code.size());
-		copy(code.begin(), code.end(), psi.code.begin());
+		CompileExplosionCode(&psi, code);
 
 		expGenParams.projectiles.push_back(psi);
 	}
@@ -1026,7 +1193,7 @@ bool CCustomExplosionGenerator::Explosion(
 
 		for (unsigned int c = 0; c < psi.count; c++) {
 			CExpGenSpawnable* projectile = CExpGenSpawnable::CreateSpawnable(psi.spawnableID);
-			ExecuteExplosionCode(&psi.code[0], damage, (char*) projectile, c, dir);
+			ExecuteExplosionCode(psi, damage, (char*) projectile, c, dir);
 			projectile->Init(owner, pos);
 		}
 	}
@@ -3,6 +3,7 @@
 #ifndef EXPLOSION_GENERATOR_H
 #define EXPLOSION_GENERATOR_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -143,6 +144,19 @@ public:
 class CCustomExplosionGenerator: public IExplosionGenerator
 {
 protected:
+	/// one pre-decoded instruction of a compiled spawn program
+	struct SpawnOp {
+		std::uint8_t  opcode = 0;
+		std::uint8_t  size   = 0;
+		std::uint16_t offset = 0;
+
+		union {
+			float f;
+			int   i;
+			void* p;
+		} arg = {0.0f};
+	};
+
 	struct ProjectileSpawnInfo {
 		unsigned int spawnableID = 0;
 
@@ -150,8 +164,10 @@ protected:
 		unsigned int count = 0;
 		unsigned int flags = 0;
 
-		/// parsed explosion script code
-		std::vector<char> code;
+		/// compiled explosion script code, executed once per spawned projectile
+		std::vector<SpawnOp> ops;
+		/// true if any op reads or writes the yank-buffer
+		bool usesBuffer = false;
 	};
 
 	struct ExpGenParams {
@@ -214,11 +230,17 @@ public:
 		OP_ADDBUFF  = 16, // Adds buffer value
 		OP_POW      = 17, // Power with code as exponent
 		OP_POWBUFF  = 18, // Power with buffer as exponent
+
+		// compiled-only opcodes, never emitted by ParseExplosionCode
+		OP_LOADF    = 19, // set val to a constant folded at load-time
+		OP_STOREIC  = 20, // store a folded constant into an int member
+		OP_STOREFC  = 21, // store a folded constant into a float member
 	};
 
 private:
 	void ParseExplosionCode(ProjectileSpawnInfo* psi, const std::string& script, SExpGenSpawnableMemberInfo& memberInfo, std::string& code);
-	void ExecuteExplosionCode(const char* code, float damage, char* instance, int spawnIndex, const float3& dir);
+	static void CompileExplosionCode(ProjectileSpawnInfo* psi, const std::string& code);
+	static void ExecuteExplosionCode(const ProjectileSpawnInfo& psi, float damage, char* instance, int spawnIndex, const float3& dir);
 
 protected:
 	ExpGenParams expGenParams;
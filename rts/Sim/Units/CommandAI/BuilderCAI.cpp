@@ -1438,8 +1438,21 @@ int CBuilderCAI::FindReclaimTarget(const float3& pos, float radius, unsigned cha
 	if ((!best || !stationary) && !recEnemyOnly) {
 		best = nullptr;
 		const CTeam* team = teamHandler.Team(owner->team);
+
+		// only visit quads that can contain a valid candidate; without
+		// free storage for either resource none of them can qualify
+		unsigned int featureCats = recSpecial? CQuadField::FEATURE_CAT_RECLAIMABLE: CQuadField::FEATURE_CAT_AUTORECLAIMABLE;
+
+		if (!noResCheck) {
+			featureCats  = CQuadField::FEATURE_CAT_RECLAIMABLE_METAL  * (team->res.metal  < team->resStorage.metal );
+			featureCats |= CQuadField::FEATURE_CAT_RECLAIMABLE_ENERGY * (team->res.energy < team->resStorage.energy);
+		}
+
+		if (featureCats == 0)
+			return rid;
+
 		QuadFieldQuery qfQuery;
-		quadField.GetFeaturesExact(qfQuery, pos, radius, false);
+		quadField.GetFeaturesExact(qfQuery, pos, radius, false, featureCats);
 		bool metal = false;
 
 		for (const CFeature* f: *qfQuery.features) {
@@ -1517,7 +1530,7 @@ bool CBuilderCAI::FindResurrectableFeatureAndResurrect(
 ) {
 	RECOIL_DETAILED_TRACY_ZONE;
 	QuadFieldQuery qfQuery;
-	quadField.GetFeaturesExact(qfQuery, pos, radius, false);
+	quadField.GetFeaturesExact(qfQuery, pos, radius, false, CQuadField::FEATURE_CAT_RESURRECTABLE);
 
 	const CFeature* best = nullptr;
 	float bestDist = 1.0e30f;
@@ -26,6 +26,26 @@ Command::~Command() {
 	cmdParamsPool.ReleasePage(pageIndex);
 }
 
+Command& Command::operator = (Command&& c) noexcept {
+	if (this == &c)
+		return *this;
+
+	if (IsPooledCommand())
+		cmdParamsPool.ReleasePage(pageIndex);
+
+	memcpy(&id[0], &c.id[0], sizeof(id));
+	memcpy(&params[0], &c.params[0], sizeof(params));
+
+	SetFlags(c.timeOut, c.tag, c.options);
+
+	pageIndex = c.pageIndex;
+	numParams = c.numParams;
+
+	c.pageIndex = -1u;
+	c.numParams = 0;
+	return *this;
+}
+
 
 const float* Command::GetParams(unsigned int idx) const {
 	if (idx >= numParams)
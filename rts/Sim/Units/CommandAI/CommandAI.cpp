@@ -51,6 +51,8 @@ static const float COMMAND_CANCEL_DIST = 17.0f;
 void CCommandAI::InitCommandDescriptionCache() { commandDescriptionCache.Init(); }
 void CCommandAI::KillCommandDescriptionCache() { commandDescriptionCache.Kill(); }
 
+CommandQueueMemPool cmdQueueMemPool;
+
 CR_BIND(CCommandQueue, )
 CR_REG_METADATA(CCommandQueue, (
 	CR_MEMBER(queue),
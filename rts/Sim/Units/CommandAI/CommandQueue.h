@@ -5,6 +5,30 @@
 
 #include <deque>
 #include "Command.h"
+#include "System/MemPoolTypes.h"
+
+// std::deque allocates its element blocks (and block map) separately
+// from the elements; long queues that are constantly grown and drained
+// from both ends (waypoints, factory repeat-queues) would otherwise hit
+// the system allocator for each block. Serve them from a shared small-
+// object pool instead, big allocations are passed through by smmalloc.
+typedef PassThroughPool<32, 2 * (1024 * 1024)> CommandQueueMemPool;
+
+extern CommandQueueMemPool cmdQueueMemPool;
+
+template<typename T> struct CommandQueueAllocator {
+public:
+	typedef T value_type;
+
+	CommandQueueAllocator() = default;
+	template<typename U> CommandQueueAllocator(const CommandQueueAllocator<U>&) {}
+
+	T* allocate(size_t n) { return (static_cast<T*>(cmdQueueMemPool.allocMem(n * sizeof(T)))); }
+	void deallocate(T* p, size_t n) { cmdQueueMemPool.freeMem(p); }
+
+	template<typename U> bool operator == (const CommandQueueAllocator<U>&) const { return true; }
+	template<typename U> bool operator != (const CommandQueueAllocator<U>&) const { return false; }
+};
 
 /// A wrapper class for std::deque<Command> to keep track of commands
 class CCommandQueue {
@@ -28,7 +52,7 @@ class CCommandQueue {
 		/// limit to a float's integer range
 		static const int maxTagValue = (1 << 24); // 16777216
 
-		typedef std::deque<Command> basis;
+		typedef std::deque<Command, CommandQueueAllocator<Command> > basis;
 
 		typedef basis::size_type              size_type;
 		typedef basis::iterator               iterator;
@@ -44,11 +68,11 @@ class CCommandQueue {
 		inline void push_front(const Command& cmd);
 
 		void emplace_back(Command&& cmd) {
-			queue.emplace_back(cmd);
+			queue.emplace_back(std::move(cmd));
 			queue.back().SetTag(GetNextTag());
 		}
 		void emplace_front(Command&& cmd) {
-			queue.emplace_front(cmd);
+			queue.emplace_front(std::move(cmd));
 			queue.front().SetTag(GetNextTag());
 		}
 
@@ -107,7 +131,7 @@ class CCommandQueue {
 		inline void SetQueueType(QueueType type) { queueType = type; }
 
 	private:
-		std::deque<Command> queue;
+		basis queue;
 		QueueType queueType;
 		int tagCounter;
 };
@@ -141,7 +165,7 @@ inline CCommandQueue::iterator CCommandQueue::insert(iterator pos, const Command
 {
 	Command tmpCmd = cmd;
 	tmpCmd.SetTag(GetNextTag());
-	return queue.insert(pos, tmpCmd);
+	return queue.insert(pos, std::move(tmpCmd));
 }
 
 
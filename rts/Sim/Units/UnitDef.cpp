@@ -41,11 +41,7 @@ UnitDefWeapon::UnitDefWeapon(const WeaponDef* weaponDef, const LuaTable& weaponT
 	//     (arcs are always symmetric around mainDir)
 	this->maxMainDirAngleDif = math::cos((weaponTable.GetFloat("maxAngleDif", 360.0f) * 0.5f) * math::DEG_TO_RAD);
 
-	const string& btcString = weaponTable.GetString("badTargetCategory", "");
-	const string& otcString = weaponTable.GetString("onlyTargetCategory", "");
-
-	this->badTargetCat =                                   CCategoryHandler::Instance()->GetCategories(btcString);
-	this->onlyTargetCat = (otcString.empty())? 0xffffffff: CCategoryHandler::Instance()->GetCategories(otcString);
+	// badTargetCat and onlyTargetCat are set by UnitDef::ResolveCategories
 
 	this->mainDir = weaponTable.GetFloat3("mainDir", FwdVector);
 	this->mainDir.SafeNormalize();
@@ -553,9 +549,6 @@ UnitDef::UnitDef(const LuaTable& udTable, const std::string& unitName, int id)
 
 	categoryString = udTable.GetString("category", "");
 
-	category = CCategoryHandler::Instance()->GetCategories(udTable.GetString("category", ""));
-	noChaseCategory = CCategoryHandler::Instance()->GetCategories(udTable.GetString("noChaseCategory", ""));
-
 	iconType = icon::iconHandler.GetIcon(udTable.GetString("iconType", "default"));
 
 	shieldWeaponDef    = nullptr;
@@ -761,7 +754,8 @@ void UnitDef::ParseWeaponsTable(const LuaTable& weaponsTable)
 			weapons[k++] = {noWeaponDef};
 		}
 
-		weapons[k++] = {wd, wTable};
+		weapons[k] = {wd, wTable};
+		weapons[k++].tableIndex = w + 1;
 
 		maxWeaponRange = std::max(maxWeaponRange, wd->range);
 
@@ -784,6 +778,33 @@ void UnitDef::ParseWeaponsTable(const LuaTable& weaponsTable)
 
 
 
+void UnitDef::ResolveCategories(const LuaTable& udTable)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	CCategoryHandler* categoryHandler = CCategoryHandler::Instance();
+
+	category = categoryHandler->GetCategories(udTable.GetString("category", ""));
+	noChaseCategory = categoryHandler->GetCategories(udTable.GetString("noChaseCategory", ""));
+
+	const LuaTable& weaponsTable = udTable.SubTable("weapons");
+
+	for (UnitDefWeapon& udw: weapons) {
+		// NOWEAPON padding or unused slot
+		if (udw.tableIndex == 0)
+			continue;
+
+		const LuaTable& weaponTable = weaponsTable.SubTable(udw.tableIndex);
+
+		const std::string& btcString = weaponTable.GetString("badTargetCategory", "");
+		const std::string& otcString = weaponTable.GetString("onlyTargetCategory", "");
+
+		udw.badTargetCat =                                   categoryHandler->GetCategories(btcString);
+		udw.onlyTargetCat = (otcString.empty())? 0xffffffff: categoryHandler->GetCategories(otcString);
+	}
+}
+
+
+
 void UnitDef::CreateYardMap(std::string&& yardMapStr)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -41,6 +41,9 @@ struct UnitDefWeapon {
 	unsigned int badTargetCat = 0;
 	unsigned int onlyTargetCat = 0;
 
+	/// 1-based index into the weapons table of the UnitDef, 0 for NOWEAPON padding
+	int tableIndex = 0;
+
 	float3 mainDir = FwdVector;
 
 	bool fastAutoRetargeting = false; ///< pick new targets as soon as possible, don't wait for slow update
@@ -62,6 +65,8 @@ public:
 	UnitDef();
 
 	void SetNoCost(bool noCost);
+	/// registers the unit and weapon categories, must be called serially in def order
+	void ResolveCategories(const LuaTable& udTable);
 
 	bool IsTransportUnit()     const { return (transportCapacity > 0 && transportMass > 0.0f); }
 	bool IsImmobileUnit()      const { return (pathType == -1U && !canfly && speed <= 0.0f); }
@@ -5,11 +5,13 @@
 #include <iostream>
 #include <locale>
 #include <cctype>
+#include <exception>
 
 #include "UnitDefHandler.h"
 #include "UnitDef.h"
 #include "Lua/LuaParser.h"
 #include "Sim/Features/FeatureDefHandler.h"
+#include "Sim/Misc/CommonDefHandler.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
 #include "System/StringUtil.h"
@@ -45,13 +47,7 @@ void CUnitDefHandler::Init(LuaParser* defsParser)
 	unitDefsVector.reserve(unitDefNames.size() + 1);
 	unitDefsVector.emplace_back();
 
-	for (unsigned int a = 0; a < unitDefNames.size(); ++a) {
-		const string& unitName = unitDefNames[a];
-		const LuaTable& udTable = rootTable.SubTable(unitName);
-
-		// parse the unitdef data (but don't load buildpics, etc...)
-		PushNewUnitDef(StringToLower(unitName), udTable);
-	}
+	PushNewUnitDefs(rootTable, unitDefNames);
 
 	CleanBuildOptions();
 	ProcessDecoys();
@@ -69,26 +65,68 @@ int CUnitDefHandler::PushNewUnitDef(const std::string& unitName, const LuaTable&
 
 	try {
 		unitDefsVector.emplace_back(udTable, unitName, defID);
-		UnitDef& newDef = unitDefsVector.back();
-		UnitDefLoadSounds(&newDef, udTable);
-
-		// map unitName to newDef.decoyName
-		if (!newDef.decoyName.empty())
-			decoyNameMap.emplace_back(unitName, StringToLower(newDef.decoyName));
-
-		// force-initialize the real* members
-		newDef.SetNoCost(true);
-		newDef.SetNoCost(noCost);
 	} catch (const content_error& err) {
 		LOG_L(L_ERROR, "%s", err.what());
 		return 0;
 	}
 
-	unitDefIDs[unitName] = defID;
+	LinkNewUnitDef(unitDefsVector.back(), udTable);
 	return defID;
 }
 
 
+void CUnitDefHandler::PushNewUnitDefs(const LuaTable& rootTable, const std::vector<std::string>& unitDefNames)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<UnitDef> newDefs(unitDefNames.size());
+
+	// IDs are only known once all defs are parsed, since failed ones do not get any
+	const std::vector<std::exception_ptr>& newDefErrors = CommonDefHandler::ParseDefTables(rootTable, unitDefNames, [&](int i, const LuaTable& udTable) {
+		newDefs[i] = UnitDef(udTable, StringToLower(unitDefNames[i]), -1);
+	});
+
+	for (size_t i = 0; i < unitDefNames.size(); i++) {
+		const std::string& unitName = StringToLower(unitDefNames[i]);
+
+		if (std::find_if(unitName.begin(), unitName.end(), isblank) != unitName.end())
+			LOG_L(L_WARNING, "[%s] UnitDef name \"%s\" contains white-spaces", __func__, unitName.c_str());
+
+		if (newDefErrors[i] != nullptr) {
+			try {
+				std::rethrow_exception(newDefErrors[i]);
+			} catch (const content_error& err) {
+				LOG_L(L_ERROR, "%s", err.what());
+				continue;
+			}
+		}
+
+		UnitDef& newDef = unitDefsVector.emplace_back(std::move(newDefs[i]));
+		newDef.id = unitDefsVector.size() - 1;
+
+		LinkNewUnitDef(newDef, rootTable.SubTable(unitDefNames[i]));
+	}
+}
+
+
+void CUnitDefHandler::LinkNewUnitDef(UnitDef& newDef, const LuaTable& udTable)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	// category bits are handed out in order of first use
+	newDef.ResolveCategories(udTable);
+	UnitDefLoadSounds(&newDef, udTable);
+
+	// map unitName to newDef.decoyName
+	if (!newDef.decoyName.empty())
+		decoyNameMap.emplace_back(newDef.name, StringToLower(newDef.decoyName));
+
+	// force-initialize the real* members
+	newDef.SetNoCost(true);
+	newDef.SetNoCost(noCost);
+
+	unitDefIDs[newDef.name] = newDef.id;
+}
+
+
 void CUnitDefHandler::CleanBuildOptions()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -64,6 +64,9 @@ protected:
 	void UnitDefLoadSounds(UnitDef*, const LuaTable&);
 	void LoadSounds(const LuaTable&, GuiSoundSet&, const std::string& soundName);
 
+	void PushNewUnitDefs(const LuaTable& rootTable, const std::vector<std::string>& unitDefNames);
+	void LinkNewUnitDef(UnitDef& newDef, const LuaTable& udTable);
+
 	void CleanBuildOptions();
 	void ProcessDecoys();
 
@@ -426,6 +426,18 @@ void CUnitHandler::UpdateUnitWeapons()
 			activeUnits[activeUpdateUnit]->UpdateWeapons();
 		}
 	}
+	{
+		// line-of-fire tests answered from / added to the per-frame cache since the last frame
+		static const char* const tracingLoFCacheHits = "Sim::Weapon::LoFCacheHits";
+		static const char* const tracingLoFCacheMisses = "Sim::Weapon::LoFCacheMisses";
+
+		CLineOfFireCache::Stats& stats = CLineOfFireCache::stats;
+
+		TracyPlot(tracingLoFCacheHits, static_cast<int64_t>(stats.numHits.load(std::memory_order_relaxed)));
+		TracyPlot(tracingLoFCacheMisses, static_cast<int64_t>(stats.numMisses.load(std::memory_order_relaxed)));
+
+		stats.Reset();
+	}
 }
 
 
@@ -49,6 +49,7 @@ private:
 	const float3& GetAimFromPos(bool useMuzzle = false) const override { return weaponMuzzlePos; }
 
 	bool HaveFreeLineOfFire(const float3 srcPos, const float3 tgtPos, const SWeaponTarget& trg) const override final;
+	unsigned int GetLineOfFireState() const override final { return highTrajectory; }
 	void FireImpl(const bool scriptCall) override final;
 };
 
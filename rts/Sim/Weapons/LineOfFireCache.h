@@ -0,0 +1,110 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef LINE_OF_FIRE_CACHE_H
+#define LINE_OF_FIRE_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "System/float3.h"
+
+/**
+ * HaveFreeLineOfFire results keyed on the exact query; the same (weapon, target)
+ * pair is usually tested by AutoTarget, the CAI and UpdateFire within one frame.
+ *
+ * Every entry is tagged with the generation passed in when it was stored and is
+ * only returned for the same generation, the owner has to advance it whenever a
+ * stored result may have gone stale (a new frame, moved blockers).
+ */
+class CLineOfFireCache {
+public:
+	struct Query {
+		float3 srcPos;
+		float3 tgtPos;
+
+		float spread = 0.0f;
+		float areaOfEffect = 0.0f;
+
+		int targetID = -1;
+		int allyTeam = -1;
+
+		unsigned int targetFlags = 0;
+		unsigned int avoidFlags = 0;
+		unsigned int weaponState = 0;
+
+		// positions must match exactly (not within float3::cmp_eps) so hits
+		// return what a new test would have
+		bool operator == (const Query& q) const {
+			if (targetID != q.targetID || targetFlags != q.targetFlags)
+				return false;
+			if (avoidFlags != q.avoidFlags || spread != q.spread)
+				return false;
+			if (allyTeam != q.allyTeam || areaOfEffect != q.areaOfEffect || weaponState != q.weaponState)
+				return false;
+
+			return (srcPos.x == q.srcPos.x && srcPos.y == q.srcPos.y && srcPos.z == q.srcPos.z &&
+			        tgtPos.x == q.tgtPos.x && tgtPos.y == q.tgtPos.y && tgtPos.z == q.tgtPos.z);
+		}
+	};
+
+	struct Stats {
+		std::atomic<uint64_t> numHits = {0};
+		std::atomic<uint64_t> numMisses = {0};
+
+		void Reset() {
+			numHits.store(0, std::memory_order_relaxed);
+			numMisses.store(0, std::memory_order_relaxed);
+		}
+	};
+
+public:
+	/// returns the stored result for <q> or stores and returns testFunc()
+	template<typename TestFunc>
+	bool Get(const Query& q, uint64_t generation, TestFunc&& testFunc) {
+		for (const Entry& e: entries) {
+			if (e.generation != generation || !(e.query == q))
+				continue;
+
+			stats.numHits.fetch_add(1, std::memory_order_relaxed);
+			return e.result;
+		}
+
+		stats.numMisses.fetch_add(1, std::memory_order_relaxed);
+
+		const bool result = testFunc();
+
+		entries[index] = {q, generation, result};
+		index = (index + 1) % NUM_ENTRIES;
+		return result;
+	}
+
+	void Clear() {
+		entries = {};
+		index = 0;
+	}
+
+public:
+	static constexpr size_t NUM_ENTRIES = 4;
+
+	// summed over all caches, reset by CUnitHandler after every frame
+	static Stats stats;
+
+private:
+	struct Entry {
+		Query query;
+
+		// owners start counting at 1, default entries never match
+		uint64_t generation = 0;
+
+		bool result = false;
+	};
+
+	std::array<Entry, NUM_ENTRIES> entries;
+	size_t index = 0;
+};
+
+inline CLineOfFireCache::Stats CLineOfFireCache::stats;
+
+#endif
@@ -111,7 +111,9 @@ CR_REG_METADATA(CWeapon, (
 	CR_MEMBER(weaponAimAdjustPriority),
 	CR_MEMBER(fastAutoRetargeting),
 	CR_MEMBER(fastQueryPointUpdate),
-	CR_MEMBER(burstControlWhenOutOfArc)
+	CR_MEMBER(burstControlWhenOutOfArc),
+
+	CR_IGNORED(lofCache)
 ))
 
 
@@ -935,7 +937,7 @@ float3 CWeapon::GetTargetBorderPos(
 }
 
 
-bool CWeapon::TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire) const
+bool CWeapon::TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire, bool synced) const
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	assert(GetLeadTargetPos(trg).SqDistance(tgtPos) < Square(250.0f));
@@ -953,7 +955,10 @@ bool CWeapon::TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preF
 		return false;
 
 	// TODO: add a forcedUserTarget (forced-fire mode enabled with CTRL e.g.) and skip the tests below
-	return (HaveFreeLineOfFire(GetAimFromPos(preFire), tgtPos, trg));
+	if (!synced)
+		return (HaveFreeLineOfFire(GetAimFromPos(preFire), tgtPos, trg));
+
+	return (HaveFreeLineOfFireCached(GetAimFromPos(preFire), tgtPos, trg));
 }
 
 
@@ -1091,9 +1096,51 @@ bool CWeapon::HaveFreeLineOfFire(const float3 srcPos, const float3 tgtPos, const
 }
 
 
-bool CWeapon::TryTarget(const SWeaponTarget& trg) const {
+static uint64_t GetLineOfFireCacheGeneration()
+{
+	// cached results stay valid within a frame until a solid object moves,
+	// e.g. through Lua or a script callin between two queries
+	static int generationFrame = -1;
+	static uint64_t generation = 1;
+
+	const bool objectsMoved = CSolidObject::GetResetObjectsMoved();
+
+	if (objectsMoved || generationFrame != gs->frameNum) {
+		generationFrame = gs->frameNum;
+		generation += 1;
+	}
+
+	return generation;
+}
+
+bool CWeapon::HaveFreeLineOfFireCached(const float3 srcPos, const float3 tgtPos, const SWeaponTarget& trg) const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	CLineOfFireCache::Query q;
+
+	switch (trg.type) {
+		case Target_Unit     : { q.targetID = (trg.unit      != nullptr)? trg.unit->id     : -1; } break;
+		case Target_Intercept: { q.targetID = (trg.intercept != nullptr)? trg.intercept->id: -1; } break;
+		default: break;
+	}
+
+	q.srcPos = srcPos;
+	q.tgtPos = tgtPos;
+	q.targetFlags = (trg.type << 3) | (trg.isUserTarget << 2) | (trg.isAutoTarget << 1) | (trg.isManualFire << 0);
+	q.avoidFlags = avoidFlags;
+	q.weaponState = GetLineOfFireState();
+	q.spread = AccuracyExperience() + SprayAngleExperience();
+	// both can be changed by Lua between queries within a frame
+	q.areaOfEffect = damages->damageAreaOfEffect;
+	q.allyTeam = owner->allyteam;
+
+	return (lofCache.Get(q, GetLineOfFireCacheGeneration(), [&]() { return HaveFreeLineOfFire(srcPos, tgtPos, trg); }));
+}
+
+
+bool CWeapon::TryTarget(const SWeaponTarget& trg, bool synced) const {
 	RECOIL_DETAILED_TRACY_ZONE;
-	return TryTarget(GetLeadTargetPos(trg), trg);
+	return TryTarget(GetLeadTargetPos(trg), trg, false, synced);
 }
 
 
@@ -3,12 +3,15 @@
 #ifndef WEAPON_H
 #define WEAPON_H
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
 #include "System/Object.h"
 #include "Sim/Misc/DamageArray.h"
 #include "Sim/Projectiles/ProjectileParams.h"
+#include "Sim/Weapons/LineOfFireCache.h"
 #include "Sim/Weapons/WeaponTarget.h"
 #include "System/float3.h"
 
@@ -56,10 +59,13 @@ public:
 	virtual bool TestRange(const float3 tgtPos, const SWeaponTarget& trg) const;
 	/// test if something is blocking our LineOfFire
 	virtual bool HaveFreeLineOfFire(const float3 srcPos, const float3 tgtPos, const SWeaponTarget& trg) const;
+	/// same, but reuses results of identical queries made earlier in the same (synced) frame
+	bool HaveFreeLineOfFireCached(const float3 srcPos, const float3 tgtPos, const SWeaponTarget& trg) const;
 
 	virtual bool CanFire(bool ignoreAngleGood, bool ignoreTargetType, bool ignoreRequestedDir) const;
 
-	bool TryTarget(const SWeaponTarget& trg) const;
+	/// unsynced callers must pass synced=false so they do not seed the line-of-fire cache
+	bool TryTarget(const SWeaponTarget& trg, bool synced = true) const;
 	bool TryTargetRotate(const CUnit* unit, bool userTarget, bool manualFire);
 	bool TryTargetRotate(float3 tgtPos, bool userTarget, bool manualFire);
 	bool TryTargetHeading(short heading, const SWeaponTarget& trg);
@@ -103,6 +109,8 @@ protected:
 	virtual void FireImpl(const bool scriptCall) {}
 	virtual void UpdateWantedDir();
 	virtual float GetPredictedImpactTime(float3 p) const; //< how long time we predict it take for a projectile to reach target
+	/// subclass state HaveFreeLineOfFire depends on beyond the query itself, part of the LOF-cache key
+	virtual unsigned int GetLineOfFireState() const { return 0; }
 
 	ProjectileParams GetProjectileParams();
 	static bool TargetUnderWater(const float3 tgtPos, const SWeaponTarget&);
@@ -125,7 +133,7 @@ private:
 	bool CallAimingScript(bool waitForAim);
 	void HoldIfTargetInvalid();
 
-	bool TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire = false) const;
+	bool TryTarget(const float3 tgtPos, const SWeaponTarget& trg, bool preFire = false, bool synced = true) const;
 
 public:
 	CUnit* owner;
@@ -214,6 +222,9 @@ protected:
 	// projectiles that are on the way to our interception zone
 	// (eg. nuke toward a repulsor, or missile toward a shield)
 	std::vector<int> incomingProjectileIDs;
+
+private:
+	mutable CLineOfFireCache lofCache;
 };
 
 #endif /* WEAPON_H */
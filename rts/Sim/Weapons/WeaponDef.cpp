@@ -414,9 +414,8 @@ WeaponDef::WeaponDef(const LuaTable& wdTable, const std::string& name_, int id_)
 			damages.paralyzeDamageTime = 0;
 
 
-		static std::vector<std::pair<std::string, float>> dmgs;
+		std::vector<std::pair<std::string, float>> dmgs;
 
-		dmgs.clear();
 		dmgs.reserve(32);
 		dmgTable.GetPairs(dmgs);
 
@@ -548,11 +547,6 @@ WeaponDef::WeaponDef(const LuaTable& wdTable, const std::string& name_, int id_)
 
 	visuals.scarProjVector.w = visuals.scarProjVector.LengthNormalize();
 
-	if (!visuals.scarGlowColorMapStr.empty())
-		visuals.scarGlowColorMap = CColorMap::LoadFromDefString(visuals.scarGlowColorMapStr);
-
-	ParseWeaponSounds(wdTable);
-
 	// custom parameters table
 	wdTable.SubTable("customParams").GetMap(customParams);
 
@@ -565,6 +559,15 @@ WeaponDef::WeaponDef(const LuaTable& wdTable, const std::string& name_, int id_)
 
 
 
+void WeaponDef::LoadSharedResources(const LuaTable& wdTable)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (!visuals.scarGlowColorMapStr.empty())
+		visuals.scarGlowColorMap = CColorMap::LoadFromDefString(visuals.scarGlowColorMapStr);
+
+	ParseWeaponSounds(wdTable);
+}
+
 void WeaponDef::ParseWeaponSounds(const LuaTable& wdTable) {
 	RECOIL_DETAILED_TRACY_ZONE;
 	LoadSound(wdTable, "soundStart" , fireSound);
@@ -22,6 +22,9 @@ public:
 	WeaponDef();
 	WeaponDef(const LuaTable& wdTable, const std::string& name, int id);
 
+	// registers sounds and colormaps in global caches, not thread-safe
+	void LoadSharedResources(const LuaTable& wdTable);
+
 	S3DModel* LoadModel();
 	S3DModel* LoadModel() const;
 	void PreloadModel() const;
@@ -3,11 +3,13 @@
 
 #include <algorithm>
 #include <cctype>
+#include <exception>
 #include <iostream>
 #include <stdexcept>
 
 #include "WeaponDefHandler.h"
 #include "Lua/LuaParser.h"
+#include "Sim/Misc/CommonDefHandler.h"
 #include "Sim/Misc/DamageArrayHandler.h"
 #include "System/Exceptions.h"
 #include "System/StringUtil.h"
@@ -29,13 +31,23 @@ void CWeaponDefHandler::Init(LuaParser* defsParser)
 	std::vector<std::string> weaponNames;
 	rootTable.GetKeys(weaponNames);
 
-	weaponDefsVector.reserve(weaponNames.size());
 	weaponDefIDs.reserve(weaponNames.size());
 
+	weaponDefsVector.resize(weaponNames.size());
+
+	const std::vector<std::exception_ptr>& wdErrors = CommonDefHandler::ParseDefTables(rootTable, weaponNames, [&](int wid, const LuaTable& wdTable) {
+		weaponDefsVector[wid] = WeaponDef(wdTable, weaponNames[wid], wid);
+	});
+
+	for (const std::exception_ptr& wdError: wdErrors) {
+		if (wdError != nullptr)
+			std::rethrow_exception(wdError);
+	}
+
+	// sound and colormap handles are assigned in ID order
 	for (int wid = 0; wid < weaponNames.size(); wid++) {
 		const std::string& name = weaponNames[wid];
-		const LuaTable wdTable = rootTable.SubTable(name);
-		weaponDefsVector.emplace_back(wdTable, name, wid);
+		weaponDefsVector[wid].LoadSharedResources(rootTable.SubTable(name));
 		weaponDefIDs[name] = wid;
 	}
 }
@@ -399,6 +399,7 @@ CArchiveScanner::CArchiveScanner()
 
 CArchiveScanner::~CArchiveScanner()
 {
+	WaitForChecksums();
 	WriteCache();
 }
 
@@ -419,6 +420,7 @@ void CArchiveScanner::Clear()
 	brokenArchives.reserve(16);
 	poolFilesInfo.clear();
 	poolFilesInfo.reserve(32768); //be generous
+	staleFilesInfo.clear();
 	brokenArchivesIndex.clear();
 	brokenArchivesIndex.reserve(16);
 	cacheFile.clear();
@@ -427,6 +429,8 @@ void CArchiveScanner::Clear()
 
 void CArchiveScanner::Reload()
 {
+	WaitForChecksums();
+
 	// {Read,Write,Scan}* all grab this too but we need the entire reloading-sequence to appear atomic
 	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
 
@@ -813,6 +817,11 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 		ai.modifiedArchiveData = FileSystemAbstraction::GetFileModificationTime(ai.archiveDataPath);
 	}
 
+	if (const auto it = staleFilesInfo.find(lcfn); it != staleFilesInfo.end()) {
+		ai.filesInfo = std::move(it->second);
+		staleFilesInfo.erase(it);
+	}
+
 	ai.origName = fname;
 	ai.updated = true;
 	ai.hashed = doChecksum && GetArchiveChecksum(fullName, ai);
@@ -904,6 +913,11 @@ bool CArchiveScanner::CheckCachedData(const std::string& fullName, uint32_t& mod
 	// st_mtime only reflects changes to the directory itself
 	// (not the contents)
 	//
+	// the per-file digests remain valid for all members whose
+	// size and modTime did not change, keep them for the rescan
+	if (!ai.filesInfo.empty())
+		staleFilesInfo[fileNameLower] = std::move(ai.filesInfo);
+
 	// remap replacement archive
 	if (archiveIndex != (archiveInfos.size() - 1)) {
 		archiveInfosIndex[StringToLower(rai.origName)] = archiveIndex;
@@ -972,7 +986,7 @@ IFileFilter* CArchiveScanner::CreateIgnoreFilter(IArchive* ar)
  * Get checksum of the data in the specified archive.
  * Returns 0 if file could not be opened.
  */
-bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, ArchiveInfo& archiveInfo)
+bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, ArchiveInfo& archiveInfo, std::unique_lock<spring::recursive_mutex>* scanLock)
 {
 	// try to open an archive
 	std::unique_ptr<IArchive> ar(archiveLoader.OpenArchive(archiveName));
@@ -986,9 +1000,28 @@ bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, Archive
 	// load ignore list
 	std::unique_ptr<IFileFilter> ignore(CreateIgnoreFilter(ar.get()));
 
+	// only the archive itself and archiveInfo are touched below, except for poolFilesInfo
+	const auto UnlockScanner = [scanLock]() { if (scanLock != nullptr) scanLock->unlock(); };
+	const auto RelockScanner = [scanLock]() { if (scanLock != nullptr) scanLock->lock(); };
+
+	// HashArchive runs on its own thread, which for_mt would treat as thread 0
+	// (i.e. the loading thread) and race with it, so that path hashes serially
+	const auto ForEachFile = [parallel = (scanLock == nullptr)](int start, int end, const auto& func) {
+		if (parallel) {
+			for_mt(start, end, func);
+			return;
+		}
+
+		for (int i = start; i < end; i++) {
+			func(i);
+		}
+	};
+
+	UnlockScanner();
+
 	// warm up. For some archive types ar->FileInfo(fid) is a mutable operation loading important IArchive::SFileInfo fields
 	std::atomic_uint32_t numFiles = {0};
-	for_mt(0, ar->NumFiles(), [&numFiles, &ar, &ignore](int fid) {
+	ForEachFile(0, ar->NumFiles(), [&numFiles, &ar, &ignore](int fid) {
 		const auto fn = ar->FileName(fid);
 
 		if (ignore->Match(fn))
@@ -998,6 +1031,8 @@ bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, Archive
 		++numFiles;
 	});
 
+	RelockScanner();
+
 	// store relevant lowercased filenames from the archive
 	std::vector<std::string> fileNames;
 
@@ -1022,18 +1057,26 @@ bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, Archive
 		if (it == archiveInfo.filesInfo.end())
 			it = archiveInfo.filesInfo.emplace(fi.fileName, {}).first;
 
-		if (fi.modTime != it->second.modTime || fi.size != it->second.size) {
-			it->second.modTime = fi.modTime;
-			it->second.size = fi.size;
+		// pool files are named after the md5 of their content, so a changed
+		// modTime (e.g. after the pool got copied or re-synced) does not mean
+		// the member changed and its digest can be kept
+		const bool modTimeChanged = !sdpArchive && (fi.modTime != it->second.modTime);
+
+		if (modTimeChanged || fi.size != it->second.size) {
 			it->second.checksum = sha512::NULL_RAW_DIGEST;
 		}
 
+		it->second.modTime = fi.modTime;
+		it->second.size = fi.size;
+
 		fileNames.emplace_back(std::move(fi.fileName));
 	}
 
+	UnlockScanner();
+
 	std::array<std::vector<uint8_t>, ThreadPool::MAX_THREADS> fileBuffers;
 
-	for_mt(0, fileNames.size(), [&ar, &fileNames = std::as_const(fileNames), &fileBuffers, &filesInfo = archiveInfo.filesInfo, this](int i) {
+	ForEachFile(0, fileNames.size(), [&ar, &fileNames = std::as_const(fileNames), &fileBuffers, &filesInfo = archiveInfo.filesInfo, this](int i) {
 		const auto& fileName = fileNames[i]; // note generally (i != fid) due to ignore->Match(fi.fileName) filtering
 
 		const auto it = filesInfo.find(fileName);
@@ -1082,6 +1125,8 @@ bool CArchiveScanner::GetArchiveChecksum(const std::string& archiveName, Archive
 		#endif
 	}
 
+	RelockScanner();
+
 	if (sdpArchive) {
 		// makes no sense to store archiveInfo.filesInfo in the SDP entry
 		// so copy to poolFilesInfo and empty archiveInfo.filesInfo
@@ -1648,6 +1693,9 @@ void DumpArchiveChecksum(const std::string& lcName, const sha512::raw_digest& cs
 
 sha512::raw_digest CArchiveScanner::GetArchiveSingleChecksumBytes(const std::string& filePath)
 {
+	// the archive might be hashed by StartChecksums right now
+	WaitForChecksums();
+
 	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
 
 	// compute checksum for archive only when it is actually loaded by e.g. PreGame or LuaVFS
@@ -1688,6 +1736,32 @@ sha512::raw_digest CArchiveScanner::GetArchiveCompleteChecksumBytes(const std::s
 	return checksum;
 }
 
+bool CArchiveScanner::TryGetArchiveCompleteChecksumBytes(const std::string& name, sha512::raw_digest& checksum)
+{
+	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
+
+	checksum = {0};
+
+	for (const std::string& depName: GetAllArchivesUsedBy(name)) {
+		const auto aiIter = archiveInfosIndex.find(StringToLower(ArchiveFromName(depName)));
+
+		// unknown and replaced archives are left to GetArchiveSingleChecksumBytes
+		if (aiIter == archiveInfosIndex.end())
+			return false;
+
+		const ArchiveInfo& ai = archiveInfos[aiIter->second];
+
+		if (!ai.hashed || !ai.replaced.empty())
+			return false;
+
+		for (uint8_t i = 0; i < sha512::SHA_LEN; i++) {
+			checksum[i] ^= ai.checksum[i];
+		}
+	}
+
+	return true;
+}
+
 static constexpr sha512::raw_digest EMPTY_DIGEST = {0x80, }; // 1000...000 hex
 void CArchiveScanner::CheckArchive(
 	const std::string& name,
@@ -1719,6 +1793,89 @@ void CArchiveScanner::CheckArchive(
 	throw content_error(msg);
 }
 
+void CArchiveScanner::StartChecksums(const std::vector<std::string>& names)
+{
+	WaitForChecksums();
+
+	std::vector<std::string> archivePaths;
+
+	for (const std::string& name: names) {
+		for (const std::string& depName: GetAllArchivesUsedBy(name)) {
+			const std::string& archiveName = ArchiveFromName(depName);
+
+			archivePaths.emplace_back(GetArchivePath(archiveName) + archiveName);
+		}
+	}
+
+	std::sort(archivePaths.begin(), archivePaths.end());
+	archivePaths.erase(std::unique(archivePaths.begin(), archivePaths.end()), archivePaths.end());
+
+	std::lock_guard<decltype(checksumJobMutex)> lck(checksumJobMutex);
+
+	checksumJob = std::async(std::launch::async, [this, archivePaths = std::move(archivePaths)]() {
+		for (const std::string& archivePath: archivePaths) {
+			// an archive that fails here stays unhashed, the checksum getters
+			// then hash it on the caller's thread and see the error themselves
+			try {
+				HashArchive(archivePath);
+			} catch (const std::exception& ex) {
+				LOG_L(L_ERROR, "[AS::StartChecksums] error while hashing archive %s: %s", archivePath.c_str(), ex.what());
+			}
+		}
+	});
+}
+
+void CArchiveScanner::WaitForChecksums()
+{
+	std::lock_guard<decltype(checksumJobMutex)> lck(checksumJobMutex);
+
+	if (!checksumJob.valid())
+		return;
+
+	checksumJob.wait();
+}
+
+void CArchiveScanner::HashArchive(const std::string& fullName)
+{
+	std::unique_lock<decltype(scannerMutex)> lck(scannerMutex);
+
+	ScanArchive(fullName, false);
+
+	const std::string lcName = StringToLower(FileSystem::GetFilename(fullName));
+	const auto aiIter = archiveInfosIndex.find(lcName);
+
+	if (aiIter == archiveInfosIndex.end())
+		return;
+
+	const ArchiveInfo& ai = archiveInfos[aiIter->second];
+
+	if (ai.hashed || !ai.replaced.empty())
+		return;
+
+	// hash a copy s.t. the scanner can be used (and archiveInfos grow) meanwhile
+	ArchiveInfo hashedInfo = ai;
+
+	if (!GetArchiveChecksum(fullName, hashedInfo, &lck))
+		return;
+
+	// the archive may have been rescanned or dropped while unlocked
+	const auto newIter = archiveInfosIndex.find(lcName);
+
+	if (newIter == archiveInfosIndex.end())
+		return;
+
+	ArchiveInfo& newInfo = archiveInfos[newIter->second];
+
+	if (newInfo.hashed || newInfo.modified != hashedInfo.modified || newInfo.path != hashedInfo.path)
+		return;
+
+	newInfo.checksum = hashedInfo.checksum;
+	newInfo.filesInfo = std::move(hashedInfo.filesInfo);
+	newInfo.hashed = true;
+
+	isDirty = true;
+}
+
 std::string CArchiveScanner::GetArchivePath(const std::string& archiveName) const
 {
 	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
@@ -8,10 +8,13 @@
 #include <deque>
 #include <vector>
 #include <atomic>
+#include <future>
+#include <mutex>
 
 #include "System/Info.h"
 #include "System/Sync/SHA512.hpp"
 #include "System/UnorderedMap.hpp"
+#include "System/Threading/SpringThreading.h"
 
 class IArchive;
 class IFileFilter;
@@ -134,6 +137,11 @@ public:
 	sha512::raw_digest GetArchiveSingleChecksumBytes(const std::string& name);
 	/// calculate checksum of the given archive and all its dependencies
 	sha512::raw_digest GetArchiveCompleteChecksumBytes(const std::string& name);
+	/**
+	 * Like GetArchiveCompleteChecksumBytes, but never hashes nor waits for
+	 * StartChecksums; false if any of the archives is not hashed yet.
+	 */
+	bool TryGetArchiveCompleteChecksumBytes(const std::string& name, sha512::raw_digest& checksum);
 
 	/// first 4 bytes of single checksum (TODO: get rid of this in unitsync)
 	uint32_t GetArchiveSingleChecksum(const std::string& name) { return *reinterpret_cast<const uint32_t*>(&GetArchiveSingleChecksumBytes(name)[0]); }
@@ -142,6 +150,15 @@ public:
 
 	/// like GetArchiveCompleteChecksum, throws exception if mismatch
 	void CheckArchive(const std::string& name, const sha512::raw_digest& serverChecksum, sha512::raw_digest& clientChecksum);
+
+	/**
+	 * Hashes the given archives and all their dependencies on a separate
+	 * thread; the scanner stays usable meanwhile, but the checksum getters
+	 * block until the hashing is done (see WaitForChecksums).
+	 */
+	void StartChecksums(const std::vector<std::string>& names);
+	/// errors raised while hashing are logged, the archive is left unhashed
+	void WaitForChecksums();
 	void ScanArchive(const std::string& fullName, bool checksum = false);
 	void ScanAllDirs();
 	void Clear();
@@ -223,8 +240,13 @@ private:
 	/**
 	 * Get hash of the data in the specified archive.
 	 * Returns false if file could not be opened.
+	 * If scanLock is given, it is released while the files are hashed
+	 * (serially, without the thread-pool) and archiveInfo must not be
+	 * owned by the scanner.
 	 */
-	bool GetArchiveChecksum(const std::string& filename, ArchiveInfo& archiveInfo);
+	bool GetArchiveChecksum(const std::string& filename, ArchiveInfo& archiveInfo, std::unique_lock<spring::recursive_mutex>* scanLock = nullptr);
+	/// hashes a copy of the archive's info with the scanner unlocked, used by StartChecksums
+	void HashArchive(const std::string& fullName);
 
 	bool CheckCachedData(const std::string& fullName, unsigned& modified, bool doChecksum);
 
@@ -252,10 +274,15 @@ private:
 private:
 	std::atomic<uint32_t> numFilesHashed{0};
 
+	spring::mutex checksumJobMutex;
+	std::future<void> checksumJob;
+
 	spring::unordered_map<std::string, size_t> archiveInfosIndex;
 	spring::unordered_map<std::string, size_t> brokenArchivesIndex;
 
 	spring::unordered_map<std::string, FileInfo> poolFilesInfo;
+	// per-file digests of archives whose cached info was invalidated, keyed by lowercase archive name
+	spring::unordered_map<std::string, spring::unordered_map<std::string, FileInfo>> staleFilesInfo;
 	std::vector<ArchiveInfo> archiveInfos;
 	std::vector<BrokenArchive> brokenArchives;
 
@@ -2,15 +2,18 @@
 
 #include <cassert>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <memory>
 
 #include "DemoRecorder.h"
+#include "DemoStreamWriter.h"
 #include "base64.h"
 #include "Game/GameVersion.h"
 #include "Sim/Misc/TeamStatistics.h"
 #include "System/TimeUtil.h"
 #include "System/StringUtil.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
@@ -27,42 +30,46 @@
 #endif
 
 
-// server and client memory-streams
-static std::string demoStreams[2];
-static spring::mutex demoMutex;
+CONFIG(int, DemoCompressionLevel)
+	.defaultValue(Z_BEST_COMPRESSION)
+	.minimumValue(Z_NO_COMPRESSION)
+	.maximumValue(Z_BEST_COMPRESSION)
+	.description("zlib level used for recorded demos (0 stores them uncompressed). Compression runs on a separate thread.");
+
+// data is handed to the writer thread in blocks of (at least) this size
+static constexpr size_t DEMO_BLOCK_SIZE = 64 * 1024;
 
 
 CDemoRecorder::CDemoRecorder(const std::string& mapName, const std::string& modName, bool serverDemo): isServerDemo(serverDemo)
 {
-	std::lock_guard<spring::mutex> lock(demoMutex);
-
-	SetStream();
 	SetName(mapName, modName);
 	SetFileHeader();
-	WriteFileHeader(false);
 
-	file = gzopen(demoName.c_str(), "wb9");
+	FILE* file = fopen(demoName.c_str(), "wb");
+
+	if (file == nullptr) {
+		LOG_L(L_ERROR, "[DemoRecorder::%s] could not open \"%s\" for writing (%s)", __func__, demoName.c_str(), strerror(errno));
+		return;
+	}
+
+	pendingBlock.reserve(DEMO_BLOCK_SIZE * 2);
+
+	writer = std::make_shared<CDemoStreamWriter>(file, GetSwabbedFileHeader(false), configHandler->GetInt("DemoCompressionLevel"));
+	// the thread keeps its own reference, it can outlive the recorder while finishing
+	writerThread = spring::thread([w = writer]() { w->Run(); });
 }
 
 CDemoRecorder::~CDemoRecorder()
 {
-	if (file == nullptr)
+	if (writer == nullptr)
 		return;
 
 	WriteWinnerList();
 	WritePlayerStats();
 	WriteTeamStats();
-	WriteFileHeader(true);
 	WriteDemoFile();
 }
 
-
-void CDemoRecorder::SetStream()
-{
-	demoStreams[isServerDemo].clear();
-	demoStreams[isServerDemo].reserve(8 * 1024 * 1024);
-}
-
 void CDemoRecorder::SetFileHeader()
 {
 	memset(&fileHeader, 0, sizeof(DemoFileHeader));
@@ -79,29 +86,25 @@ void CDemoRecorder::SetFileHeader()
 
 void CDemoRecorder::WriteDemoFile()
 {
-	// zlib FAQ claims the lib is thread-safe, "however any library routines that zlib uses and
-	// any application-provided memory allocation routines must also be thread-safe. zlib's gz*
-	// functions use stdio library routines, and most of zlib's functions use the library memory
-	// allocation routines by default" (so code below should be OK)
-	// gz* should usually be finished before ctor runs again when reloading, but take no chances
-	std::string& data = demoStreams[isServerDemo];
-	std::function<void(gzFile, std::string&)> func = [](gzFile file, std::string& data) {
-		std::lock_guard<spring::mutex> lock(demoMutex);
-
-		gzwrite(file, data.c_str(), data.size());
-		gzflush(file, Z_FINISH);
-		gzclose(file);
-	};
-
-	LOG("[DemoRecorder::%s] writing %s-demo \"%s\" (" _STPF_ " bytes)", __func__, (isServerDemo? "server": "client"), demoName.c_str(), data.size());
-
-	#ifndef _WIN32
+	LOG("[DemoRecorder::%s] finishing %s-demo \"%s\"", __func__, (isServerDemo? "server": "client"), demoName.c_str());
+
+	// header goes last, the statistics writers above update its sizes
+	writer->Finish(std::move(pendingBlock), GetSwabbedFileHeader(true));
+	writer.reset();
+
 	// NOTE: can not use ThreadPool for this directly here, workers are already gone
-	// FIXME: does not currently (august 2017) compile on Windows mingw buildbots
-	ThreadPool::AddExtJob(spring::thread(std::move(func), file, std::ref(data)));
-	#else
-	ThreadPool::AddExtJob(std::move(std::async(std::launch::async, std::move(func), file, std::ref(data))));
-	#endif
+	ThreadPool::AddExtJob(std::move(writerThread));
+}
+
+void CDemoRecorder::FlushPendingBlock()
+{
+	if (pendingBlock.size() < DEMO_BLOCK_SIZE)
+		return;
+
+	writer->Write(std::move(pendingBlock));
+
+	pendingBlock = {};
+	pendingBlock.reserve(DEMO_BLOCK_SIZE * 2);
 }
 
 void CDemoRecorder::WriteSetupText(const std::string& text)
@@ -120,19 +123,24 @@ void CDemoRecorder::WriteSetupText(const std::string& text)
 	}
 
 	fileHeader.scriptSize = length;
-	demoStreams[isServerDemo].append(text.c_str(), length);
+	pendingBlock.append(text.c_str(), length);
 }
 
 void CDemoRecorder::SaveToDemo(const unsigned char* buf, const unsigned length, const float modGameTime)
 {
+	if (writer == nullptr)
+		return;
+
 	DemoStreamChunkHeader chunkHeader;
 
 	chunkHeader.modGameTime = modGameTime;
 	chunkHeader.length = length;
 	chunkHeader.swab();
-	demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
-	demoStreams[isServerDemo].append(reinterpret_cast<const char*>(buf), length);
+	pendingBlock.append(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
+	pendingBlock.append(reinterpret_cast<const char*>(buf), length);
 	fileHeader.demoStreamSize += (length + sizeof(chunkHeader));
+
+	FlushPendingBlock();
 }
 
 void CDemoRecorder::SetName(const std::string& mapName, const std::string& modName)
@@ -172,8 +180,8 @@ void CDemoRecorder::SetName(const std::string& mapName, const std::string& modNa
 
 void CDemoRecorder::SetGameID(const unsigned char* buf)
 {
+	// written out (together with the final sizes) when the demo is closed
 	memcpy(&fileHeader.gameID, buf, sizeof(fileHeader.gameID));
-	WriteFileHeader(false);
 }
 
 void CDemoRecorder::SetTime(int gameTime, int wallclockTime)
@@ -228,10 +236,10 @@ void CDemoRecorder::SetWinningAllyTeams(const std::vector<unsigned char>& winnin
 	winningAllyTeams = winningAllyTeamIDs;
 }
 
-/** @brief Write DemoFileHeader
-Write the DemoFileHeader at the start of the file and restores the original
-position in the file afterwards. */
-unsigned int CDemoRecorder::WriteFileHeader(bool updateStreamLength)
+/** @brief Get the DemoFileHeader as stored at the start of the file
+The writer reserves room for it when the demo is opened and patches in the
+final version (with updateStreamLength) when it is closed. */
+DemoFileHeader CDemoRecorder::GetSwabbedFileHeader(bool updateStreamLength) const
 {
 	DemoFileHeader tmpHeader;
 	memcpy(&tmpHeader, &fileHeader, sizeof(fileHeader));
@@ -241,29 +249,21 @@ unsigned int CDemoRecorder::WriteFileHeader(bool updateStreamLength)
 
 	// to little endian
 	tmpHeader.swab();
-
-	if (demoStreams[isServerDemo].empty()) {
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&tmpHeader), sizeof(tmpHeader));
-	} else {
-		assert(demoStreams[isServerDemo].size() >= sizeof(tmpHeader));
-		memcpy(&demoStreams[isServerDemo][0], reinterpret_cast<const char*>(&tmpHeader), sizeof(tmpHeader)); // no non-const .data() until C++17
-	}
-
-	return (demoStreams[isServerDemo].size());
+	return tmpHeader;
 }
 
 /** @brief Write the CPlayer::Statistics at the current position in the file. */
 void CDemoRecorder::WritePlayerStats()
 {
-	const size_t pos = demoStreams[isServerDemo].size();
+	const size_t pos = pendingBlock.size();
 
 	for (PlayerStatistics& stats: playerStats) {
 		stats.swab();
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&stats), sizeof(PlayerStatistics));
+		pendingBlock.append(reinterpret_cast<const char*>(&stats), sizeof(PlayerStatistics));
 	}
 
 	fileHeader.numPlayers = playerStats.size();
-	fileHeader.playerStatSize = int(demoStreams[isServerDemo].size() - pos);
+	fileHeader.playerStatSize = int(pendingBlock.size() - pos);
 
 	playerStats.clear();
 }
@@ -276,38 +276,38 @@ void CDemoRecorder::WriteWinnerList()
 	if (fileHeader.numTeams == 0)
 		return;
 
-	const size_t pos = demoStreams[isServerDemo].size();
+	const size_t pos = pendingBlock.size();
 
 	// Write the array of winningAllyTeams.
 	for (size_t i = 0; i < winningAllyTeams.size(); i++) { // NOLINT{modernize-loop-convert}
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&winningAllyTeams[i]), sizeof(unsigned char));
+		pendingBlock.append(reinterpret_cast<const char*>(&winningAllyTeams[i]), sizeof(unsigned char));
 	}
 
 	winningAllyTeams.clear();
 
-	fileHeader.winningAllyTeamsSize = int(demoStreams[isServerDemo].size() - pos);
+	fileHeader.winningAllyTeamsSize = int(pendingBlock.size() - pos);
 }
 
 /** @brief Write the TeamStatistics at the current position in the file. */
 void CDemoRecorder::WriteTeamStats()
 {
-	const size_t pos = demoStreams[isServerDemo].size();
+	const size_t pos = pendingBlock.size();
 
 	// Write array of dwords indicating number of TeamStatistics per team.
 	for (std::vector<TeamStatistics>& history: teamStats) {
 		unsigned int c = swabDWord(history.size());
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&c), sizeof(unsigned int));
+		pendingBlock.append(reinterpret_cast<const char*>(&c), sizeof(unsigned int));
 	}
 
 	// Write big array of TeamStatistics.
 	for (std::vector<TeamStatistics>& history: teamStats) {
 		for (TeamStatistics& stats: history) {
 			stats.swab();
-			demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&stats), sizeof(TeamStatistics));
+			pendingBlock.append(reinterpret_cast<const char*>(&stats), sizeof(TeamStatistics));
 		}
 	}
 
-	fileHeader.teamStatSize = int(demoStreams[isServerDemo].size() - pos);
+	fileHeader.teamStatSize = int(pendingBlock.size() - pos);
 
 	teamStats.clear();
 }
@@ -3,17 +3,23 @@
 #ifndef DEMO_RECORDER
 #define DEMO_RECORDER
 
+#include <memory>
 #include <vector>
 #include <sstream>
-#include <zlib.h>
 
 #include "Demo.h"
 #include "Game/Players/PlayerStatistics.h"
 #include "Sim/Misc/TeamStatistics.h"
+#include "System/Threading/SpringThreading.h"
+
+class CDemoStreamWriter;
 
 
 /**
  * @brief Used to record demos
+ *
+ * Data is collected into blocks which are compressed and written to disk by a
+ * CDemoStreamWriter on its own thread, keeping deflate off the server loop.
  */
 class CDemoRecorder : public CDemo
 {
@@ -32,7 +38,9 @@ public:
 		memcpy(&fileHeader, &r.fileHeader, sizeof(fileHeader));
 		memset(&r.fileHeader, 0, sizeof(fileHeader));
 
-		std::swap(file, r.file);
+		std::swap(writer, r.writer);
+		std::swap(writerThread, r.writerThread);
+		std::swap(pendingBlock, r.pendingBlock);
 
 		std::swap(demoName, r.demoName);
 		std::swap(playerStats, r.playerStats);
@@ -44,12 +52,11 @@ public:
 	}
 
 
-	bool IsValid() const { return (file != nullptr); }
+	bool IsValid() const { return (writer != nullptr); }
 
 	void WriteSetupText(const std::string& text);
 	void SaveToDemo(const unsigned char* buf, const unsigned length, const float modGameTime);
 
-	void SetStream();
 	void SetName(const std::string& mapName, const std::string& modName);
 	const std::string& GetName() const { return demoName; }
 
@@ -63,15 +70,20 @@ public:
 	void SetWinningAllyTeams(const std::vector<unsigned char>& winningAllyTeams);
 
 private:
-	unsigned int WriteFileHeader(bool updateStreamLength);
+	DemoFileHeader GetSwabbedFileHeader(bool updateStreamLength) const;
 	void SetFileHeader();
+	void FlushPendingBlock();
 	void WritePlayerStats();
 	void WriteTeamStats();
 	void WriteWinnerList();
 	void WriteDemoFile();
 
 private:
-	gzFile file = nullptr;
+	std::shared_ptr<CDemoStreamWriter> writer;
+	spring::thread writerThread;
+
+	// data not yet handed to the writer
+	std::string pendingBlock;
 
 	std::vector<PlayerStatistics> playerStats;
 	std::vector< std::vector<TeamStatistics> > teamStats;
@@ -0,0 +1,173 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include "DemoStreamWriter.h"
+#include "System/MainDefines.h"
+#include "System/Log/ILog.h"
+#include "System/Platform/Threading.h"
+
+// gzip member header: magic, deflate, no flags, no mtime, no extra flags, unknown OS
+static constexpr uint8_t GZIP_HEADER[10] = {0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 0xff};
+// gzip header plus the header of the stored block around the DemoFileHeader
+static constexpr long DEMO_HEADER_OFFSET = sizeof(GZIP_HEADER) + 5;
+
+static_assert(sizeof(DemoFileHeader) <= 0xffff, "DemoFileHeader does not fit into a single stored block");
+
+
+CDemoStreamWriter::CDemoStreamWriter(FILE* f, const DemoFileHeader& header, int level): file(f)
+{
+	assert(file != nullptr);
+	memset(&zstream, 0, sizeof(zstream));
+	memcpy(&finalHeader, &header, sizeof(header));
+
+	// raw deflate, the gzip wrapper is written by hand around it
+	deflateInit2(&zstream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+	const uint16_t len = sizeof(DemoFileHeader);
+	const uint16_t nlen = ~len;
+
+	// non-final stored block (BFINAL=0, BTYPE=00, byte-aligned) followed by LEN and NLEN
+	const uint8_t blockHeader[5] = {0x00, uint8_t(len & 0xff), uint8_t(len >> 8), uint8_t(nlen & 0xff), uint8_t(nlen >> 8)};
+
+	WriteRaw(GZIP_HEADER, sizeof(GZIP_HEADER));
+	WriteRaw(blockHeader, sizeof(blockHeader));
+	WriteRaw(&header, sizeof(header));
+
+	assert(failed || fileSize == (DEMO_HEADER_OFFSET + sizeof(DemoFileHeader)));
+}
+
+CDemoStreamWriter::~CDemoStreamWriter()
+{
+	assert(file == nullptr);
+}
+
+
+void CDemoStreamWriter::Write(std::string&& data)
+{
+	assert(!finished.load());
+
+	blocks.enqueue({numQueuedBlocks++, std::move(data)});
+	waitCond.notify_one();
+}
+
+void CDemoStreamWriter::Finish(std::string&& data, const DemoFileHeader& header)
+{
+	assert(!finished.load());
+
+	memcpy(&finalHeader, &header, sizeof(header));
+	blocks.enqueue({numQueuedBlocks++, std::move(data)});
+
+	numFinalBlocks = numQueuedBlocks;
+	finished.store(true);
+	waitCond.notify_one();
+}
+
+
+void CDemoStreamWriter::Run()
+{
+	Threading::SetThreadName("demowriter");
+
+	Block block;
+
+	while (true) {
+		// Finish publishes numFinalBlocks and finalHeader through <finished>
+		const bool finishing = finished.load();
+
+		while (blocks.try_dequeue(block)) {
+			pendingBlocks.emplace(block.seqNum, std::move(block.data));
+		}
+
+		for (auto it = pendingBlocks.begin(); it != pendingBlocks.end() && it->first == numWrittenBlocks; it = pendingBlocks.erase(it)) {
+			Deflate(it->second, false);
+			numWrittenBlocks++;
+		}
+
+		if (finishing && numWrittenBlocks == numFinalBlocks)
+			break;
+
+		// notifications can be missed between the checks above and here, hence the timeout
+		std::unique_lock<spring::mutex> lock(waitMutex);
+		waitCond.wait_for(lock, std::chrono::milliseconds(100));
+	}
+
+	Deflate({}, true);
+	Close();
+}
+
+
+bool CDemoStreamWriter::WriteRaw(const void* data, size_t size)
+{
+	if (failed || size == 0)
+		return !failed;
+
+	if (fwrite(data, 1, size, file) != size) {
+		LOG_L(L_ERROR, "[DemoStreamWriter::%s] error writing %u bytes at offset %u (%s)", __func__, uint32_t(size), uint32_t(fileSize), strerror(errno));
+		return !(failed = true);
+	}
+
+	fileSize += size;
+	return true;
+}
+
+void CDemoStreamWriter::Deflate(const std::string& data, bool finish)
+{
+	std::array<uint8_t, 16384> outBuffer;
+
+	streamCRC = crc32(streamCRC, reinterpret_cast<const Bytef*>(data.data()), data.size());
+	streamSize += data.size();
+
+	zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+	zstream.avail_in = data.size();
+
+	for (int ret = Z_OK; ret != Z_STREAM_ERROR; ) {
+		zstream.next_out = outBuffer.data();
+		zstream.avail_out = outBuffer.size();
+
+		ret = deflate(&zstream, finish? Z_FINISH: Z_NO_FLUSH);
+
+		WriteRaw(outBuffer.data(), outBuffer.size() - zstream.avail_out);
+
+		if (finish) {
+			if (ret == Z_STREAM_END)
+				break;
+		} else {
+			if (zstream.avail_out != 0)
+				break;
+		}
+	}
+}
+
+void CDemoStreamWriter::Close()
+{
+	deflateEnd(&zstream);
+
+	// CRC and size (mod 2^32) over all uncompressed data, including the final header
+	const uint32_t headerCRC = crc32(0, reinterpret_cast<const Bytef*>(&finalHeader), sizeof(finalHeader));
+	const uint32_t totalCRC = crc32_combine(headerCRC, streamCRC, streamSize);
+	const uint32_t totalSize = sizeof(finalHeader) + streamSize;
+
+	const uint8_t trailer[8] = {
+		uint8_t(totalCRC       ), uint8_t(totalCRC  >>  8), uint8_t(totalCRC  >> 16), uint8_t(totalCRC  >> 24),
+		uint8_t(totalSize      ), uint8_t(totalSize >>  8), uint8_t(totalSize >> 16), uint8_t(totalSize >> 24),
+	};
+
+	WriteRaw(trailer, sizeof(trailer));
+
+	if (!failed && fseek(file, DEMO_HEADER_OFFSET, SEEK_SET) == 0)
+		failed = (fwrite(&finalHeader, 1, sizeof(finalHeader), file) != sizeof(finalHeader));
+
+	failed |= (fclose(file) != 0);
+	file = nullptr;
+
+	if (failed) {
+		LOG_L(L_ERROR, "[DemoStreamWriter::%s] demo file is incomplete", __func__);
+		return;
+	}
+
+	LOG("[DemoStreamWriter::%s] wrote " _STPF_ " bytes of demo data (" _STPF_ " compressed)", __func__, size_t(sizeof(finalHeader) + streamSize), size_t(fileSize));
+}
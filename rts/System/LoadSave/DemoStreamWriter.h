@@ -0,0 +1,83 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEMO_STREAM_WRITER_H
+#define DEMO_STREAM_WRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <zlib.h>
+
+#include "demofile.h"
+#include "System/ConcurrentQueue.h"
+#include "System/Threading/SpringThreading.h"
+
+
+/**
+ * @brief Compresses and writes demo data on a background thread
+ *
+ * The output is a regular single-member gzip file. Its deflate stream starts
+ * with a stored (uncompressed) block holding only the DemoFileHeader, so the
+ * header can be overwritten in place once the final stream and statistics sizes
+ * are known; everything after it is deflated incrementally as blocks arrive.
+ *
+ * Write and Finish may be called from different threads over the lifetime of a
+ * recorder (e.g. PreGame and the net thread), but never concurrently.
+ */
+class CDemoStreamWriter
+{
+public:
+	CDemoStreamWriter(FILE* file, const DemoFileHeader& header, int level);
+	~CDemoStreamWriter();
+
+	CDemoStreamWriter(const CDemoStreamWriter&) = delete;
+	CDemoStreamWriter& operator = (const CDemoStreamWriter&) = delete;
+
+	/// hands a block of (uncompressed) demo data to the writer thread
+	void Write(std::string&& data);
+	/// queues the final block; the writer then patches in <header> and closes the file
+	void Finish(std::string&& data, const DemoFileHeader& header);
+
+	/// writer thread main loop, returns once the file is closed
+	void Run();
+
+private:
+	struct Block {
+		uint64_t seqNum = 0;
+		std::string data;
+	};
+
+	bool WriteRaw(const void* data, size_t size);
+	void Deflate(const std::string& data, bool finish);
+	void Close();
+
+private:
+	FILE* file = nullptr;
+
+	z_stream zstream;
+
+	// producer threads may differ between calls, which the queue does not order
+	moodycamel::ConcurrentQueue<Block> blocks;
+	std::map<uint64_t, std::string> pendingBlocks;
+
+	spring::mutex waitMutex;
+	spring::condition_variable waitCond;
+
+	// set by Finish before <finished>, little-endian
+	DemoFileHeader finalHeader;
+
+	uint64_t numQueuedBlocks = 0;
+	uint64_t numWrittenBlocks = 0;
+	uint64_t numFinalBlocks = 0;
+
+	uint32_t streamCRC = 0;
+	uint64_t streamSize = 0;
+	uint64_t fileSize = 0;
+
+	std::atomic<bool> finished = {false};
+	bool failed = false;
+};
+
+#endif // DEMO_STREAM_WRITER_H
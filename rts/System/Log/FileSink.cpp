@@ -9,10 +9,18 @@
 #include "System/Log/Level.h"
 
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 
@@ -65,6 +73,7 @@ namespace log_file {
 		typedef std::vector<LogFilePair> LogFilesMap;
 
 		~LogFilesContainer() {
+			log_file_setAsync(false);
 			log_file_removeAllLogFiles();
 			validTracker = false;
 		}
@@ -120,10 +129,7 @@ namespace log_file {
 		return (!getLogFiles().empty());
 	}
 
-	void writeToFile(FILE* outStream, const char* record, bool flush) {
-		char framePrefix[128] = {'\0'};
-		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
-
+	void writeToFile(FILE* outStream, const char* framePrefix, const char* record, bool flush) {
 		FPRINTF(outStream, "%s%s\n", framePrefix, record);
 
 		if (flush)
@@ -133,7 +139,7 @@ namespace log_file {
 	/**
 	 * Writes to the individual log files, if they do want to log the section.
 	 */
-	void writeToFiles(int level, const char* section, const char* record)
+	void writeToFiles(int level, const char* section, const char* framePrefix, const char* record, bool flush = true)
 	{
 		const auto& logFiles = getLogFiles();
 
@@ -143,8 +149,27 @@ namespace log_file {
 			if (p.second.GetOutStream() == nullptr)
 				continue;
 
-			writeToFile(p.second.GetOutStream(), record, p.second.FlushOnWrite(level));
+			writeToFile(p.second.GetOutStream(), framePrefix, record, flush && p.second.FlushOnWrite(level));
+		}
+	}
+
+	void writeToFiles(int level, const char* section, const char* record)
+	{
+		char framePrefix[128] = {'\0'};
+		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+
+		writeToFiles(level, section, framePrefix, record);
+	}
+
+	bool isFlushedOnWrite(int level) {
+		const auto& logFiles = getLogFiles();
+
+		for (const auto& p: logFiles) {
+			if (p.second.FlushOnWrite(level))
+				return true;
 		}
+
+		return false;
 	}
 
 	/**
@@ -184,6 +209,191 @@ namespace log_file {
 
 		logRecords.emplace_back(level, section, record);
 	}
+
+
+	/**
+	 * Asynchronous writing of log records, see log_file_setAsync.
+	 *
+	 * Records are formatted (frame prefix included) into the slots of a
+	 * bounded lock-free MPMC ring by the logging threads and written out in
+	 * batches by one writer thread, which flushes the files once per batch.
+	 * When the ring is full, records below the flush-level of every file
+	 * are dropped and counted. Records at or above a flush-level are never
+	 * dropped; like in synchronous mode they are on disk once logged, since
+	 * the logging thread writes out the ring itself.
+	 */
+	class AsyncLogWriter {
+	public:
+		static constexpr size_t NUM_SLOTS = 4096; // power of two
+		static constexpr auto WRITE_INTERVAL = std::chrono::milliseconds(50);
+
+		AsyncLogWriter(): slots(NUM_SLOTS) {
+			for (size_t i = 0; i < NUM_SLOTS; i++) {
+				slots[i].seq.store(i, std::memory_order_relaxed);
+			}
+
+			writerThread = std::thread([this]() { Run(); });
+		}
+		~AsyncLogWriter() {
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				running = false;
+			}
+
+			wakeCond.notify_one();
+			writerThread.join();
+
+			// records pushed while the writer was stopping
+			WriteRecords();
+		}
+
+		void Push(int level, const char* section, const char* record) {
+			const bool flushed = isFlushedOnWrite(level);
+
+			while (!TryPush(level, section, record)) {
+				if (!flushed) {
+					numDropped.fetch_add(1, std::memory_order_relaxed);
+					wakeCond.notify_one();
+					return;
+				}
+
+				WriteRecords();
+			}
+
+			if (flushed)
+				WriteRecords();
+		}
+
+		/// writes and flushes all pending records, callable from any thread
+		void WriteRecords() {
+			std::lock_guard<std::mutex> lock(writeMutex);
+			WriteRecordsLocked();
+		}
+
+		/**
+		 * Writes all pending records and keeps the writer from touching the
+		 * log files until the returned lock is released; nothing may be logged
+		 * while holding it.
+		 */
+		std::unique_lock<std::mutex> LockFiles() {
+			std::unique_lock<std::mutex> lock(writeMutex);
+			WriteRecordsLocked();
+			return lock;
+		}
+
+	private:
+		void WriteRecordsLocked() {
+			Slot* slot = nullptr;
+
+			while ((slot = TryPopBegin()) != nullptr) {
+				writeToFiles(slot->level, slot->section.c_str(), slot->framePrefix, slot->record.c_str(), false);
+				PopEnd(slot);
+			}
+
+			if (const uint32_t n = numDropped.exchange(0, std::memory_order_relaxed); n > 0) {
+				char framePrefix[128] = {'\0'};
+				char record[128] = {'\0'};
+
+				log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+				SNPRINTF(record, sizeof(record), "Warning: [FileSink] %u log records were dropped, the log buffer was full", n);
+
+				writeToFiles(LOG_LEVEL_WARNING, LOG_SECTION_DEFAULT, framePrefix, record, false);
+			}
+
+			flushFiles();
+		}
+
+		struct Slot {
+			std::atomic<size_t> seq;
+
+			int level = 0;
+			char framePrefix[128];
+
+			// capacity is kept between uses, so steady-state logging does not allocate
+			std::string section;
+			std::string record;
+		};
+
+		bool TryPush(int level, const char* section, const char* record) {
+			size_t pos = pushPos.load(std::memory_order_relaxed);
+			Slot* slot = nullptr;
+
+			while (true) {
+				slot = &slots[pos & (NUM_SLOTS - 1)];
+
+				const size_t seq = slot->seq.load(std::memory_order_acquire);
+				const intptr_t dif = intptr_t(seq) - intptr_t(pos);
+
+				// full
+				if (dif < 0)
+					return false;
+
+				if (dif == 0 && pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+
+				if (dif > 0)
+					pos = pushPos.load(std::memory_order_relaxed);
+			}
+
+			slot->level = level;
+			slot->section.assign(section);
+			slot->record.assign(record);
+			log_framePrefixer_createPrefix(slot->framePrefix, sizeof(slot->framePrefix));
+			slot->seq.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// only called with writeMutex held, so there is one consumer at a time
+		Slot* TryPopBegin() {
+			Slot* slot = &slots[popPos & (NUM_SLOTS - 1)];
+
+			if (slot->seq.load(std::memory_order_acquire) != (popPos + 1))
+				return nullptr;
+
+			return slot;
+		}
+		void PopEnd(Slot* slot) {
+			slot->seq.store(popPos + NUM_SLOTS, std::memory_order_release);
+			popPos += 1;
+		}
+
+		void Run() {
+			std::unique_lock<std::mutex> lock(wakeMutex);
+
+			while (running) {
+				wakeCond.wait_for(lock, WRITE_INTERVAL);
+
+				lock.unlock();
+				WriteRecords();
+				lock.lock();
+			}
+		}
+
+	private:
+		std::vector<Slot> slots;
+
+		alignas(64) std::atomic<size_t> pushPos = {0};
+		alignas(64) size_t popPos = 0;
+
+		std::atomic<uint32_t> numDropped = {0};
+
+		std::mutex writeMutex;
+		std::mutex wakeMutex;
+		std::condition_variable wakeCond;
+
+		std::thread writerThread;
+		bool running = true;
+	};
+
+	std::unique_ptr<AsyncLogWriter> asyncLogWriter;
+
+	/// the writer thread iterates the log files, changes to them have to hold this lock
+	std::unique_lock<std::mutex> lockLogFiles() {
+		if (asyncLogWriter == nullptr)
+			return {};
+
+		return (asyncLogWriter->LockFiles());
+	}
 }
 
 
@@ -199,6 +409,8 @@ void log_file_addLogFile(
 ) {
 	assert(filePath != nullptr);
 
+	std::unique_lock<std::mutex> lock = log_file::lockLogFiles();
+
 	auto& logFiles = log_file::getLogFiles();
 
 	const std::string sectionsStr = (sections == nullptr) ? "" : sections;
@@ -214,6 +426,9 @@ void log_file_addLogFile(
 	FILE* tmpStream = fopen(filePath, "w");
 
 	if (tmpStream == nullptr) {
+		if (lock.owns_lock())
+			lock.unlock();
+
 		LOG_L(L_ERROR, "[%s] failed to open log file \"%s\" for writing", __func__, filePath);
 		return;
 	}
@@ -234,6 +449,8 @@ void log_file_addLogFile(
 void log_file_removeLogFile(const char* filePath) {
 	assert(filePath != nullptr);
 
+	const std::unique_lock<std::mutex> lock = log_file::lockLogFiles();
+
 	auto& logFiles = log_file::getLogFiles();
 
 	const auto pred = [](const log_file::LogFilePair& a, const log_file::LogFilePair& b) { return (a.first < b.first); };
@@ -256,6 +473,8 @@ void log_file_removeLogFile(const char* filePath) {
 }
 
 void log_file_removeAllLogFiles() {
+	const std::unique_lock<std::mutex> lock = log_file::lockLogFiles();
+
 	auto& logFiles = log_file::getLogFiles();
 
 	for (auto& logFilePair: logFiles) {
@@ -269,6 +488,10 @@ void log_file_removeAllLogFiles() {
 FILE* log_file_getLogFileStream(const char* filePath) {
 	const auto& logFiles = log_file::getLogFiles();
 
+	// the caller writes to the stream directly, keep the order of records
+	if (log_file::asyncLogWriter != nullptr)
+		log_file::asyncLogWriter->WriteRecords();
+
 	for (const auto& p: logFiles) {
 		if (strcmp((p.first).c_str(), filePath) != 0)
 			continue;
@@ -281,6 +504,23 @@ FILE* log_file_getLogFileStream(const char* filePath) {
 
 
 
+void log_file_setAsync(bool async) {
+	if (async == (log_file::asyncLogWriter != nullptr))
+		return;
+
+	if (async) {
+		log_file::asyncLogWriter = std::make_unique<log_file::AsyncLogWriter>();
+	} else {
+		log_file::asyncLogWriter.reset();
+	}
+}
+
+bool log_file_isAsync() {
+	return (log_file::asyncLogWriter != nullptr);
+}
+
+
+
 /**
  * @name logging_sink_file
  * ILog.h sink implementation.
@@ -294,8 +534,12 @@ static void log_sink_record_file(int level, const char* section, const char* rec
 		// write buffer to log file
 		log_file::writeBufferToFiles();
 
-		// write current record to log file
-		log_file::writeToFiles(level, section, record);
+		// write current record to log file, or queue it for the writer thread
+		if (log_file::asyncLogWriter != nullptr) {
+			log_file::asyncLogWriter->Push(level, section, record);
+		} else {
+			log_file::writeToFiles(level, section, record);
+		}
 	} else {
 		// buffer until a log file is ready for output
 		log_file::writeToBuffer(level, section, record);
@@ -307,6 +551,10 @@ static void log_sink_cleanup_file() {
 	if (!log_file::isActivelyLogging())
 		return;
 
+	// write out everything still queued; no-op if the writer just did so
+	if (log_file::asyncLogWriter != nullptr)
+		log_file::asyncLogWriter->WriteRecords();
+
 	// flush the log buffers to files
 	log_file::flushFiles();
 }
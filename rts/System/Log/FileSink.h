@@ -41,6 +41,15 @@ void log_file_removeLogFile(const char* filePath);
 
 void log_file_removeAllLogFiles();
 
+/**
+ * Enables or disables writing the log files from a background thread.
+ * Records are then queued in a bounded buffer; when it is full, records
+ * below the flush-level of all files are dropped (the number of dropped
+ * records is logged afterwards). LOG_CLEANUP writes out the queue.
+ */
+void log_file_setAsync(bool async);
+bool log_file_isAsync();
+
 ///@}
 
 #ifdef __cplusplus
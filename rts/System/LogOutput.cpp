@@ -40,6 +40,10 @@ CONFIG(int, LogFlushLevel)
 	.defaultValue(LOG_LEVEL_ERROR)
 	.description("Flush the logfile when a message's level exceeds this value. ERROR is flushed by default, WARNING is not.");
 
+CONFIG(bool, LogAsync)
+	.defaultValue(false)
+	.description("Write the logfile from a background thread. When messages are logged faster than they can be written, those below LogFlushLevel are dropped and counted.");
+
 CONFIG(int, LogRepeatLimit)
 	.defaultValue(10)
 	.description("Allow at most this many consecutive identical messages to be logged.");
@@ -173,6 +177,7 @@ void CLogOutput::Initialize()
 
 	log_filter_setRepeatLimit(configHandler->GetInt("LogRepeatLimit")); // all sinks
 	log_file_addLogFile(filePath.c_str(), nullptr, LOG_LEVEL_ALL, configHandler->GetInt("LogFlushLevel"));
+	log_file_setAsync(configHandler->GetBool("LogAsync"));
 
 	LOG("LogOutput initialized. Logging to %s", filePath.c_str());
 }
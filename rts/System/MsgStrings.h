@@ -19,6 +19,8 @@ const std::string NoClientsExit = "No clients connected, shutting down server";
 const std::string NoSyncResponse = "Error: Player %s did not send sync checksum for frame %d";
 const std::string SyncError = "Sync error for %s in frame %d (got %x, correct is %x)";
 const std::string NoSyncCheck = "Warning: Sync checking disabled!";
+const std::string SyncSubsystemsError = "Sync error in frame %d diverged in: %s";
+const std::string SyncSubsystemsUnitIDs = "Sync error in frame %d diverged in unit IDs %d to %d";
 
 const std::string ConnectionReject = "Connection attempt rejected from %s: %s";
 const std::string WrongPlayer = "Got message %d from %d claiming to be from %d";
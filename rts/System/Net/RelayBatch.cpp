@@ -0,0 +1,81 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "RelayBatch.h"
+
+#include <zlib.h>
+
+#include "RawPacket.h"
+#include "ProtocolDef.h"
+#include "Net/Protocol/BaseNetProtocol.h"
+#include "System/Log/ILog.h"
+
+namespace netcode {
+
+static constexpr unsigned relayHeaderSize = sizeof(std::uint8_t) + sizeof(std::uint16_t);
+
+
+void RelayBatch::Append(PacketType packet)
+{
+	if ((buffer.size() + packet->length) > MAX_BATCH_SIZE)
+		Flush();
+
+	if (packet->length > MAX_BATCH_SIZE) {
+		// too large to batch, pass it on as-is (in order since the buffer was just flushed)
+		sink(packet);
+		return;
+	}
+
+	buffer.insert(buffer.end(), packet->data, packet->data + packet->length);
+}
+
+void RelayBatch::Flush()
+{
+	if (buffer.empty())
+		return;
+
+	std::vector<std::uint8_t> deflData(compressBound(buffer.size()));
+	uLongf deflSize = deflData.size();
+
+	if (compress(deflData.data(), &deflSize, buffer.data(), buffer.size()) != Z_OK) {
+		LOG_L(L_ERROR, "[RelayBatch::%s] failed to compress %u bytes for relayed spectators", __func__, unsigned(buffer.size()));
+		buffer.clear();
+		return;
+	}
+
+	deflData.resize(deflSize);
+	buffer.clear();
+
+	sink(CBaseNetProtocol::Get().SendRelayedPackets(deflData));
+}
+
+
+bool RelayBatch::Unpack(const std::uint8_t* data, unsigned length, const MessageFunc& msgFunc)
+{
+	if (length < relayHeaderSize || data[0] != NETMSG_RELAYED_PACKETS)
+		return false;
+
+	// batches never exceed MAX_BATCH_SIZE, anything that inflates to more is malformed
+	std::vector<std::uint8_t> inflData(MAX_BATCH_SIZE);
+	uLongf inflSize = inflData.size();
+
+	if (uncompress(inflData.data(), &inflSize, data + relayHeaderSize, length - relayHeaderSize) != Z_OK)
+		return false;
+
+	// the server only relays whole messages, so a batch never ends in a fragment
+	for (unsigned pos = 0; pos < inflSize; ) {
+		const std::uint8_t* bufp = &inflData[pos];
+		const unsigned int msgLength = inflSize - pos;
+
+		const int pktLength = ProtocolDef::GetInstance()->PacketLength(bufp, msgLength);
+
+		if (!ProtocolDef::GetInstance()->IsValidLength(pktLength, msgLength))
+			return false;
+
+		msgFunc(bufp, pktLength);
+		pos += pktLength;
+	}
+
+	return true;
+}
+
+} // namespace netcode
@@ -0,0 +1,57 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _RELAY_BATCH_H
+#define _RELAY_BATCH_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace netcode
+{
+class RawPacket;
+
+/**
+ * @brief Broadcasts batched for relayed spectators
+ *
+ * Whole protocol messages are appended back to back and deflated into one
+ * NETMSG_RELAYED_PACKETS message by Flush; messages too large for a batch
+ * flush it and are passed on as they are. Either way the sink receives
+ * everything in append order, and Unpack restores the original messages.
+ */
+class RelayBatch
+{
+public:
+	typedef std::shared_ptr<const RawPacket> PacketType;
+	typedef std::function<void(PacketType)> SinkFunc;
+	typedef std::function<void(const std::uint8_t*, unsigned)> MessageFunc;
+
+	/// uncompressed bytes per batch, keeps the deflated data within a uint16 message size
+	static constexpr unsigned MAX_BATCH_SIZE = 32768;
+
+	explicit RelayBatch(SinkFunc sinkFunc): sink(std::move(sinkFunc)) {}
+
+	void Append(PacketType packet);
+	void Flush();
+	void Clear() { buffer.clear(); }
+
+	bool Empty() const { return buffer.empty(); }
+	size_t Size() const { return buffer.size(); }
+
+	/**
+	 * Calls msgFunc(data, length) for every message in the NETMSG_RELAYED_PACKETS
+	 * message <data>, in batch order. Returns false if that was malformed, the
+	 * messages preceding the error have been passed on already.
+	 */
+	static bool Unpack(const std::uint8_t* data, unsigned length, const MessageFunc& msgFunc);
+
+private:
+	std::vector<std::uint8_t> buffer;
+
+	SinkFunc sink;
+};
+
+} // namespace netcode
+
+#endif // _RELAY_BATCH_H
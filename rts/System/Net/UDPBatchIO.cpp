@@ -0,0 +1,233 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "UDPBatchIO.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+	#include <sys/socket.h>
+	#include <sys/uio.h>
+	#define UDP_BATCH_IO_MMSG 1
+#else
+	#define UDP_BATCH_IO_MMSG 0
+#endif
+
+#include "Socket.h"
+#include "System/Log/ILog.h"
+
+
+namespace netcode
+{
+
+UDPBatchIO::UDPBatchIO(std::shared_ptr<asio::ip::udp::socket> netSocket)
+	: socket(netSocket)
+	, batched(UDP_BATCH_IO_MMSG)
+{
+	recvBuffer.resize(MAX_BATCH_SIZE * MAX_DATAGRAM_SIZE, 0);
+	sendBuffer.reserve(MAX_BATCH_SIZE * 1500);
+	sendQueue.reserve(MAX_BATCH_SIZE);
+}
+
+UDPBatchIO::~UDPBatchIO()
+{
+	deferDepth = 0;
+	FlushDeferred();
+}
+
+
+bool UDPBatchIO::Receive(std::vector<Datagram>& datagrams)
+{
+	if (batched)
+		return (ReceiveBatched(datagrams));
+
+	return (ReceiveFallback(datagrams));
+}
+
+bool UDPBatchIO::ReceiveBatched(std::vector<Datagram>& datagrams)
+{
+#if UDP_BATCH_IO_MMSG
+	mmsghdr msgs[MAX_BATCH_SIZE];
+	iovec iovs[MAX_BATCH_SIZE];
+	sockaddr_storage addrs[MAX_BATCH_SIZE];
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (size_t i = 0; i < MAX_BATCH_SIZE; i++) {
+		iovs[i].iov_base = &recvBuffer[i * MAX_DATAGRAM_SIZE];
+		iovs[i].iov_len = MAX_DATAGRAM_SIZE;
+
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	const int numMsgs = recvmmsg(socket->native_handle(), msgs, MAX_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+	if (numMsgs < 0) {
+		switch (errno) {
+			case EAGAIN:
+			#if (EWOULDBLOCK != EAGAIN)
+			case EWOULDBLOCK:
+			#endif
+				return false;
+
+			// pending ICMP errors from a peer that went away; consumed by this call
+			case EINTR:
+			case ECONNREFUSED:
+				return true;
+
+			case ENOSYS: {
+				LOG_L(L_WARNING, "[UDPBatchIO::%s] recvmmsg not supported, falling back to unbatched I/O", __func__);
+				batched = false;
+				return (ReceiveFallback(datagrams));
+			} break;
+
+			default: {
+				asio::error_code err(errno, asio::error::get_system_category());
+				CheckErrorCode(err);
+				return false;
+			} break;
+		}
+	}
+
+	for (int i = 0; i < numMsgs; i++) {
+		const msghdr& hdr = msgs[i].msg_hdr;
+
+		// not one of ours
+		if ((hdr.msg_flags & MSG_TRUNC) != 0)
+			continue;
+
+		// endpoint storage only holds a sockaddr_in6, less than sockaddr_storage
+		if (hdr.msg_namelen > asio::ip::udp::endpoint().capacity())
+			continue;
+
+		Datagram& dgram = datagrams.emplace_back();
+
+		memcpy(dgram.sender.data(), &addrs[i], hdr.msg_namelen);
+		dgram.sender.resize(hdr.msg_namelen);
+
+		dgram.data = &recvBuffer[i * MAX_DATAGRAM_SIZE];
+		dgram.size = msgs[i].msg_len;
+	}
+
+	// a partial batch means the receive queue was drained
+	return (numMsgs == MAX_BATCH_SIZE);
+#else
+	return (ReceiveFallback(datagrams));
+#endif
+}
+
+bool UDPBatchIO::ReceiveFallback(std::vector<Datagram>& datagrams)
+{
+	const size_t bytesAvailable = socket->available();
+
+	if (bytesAvailable == 0)
+		return false;
+
+	// available() can report the whole queue on some platforms
+	if (bytesAvailable > recvBuffer.size())
+		recvBuffer.resize(bytesAvailable, 0);
+
+	Datagram dgram;
+	asio::ip::udp::socket::message_flags msgFlags = 0;
+	asio::error_code err;
+
+	dgram.data = recvBuffer.data();
+	dgram.size = socket->receive_from(asio::buffer(recvBuffer), dgram.sender, msgFlags, err);
+
+	if (CheckErrorCode(err))
+		return false;
+
+	datagrams.push_back(dgram);
+	return true;
+}
+
+
+void UDPBatchIO::Send(const std::uint8_t* data, size_t size, const asio::ip::udp::endpoint& dest, asio::error_code& err)
+{
+	if (!batched || deferDepth == 0) {
+		socket->send_to(asio::buffer(data, size), dest, 0, err);
+		return;
+	}
+
+	sendQueue.push_back({dest, sendBuffer.size(), size});
+	sendBuffer.insert(sendBuffer.end(), data, data + size);
+
+	if (sendQueue.size() < MAX_BATCH_SIZE)
+		return;
+
+	FlushDeferred();
+}
+
+void UDPBatchIO::EndDeferred()
+{
+	assert(deferDepth > 0);
+
+	if ((deferDepth -= 1) > 0)
+		return;
+
+	FlushDeferred();
+}
+
+void UDPBatchIO::FlushDeferred()
+{
+#if UDP_BATCH_IO_MMSG
+	mmsghdr msgs[MAX_BATCH_SIZE];
+	iovec iovs[MAX_BATCH_SIZE];
+
+	for (size_t i = 0; i < sendQueue.size(); ) {
+		const size_t numMsgs = std::min(sendQueue.size() - i, MAX_BATCH_SIZE);
+
+		memset(msgs, 0, sizeof(msgs));
+
+		for (size_t j = 0; j < numMsgs; j++) {
+			QueuedDatagram& qd = sendQueue[i + j];
+
+			iovs[j].iov_base = &sendBuffer[qd.offset];
+			iovs[j].iov_len = qd.size;
+
+			msgs[j].msg_hdr.msg_name = qd.dest.data();
+			msgs[j].msg_hdr.msg_namelen = qd.dest.size();
+			msgs[j].msg_hdr.msg_iov = &iovs[j];
+			msgs[j].msg_hdr.msg_iovlen = 1;
+		}
+
+		const int numSent = sendmmsg(socket->native_handle(), msgs, numMsgs, MSG_DONTWAIT);
+
+		if (numSent > 0) {
+			i += numSent;
+			continue;
+		}
+
+		if (numSent < 0 && errno == EINTR)
+			continue;
+
+		if (numSent < 0 && errno == ENOSYS) {
+			batched = false;
+
+			for (; i < sendQueue.size(); i++) {
+				asio::error_code err;
+				socket->send_to(asio::buffer(&sendBuffer[sendQueue[i].offset], sendQueue[i].size), sendQueue[i].dest, 0, err);
+				CheckErrorCode(err);
+			}
+
+			break;
+		}
+
+		// the first datagram of the batch failed; drop it like a failed send_to would
+		asio::error_code err((numSent < 0)? errno: EAGAIN, asio::error::get_system_category());
+		CheckErrorCode(err);
+
+		i += 1;
+	}
+#endif
+
+	sendQueue.clear();
+	sendBuffer.clear();
+}
+
+}
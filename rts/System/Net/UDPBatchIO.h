@@ -0,0 +1,91 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _UDP_BATCH_IO_H
+#define _UDP_BATCH_IO_H
+
+#include "System/Misc/NonCopyable.h"
+
+#include <asio/ip/udp.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace netcode
+{
+
+/**
+ * @brief Batched datagram I/O on a socket shared by many connections
+ *
+ * On Linux, incoming datagrams are drained with recvmmsg and the packets
+ * that connections send while a deferred section is open are flushed with
+ * one sendmmsg call per batch, instead of one syscall per datagram. Other
+ * platforms (or kernels lacking these calls) use the plain asio path.
+ */
+class UDPBatchIO : spring::noncopyable
+{
+public:
+	struct Datagram {
+		asio::ip::udp::endpoint sender;
+
+		const std::uint8_t* data = nullptr;
+		size_t size = 0;
+	};
+
+	static constexpr size_t MAX_BATCH_SIZE = 32;
+	/// UDPConnection never sends more than udpMaxPacketSize (4096) bytes per datagram
+	static constexpr size_t MAX_DATAGRAM_SIZE = 8192;
+
+public:
+	UDPBatchIO(std::shared_ptr<asio::ip::udp::socket> netSocket);
+	~UDPBatchIO();
+
+	/**
+	 * @brief Append the next batch of pending datagrams to <datagrams>
+	 * The data pointers stay valid until the next call.
+	 * @return false if the socket has been drained (or failed)
+	 */
+	bool Receive(std::vector<Datagram>& datagrams);
+
+	/**
+	 * @brief Send a datagram, or queue it if inside a deferred section
+	 * Errors of queued datagrams are logged by the flush, <err> stays clear.
+	 */
+	void Send(const std::uint8_t* data, size_t size, const asio::ip::udp::endpoint& dest, asio::error_code& err);
+
+	/// queue all Send's until the matching EndDeferred, which flushes them
+	void BeginDeferred() { deferDepth += 1; }
+	void EndDeferred();
+
+	bool IsBatched() const { return batched; }
+
+private:
+	bool ReceiveBatched(std::vector<Datagram>& datagrams);
+	bool ReceiveFallback(std::vector<Datagram>& datagrams);
+
+	void FlushDeferred();
+
+private:
+	struct QueuedDatagram {
+		asio::ip::udp::endpoint dest;
+
+		size_t offset;
+		size_t size;
+	};
+
+	std::shared_ptr<asio::ip::udp::socket> socket;
+
+	/// MAX_BATCH_SIZE slots of MAX_DATAGRAM_SIZE bytes
+	std::vector<std::uint8_t> recvBuffer;
+	/// payloads of all queued datagrams, back to back
+	std::vector<std::uint8_t> sendBuffer;
+
+	std::vector<QueuedDatagram> sendQueue;
+
+	int deferDepth = 0;
+
+	bool batched = false;
+};
+
+}
+
+#endif // _UDP_BATCH_IO_H
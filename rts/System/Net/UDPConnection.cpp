@@ -7,6 +7,8 @@
 
 #include "Socket.h"
 #include "ProtocolDef.h"
+#include "RelayBatch.h"
+#include "UDPBatchIO.h"
 #include "Exception.h"
 #include "Net/Protocol/BaseNetProtocol.h"
 #include "System/Config/ConfigHandler.h"
@@ -14,6 +16,7 @@
 #include "System/GlobalConfig.h"
 #include "System/Log/ILog.h"
 #include "System/SpringFormat.h"
+#include "System/StringUtil.h"
 #include "System/SafeUtil.h"
 
 #ifndef UNIT_TEST
@@ -67,12 +70,12 @@ inline void EMULATE_PACKET_CORRUPTION(std::uint8_t& crc) {}
 	for (auto di = delayed.begin(); di != delayed.end(); ) { \
 		spring_time curtime = spring_gettime(); \
 		if (curtime > di->first && (curtime - di->first) > spring_msecs(0)) { \
-			mySocket->send_to(buffer(di->second), addr, flags, err); \
+			SendRaw(di->second, err); \
 			di = delayed.erase(di); \
 		} else { ++di; } \
 	} \
 	if (cond) \
-		delayed[spring_gettime() + spring_msecs(PACKET_MIN_LATENCY + (PACKET_MAX_LATENCY - PACKET_MIN_LATENCY) * RANDOM_NUMBER())] = data; \
+		delayed[spring_gettime() + spring_msecs(PACKET_MIN_LATENCY + (PACKET_MAX_LATENCY - PACKET_MIN_LATENCY) * RANDOM_NUMBER())] = sendBuffer; \
 	if (false)
 #else
 #define EMULATE_LATENCY(cond) if(cond)
@@ -231,10 +234,11 @@ void Packet::Serialize(std::vector<std::uint8_t>& data)
 
 
 
-UDPConnection::UDPConnection(std::shared_ptr<ip::udp::socket> netSocket, const ip::udp::endpoint& myAddr)
+UDPConnection::UDPConnection(std::shared_ptr<ip::udp::socket> netSocket, const ip::udp::endpoint& myAddr, std::shared_ptr<UDPBatchIO> batchIO)
 	: addr(myAddr)
 	, sharedSocket(true)
 	, mySocket(netSocket)
+	, myBatchIO(batchIO)
 {
 	Init();
 }
@@ -330,12 +334,13 @@ void UDPConnection::ReconnectTo(CConnection& conn) {
 }
 
 void UDPConnection::CopyConnection(UDPConnection &conn) {
-	conn.InitConnection(addr, mySocket);
+	conn.InitConnection(addr, mySocket, myBatchIO);
 }
 
-void UDPConnection::InitConnection(ip::udp::endpoint address, std::shared_ptr<ip::udp::socket> socket) {
+void UDPConnection::InitConnection(ip::udp::endpoint address, std::shared_ptr<ip::udp::socket> socket, std::shared_ptr<UDPBatchIO> batchIO) {
 	addr = address;
 	mySocket = socket;
+	myBatchIO = batchIO;
 }
 
 UDPConnection::~UDPConnection()
@@ -644,36 +649,14 @@ void UDPConnection::ProcessRawPacket(Packet& incoming)
 
 			// this returns false for zero/invalid pktLength
 			if (ProtocolDef::GetInstance()->IsValidLength(pktLength, msgLength)) {
-				msgQueue.emplace_back(new RawPacket(bufp, pktLength));
-				std::shared_ptr<const RawPacket>& msgPacket = msgQueue.back();
-
-				#ifdef ENABLE_DEBUG_STATS
-				// server sends both of these, clients send only keyframe messages
-				// TODO: would be easy to feed this data into a Q3A-style lagometer
-				//
-				if (msgPacket->data[0] == NETMSG_NEWFRAME || msgPacket->data[0] == NETMSG_KEYFRAME) {
-					const spring_time dt = spring_gettime() - lastFramePacketRecvTime;
-
-					sumDeltaFramePacketRecvTime += dt.toMilliSecsf();
-					minDeltaFramePacketRecvTime = std::min(dt.toMilliSecsf(), minDeltaFramePacketRecvTime);
-					maxDeltaFramePacketRecvTime = std::max(dt.toMilliSecsf(), maxDeltaFramePacketRecvTime);
-
-					numReceivedFramePackets += 1;
-					numEnqueuedFramePackets += 1;
-					lastFramePacketRecvTime = spring_gettime();
-
-					if (logMessages) {
-						LOG_L(L_INFO,
-							"\t[%s] (received=%u enqueued=%u) packets (dt=%fms mindt=%fms maxdt=%fms sumdt=%fms)",
-							__func__, numReceivedFramePackets, numEnqueuedFramePackets, dt.toMilliSecsf(),
-							minDeltaFramePacketRecvTime, maxDeltaFramePacketRecvTime, sumDeltaFramePacketRecvTime
-						);
-					}
+				// only servers send relayed batches, never unpack them from clients
+				if (*bufp == NETMSG_RELAYED_PACKETS && !sharedSocket) {
+					UnpackRelayedPackets(bufp, pktLength);
+				} else {
+					EnqueueMessage(bufp, pktLength);
 				}
-				#endif
 
 				pos += pktLength;
-				numPings += (msgPacket->data[0] == NETMSG_PING); // incoming
 			} else {
 				if (pktLength >= 0) {
 					// partial packet in buffer
@@ -693,6 +676,47 @@ void UDPConnection::ProcessRawPacket(Packet& incoming)
 	UpdateWaitingPackets();
 }
 
+void UDPConnection::EnqueueMessage(const std::uint8_t* data, unsigned length)
+{
+	msgQueue.emplace_back(new RawPacket(data, length));
+	std::shared_ptr<const RawPacket>& msgPacket = msgQueue.back();
+
+	#ifdef ENABLE_DEBUG_STATS
+	// server sends both of these, clients send only keyframe messages
+	// TODO: would be easy to feed this data into a Q3A-style lagometer
+	//
+	if (msgPacket->data[0] == NETMSG_NEWFRAME || msgPacket->data[0] == NETMSG_KEYFRAME) {
+		const spring_time dt = spring_gettime() - lastFramePacketRecvTime;
+
+		sumDeltaFramePacketRecvTime += dt.toMilliSecsf();
+		minDeltaFramePacketRecvTime = std::min(dt.toMilliSecsf(), minDeltaFramePacketRecvTime);
+		maxDeltaFramePacketRecvTime = std::max(dt.toMilliSecsf(), maxDeltaFramePacketRecvTime);
+
+		numReceivedFramePackets += 1;
+		numEnqueuedFramePackets += 1;
+		lastFramePacketRecvTime = spring_gettime();
+
+		if (logMessages) {
+			LOG_L(L_INFO,
+				"\t[%s] (received=%u enqueued=%u) packets (dt=%fms mindt=%fms maxdt=%fms sumdt=%fms)",
+				__func__, numReceivedFramePackets, numEnqueuedFramePackets, dt.toMilliSecsf(),
+				minDeltaFramePacketRecvTime, maxDeltaFramePacketRecvTime, sumDeltaFramePacketRecvTime
+			);
+		}
+	}
+	#endif
+
+	numPings += (msgPacket->data[0] == NETMSG_PING); // incoming
+}
+
+void UDPConnection::UnpackRelayedPackets(const std::uint8_t* data, unsigned length)
+{
+	const auto EnqueueRelayed = [this](const std::uint8_t* msgData, unsigned msgLength) { EnqueueMessage(msgData, msgLength); };
+
+	if (!RelayBatch::Unpack(data, length, EnqueueRelayed))
+		LOG_L(L_ERROR, "\t[%s] discarding (rest of) malformed relayed batch of %u bytes", __func__, length);
+}
+
 void UDPConnection::Flush(const bool forced)
 {
 	if (muted)
@@ -1053,11 +1077,10 @@ void UDPConnection::SendPacket(Packet& pkt)
 	outgoing.DataSent(sendBuffer.size());
 	lastPacketSendTime = spring_gettime();
 
-	ip::udp::socket::message_flags flags = 0;
 	asio::error_code err;
 
 	EMULATE_LATENCY( !EMULATE_PACKET_LOSS( LOSS_COUNTER ) ) {
-		mySocket->send_to(buffer(sendBuffer), addr, flags, err);
+		SendRaw(sendBuffer, err);
 	}
 
 	if (CheckErrorCode(err))
@@ -1067,6 +1090,17 @@ void UDPConnection::SendPacket(Packet& pkt)
 	sentPackets += 1;
 }
 
+void UDPConnection::SendRaw(const std::vector<std::uint8_t>& data, asio::error_code& err)
+{
+	if (myBatchIO != nullptr) {
+		myBatchIO->Send(data.data(), data.size(), addr, err);
+		return;
+	}
+
+	ip::udp::socket::message_flags flags = 0;
+	mySocket->send_to(buffer(data), addr, flags, err);
+}
+
 void UDPConnection::AckChunks(int lastAck)
 {
 	while (!unackedChunks.empty() && (lastAck >= (*unackedChunks.begin())->chunkNumber)) {
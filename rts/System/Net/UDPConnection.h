@@ -15,6 +15,7 @@ class CRC;
 
 
 namespace netcode {
+class UDPBatchIO;
 
 // for reliability testing, introduce fake packet loss with a percentage probability
 #define NETWORK_TEST 0                        // in [0, 1] // enable network reliability testing mode
@@ -81,7 +82,7 @@ public:
 class UDPConnection : public CConnection
 {
 public:
-	UDPConnection(std::shared_ptr<asio::ip::udp::socket> netSocket, const asio::ip::udp::endpoint& myAddr);
+	UDPConnection(std::shared_ptr<asio::ip::udp::socket> netSocket, const asio::ip::udp::endpoint& myAddr, std::shared_ptr<UDPBatchIO> batchIO = nullptr);
 	UDPConnection(int sourceport, const std::string& address, const unsigned port);
 	UDPConnection(CConnection& conn);
 	~UDPConnection();
@@ -136,7 +137,8 @@ public:
 
 private:
 	void InitConnection(asio::ip::udp::endpoint address,
-			std::shared_ptr<asio::ip::udp::socket> socket);
+			std::shared_ptr<asio::ip::udp::socket> socket,
+			std::shared_ptr<UDPBatchIO> batchIO);
 
 	void CopyConnection(UDPConnection& conn);
 
@@ -151,8 +153,12 @@ private:
 
 	void RequestResend(ChunkPtr ptr, bool noSort);
 	void SendPacket(Packet& pkt);
+	void SendRaw(const std::vector<std::uint8_t>& data, asio::error_code& err);
 
 	void UpdateWaitingPackets();
+	void EnqueueMessage(const std::uint8_t* data, unsigned length);
+	/// expand a NETMSG_RELAYED_PACKETS batch into its messages
+	void UnpackRelayedPackets(const std::uint8_t* data, unsigned length);
 	void UpdateResendRequests();
 
 private:
@@ -221,6 +227,8 @@ private:
 
 	/// Our socket
 	std::shared_ptr<asio::ip::udp::socket> mySocket;
+	/// batched sends if mySocket is shared with a listener, may be null
+	std::shared_ptr<UDPBatchIO> myBatchIO;
 
 	RawPacket fragmentBuffer;
 
@@ -34,7 +34,10 @@ UDPListener::UDPListener(int port, const std::string& ip): acceptNewConnections(
 	socket->non_blocking(true);
 	SetAcceptingConnections(true);
 
-	LOG("[%s] successfully bound socket on port %i", __func__, socket->local_endpoint().port());
+	batchIO = std::make_shared<UDPBatchIO>(socket);
+	datagrams.reserve(UDPBatchIO::MAX_BATCH_SIZE);
+
+	LOG("[%s] successfully bound socket on port %i (batched I/O: %d)", __func__, socket->local_endpoint().port(), batchIO->IsBatched());
 }
 
 UDPListener::~UDPListener() {
@@ -108,85 +111,88 @@ std::string UDPListener::TryBindSocket(int port, std::shared_ptr<asio::ip::udp::
 void UDPListener::Update() {
 	netservice.poll();
 
-	size_t bytesAvailable = 0;
-
-	while ((bytesAvailable = socket->available()) > 0) {
-		recvBuffer.clear();
-		recvBuffer.resize(bytesAvailable, 0);
+	bool receiving = true;
 
-		ip::udp::endpoint udpEndPoint;
-		asio::ip::udp::socket::message_flags msgFlags = 0;
-		asio::error_code err;
+	while (receiving) {
+		datagrams.clear();
+		receiving = batchIO->Receive(datagrams);
 
-		const size_t bytesReceived = socket->receive_from(asio::buffer(recvBuffer), udpEndPoint, msgFlags, err);
+		for (const UDPBatchIO::Datagram& dgram: datagrams) {
+			ProcessDatagram(dgram);
+		}
+	}
 
-		const auto ci = connMap.find(udpEndPoint);
+	// connections send from Update, flush everything they produced at once
+	batchIO->BeginDeferred();
 
-		// known connection but expired
-		if (ci != connMap.end() && ci->second.expired())
+	for (auto i = connMap.cbegin(); i != connMap.cend(); ) {
+		if (i->second.expired()) {
+			LOG_L(L_DEBUG, "[UDPListener::%s] connection closed: [%s]:%i", __func__, i->first.address().to_string().c_str(), i->first.port());
+			i = connMap.erase(i);
 			continue;
+		}
+		i->second.lock()->Update();
+		++i;
+	}
 
-		if (CheckErrorCode(err))
-			break;
+	batchIO->EndDeferred();
+}
 
-		if (bytesReceived < Packet::headerSize)
-			continue;
+void UDPListener::ProcessDatagram(const UDPBatchIO::Datagram& dgram) {
+	const ip::udp::endpoint& udpEndPoint = dgram.sender;
+	const auto ci = connMap.find(udpEndPoint);
 
-		Packet data(&recvBuffer[0], bytesReceived);
+	// known connection but expired
+	if (ci != connMap.end() && ci->second.expired())
+		return;
 
-		if (ci != connMap.end()) {
-			ci->second.lock()->ProcessRawPacket(data);
-			continue;
-		}
+	if (dgram.size < Packet::headerSize)
+		return;
 
+	Packet data(dgram.data, dgram.size);
 
-		// unknown connection but still have the packet, maybe a new client wants to connect from sender's address
-		if (acceptNewConnections && data.lastContinuous == -1 && data.nakType == 0)	{
-			if (!data.chunks.empty() && (*data.chunks.begin())->chunkNumber == 0) {
-				std::shared_ptr<UDPConnection> incoming(new UDPConnection(socket, udpEndPoint));
-				waiting.push(incoming);
-				connMap[udpEndPoint] = incoming;
-				incoming->ProcessRawPacket(data);
-			}
+	if (ci != connMap.end()) {
+		ci->second.lock()->ProcessRawPacket(data);
+		return;
+	}
 
-			continue;
+
+	// unknown connection but still have the packet, maybe a new client wants to connect from sender's address
+	if (acceptNewConnections && data.lastContinuous == -1 && data.nakType == 0)	{
+		if (!data.chunks.empty() && (*data.chunks.begin())->chunkNumber == 0) {
+			std::shared_ptr<UDPConnection> incoming(new UDPConnection(socket, udpEndPoint, batchIO));
+			waiting.push(incoming);
+			connMap[udpEndPoint] = incoming;
+			incoming->ProcessRawPacket(data);
 		}
 
+		return;
+	}
 
-		const asio::ip::address& senderAddr = udpEndPoint.address();
-		const std::string& senderIP = senderAddr.to_string();
 
-		if (dropMap.find(senderIP) == dropMap.end()) {
-			LOG_L(L_DEBUG, "[UDPListener::%s] dropping packet from unknown IP: [%s]:%i", __func__, senderIP.c_str(), udpEndPoint.port());
-			dropMap[senderIP] = 0;
-		} else {
-			dropMap[senderIP] += 1;
-		}
+	const asio::ip::address& senderAddr = udpEndPoint.address();
+	const std::string& senderIP = senderAddr.to_string();
 
-	#ifdef DEBUG
-		std::string conns;
-		for (auto it = connMap.cbegin(); it != connMap.cend(); ++it) {
-			conns += spring::format(" [%s]:%i;", it->first.address().to_string().c_str(),it->first.port());
-		}
-		LOG_L(L_DEBUG, "[UDPListener::%s] open connections: %s", __func__, conns.c_str());
-	#endif
+	if (dropMap.find(senderIP) == dropMap.end()) {
+		LOG_L(L_DEBUG, "[UDPListener::%s] dropping packet from unknown IP: [%s]:%i", __func__, senderIP.c_str(), udpEndPoint.port());
+		dropMap[senderIP] = 0;
+	} else {
+		dropMap[senderIP] += 1;
 	}
 
-	for (auto i = connMap.cbegin(); i != connMap.cend(); ) {
-		if (i->second.expired()) {
-			LOG_L(L_DEBUG, "[UDPListener::%s] connection closed: [%s]:%i", __func__, i->first.address().to_string().c_str(), i->first.port());
-			i = connMap.erase(i);
-			continue;
-		}
-		i->second.lock()->Update();
-		++i;
+#ifdef DEBUG
+	std::string conns;
+	for (auto it = connMap.cbegin(); it != connMap.cend(); ++it) {
+		conns += spring::format(" [%s]:%i;", it->first.address().to_string().c_str(),it->first.port());
 	}
+	LOG_L(L_DEBUG, "[UDPListener::%s] open connections: %s", __func__, conns.c_str());
+#endif
 }
 
 
 std::shared_ptr<UDPConnection> UDPListener::SpawnConnection(const std::string& ip, const unsigned port)
 {
-	std::shared_ptr<UDPConnection> newConn(new UDPConnection(socket, ip::udp::endpoint(WrapIP(ip), port)));
+	std::shared_ptr<UDPConnection> newConn(new UDPConnection(socket, ip::udp::endpoint(WrapIP(ip), port), batchIO));
 	connMap[newConn->GetEndpoint()] = newConn;
 	return newConn;
 }
@@ -9,6 +9,9 @@
 #include <map>
 #include <queue>
 #include <string>
+#include <vector>
+
+#include "UDPBatchIO.h"
 
 namespace netcode
 {
@@ -51,7 +54,8 @@ public:
 	/**
 	 * @brief Run this from time to time
 	 * Receive data from the socket and hand it to the associated UDPConnection,
-	 * or open a new UDPConnection. It also Updates all of its connections.
+	 * or open a new UDPConnection. It also Updates all of its connections,
+	 * whose outgoing packets are then sent in batches.
 	 */
 	void Update();
 
@@ -75,6 +79,9 @@ public:
 	void RejectConnection() { waiting.pop(); }
 	void UpdateConnections(); // Updates connections when the endpoint has been reconnected
 
+private:
+	void ProcessDatagram(const UDPBatchIO::Datagram& dgram);
+
 private:
 	/**
 	 * @brief Do we accept packets from unknown sources?
@@ -85,7 +92,10 @@ private:
 	/// socket being listened on
 	std::shared_ptr<asio::ip::udp::socket> socket;
 
-	std::vector<std::uint8_t> recvBuffer;
+	/// batched receives and sends on <socket>, shared with all connections
+	std::shared_ptr<UDPBatchIO> batchIO;
+
+	std::vector<UDPBatchIO::Datagram> datagrams;
 
 	/// all connections
 	std::map< asio::ip::udp::endpoint, std::weak_ptr<UDPConnection> > connMap;
@@ -35,6 +35,8 @@ static void ExitSpringProcessAux(bool waitForExit, bool exitSuccess)
 	if (waitForExit)
 		spring::this_thread::sleep_for(std::chrono::seconds(5));
 
+	// write out records still queued by asynchronous sinks
+	LOG_CLEANUP();
 	logSinkHandler.SetSinking(false);
 
 #ifdef _MSC_VER
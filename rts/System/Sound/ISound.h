@@ -35,6 +35,8 @@ public:
 	virtual bool PreloadSoundItem(const std::string& name) = 0;
 	virtual size_t GetDefSoundId(const std::string& name) = 0;
 	virtual size_t GetSoundId(const std::string& name) = 0;
+	/// decodes the files of all named sounds in parallel, then loads them like GetSoundId
+	virtual void PredecodeSounds(const std::vector<std::string>& names) = 0;
 
 
 	virtual SoundItem* GetSoundItem(size_t id) = 0;
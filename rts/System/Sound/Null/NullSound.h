@@ -22,6 +22,7 @@ public:
 	bool PreloadSoundItem(const std::string& name) override { return false; }
 	size_t GetDefSoundId(const std::string& name) override { return 0; }
 	size_t GetSoundId(const std::string& name) override { return 0; }
+	void PredecodeSounds(const std::vector<std::string>& names) override {}
 
 	SoundItem* GetSoundItem(size_t id) override { return nullptr; }
 	CSoundSource* GetNextBestSource(bool lock = true) override { return nullptr; }
@@ -16,6 +16,7 @@
 // #include <alext.h>
 #endif
 
+#include <array>
 #include <climits>
 #include <cinttypes>
 #include <functional>
@@ -91,12 +92,14 @@ void CSound::Init()
 	}
 	{
 		SoundBuffer::Initialise();
+		pcmCache.SetDiskCacheSize(std::int64_t(configHandler->GetInt("SoundPCMCacheSize")) * 1024 * 1024);
 
 		soundMap.clear();
 		soundMap.reserve(256);
 		preloadSet.clear();
 		preloadSet.reserve(16);
 		failureSet.clear();
+		loadingItems.clear();
 
 		defaultItemNameMap.clear();
 		soundItemDefsMap.clear();
@@ -121,6 +124,7 @@ void CSound::Kill()
 			soundThread.join();
 	}
 
+	pcmCache.Clear();
 	SoundBuffer::Deinitialise();
 }
 
@@ -169,7 +173,15 @@ bool CSound::PreloadSoundItem(const std::string& name)
 	ThreadPool::Enqueue([name]() { sound->GetSoundId(name); });
 	#else
 	std::lock_guard<spring::recursive_mutex> lck(soundMutex);
-	return ((preloadSet.insert(name)).second);
+
+	if (!preloadSet.insert(name).second)
+		return false;
+
+	// decode in the background, Update picks the item up once it is done
+	if (const std::string file = GetSoundFile(name); !file.empty() && SoundBuffer::GetId(file) == 0 && !failureSet.contains(file))
+		pcmCache.PredecodeAsync(file);
+
+	return true;
 	#endif
 }
 
@@ -203,17 +215,71 @@ size_t CSound::GetSoundId(const std::string& name)
 		return (preloadSet.erase(name), MakeItemFromDef(itemDefIt->second));
 
 	// name does not match any sounds.lua item, interpret as raw file reference
-	if (LoadSoundBuffer(name) > 0) {
-		SoundItemNameMap itemMap = defaultItemNameMap;
-		itemMap.erase("file");
-		itemMap.emplace("file", name);
-		return (preloadSet.erase(name), MakeItemFromDef(itemMap));
-	}
+	SoundItemNameMap itemMap = defaultItemNameMap;
+	itemMap.erase("file");
+	itemMap.emplace("file", name);
+
+	if (const size_t itemID = MakeItemFromDef(itemMap); itemID > 0)
+		return (preloadSet.erase(name), itemID);
 
 	LOG_L(L_ERROR, "[Sound::%s] could not find sound \"%s\"", __func__, name.c_str());
 	return (preloadSet.erase(name), 0);
 }
 
+void CSound::PredecodeSounds(const std::vector<std::string>& names)
+{
+	std::vector<std::string> files;
+
+	{
+		std::lock_guard<spring::recursive_mutex> lck(soundMutex);
+
+		// GetSoundId would not load anything
+		if (soundSources.empty())
+			return;
+
+		files.reserve(names.size());
+
+		for (const std::string& name: names) {
+			const std::string file = GetSoundFile(name);
+
+			if (file.empty() || SoundBuffer::GetId(file) > 0 || failureSet.contains(file))
+				continue;
+
+			files.push_back(file);
+		}
+	}
+
+	// decoding needs no AL context, only the buffer uploads below are serial
+	pcmCache.Predecode(files);
+
+	std::lock_guard<spring::recursive_mutex> lck(soundMutex);
+
+	for (const std::string& name: names) {
+		GetSoundId(name);
+	}
+
+	// whatever GetSoundId did not take would otherwise stay around until Kill
+	pcmCache.Drop(files);
+}
+
+std::string CSound::GetSoundFile(const std::string& name) const
+{
+	if (soundMap.find(name) != soundMap.end())
+		return "";
+
+	const auto itemDefIt = soundItemDefsMap.find(StringToLower(name));
+
+	if (itemDefIt == soundItemDefsMap.end())
+		return name;
+
+	const auto fileIt = itemDefIt->second.find("file");
+
+	if (fileIt == itemDefIt->second.end())
+		return "";
+
+	return fileIt->second;
+}
+
 
 SoundItem* CSound::GetSoundItem(size_t id) {
 	// id==0 is a special id and invalid
@@ -757,8 +823,41 @@ void CSound::Update()
 
 	// limit consumption-rate to prevent source starvation
 	// lock is held, size can not be changed except by loop
-	for (size_t i = 0, n = std::min(size_t(4), preloadSet.size()); i < n; i++) {
-		GetSoundId(*preloadSet.begin());
+	// items still being decoded are skipped, GetSoundId would wait for them
+	std::array<std::string, 4> preloadNames;
+	size_t numPreloadNames = 0;
+
+	for (const std::string& name: preloadSet) {
+		if (numPreloadNames == preloadNames.size())
+			break;
+
+		if (const std::string file = GetSoundFile(name); !file.empty() && pcmCache.IsDecoding(file))
+			continue;
+
+		preloadNames[numPreloadNames++] = name;
+	}
+
+	for (size_t i = 0; i < numPreloadNames; i++) {
+		GetSoundId(preloadNames[i]);
+	}
+
+	for (size_t i = 0; i < loadingItems.size(); ) {
+		const auto& [itemID, file] = loadingItems[i];
+
+		if (pcmCache.IsDecoding(file)) {
+			i++;
+			continue;
+		}
+
+		SoundItem& item = soundItems[itemID];
+		item.SetSoundBufferID(LoadSoundBuffer(file));
+
+		// let the next GetSoundId fail like it would have without decoding in the background
+		if (item.GetSoundBufferID() == 0)
+			soundMap.erase(item.Name());
+
+		loadingItems[i] = std::move(loadingItems.back());
+		loadingItems.pop_back();
 	}
 
 	for (CSoundSource& source: soundSources) {
@@ -779,11 +878,32 @@ size_t CSound::MakeItemFromDef(const SoundItemNameMap& itemDef)
 	if (defIt == itemDef.end())
 		return 0;
 
-	const size_t bufferID = LoadSoundBuffer(defIt->second);
-	const size_t   itemID = soundItems.size();
+	const std::string& file = defIt->second;
+
+	size_t bufferID = SoundBuffer::GetId(file);
+	const size_t itemID = soundItems.size();
 
+	if (bufferID == 0) {
+		if (failureSet.contains(file))
+			return 0;
+
+		if (!CFileHandler::FileExists(file, SPRING_VFS_RAW_FIRST)) {
+			LOG_L(L_WARNING, "[%s] failed to load file \"%s\"", __func__, file.c_str());
+			failureSet.insert(file);
+			return 0;
+		}
+
+		// no-op if PredecodeSounds or PreloadSoundItem got to it first
+		pcmCache.PredecodeAsync(file);
+
+		if (!pcmCache.IsDecoding(file) && (bufferID = LoadSoundBuffer(file)) == 0)
+			return 0;
+	}
+
+	// items whose file is still decoding are handed out right away, Update
+	// loads their buffer once it is done and sources wait for that to play
 	if (bufferID == 0)
-		return 0;
+		loadingItems.emplace_back(itemID, file);
 
 	soundItems.emplace_back(itemID, bufferID, itemDef);
 	soundMap[ soundItems[itemID].Name() ] = itemID;
@@ -873,6 +993,7 @@ bool CSound::LoadSoundDefsImpl(LuaParser* defsParser)
 
 		{
 			std::vector<std::string> keys;
+			std::vector<std::string> preloadNames;
 			soundItemTable.GetKeys(keys);
 
 			for (const std::string& name: keys) {
@@ -902,9 +1023,29 @@ bool CSound::LoadSoundDefsImpl(LuaParser* defsParser)
 				if (!buf.KeyExists("preload"))
 					continue;
 
+				preloadNames.push_back(name);
+			}
+
+			// items are (re)made even if already in soundMap, so not via PredecodeSounds
+			std::vector<std::string> preloadFiles;
+
+			for (const std::string& name: preloadNames) {
+				const std::string& file = soundItemDefsMap[name]["file"];
+
+				if (SoundBuffer::GetId(file) > 0 || failureSet.contains(file))
+					continue;
+
+				preloadFiles.push_back(file);
+			}
+
+			pcmCache.Predecode(preloadFiles);
+
+			for (const std::string& name: preloadNames) {
 				MakeItemFromDef(soundItemDefsMap[name]);
 			}
 
+			pcmCache.Drop(preloadFiles);
+
 			LOG("[%s] parsed %i sounds from %s", __func__, (int)keys.size(), fileName.c_str());
 		}
 	}
@@ -938,41 +1079,12 @@ size_t CSound::LoadSoundBuffer(const std::string& path)
 	if (failureSet.find(path) != failureSet.end())
 		return 0;
 
-	CFileHandler file("", "");
-
-	loadBuffer.clear();
-	loadBuffer.reserve(1024 * 1024);
-
-	file.GetBuffer() = std::move(loadBuffer);
-	file.Open(path, SPRING_VFS_RAW_FIRST);
-
-	// steal back
-	loadBuffer = std::move(file.GetBuffer());
-
-	if (!file.FileExists()) {
-		LOG_L(L_ERROR, "[%s] unable to open audio file \"%s\"", __func__, path.c_str());
-		failureSet.insert(path);
-		return 0;
-	}
-
-	if (loadBuffer.empty()) {
-		// copy file into buffer manually if not in VFS
-		loadBuffer.resize(file.FileSize());
-		file.Read(loadBuffer.data(), loadBuffer.size());
-	}
-
-
+	SoundPCM pcm;
 	SoundBuffer soundBuf;
-	const std::string& soundExt = file.GetFileExt();
-
-	switch (soundExt[0]) {
-		case 'w': { soundBuf.LoadWAV   (path, loadBuffer); } break; // wav
-		case 'o': { soundBuf.LoadVorbis(path, loadBuffer); } break; // ogg
-		case 'm': { soundBuf.LoadMp3   (path, loadBuffer); } break; // mp3
-		default : {
-			LOG_L(L_WARNING, "[%s] unknown audio format \"%s\"", __func__, soundExt.c_str());
-		} break;
-	}
+
+	// callers make sure the file was decoded on the thread-pool first, Take does not wait
+	if (pcmCache.Take(path, pcm) && pcm.length > 0.0f)
+		soundBuf.LoadPCM(path, pcm);
 
 	CheckError("[Sound::LoadSoundBuffer]");
 
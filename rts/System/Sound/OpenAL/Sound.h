@@ -16,6 +16,7 @@
 #include "System/Threading/SpringThreading.h"
 
 #include "SoundItem.h"
+#include "SoundPCMCache.h"
 
 class CSoundSource;
 class SoundBuffer;
@@ -35,6 +36,7 @@ public:
 	bool PreloadSoundItem(const std::string& name) override;
 	size_t GetDefSoundId(const std::string& name) override;
 	size_t GetSoundId(const std::string& name) override;
+	void PredecodeSounds(const std::vector<std::string>& names) override;
 
 	SoundItem* GetSoundItem(size_t id);
 	CSoundSource* GetNextBestSource(bool lock = true) override;
@@ -93,6 +95,9 @@ private:
 	size_t MakeItemFromDef(const SoundItemNameMap& itemDef);
 	size_t LoadSoundBuffer(const std::string& filename);
 
+	/// file behind a sound name not loaded yet, empty if there is none
+	std::string GetSoundFile(const std::string& name) const;
+
 private:
 	ALCdevice* curDevice = nullptr;
 	ALCcontext* curContext = nullptr;
@@ -106,10 +111,13 @@ private:
 	spring::unordered_set<std::string> preloadSet;
 	spring::unordered_set<std::string> failureSet;
 
+	/// <itemID, file> of items whose file is still being decoded
+	std::vector<std::pair<size_t, std::string>> loadingItems;
+
 	std::vector<SoundItem> soundItems;
 	std::vector<CSoundSource> soundSources; // fixed-size
 
-	std::vector<std::uint8_t> loadBuffer;
+	CSoundPCMCache pcmCache;
 
 	SoundItemNameMap defaultItemNameMap;
 	SoundItemDefsMap soundItemDefsMap; // parsed from sounds.lua
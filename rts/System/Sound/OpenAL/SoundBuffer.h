@@ -12,6 +12,8 @@
 #include "System/UnorderedMap.hpp"
 #include "System/Misc/NonCopyable.h"
 
+struct SoundPCM;
+
 /**
  * @brief A buffer holding a sound
  *
@@ -37,9 +39,8 @@ public:
 		return *this;
 	}
 
-	bool LoadWAV(const std::string& file, const std::vector<std::uint8_t>& buffer);
-	bool LoadVorbis(const std::string& file, const std::vector<std::uint8_t>& buffer);
-	bool LoadMp3(const std::string& file, const std::vector<std::uint8_t>& buffer);
+	/// uploads samples decoded by CSoundPCMCache
+	bool LoadPCM(const std::string& file, const SoundPCM& pcm);
 	bool Release();
 
 	const std::string& GetFilename() const { return filename; }
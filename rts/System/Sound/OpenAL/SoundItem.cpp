@@ -7,7 +7,6 @@
 #include <stdexcept>
 #include <cfloat>
 
-#include "SoundBuffer.h"
 #include "System/GlobalRNG.h"
 
 namespace
@@ -40,7 +39,7 @@ SoundItem::SoundItem(size_t itemID, size_t bufferID, const spring::unordered_map
 	, maxDist(FLT_MAX)
 {
 	if (!MapEntryValExtract(items, "name", name))
-		name = (SoundBuffer::GetById(bufferID)).GetFilename();
+		MapEntryValExtract(items, "file", name);
 
 	MapEntryValExtract(items, "gain", gain);
 	MapEntryValExtract(items, "gainmod", gainMod);
@@ -33,6 +33,11 @@ public:
 	void StopPlay();
 
 	size_t GetSoundBufferID() const { return soundBufferID; }
+	/// set once the file has been decoded in the background, 0 if that failed
+	void SetSoundBufferID(size_t bufferID) { soundBufferID = bufferID; loadFailed = (bufferID == 0); }
+
+	/// true while the buffer is still being decoded, playback has to wait
+	bool IsLoading() const { return (soundBufferID == 0 && !loadFailed); }
 
 	float MaxDistance() const { return maxDist; }
 	const std::string& Name() const { return name; }
@@ -66,6 +71,7 @@ private:
 	unsigned loopTime = 0;
 
 	bool in3D = true;
+	bool loadFailed = false;
 };
 
 #endif
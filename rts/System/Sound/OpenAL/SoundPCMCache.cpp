@@ -0,0 +1,537 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "SoundPCMCache.h"
+
+#include "ALShared.h"
+#include "Mp3Decoder.h"
+#include "OggDecoder.h"
+#include "System/Sound/SoundLog.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/CRC.h"
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/VFSHandler.h"
+#include "System/Platform/byteorder.h"
+#include "System/StringUtil.h"
+#include "System/Sync/SHA512.hpp"
+#include "System/Threading/ThreadPool.h"
+
+#include "System/Misc/TracyDefs.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+CONFIG(int, SoundPCMCacheSize)
+	.defaultValue(0)
+	.minimumValue(0)
+	.description("Size limit in MB of the on-disk cache of decoded Ogg and MP3 sounds, 0 disables it. Only worthwhile where decoding is slower than reading the decoded samples back.");
+
+
+namespace {
+	constexpr char PCM_CACHE_MAGIC[8] = {'S', 'N', 'D', 'P', 'C', 'M', '\0', '\0'};
+	constexpr std::uint32_t PCM_CACHE_VERSION = 1;
+
+	struct PCMCacheFileHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t checksum; // CRC of the samples
+		std::uint32_t numBytes;
+		std::int32_t channels;
+		std::int32_t bitsPerSample;
+		std::int32_t rate;
+		float length;
+	};
+
+	#pragma pack(push, 1)
+	// Header copied from WavLib by Michael McTernan
+	struct WAVHeader
+	{
+		std::uint8_t riff[4];        // "RIFF"
+		std::int32_t totalLength;
+		std::uint8_t wavefmt[8];     // WAVEfmt "
+		std::int32_t length;         // Remaining length 4 bytes
+		std::int16_t format_tag;
+		std::int16_t channels;       // Mono=1 Stereo=2
+		std::int32_t SamplesPerSec;
+		std::int32_t AvgBytesPerSec;
+		std::int16_t BlockAlign;
+		std::int16_t BitsPerSample;
+		std::uint8_t data[4];        // "data"
+		std::int32_t datalen;        // Raw data length 4 bytes
+	};
+	#pragma pack(pop)
+
+
+	std::string GetPCMCacheDir() {
+		return (FileSystem::GetCacheDir() + FileSystemAbstraction::GetNativePathSeparator() + "sounds" + FileSystemAbstraction::GetNativePathSeparator());
+	}
+
+
+	bool DecodeWAV(const std::string& file, std::vector<std::uint8_t>& buffer, SoundPCM& pcm)
+	{
+		WAVHeader* header = (WAVHeader*)(&buffer[0]);
+
+		if ((buffer.size() < sizeof(WAVHeader)) || memcmp(header->riff, "RIFF", 4) || memcmp(header->wavefmt, "WAVEfmt", 7)) {
+			LOG_L(L_ERROR, "[%s(%s)] invalid header", __func__, file.c_str());
+			return false;
+		}
+
+	#define hswabword(c) swabWordInPlace(header->c)
+	#define hswabdword(c) swabDWordInPlace(header->c)
+		hswabword(format_tag);
+		hswabword(channels);
+		hswabword(BlockAlign);
+		hswabword(BitsPerSample);
+
+		hswabdword(totalLength);
+		hswabdword(length);
+		hswabdword(SamplesPerSec);
+		hswabdword(AvgBytesPerSec);
+		hswabdword(datalen);
+	#undef hswabword
+	#undef hswabdword
+
+		if (header->format_tag != 1) { // Microsoft PCM format?
+			LOG_L(L_ERROR, "[%s(%s)] invalid format tag", __func__, file.c_str());
+			return false;
+		}
+
+		if (header->channels != 1 && header->channels != 2) {
+			LOG_L(L_ERROR, "[%s(%s)] invalid number of channels (%d)", __func__, file.c_str(), header->channels);
+			return false;
+		}
+
+		if (header->BitsPerSample != 8 && header->BitsPerSample != 16) {
+			LOG_L(L_ERROR, "[%s(%s)] invalid number of bits per sample (%s; %d)", __func__, file.c_str(), (header->channels == 1)? "mono": "stereo", header->BitsPerSample);
+			return false;
+		}
+
+		if (static_cast<unsigned>(header->datalen) > buffer.size() - sizeof(WAVHeader)) {
+			LOG_L(L_ERROR,
+					"[%s(%s)] data length %i greater than actual data length %i",
+					__func__, file.c_str(), header->datalen,
+					(int)(buffer.size() - sizeof(WAVHeader)));
+
+			header->datalen = std::uint32_t(buffer.size() - sizeof(WAVHeader))&(~std::uint32_t((header->BitsPerSample*header->channels)/8 -1));
+		}
+
+		if (header->datalen > 0)
+			pcm.samples.assign(buffer.begin() + sizeof(WAVHeader), buffer.begin() + sizeof(WAVHeader) + header->datalen);
+
+		pcm.channels      = header->channels;
+		pcm.bitsPerSample = header->BitsPerSample;
+		pcm.rate          = header->SamplesPerSec;
+		pcm.length        = float(header->datalen) / (header->channels * header->SamplesPerSec * header->BitsPerSample);
+		return true;
+	}
+
+	template<typename Decoder, typename ReadFunc>
+	bool DecodeCompressed(const std::string& file, const std::vector<std::uint8_t>& buffer, SoundPCM& pcm, const char* caller, ReadFunc&& readFunc)
+	{
+		Decoder decoder;
+
+		if (!decoder.LoadData(buffer.data(), buffer.size()))
+			return false;
+
+		if (decoder.GetChannels() != 1 && decoder.GetChannels() != 2) {
+			LOG_L(L_ERROR, "[%s(%s)] invalid number of channels (%i)", caller, file.c_str(), decoder.GetChannels());
+			return false;
+		}
+
+		std::vector<std::uint8_t>& decodeBuffer = pcm.samples;
+
+		size_t pos = 0;
+		long read = 0;
+
+		decodeBuffer.resize(DECODE_BUFFER_SIZE);
+
+		do {
+			// enlarge buffer so the decoder has enough space
+			if ((4 * pos) > (3 * decodeBuffer.size()))
+				decodeBuffer.resize(decodeBuffer.size() * 2);
+
+			if ((read = readFunc(decoder, &decodeBuffer[pos], decodeBuffer.size() - pos)) < 0)
+				return false; // abort
+
+			pos += read;
+		} while (read > 0); // read == 0 indicated EOF, read < 0 is error
+
+		decodeBuffer.resize(pos);
+		decodeBuffer.shrink_to_fit();
+
+		pcm.channels      = decoder.GetChannels();
+		pcm.bitsPerSample = 16;
+		pcm.rate          = decoder.GetRate();
+		pcm.length        = decoder.GetTotalTime();
+		return true;
+	}
+
+	bool DecodeVorbis(const std::string& file, const std::vector<std::uint8_t>& buffer, SoundPCM& pcm)
+	{
+		return DecodeCompressed<OggDecoder>(file, buffer, pcm, __func__, [&file](OggDecoder& decoder, std::uint8_t* data, size_t size) -> long {
+			int section = 0;
+
+			while (true) {
+				const long read = decoder.Read(data, size, 0, 2, 1, &section);
+
+				switch (read) {
+					case OV_HOLE: {
+						LOG_L(L_WARNING, "[DecodeVorbis(%s)] garbage or corrupt page in stream (non-fatal)", file.c_str());
+						continue; // read next
+					} break;
+					case OV_EBADLINK: {
+						LOG_L(L_WARNING, "[DecodeVorbis(%s)] corrupted stream", file.c_str());
+					} break;
+					case OV_EINVAL: {
+						LOG_L(L_WARNING, "[DecodeVorbis(%s)] corrupted headers", file.c_str());
+					} break;
+					default: {
+					} break;
+				}
+
+				return read;
+			}
+		});
+	}
+
+	bool DecodeMp3(const std::string& file, const std::vector<std::uint8_t>& buffer, SoundPCM& pcm)
+	{
+		return DecodeCompressed<Mp3Decoder>(file, buffer, pcm, __func__, [&file](Mp3Decoder& decoder, std::uint8_t* data, size_t size) -> long {
+			const long read = decoder.Read(data, size, 0, 0, 0, 0);
+
+			if (read < 0)
+				LOG_L(L_WARNING, "[DecodeMp3(%s)] corrupt page in stream: %ld", file.c_str(), read);
+
+			return read;
+		});
+	}
+}
+
+
+bool CSoundPCMCache::DecodeFile(const std::string& path, SoundPCM& pcm)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	pcm = {};
+
+	CFileHandler file("", "");
+	std::vector<std::uint8_t>& fileBuffer = file.GetBuffer();
+
+	file.Open(path, SPRING_VFS_RAW_FIRST);
+
+	if (!file.FileExists()) {
+		LOG_L(L_ERROR, "[%s] unable to open audio file \"%s\"", __func__, path.c_str());
+		return false;
+	}
+
+	if (fileBuffer.empty()) {
+		// copy file into buffer manually if not in VFS
+		fileBuffer.resize(file.FileSize());
+		file.Read(fileBuffer.data(), fileBuffer.size());
+	}
+
+	const std::string& soundExt = file.GetFileExt();
+
+	switch (soundExt[0]) {
+		case 'w': { DecodeWAV   (path, fileBuffer, pcm); } break; // wav
+		case 'o': { DecodeVorbis(path, fileBuffer, pcm); } break; // ogg
+		case 'm': { DecodeMp3   (path, fileBuffer, pcm); } break; // mp3
+		default : {
+			LOG_L(L_WARNING, "[%s] unknown audio format \"%s\"", __func__, soundExt.c_str());
+		} break;
+	}
+
+	return (pcm.length > 0.0f);
+}
+
+
+void CSoundPCMCache::Predecode(const std::vector<std::string>& paths)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	std::vector<std::string> decodePaths;
+	std::vector<std::string> archiveNames;
+
+	{
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		for (const std::string& path: paths) {
+			if (decoded.contains(path) || pending.contains(path))
+				continue;
+			if (std::find(decodePaths.begin(), decodePaths.end(), path) != decodePaths.end())
+				continue;
+
+			decodePaths.push_back(path);
+		}
+	}
+
+	// VFS lookups stay on this thread, archives are hashed by the workers
+	for (const std::string& path: decodePaths) {
+		archiveNames.push_back(GetCacheArchiveName(path));
+	}
+
+	std::vector<SoundPCM> decodedPCM(decodePaths.size());
+
+	for_mt(0, decodePaths.size(), [&](const int i) {
+		decodedPCM[i] = DecodeOrReadCached(decodePaths[i], archiveNames[i]);
+	});
+
+	std::lock_guard<spring::mutex> lck(mutex);
+
+	for (size_t i = 0; i < decodePaths.size(); i++) {
+		decoded.emplace(decodePaths[i], std::move(decodedPCM[i]));
+	}
+}
+
+void CSoundPCMCache::PredecodeAsync(const std::string& path)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	{
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		if (decoded.contains(path) || pending.contains(path))
+			return;
+	}
+
+	const std::string archiveName = GetCacheArchiveName(path);
+
+	// without a pool Enqueue defers the task until it is waited on
+	if (!ThreadPool::HasThreads()) {
+		SoundPCM pcm = DecodeOrReadCached(path, archiveName);
+
+		std::lock_guard<spring::mutex> lck(mutex);
+		decoded.emplace(path, std::move(pcm));
+		return;
+	}
+
+	// held until the task is registered, it erases itself when done
+	std::lock_guard<spring::mutex> lck(mutex);
+
+	pending[path] = ThreadPool::Enqueue([this, path, archiveName]() {
+		SoundPCM pcm = DecodeOrReadCached(path, archiveName);
+
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		decoded.emplace(path, std::move(pcm));
+		pending.erase(path);
+	});
+}
+
+bool CSoundPCMCache::IsDecoding(const std::string& path) const
+{
+	std::lock_guard<spring::mutex> lck(mutex);
+	return (pending.contains(path));
+}
+
+bool CSoundPCMCache::Take(const std::string& path, SoundPCM& pcm)
+{
+	std::unique_lock<spring::mutex> lck(mutex);
+
+	if (const auto it = pending.find(path); it != pending.end()) {
+		const std::shared_future<void> future = it->second;
+
+		lck.unlock();
+		future.wait();
+		lck.lock();
+	}
+
+	const auto it = decoded.find(path);
+
+	if (it == decoded.end())
+		return false;
+
+	pcm = std::move(it->second);
+	decoded.erase(it);
+	return true;
+}
+
+void CSoundPCMCache::Drop(const std::vector<std::string>& paths)
+{
+	std::lock_guard<spring::mutex> lck(mutex);
+
+	for (const std::string& path: paths) {
+		decoded.erase(path);
+	}
+}
+
+void CSoundPCMCache::Clear()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	while (true) {
+		std::shared_future<void> future;
+
+		{
+			std::lock_guard<spring::mutex> lck(mutex);
+
+			if (pending.empty())
+				break;
+
+			future = pending.begin()->second;
+		}
+
+		future.wait();
+
+		// the task normally erases itself, but not if it threw
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		for (auto it = pending.begin(); it != pending.end(); ++it) {
+			if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				continue;
+
+			pending.erase(it);
+			break;
+		}
+	}
+
+	std::lock_guard<spring::mutex> lck(mutex);
+	decoded.clear();
+}
+
+
+std::string CSoundPCMCache::GetCacheArchiveName(const std::string& path) const
+{
+	if (maxDiskCacheSize <= 0)
+		return "";
+
+	// wav files are stored as PCM already
+	const std::string ext = StringToLower(FileSystem::GetExtension(path));
+
+	if (ext != "ogg" && ext != "mp3")
+		return "";
+
+	// loose files have no archive checksum to key on
+	if (CFileHandler::FileExists(path, SPRING_VFS_RAW))
+		return "";
+
+	for (const char mode: std::string(SPRING_VFS_ZIP)) {
+		const CVFSHandler::Section section = CVFSHandler::GetModeSection(mode);
+
+		if (!vfsHandler->FileExists(path, section))
+			continue;
+
+		return (vfsHandler->GetFileArchiveName(path, section));
+	}
+
+	return "";
+}
+
+std::string CSoundPCMCache::GetCacheFileName(const std::string& path, const std::string& archiveName)
+{
+	const sha512::raw_digest& archiveChecksum = archiveScanner->GetArchiveSingleChecksumBytes(archiveName);
+	const std::string normPath = StringToLower(path) + '\0' + IntToString(PCM_CACHE_VERSION);
+
+	std::vector<std::uint8_t> keyData(archiveChecksum.begin(), archiveChecksum.end());
+	keyData.insert(keyData.end(), normPath.begin(), normPath.end());
+
+	sha512::raw_digest keyDigest;
+	sha512::calc_digest(keyData, keyDigest);
+
+	return (GetPCMCacheDir() + sha512::dump_digest(keyDigest).substr(0, 32) + ".pcm");
+}
+
+SoundPCM CSoundPCMCache::DecodeOrReadCached(const std::string& path, const std::string& archiveName)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	SoundPCM pcm;
+
+	const std::string cacheFileName = archiveName.empty()? "": GetCacheFileName(path, archiveName);
+
+	if (!cacheFileName.empty() && ReadPCMFile(cacheFileName, pcm))
+		return pcm;
+
+	DecodeFile(path, pcm);
+
+	if (!cacheFileName.empty() && pcm.length > 0.0f)
+		WriteCacheFile(cacheFileName, pcm);
+
+	return pcm;
+}
+
+
+bool CSoundPCMCache::ReadPCMFile(const std::string& fileName, SoundPCM& pcm)
+{
+	CFileHandler fh(fileName, SPRING_VFS_RAW);
+	PCMCacheFileHeader header;
+
+	if (!fh.FileExists())
+		return false;
+
+	if (fh.Read(&header, sizeof(header)) != sizeof(header))
+		return false;
+
+	if (std::memcmp(header.magic, PCM_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != PCM_CACHE_VERSION)
+		return false;
+
+	pcm.samples.resize(std::min<size_t>(header.numBytes, fh.FileSize() - sizeof(header)));
+
+	if (pcm.samples.size() != header.numBytes || fh.Read(pcm.samples.data(), pcm.samples.size()) != static_cast<int>(pcm.samples.size()) || CRC::CalcDigest(pcm.samples.data(), pcm.samples.size()) != header.checksum) {
+		LOG_L(L_WARNING, "[SoundPCMCache::%s] ignoring corrupt cache-file \"%s\"", __func__, fileName.c_str());
+		pcm = {};
+		return false;
+	}
+
+	pcm.channels      = header.channels;
+	pcm.bitsPerSample = header.bitsPerSample;
+	pcm.rate          = header.rate;
+	pcm.length        = header.length;
+	return true;
+}
+
+bool CSoundPCMCache::WritePCMFile(const std::string& fileName, const SoundPCM& pcm)
+{
+	PCMCacheFileHeader header;
+	std::memcpy(header.magic, PCM_CACHE_MAGIC, sizeof(header.magic));
+	header.version = PCM_CACHE_VERSION;
+	header.checksum = CRC::CalcDigest(pcm.samples.data(), pcm.samples.size());
+	header.numBytes = pcm.samples.size();
+	header.channels = pcm.channels;
+	header.bitsPerSample = pcm.bitsPerSample;
+	header.rate = pcm.rate;
+	header.length = pcm.length;
+
+	std::ofstream ofs(fileName, std::ios::binary);
+
+	ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	ofs.write(reinterpret_cast<const char*>(pcm.samples.data()), pcm.samples.size());
+
+	if (ofs.good())
+		return true;
+
+	ofs.close();
+	FileSystem::Remove(fileName);
+	return false;
+}
+
+void CSoundPCMCache::WriteCacheFile(const std::string& cacheFileName, const SoundPCM& pcm)
+{
+	const std::int64_t fileSize = sizeof(PCMCacheFileHeader) + pcm.samples.size();
+
+	{
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		if (diskCacheSize < 0) {
+			diskCacheSize = 0;
+
+			for (const std::string& cacheFile: dataDirsAccess.FindFiles(GetPCMCacheDir(), "*.pcm")) {
+				diskCacheSize += FileSystem::GetFileSize(dataDirsAccess.LocateFile(cacheFile));
+			}
+		}
+
+		// full; entries are not evicted, delete the directory to start over
+		if ((diskCacheSize + fileSize) > maxDiskCacheSize)
+			return;
+
+		diskCacheSize += fileSize;
+
+		if (!FileSystem::CreateDirectory(GetPCMCacheDir()))
+			return;
+	}
+
+	WritePCMFile(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE), pcm);
+}
@@ -0,0 +1,87 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SOUND_PCM_CACHE_H
+#define SOUND_PCM_CACHE_H
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "System/UnorderedMap.hpp"
+#include "System/Threading/SpringThreading.h"
+
+/// decoded samples of a sound file, independent of any AL device
+struct SoundPCM {
+	std::vector<std::uint8_t> samples;
+
+	std::int32_t channels = 0;
+	std::int32_t bitsPerSample = 0;
+	std::int32_t rate = 0;
+
+	/// <= 0 if the file could not be decoded
+	float length = 0.0f;
+};
+
+/**
+ * @brief Decoded sound data waiting to be uploaded into SoundBuffers
+ *
+ * Files are decoded on the thread-pool, either all at once during loading
+ * (Predecode) or one by one in the background (PredecodeAsync); CSound then
+ * only has to Take the result and create the AL buffer. Decoded Ogg and MP3
+ * files can additionally be kept on disk, keyed by the checksum of the
+ * archive containing them and their path, bounded by SetDiskCacheSize.
+ */
+class CSoundPCMCache {
+public:
+	~CSoundPCMCache() { Clear(); }
+
+	/// size limit in bytes of the on-disk cache, 0 (the default) disables it
+	void SetDiskCacheSize(std::int64_t size) { maxDiskCacheSize = size; }
+
+	/// decodes (or reads back) all files in parallel, blocks until done
+	void Predecode(const std::vector<std::string>& paths);
+	/// queues one file for decoding on the thread-pool
+	void PredecodeAsync(const std::string& path);
+
+	/// true while path is queued by PredecodeAsync
+	bool IsDecoding(const std::string& path) const;
+	/// moves the decoded data for path out of the cache (waiting if it is
+	/// still queued), false if there is none
+	bool Take(const std::string& path, SoundPCM& pcm);
+	/// drops decoded data for paths nobody took (e.g. after Predecode),
+	/// does not wait for queued decodes
+	void Drop(const std::vector<std::string>& paths);
+
+	/// waits for queued decodes and drops all decoded data
+	void Clear();
+
+	/// reads and decodes a wav, ogg or mp3 file; thread-safe
+	static bool DecodeFile(const std::string& path, SoundPCM& pcm);
+
+	/// cache-file format; reading rejects files whose samples fail the CRC
+	static bool ReadPCMFile(const std::string& fileName, SoundPCM& pcm);
+	static bool WritePCMFile(const std::string& fileName, const SoundPCM& pcm);
+
+private:
+	/// archive containing path if its decoded data can be kept on disk, "" otherwise
+	std::string GetCacheArchiveName(const std::string& path) const;
+	/// may block on hashing the archive, called by the decode tasks
+	static std::string GetCacheFileName(const std::string& path, const std::string& archiveName);
+
+	SoundPCM DecodeOrReadCached(const std::string& path, const std::string& archiveName);
+
+	void WriteCacheFile(const std::string& cacheFileName, const SoundPCM& pcm);
+
+private:
+	mutable spring::mutex mutex;
+
+	spring::unordered_map<std::string, SoundPCM> decoded;
+	spring::unordered_map<std::string, std::shared_future<void>> pending;
+
+	std::int64_t maxDiskCacheSize = 0;
+	// bytes in the on-disk cache, -1 until first scanned
+	std::int64_t diskCacheSize = -1;
+};
+
+#endif // SOUND_PCM_CACHE_H
@@ -80,8 +80,18 @@ void CSoundSource::Update()
 {
 	if (asyncPlayItem.id != 0) {
 		// Sound::Update() holds mutex, soundItems can not be accessed concurrently
-		Play(asyncPlayItem.channel, sound->GetSoundItem(asyncPlayItem.id), asyncPlayItem.position, asyncPlayItem.velocity, asyncPlayItem.volume, asyncPlayItem.relative);
-		asyncPlayItem = AsyncSoundItemData();
+		SoundItem* item = sound->GetSoundItem(asyncPlayItem.id);
+
+		// keep the source reserved until the item's buffer has been decoded
+		if (!item->IsLoading()) {
+			if (item->GetSoundBufferID() != 0) {
+				Play(asyncPlayItem.channel, item, asyncPlayItem.position, asyncPlayItem.velocity, asyncPlayItem.volume, asyncPlayItem.relative);
+			} else {
+				asyncPlayItem.channel->SoundSourceFinished(this);
+			}
+
+			asyncPlayItem = AsyncSoundItemData();
+		}
 	}
 
 	if (curPlayingItem.id != 0) {
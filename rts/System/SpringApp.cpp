@@ -105,6 +105,8 @@
 CONFIG(unsigned, SetCoreAffinity).defaultValue(0).safemodeValue(1).description("Defines a bitmask indicating which CPU cores the main-thread should use.");
 CONFIG(unsigned, TextureMemPoolSize).defaultValue(512).minimumValue(0).description("Set to 0 to disable, otherwise specify a predefined memory to serve Bitmap allocation requests");
 CONFIG(bool, UseLuaMemPools).defaultValue(true).description("Whether Lua VM memory allocations are made from pools.");
+CONFIG(unsigned, LuaMemPoolFrameArenaSize).defaultValue(0).minimumValue(0).maximumValue(64 * 1024).description("Size in KB of the per-state bump arena serving small short-lived Lua allocations (0 disables it). Requires UseLuaMemPools.");
+CONFIG(bool, LuaMemPoolTrackSizeClasses).defaultValue(false).description("Whether Lua VM memory allocations are counted per size-class (see /debuglua and Spring.GetLuaMemUsage).");
 CONFIG(bool, UseHighResTimer).defaultValue(false).description("On Windows, sets whether Spring will use low- or high-resolution timer functions for tasks like graphical interpolation between game frames.");
 CONFIG(bool, UseFontConfigLib).defaultValue(true).description("Whether the system fontconfig library (if present and enabled at compile-time) should be used for handling fonts.");
 CONFIG(bool, UseFontConfigSystemFonts).defaultValue(true).description("Whether the system fonts will be searched by fontconfig.");
@@ -234,7 +236,7 @@ SpringApp::~SpringApp()
 bool SpringApp::Init()
 {
 	SpringMath::Init();
-	LuaMemPool::InitStatic(configHandler->GetBool("UseLuaMemPools"));
+	LuaMemPool::InitStatic(configHandler->GetBool("UseLuaMemPools"), configHandler->GetUnsigned("LuaMemPoolFrameArenaSize") * 1024, configHandler->GetBool("LuaMemPoolTrackSizeClasses"));
 
 	CGlobalRendering::InitStatic();
 	globalRendering->SetFullScreen(FLAGS_window, FLAGS_fullscreen);
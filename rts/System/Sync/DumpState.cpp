@@ -10,6 +10,7 @@
 
 #include "DumpState.h"
 #include "DumpHistory.h"
+#include "SubsystemChecksums.h"
 
 #include "Game/Game.h"
 #include "Game/GameSetup.h"
@@ -111,7 +112,7 @@ namespace {
 }
 
 
-void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::optional<bool> outputFloats, std::optional<int> historyFrame, bool serverRequest)
+void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::optional<bool> outputFloats, std::optional<int> historyFrame, bool serverRequest, const DumpStateFilter& filter)
 {
 	if (outputFloats.has_value())
 		onlyHash = !outputFloats.value();
@@ -121,6 +122,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	static int gMaxFrameNum = -1;
 	static int gFramePeriod =  1;
 	static int gHistoryFrame = -1;
+	static DumpStateFilter gFilter;
 
 	const int oldMinFrameNum = gMinFrameNum;
 	const int oldMaxFrameNum = gMaxFrameNum;
@@ -145,6 +147,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 		}
 
 		gHistoryFrame = historyFrame.value_or(-1);
+		gFilter = filter;
 
 		std::string name = (gameServer != nullptr)? "Server": "Client";
 		name += "GameState-";
@@ -167,6 +170,13 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 			file << "genState: " << gsRNG.GetGenState() << "\n";
 			file << "  gameID: " << DumpGameID(game->gameID) << "\n";
 			file << " syncVer: " << SpringVersion::GetSync() << "\n";
+
+			if (gFilter.subsystemMask != DumpStateFilter{}.subsystemMask) {
+				file << "  filter: " << CSubsystemChecksums::GetSubsystemNames(gFilter.subsystemMask) << "\n";
+			}
+			if (gFilter.minUnitID != DumpStateFilter{}.minUnitID || gFilter.maxUnitID != DumpStateFilter{}.maxUnitID) {
+				file << " unitIDs: " << gFilter.minUnitID << "-" << gFilter.maxUnitID << "\n";
+			}
 		}
 
 		LOG("[%s] using dump-file \"%s\"", __func__, name.c_str());
@@ -182,6 +192,17 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	if ((gs->frameNum % gFramePeriod) != 0)
 		return;
 
+	// per-unit data also covers the LOS, pathing and rules-param subsystem checksums
+	constexpr uint32_t unitSubsystemsMask =
+		(1u << CSubsystemChecksums::SUBSYS_UNITS) |
+		(1u << CSubsystemChecksums::SUBSYS_LOS) |
+		(1u << CSubsystemChecksums::SUBSYS_PATHING) |
+		(1u << CSubsystemChecksums::SUBSYS_LUA);
+
+	const bool dumpUnits = ((gFilter.subsystemMask & unitSubsystemsMask) != 0);
+	const bool dumpFeatures = ((gFilter.subsystemMask & (1u << CSubsystemChecksums::SUBSYS_FEATURES)) != 0);
+	const bool dumpProjectiles = ((gFilter.subsystemMask & (1u << CSubsystemChecksums::SUBSYS_PROJECTILES)) != 0);
+
 	// we only care about the synced projectile data here
 	const std::vector<CUnit*>& activeUnits = unitHandler.GetActiveUnits();
 	const auto& activeFeatureIDs = featureHandler.GetActiveFeatureIDs();
@@ -326,6 +347,9 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 
 	#ifdef DUMP_UNIT_DATA
 	for (const CUnit* u: activeUnits) {
+		if (!dumpUnits || u->id < gFilter.minUnitID || u->id > gFilter.maxUnitID)
+			continue;
+
 		const std::vector<CWeapon*>& weapons = u->weapons;
 		const LocalModel& lm = u->localModel;
 		const std::vector<LocalModelPiece>& pieces = lm.pieces;
@@ -454,7 +478,7 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 	}
 	#endif
 	#ifdef DUMP_UNIT_SCRIPT_DATA
-	{
+	if (dumpUnits) {
 		file << "\tCobEngine:\n";
 		file << "\t\tcurrentTime: " << cobEngine->GetCurrTime();
 		file << "\t\tCobThreads: " << cobEngine->GetThreadInstances().size() << "\n";
@@ -489,6 +513,9 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 
 	#ifdef DUMP_FEATURE_DATA
 	for (const int featureID: activeFeatureIDs) {
+		if (!dumpFeatures)
+			break;
+
 		const CFeature* f = featureHandler.GetFeature(featureID);
 
 		const auto& pos  = f->pos;
@@ -515,6 +542,9 @@ void DumpState(int newMinFrameNum, int newMaxFrameNum, int newFramePeriod, std::
 
 	#ifdef DUMP_PROJECTILE_DATA
 	for (const CProjectile* p: projectiles) {
+		if (!dumpProjectiles)
+			break;
+
 		file << "\t\tprojectileID: " << p->id << "\n";
 		file << "\t\t\tpos: <" << TapFloats(p->pos);
 		file << "\t\t\tdir: <" << TapFloats(p->dir);
@@ -3,9 +3,19 @@
 #ifndef DUMPSTATE_H
 #define DUMPSTATE_H
 
+#include <cstdint>
+#include <limits>
 #include <optional>
 
-extern void DumpState(int startFrameNum, int endFrameNum, int newFramePeriod, std::optional<bool> outputFloats, std::optional<int> historyFrame = std::nullopt, bool serverRequest = false);
+// restricts a dump to the unit-ID range and subsystems (CSubsystemChecksums bits) that diverged
+struct DumpStateFilter {
+	int minUnitID = 0;
+	int maxUnitID = std::numeric_limits<int>::max();
+
+	uint32_t subsystemMask = ~0u;
+};
+
+extern void DumpState(int startFrameNum, int endFrameNum, int newFramePeriod, std::optional<bool> outputFloats, std::optional<int> historyFrame = std::nullopt, bool serverRequest = false, const DumpStateFilter& filter = {});
 extern void DumpRNG(int startFrameNum, int endFrameNum);
 
 #endif /* DUMPSTATE_H */
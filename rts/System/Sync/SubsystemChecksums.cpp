@@ -0,0 +1,192 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <variant>
+
+#include "SubsystemChecksums.h"
+
+#include "Lua/LuaHandleSynced.h"
+#include "Lua/LuaRulesParams.h"
+#include "Sim/Features/Feature.h"
+#include "Sim/Features/FeatureHandler.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/Team.h"
+#include "Sim/Misc/TeamHandler.h"
+#include "Sim/MoveTypes/GroundMoveType.h"
+#include "Sim/MoveTypes/MoveType.h"
+#include "Sim/Projectiles/Projectile.h"
+#include "Sim/Projectiles/ProjectileHandler.h"
+#include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitHandler.h"
+#include "System/SpringHash.h"
+#include "System/Misc/TracyDefs.h"
+
+CSubsystemChecksums::Record CSubsystemChecksums::record;
+
+
+namespace {
+	// hashed as raw bytes, so all members are 4-byte wide to rule out padding
+	struct UnitState {
+		int32_t id;
+		int32_t heading;
+		int32_t physicalState;
+		int32_t isDead;
+		float3 pos;
+		float4 speed;
+		float3 frontdir;
+		float3 updir;
+		float health;
+		float experience;
+		float buildProgress;
+	};
+	struct PathState {
+		int32_t id;
+		int32_t progressState;
+		float3 goalPos;
+		float3 currWayPoint;
+		float3 nextWayPoint;
+	};
+	struct FeatureState {
+		int32_t id;
+		float3 pos;
+		float4 speed;
+		float health;
+		float reclaimLeft;
+		float resurrectProgress;
+	};
+	struct ProjectileState {
+		int32_t id;
+		int32_t checkCol;
+		int32_t deleteMe;
+		float3 pos;
+		float3 dir;
+		float4 speed;
+	};
+
+	static_assert(sizeof(UnitState) == (4 * 4 + 12 + 16 + 12 + 12 + 3 * 4), "");
+	static_assert(sizeof(PathState) == (2 * 4 + 3 * 12), "");
+	static_assert(sizeof(FeatureState) == (4 + 12 + 16 + 3 * 4), "");
+	static_assert(sizeof(ProjectileState) == (3 * 4 + 12 + 12 + 16), "");
+
+
+	uint32_t HashParamValue(bool v, uint32_t cs) { return spring::LiteHash(static_cast<uint8_t>(v), cs); }
+	uint32_t HashParamValue(float v, uint32_t cs) { return spring::LiteHash(v, cs); }
+	uint32_t HashParamValue(const std::string& v, uint32_t cs) { return spring::LiteHash(v.data(), v.size(), cs); }
+
+	// rules-params live in unordered maps, so entries are combined independently of iteration order
+	uint32_t HashRulesParams(const LuaRulesParams::Params& params, uint32_t cs) {
+		uint32_t sum = 0;
+
+		for (const auto& [name, param]: params) {
+			const uint32_t nameHash = spring::LiteHash(name.data(), name.size(), param.los);
+			sum += std::visit([nameHash](const auto& v) { return HashParamValue(v, nameHash); }, param.value);
+		}
+
+		return spring::LiteHash(sum, cs);
+	}
+}
+
+
+void CSubsystemChecksums::Update(int frameNum)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	record = {};
+	record.frameNum = frameNum;
+	record.unitsPerBucket = (unitHandler.MaxUnits() + NUM_UNIT_BUCKETS - 1) / NUM_UNIT_BUCKETS;
+
+	auto& subsystems = record.subsystems;
+	auto& unitBuckets = record.unitBuckets;
+
+	const size_t numAllyTeams = teamHandler.ActiveAllyTeams();
+
+	for (const CUnit* u: unitHandler.GetActiveUnits()) {
+		const UnitState us = {
+			u->id,
+			u->heading,
+			static_cast<int32_t>(u->physicalState),
+			u->isDead,
+			u->pos,
+			u->speed,
+			u->frontdir,
+			u->updir,
+			u->health,
+			u->experience,
+			u->buildProgress,
+		};
+
+		uint32_t& bucket = unitBuckets[u->id / record.unitsPerBucket];
+
+		bucket = spring::LiteHash(us, bucket);
+
+		subsystems[SUBSYS_LOS] = spring::LiteHash(u->losStatus.data(), numAllyTeams * sizeof(u->losStatus[0]), subsystems[SUBSYS_LOS]);
+		subsystems[SUBSYS_LUA] = HashRulesParams(u->modParams, subsystems[SUBSYS_LUA]);
+
+		const AMoveType* mt = u->moveType;
+		const CGroundMoveType* gmt = (u->moveDef != nullptr)? dynamic_cast<const CGroundMoveType*>(mt): nullptr;
+
+		const PathState ps = {
+			u->id,
+			static_cast<int32_t>(mt->progressState),
+			mt->goalPos,
+			(gmt != nullptr)? static_cast<float3>(gmt->GetCurrWayPoint()): ZeroVector,
+			(gmt != nullptr)? static_cast<float3>(gmt->GetNextWayPoint()): ZeroVector,
+		};
+
+		subsystems[SUBSYS_PATHING] = spring::LiteHash(ps, subsystems[SUBSYS_PATHING]);
+	}
+
+	subsystems[SUBSYS_UNITS] = spring::LiteHash(unitBuckets.data(), sizeof(unitBuckets), 0);
+
+	{
+		uint32_t featuresSum = 0;
+		uint32_t paramsSum = 0;
+
+		for (const int featureID: featureHandler.GetActiveFeatureIDs()) {
+			const CFeature* f = featureHandler.GetFeature(featureID);
+			const FeatureState fs = {
+				f->id,
+				f->pos,
+				f->speed,
+				f->health,
+				f->reclaimLeft,
+				f->resurrectProgress,
+			};
+
+			featuresSum += spring::LiteHash(fs);
+			paramsSum += HashRulesParams(f->modParams, featureID);
+		}
+
+		subsystems[SUBSYS_FEATURES] = spring::LiteHash(featuresSum);
+		subsystems[SUBSYS_LUA] = spring::LiteHash(paramsSum, subsystems[SUBSYS_LUA]);
+	}
+
+	for (const CProjectile* p: projectileHandler.GetActiveProjectiles(true)) {
+		const ProjectileState ps = {
+			p->id,
+			p->checkCol,
+			p->deleteMe,
+			p->pos,
+			p->dir,
+			p->speed,
+		};
+
+		subsystems[SUBSYS_PROJECTILES] = spring::LiteHash(ps, subsystems[SUBSYS_PROJECTILES]);
+	}
+
+	for (int t = 0; t < teamHandler.ActiveTeams(); ++t) {
+		subsystems[SUBSYS_LUA] = HashRulesParams(teamHandler.Team(t)->modParams, subsystems[SUBSYS_LUA]);
+	}
+
+	subsystems[SUBSYS_LUA] = HashRulesParams(CSplitLuaHandle::GetGameParams(), subsystems[SUBSYS_LUA]);
+
+	subsystems[SUBSYS_RNG] = spring::LiteHash(gsRNG.GetGenState());
+	subsystems[SUBSYS_RNG] = spring::LiteHash(gsRNG.GetLastSeed(), subsystems[SUBSYS_RNG]);
+}
+
+const CSubsystemChecksums::Record* CSubsystemChecksums::GetRecord(int frameNum)
+{
+	if (frameNum < 0 || record.frameNum != frameNum)
+		return nullptr;
+
+	return &record;
+}
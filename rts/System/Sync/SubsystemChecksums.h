@@ -0,0 +1,164 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SUBSYSTEM_CHECKSUMS_H
+#define SUBSYSTEM_CHECKSUMS_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief per-subsystem frame checksums
+ *
+ * Coarse hashes over the synced state of each simulation subsystem, with the
+ * unit hash further split into buckets of consecutive unit IDs. After a
+ * sync-response mismatch the server asks all clients for the record of a frame
+ * none of them has simulated yet, so only that frame is ever hashed; comparing
+ * the records then tells which subsystems (and which unit-ID range) diverged,
+ * so that the full state dump can be restricted to them.
+ *
+ * Everything except Update and GetRecord is header-only, since the dedicated
+ * server compares records without linking the simulation.
+ */
+class CSubsystemChecksums {
+public:
+	enum Subsystem {
+		SUBSYS_UNITS       = 0,
+		SUBSYS_FEATURES    = 1,
+		SUBSYS_PROJECTILES = 2,
+		SUBSYS_LOS         = 3,
+		SUBSYS_PATHING     = 4,
+		SUBSYS_LUA         = 5,
+		SUBSYS_RNG         = 6,
+		SUBSYS_COUNT       = 7,
+	};
+
+	static constexpr uint32_t SUBSYS_ALL_MASK = (1u << SUBSYS_COUNT) - 1;
+
+	static constexpr uint32_t NUM_UNIT_BUCKETS = 64;
+
+	struct Record {
+		int32_t frameNum = -1;
+		uint32_t unitsPerBucket = 0;
+
+		std::array<uint32_t, SUBSYS_COUNT> subsystems = {};
+		std::array<uint32_t, NUM_UNIT_BUCKETS> unitBuckets = {};
+	};
+
+	// number of words in a packed record
+	static constexpr size_t PACKED_SIZE = 2 + SUBSYS_COUNT + NUM_UNIT_BUCKETS;
+
+public:
+	/// marks <frameNum> as the next frame whose record is wanted
+	static void Request(int frameNum) { requestedFrame = frameNum; }
+	static bool IsRequested(int frameNum) { return (requestedFrame == frameNum); }
+
+	/// hashes the current synced state into the record for <frameNum>
+	static void Update(int frameNum);
+
+	/// returns nullptr unless <frameNum> was the last frame hashed
+	static const Record* GetRecord(int frameNum);
+
+
+	static std::vector<uint32_t> Pack(const Record& record) {
+		std::vector<uint32_t> words;
+		words.reserve(PACKED_SIZE);
+		words.push_back(static_cast<uint32_t>(record.frameNum));
+		words.push_back(record.unitsPerBucket);
+		words.insert(words.end(), record.subsystems.begin(), record.subsystems.end());
+		words.insert(words.end(), record.unitBuckets.begin(), record.unitBuckets.end());
+
+		assert(words.size() == PACKED_SIZE);
+		return words;
+	}
+
+	static bool Unpack(const std::vector<uint32_t>& words, Record& record) {
+		if (words.size() != PACKED_SIZE)
+			return false;
+
+		auto it = words.begin();
+
+		record.frameNum = static_cast<int32_t>(*(it++));
+		record.unitsPerBucket = *(it++);
+
+		std::copy(it, it + SUBSYS_COUNT, record.subsystems.begin()); it += SUBSYS_COUNT;
+		std::copy(it, it + NUM_UNIT_BUCKETS, record.unitBuckets.begin());
+
+		return (record.unitsPerBucket > 0);
+	}
+
+
+	/// bit <i> is set if subsystem <i> differs between <a> and <b>
+	static uint32_t CompareSubsystems(const Record& a, const Record& b) {
+		uint32_t mask = 0;
+
+		for (uint32_t i = 0; i < SUBSYS_COUNT; i++) {
+			mask |= (uint32_t(a.subsystems[i] != b.subsystems[i]) << i);
+		}
+
+		return mask;
+	}
+
+	/// bit <i> is set if unit bucket <i> differs between <a> and <b>
+	static uint64_t CompareUnitBuckets(const Record& a, const Record& b) {
+		uint64_t mask = 0;
+
+		for (uint32_t i = 0; i < NUM_UNIT_BUCKETS; i++) {
+			mask |= (uint64_t(a.unitBuckets[i] != b.unitBuckets[i]) << i);
+		}
+
+		return mask;
+	}
+
+
+	/// smallest [min, max] unit-ID range covering all buckets in <bucketMask>
+	static std::pair<int, int> GetUnitIDRange(uint64_t bucketMask, uint32_t unitsPerBucket) {
+		if (bucketMask == 0)
+			return {-1, -1};
+
+		const int minBucket = std::countr_zero(bucketMask);
+		const int maxBucket = 63 - std::countl_zero(bucketMask);
+
+		return {int(minBucket * unitsPerBucket), int((maxBucket + 1) * unitsPerBucket - 1)};
+	}
+
+	static std::string GetSubsystemNames(uint32_t subsystemMask) {
+		constexpr const char* names[SUBSYS_COUNT] = {
+			"units",
+			"features",
+			"projectiles",
+			"los",
+			"pathing",
+			"luarules",
+			"rng",
+		};
+
+		std::string str;
+
+		for (uint32_t i = 0; i < SUBSYS_COUNT; i++) {
+			if ((subsystemMask & (1u << i)) == 0)
+				continue;
+
+			if (!str.empty())
+				str += ", ";
+
+			str += names[i];
+		}
+
+		return str;
+	}
+
+private:
+	static Record record;
+
+	static inline int requestedFrame = -1;
+};
+
+static_assert(CSubsystemChecksums::NUM_UNIT_BUCKETS <= 64, "bucket masks are 64 bits wide");
+
+#endif // SUBSYSTEM_CHECKSUMS_H
@@ -12,6 +12,10 @@
 unsigned CSyncChecker::g_checksum;
 int CSyncChecker::inSyncedCode;
 
+std::vector<unsigned> CSyncChecker::laneChecksums;
+thread_local int CSyncChecker::curLane = -1;
+bool CSyncChecker::inLanes = false;
+
 void CSyncChecker::NewFrame()
 {
 	g_checksum = 0xfade1eaf;
@@ -27,6 +31,12 @@ void CSyncChecker::debugSyncCheckThreading()
 
 void CSyncChecker::Sync(const void* p, unsigned size)
 {
+	if (curLane >= 0) {
+		// history is not logged per lane, the order between lanes is arbitrary
+		laneChecksums[curLane] = spring::LiteHash(p, size, laneChecksums[curLane]);
+		return;
+	}
+
 #ifdef DEBUG_SYNC_MT_CHECK
 	// Sync calls should not be occurring in multi-threaded sections
 	debugSyncCheckThreading();
@@ -41,6 +51,34 @@ void CSyncChecker::Sync(const void* p, unsigned size)
 #endif // SYNC_HISTORY
 }
 
+void CSyncChecker::BeginLanes(unsigned numLanes)
+{
+	// sections can not be nested, inner jobs would not know their outer lane
+	assert(!inLanes);
+	assert(curLane < 0);
+
+	laneChecksums.clear();
+	laneChecksums.resize(numLanes, 0);
+
+	inLanes = true;
+}
+
+void CSyncChecker::EndLanes()
+{
+	assert(inLanes);
+	assert(curLane < 0);
+
+	for (const unsigned laneChecksum: laneChecksums) {
+		g_checksum = spring::LiteHash(&laneChecksum, sizeof(laneChecksum), g_checksum);
+	}
+
+	inLanes = false;
+
+#ifdef SYNC_HISTORY
+	LogHistory();
+#endif // SYNC_HISTORY
+}
+
 #ifdef SYNC_HISTORY
 
 unsigned CSyncChecker::nextHistoryIndex = 0;
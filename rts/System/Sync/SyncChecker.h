@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <array>
+#include <vector>
 
 static constexpr size_t MAX_SYNC_HISTORY = 2500000; // 10MB, ~= 10 seconds of typical midgame
 static constexpr size_t MAX_SYNC_HISTORY_FRAMES = 1000;
@@ -36,6 +37,18 @@ class CSyncChecker {
 		static void NewFrame();
 		static void debugSyncCheckThreading();
 		static void Sync(const void* p, unsigned size);
+
+		/**
+		 * Checksum lanes for parallel synced sections: while a section is
+		 * open, job <i> (with lane <i> set on its thread) hashes into its own
+		 * lane instead of the global checksum, and EndLanes folds all lanes
+		 * into it in index order. The result therefore only depends on what
+		 * each job synced, not on which thread ran it or when.
+		 */
+		static void BeginLanes(unsigned numLanes);
+		static void EndLanes();
+		static void SetLane(int laneIdx) { assert(laneIdx < 0 || laneIdx < laneChecksums.size()); curLane = laneIdx; }
+		static bool InLanes() { return inLanes; }
 		#ifdef SYNC_HISTORY
 		static std::tuple<unsigned, unsigned, unsigned*> GetFrameHistory(unsigned rewindFrames);
 		static std::pair<unsigned, unsigned*> GetHistory() { return std::make_pair(nextHistoryIndex, logs.data()); };
@@ -49,6 +62,14 @@ class CSyncChecker {
 		 */
 		static unsigned g_checksum;
 
+		/**
+		 * Per-job checksums of the open parallel section, and the lane of
+		 * the current thread (-1 if it syncs into g_checksum directly)
+		 */
+		static std::vector<unsigned> laneChecksums;
+		static thread_local int curLane;
+		static bool inLanes;
+
 		/**
 		 * @brief in synced code
 		 *
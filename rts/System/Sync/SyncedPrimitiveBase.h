@@ -61,6 +61,37 @@ namespace Sync {
 		Assert(&x, sizeof(T), msg);
 	}
 
+
+	/**
+	 * @brief Opens a parallel synced section with one checksum lane per job.
+	 *
+	 * Jobs have to be identified by a deterministic index (e.g. the for_mt
+	 * index, not the thread number) and select their lane via ScopedLane:
+	 *
+	 *   Sync::ScopedLanes lanes(units.size());
+	 *   for_mt(0, units.size(), [&](int i) {
+	 *     Sync::ScopedLane lane(i);
+	 *     ...
+	 *   });
+	 */
+	struct ScopedLanes {
+	#ifdef SYNCCHECK
+		ScopedLanes(unsigned numLanes) { CSyncChecker::BeginLanes(numLanes); }
+		~ScopedLanes() { CSyncChecker::EndLanes(); }
+	#else
+		ScopedLanes(unsigned numLanes) {}
+	#endif
+	};
+
+	struct ScopedLane {
+	#ifdef SYNCCHECK
+		ScopedLane(unsigned laneIdx) { CSyncChecker::SetLane(laneIdx); }
+		~ScopedLane() { CSyncChecker::SetLane(-1); }
+	#else
+		ScopedLane(unsigned laneIdx) {}
+	#endif
+	};
+
 }
 
 #if !defined(NDEBUG) && defined(SYNCCHECK)
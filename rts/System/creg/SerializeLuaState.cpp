@@ -115,10 +115,8 @@ union creg_TKey {
 
 
 struct creg_Node {
-	CR_DECLARE_STRUCT(creg_Node)
 	creg_TValue i_val;
 	creg_TKey i_key;
-	void Serialize(creg::ISerializer* s);
 };
 
 ASSERT_SIZE(Node)
@@ -143,7 +141,6 @@ ASSERT_SIZE(Table)
 
 
 struct creg_LocVar {
-	CR_DECLARE_STRUCT(creg_LocVar)
 	creg_TString *varname;
 	int startpc;  /* first point where variable is active */
 	int endpc;    /* first point where variable is dead */
@@ -463,14 +460,6 @@ CR_REG_METADATA(creg_TValue, (
 ))
 
 
-CR_BIND_POOL(creg_Node, , allocProtector, freeProtector)
-CR_REG_METADATA(creg_Node, (
-	CR_MEMBER(i_val),
-	CR_IGNORED(i_key),
-	CR_SERIALIZER(Serialize)
-))
-
-
 CR_BIND_POOL(creg_Table, , luaContext.alloc, freeProtector)
 CR_REG_METADATA(creg_Table, (
 	CR_COMMON_HEADER(),
@@ -487,14 +476,6 @@ CR_REG_METADATA(creg_Table, (
 ))
 
 
-CR_BIND_POOL(creg_LocVar, , allocProtector, freeProtector)
-CR_REG_METADATA(creg_LocVar, (
-	CR_MEMBER(varname),
-	CR_MEMBER(startpc),
-	CR_MEMBER(endpc)
-))
-
-
 CR_BIND_POOL(creg_Proto, , luaContext.alloc, freeProtector)
 CR_REG_METADATA(creg_Proto, (
 	CR_COMMON_HEADER(),
@@ -654,23 +635,36 @@ CR_REG_METADATA(creg_LG, (
 ))
 
 
+template<typename T, typename C>
+inline T* SerializeCVectorAlloc(creg::ISerializer* s, T** vecPtr, C count)
+{
+	if (!(s->IsWriting()))
+		*vecPtr = (T*) luaContext.alloc(count * sizeof(T));
+
+	return *vecPtr;
+}
+
 template<typename T, typename C>
 inline void SerializeCVector(creg::ISerializer* s, T** vecPtr, C count)
 {
-	std::unique_ptr<creg::IType> elemType = creg::DeduceType<T>::Get();
-	T* vec;
-	if (!(s->IsWriting())) {
-		vec = (T*) luaContext.alloc(count * sizeof(T));
-		*vecPtr = vec;
-	} else {
-		vec = *vecPtr;
-	}
+	static const std::unique_ptr<creg::IType> elemType = creg::DeduceType<T>::Get();
+	T* vec = SerializeCVectorAlloc(s, vecPtr, count);
 
 	for (unsigned i = 0; i < unsigned(count); ++i) {
 		elemType->Serialize(s, &vec[i]);
 	}
 }
 
+template<typename T, typename C>
+inline void SerializeCVectorInts(creg::ISerializer* s, T** vecPtr, C count)
+{
+	T* vec = SerializeCVectorAlloc(s, vecPtr, count);
+
+	for (unsigned i = 0; i < unsigned(count); ++i) {
+		s->SerializeInt(&vec[i], sizeof(T));
+	}
+}
+
 template<typename T>
 void SerializePtr(creg::ISerializer* s, T** t) {
 	creg::ObjectPointerType<T> opt;
@@ -736,7 +730,7 @@ void creg_TValue::Serialize(creg::ISerializer* s)
 		case LUA_TSTRING: { SerializePtr(s, &value.gc); return; }
 		case LUA_TTABLE: { SerializePtr(s, &value.gc); return; }
 		case LUA_TFUNCTION: { SerializePtr(s, &value.gc); return; }
-		case LUA_TUSERDATA: { SerializePtr(s, &value.gc); }
+		case LUA_TUSERDATA: { SerializePtr(s, &value.gc); return; }
 		case LUA_TTHREAD: { SerializePtr(s, &value.gc); return; }
 		case LUA_TDEADKEY: { return; }
 		default: { assert(false); return; }
@@ -744,10 +738,59 @@ void creg_TValue::Serialize(creg::ISerializer* s)
 }
 
 
-void creg_Node::Serialize(creg::ISerializer* s)
+/*
+ * Values that no pointer can refer to (table slots, constants, C upvalues)
+ * are written as bare type-tag plus payload instead of going through
+ * SerializeInstance, which would register each of them as an embedded
+ * object; only stack slots and closed upvalues (see creg_UpVal::v) need that.
+ */
+static inline void SerializeTValueBare(creg::ISerializer* s, creg_TValue* tv)
+{
+	s->SerializeInt(&tv->tt, sizeof(tv->tt));
+	tv->Serialize(s);
+}
+
+template<typename C>
+static void SerializeTValueVector(creg::ISerializer* s, creg_TValue** vecPtr, C count)
+{
+	creg_TValue* vec = SerializeCVectorAlloc(s, vecPtr, count);
+
+	for (unsigned i = 0; i < unsigned(count); ++i) {
+		SerializeTValueBare(s, &vec[i]);
+	}
+}
+
+static void SerializeNodeVector(creg::ISerializer* s, creg_Node** vecPtr, int count)
+{
+	creg_Node* vec = SerializeCVectorAlloc(s, vecPtr, count);
+
+	for (int i = 0; i < count; ++i) {
+		creg_Node& n = vec[i];
+
+		SerializeTValueBare(s, &n.i_val);
+		SerializeTValueBare(s, &n.i_key.tvk);
+
+		// collision chains never leave the node array, store them as index+1
+		int next;
+		if (s->IsWriting())
+			next = (n.i_key.nk.next == nullptr)? 0: (n.i_key.nk.next - vec) + 1;
+
+		s->SerializeInt(&next, sizeof(next));
+
+		if (!s->IsWriting())
+			n.i_key.nk.next = (next == 0)? nullptr: (vec + next - 1);
+	}
+}
+
+static void SerializeLocVarVector(creg::ISerializer* s, creg_LocVar** vecPtr, int count)
 {
-	SerializeInstance(s, &i_key.tvk);
-	SerializePtr(s, &i_key.nk.next);
+	creg_LocVar* vec = SerializeCVectorAlloc(s, vecPtr, count);
+
+	for (int i = 0; i < count; ++i) {
+		SerializePtr(s, &vec[i].varname);
+		s->SerializeInt(&vec[i].startpc, sizeof(vec[i].startpc));
+		s->SerializeInt(&vec[i].endpc, sizeof(vec[i].endpc));
+	}
 }
 
 
@@ -755,7 +798,7 @@ void creg_Table::Serialize(creg::ISerializer* s)
 {
 	int sizenode = twoto(lsizenode);
 
-	SerializeCVector(s, &array, sizearray);
+	SerializeTValueVector(s, &array, sizearray);
 	bool empty;
 	creg_Node* dummy = GetDummyNode();
 	if (s->IsWriting())
@@ -770,7 +813,7 @@ void creg_Table::Serialize(creg::ISerializer* s)
 			assert(node == dummy);
 		}
 	} else {
-		SerializeCVector(s, &node, sizenode);
+		SerializeNodeVector(s, &node, sizenode);
 	}
 
 	ptrdiff_t lastfreeOffset;
@@ -817,12 +860,12 @@ void creg_Table::PostLoad()
 
 void creg_Proto::Serialize(creg::ISerializer* s)
 {
-	SerializeCVector(s, &k,        sizek);
-	SerializeCVector(s, &code,     sizecode);
-	SerializeCVector(s, &p,        sizep);
-	SerializeCVector(s, &lineinfo, sizelineinfo);
-	SerializeCVector(s, &locvars,  sizelocvars);
-	SerializeCVector(s, &upvalues, sizeupvalues);
+	SerializeTValueVector(s, &k,        sizek);
+	SerializeCVectorInts(s,  &code,     sizecode);
+	SerializeCVector(s,      &p,        sizep);
+	SerializeCVectorInts(s,  &lineinfo, sizelineinfo);
+	SerializeLocVarVector(s, &locvars,  sizelocvars);
+	SerializeCVector(s,      &upvalues, sizeupvalues);
 }
 
 
@@ -868,7 +911,7 @@ void creg_CClosure::Serialize(creg::ISerializer* s)
 {
 	inClosure = true;
 	for (unsigned i = 0; i < nupvalues; ++i) {
-		SerializeInstance(s, &upvalue[i]);
+		SerializeTValueBare(s, &upvalue[i]);
 	}
 	inClosure = false;
 
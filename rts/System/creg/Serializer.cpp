@@ -82,11 +82,19 @@ static void WriteZStr(std::ostream& file, const std::string& str)
 template<typename T>
 void ReadVarSizeUInt(std::istream* stream, T* buf)
 {
+	// bypass the istream sentry, this is called for nearly every value
+	std::streambuf* sbuf = stream->rdbuf();
 	std::uint64_t val = 0;
 	unsigned offset = 0;
 	while (true) {
-		unsigned char a;
-		stream->read((char*)&a, sizeof(char));
+		const int c = sbuf->sbumpc();
+
+		if (c == std::char_traits<char>::eof()) {
+			stream->setstate(std::ios::eofbit | std::ios::failbit);
+			break;
+		}
+
+		const unsigned char a = c;
 
 		val += ((std::uint64_t)(a & 0x7F)) << offset;
 		if ((a & 0x80) == 0)
@@ -101,6 +109,10 @@ void ReadVarSizeUInt(std::istream* stream, T* buf)
 template<typename T>
 void WriteVarSizeUInt(std::ostream* stream, T val)
 {
+	// at most ten 7-bit groups for 64-bit values
+	unsigned char buf[10];
+	unsigned int len = 0;
+
 	std::uint64_t v = val;
 	do {
 		unsigned char a = v & 0x7F;
@@ -109,8 +121,10 @@ void WriteVarSizeUInt(std::ostream* stream, T val)
 		if (v > 0)
 			a |= 0x80;
 
-		stream->write((char*)&a, sizeof(char));
+		buf[len++] = a;
 	} while (v > 0);
+
+	stream->write((const char*)buf, len);
 }
 
 void creg::ReadUInt(std::istream* stream, std::uint64_t* buf)
@@ -136,9 +150,8 @@ bool COutputStreamSerializer::IsWriting()
 	return true;
 }
 
-COutputStreamSerializer::ObjectRef* COutputStreamSerializer::FindObjectRef(void* inst, creg::Class* objClass, bool isEmbedded)
+COutputStreamSerializer::ObjectRef* COutputStreamSerializer::FindObjectRef(const std::vector<ObjectRef*>& refs, void* inst, creg::Class* objClass, bool isEmbedded)
 {
-	std::vector<ObjectRef*>& refs = ptrToId[inst];
 	for (auto& obj: refs) {
 		if (obj->isThisObject(inst, objClass, isEmbedded))
 			return obj;
@@ -146,16 +159,12 @@ COutputStreamSerializer::ObjectRef* COutputStreamSerializer::FindObjectRef(void*
 	return nullptr;
 }
 
-void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* objr)
+void COutputStreamSerializer::SerializeObject(Class* c, void* ptr)
 {
-	const unsigned objstart = stream->tellp();
+	const unsigned objstart = collectClassStats? unsigned(stream->tellp()): 0;
 
 	if (c->base())
-		SerializeObject(c->base(), ptr, objr);
-
-	ObjectMemberGroup omg;
-	omg.membersClass = c;
-	omg.size = 0;
+		SerializeObject(c->base(), ptr);
 
 	for (uint a = 0; a < c->members.size(); a++)
 	{
@@ -163,34 +172,16 @@ void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* ob
 		if (m->flags & CM_NoSerialize)
 			continue;
 
-		ObjectMember om;
-		om.member = m;
-		om.memberId = a;
 		void* memberAddr = ((char*)ptr) + m->offset;
-		unsigned mstart = stream->tellp();
 		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s", c->name, m->name, m->type->GetName().c_str());
 		m->type->Serialize(this, memberAddr);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
-		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s size:%d", c->name, m->name, m->type->GetName().c_str(), om.size);
 	}
 
-
-	if (c->HasSerialize()) {
-		ObjectMember om;
-		om.member = nullptr;
-		om.memberId = -1;
-		unsigned mstart = stream->tellp();
+	if (c->HasSerialize())
 		c->CallSerializeProc(ptr, this);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
-	}
 
-	objr->memberGroups.push_back(omg);
+	if (!collectClassStats)
+		return;
 
 	const unsigned objend = stream->tellp();
 	const int sz = objend - objstart;
@@ -201,21 +192,19 @@ void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* ob
 void COutputStreamSerializer::SerializeObjectInstance(void* inst, creg::Class* objClass)
 {
 	// register the object, and mark it as embedded if a pointer was already referencing it
-	ObjectRef* obj = FindObjectRef(inst, objClass, true);
+	std::vector<ObjectRef*>& refs = ptrToId[inst];
+	ObjectRef* obj = FindObjectRef(refs, inst, objClass, true);
 	if (!obj) {
 		objects.emplace_back(inst, objects.size(), true, objClass);
 		obj = &objects.back();
-		ptrToId[inst].push_back(obj);
+		refs.push_back(obj);
 	} else if (obj->isEmbedded) {
 		throw std::string("Reserialization of embedded object (") + objClass->name + ")";
-	} else {
-		std::vector<ObjectRef*>::iterator it = std::find(pendingObjects.begin(), pendingObjects.end(), obj);
-		if (it == pendingObjects.end()) {
-			throw std::string("Object pointer was serialized (") + objClass->name + ")";
-		} else {
-			pendingObjects.erase(it);
-		}
+	} else if (!obj->isPending) {
+		throw std::string("Object pointer was serialized (") + objClass->name + ")";
 	}
+	// if still in pendingObjects, SavePackage skips it from now on
+	obj->isPending = false;
 	obj->class_ = objClass;
 	obj->isEmbedded = true;
 
@@ -223,24 +212,24 @@ void COutputStreamSerializer::SerializeObjectInstance(void* inst, creg::Class* o
 	WriteVarSizeUInt(stream, obj->id);
 
 	// write the object
-	SerializeObject(objClass, inst, obj);
+	SerializeObject(objClass, inst);
 }
 
 void COutputStreamSerializer::SerializeObjectPtr(void** ptr, creg::Class* objClass)
 {
 	if (*ptr) {
 		// valid pointer, write a one and the object ID
-		int id;
-		ObjectRef* obj = FindObjectRef(*ptr, objClass, false);
+		std::vector<ObjectRef*>& refs = ptrToId[*ptr];
+		ObjectRef* obj = FindObjectRef(refs, *ptr, objClass, false);
 		if (!obj) {
 			objects.emplace_back(*ptr, objects.size(), false, objClass);
 			obj = &objects.back();
-			ptrToId[*ptr].push_back(obj);
+			obj->isPending = true;
+			refs.push_back(obj);
 			pendingObjects.push_back(obj);
 		}
-		id = obj->id;
 
-		WriteVarSizeUInt(stream, id);
+		WriteVarSizeUInt(stream, obj->id);
 	} else {
 		// null pointer, write a zero
 		WriteVarSizeUInt(stream, 0);
@@ -282,6 +271,7 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 	PackageHeader ph;
 
 	stream = s;
+	collectClassStats = LOG_IS_ENABLED(L_DEBUG);
 	unsigned startOffset = stream->tellp();
 	stream->write((char*)&ph, sizeof(PackageHeader));
 	stream->seekp(startOffset + sizeof(PackageHeader));
@@ -295,17 +285,25 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 	// Insert the first object that will provide references to everything
 	objects.emplace_back(rootObj, objects.size(), false, rootObjClass);
 	obj = &objects.back();
+	obj->isPending = true;
 	ptrToId[rootObj].push_back(obj);
 	pendingObjects.push_back(obj);
 
 	// Save until all the referenced objects have been stored
+	std::vector<ObjectRef*> po;
+
 	while (!pendingObjects.empty())
 	{
-		const std::vector<ObjectRef*> po = pendingObjects;
+		po.swap(pendingObjects);
 		pendingObjects.clear();
 
 		for (ObjectRef* obj: po) {
-			SerializeObject(obj->class_, obj->ptr, obj);
+			// skip objects that were serialized as embedded instance meanwhile
+			if (!obj->isPending)
+				continue;
+
+			obj->isPending = false;
+			SerializeObject(obj->class_, obj->ptr);
 			//LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s size:%i", obj->class_->name.c_str(), sz);
 		}
 	}
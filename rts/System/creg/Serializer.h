@@ -8,6 +8,8 @@
 
 #ifdef USING_CREG
 
+#include "System/UnorderedMap.hpp"
+
 #include <map>
 #include <vector>
 #include <deque>
@@ -23,43 +25,21 @@ namespace creg {
 	class COutputStreamSerializer : public ISerializer
 	{
 	protected:
-		struct ObjectMember {
-			Class::Member* member;
-			int memberId;
-			int size;
-		};
-		struct ObjectMemberGroup {
-			Class* membersClass;
-			std::vector<COutputStreamSerializer::ObjectMember> members;
-			int size;
-		};
 		struct ObjectRef {
-			ObjectRef() {
-				ptr = 0;
-				id=0;
-				classIndex=0;
-				isEmbedded=false;
-				class_=0;
-			}
-			ObjectRef(void* ptr, int id, bool isEmbedded, Class* class_) {
-				this->ptr = ptr;
-				this->id=id;
-				classIndex=0;
-				this->isEmbedded=isEmbedded;
-				this->class_=class_;
-			}
-			ObjectRef(const ObjectRef&src) :memberGroups(src.memberGroups){
-				ptr=src.ptr;
-				id=src.id;
-				classIndex=src.classIndex;
-				isEmbedded=src.isEmbedded;
-				class_=src.class_;
-			}
-			void* ptr;
-			int id, classIndex;
-			bool isEmbedded;
-			Class* class_;
-			std::vector<COutputStreamSerializer::ObjectMemberGroup> memberGroups;
+			ObjectRef() = default;
+			ObjectRef(void* ptr, int id, bool isEmbedded, Class* class_)
+				: ptr(ptr)
+				, id(id)
+				, isEmbedded(isEmbedded)
+				, class_(class_)
+			{}
+
+			void* ptr = nullptr;
+			int id = 0, classIndex = 0;
+			bool isEmbedded = false;
+			bool isPending = false; // referenced by pointer, but not yet written
+			Class* class_ = nullptr;
+
 			bool isThisObject(void* objPtr, Class* objClass, bool objEmbedded) const
 			{
 				if (ptr != objPtr) return false;
@@ -81,20 +61,25 @@ namespace creg {
 		struct ClassRef;
 
 		std::ostream* stream;
-		std::map<void*,std::vector<ObjectRef*> > ptrToId;
+		// nearly every address maps to a single object, but embedded
+		// first members share it with their parent (of another class)
+		spring::unsynced_map<void*, std::vector<ObjectRef*> > ptrToId;
 		std::deque<ObjectRef> objects;
 		std::vector<ObjectRef*> pendingObjects; // these objects still have to be saved
 		std::map<Class*, int> classSizes;
 		std::map<Class*, int> classCounts;
 
+		// per-class size statistics, only gathered when debug-logging
+		bool collectClassStats = false;
+
 		// Serialize all class names
 		void WriteObjectInfo();
 		// Helper for instance/ptr saving
 		void WriteObjectRef(void* inst, Class* cls, bool embedded);
 
-		ObjectRef* FindObjectRef(void* inst, Class* objClass, bool isEmbedded);
+		ObjectRef* FindObjectRef(const std::vector<ObjectRef*>& refs, void* inst, Class* objClass, bool isEmbedded);
 
-		void SerializeObject(Class* c, void* ptr, ObjectRef* objr);
+		void SerializeObject(Class* c, void* ptr);
 
 	public:
 		COutputStreamSerializer();
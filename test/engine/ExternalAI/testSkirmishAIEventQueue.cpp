@@ -0,0 +1,173 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ExternalAI/SkirmishAIEventQueue.h"
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+
+TEST_CASE("SkirmishAIEventQueueOrder")
+{
+	CSkirmishAIEventQueue queue;
+	std::vector<int> handled;
+
+	for (int i = 0; i < 10; i++) {
+		queue.Push([&, i]() { handled.push_back(i); });
+	}
+
+	CHECK(queue.Size() == 10);
+	CHECK(handled.empty());
+
+	// queued events first, then the update
+	queue.Deliver([&]() { handled.push_back(100); });
+
+	CHECK(handled == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 100});
+	CHECK(queue.Size() == 0);
+
+	// events pushed while delivering wait for the next delivery
+	handled.clear();
+	queue.Push([&]() { handled.push_back(1); queue.Push([&]() { handled.push_back(3); }); });
+	queue.Push([&]() { handled.push_back(2); });
+	queue.Deliver();
+
+	CHECK(handled == std::vector<int>{1, 2});
+	CHECK(queue.Size() == 1);
+
+	queue.Deliver();
+	CHECK(handled == std::vector<int>{1, 2, 3});
+
+	// nothing left to deliver
+	queue.Deliver();
+	CHECK(handled.size() == 3);
+}
+
+TEST_CASE("SkirmishAIEventQueueDelivering")
+{
+	CSkirmishAIEventQueue queue;
+	CSkirmishAIEventQueue otherQueue;
+
+	std::vector<bool> delivering;
+
+	CHECK(!queue.IsDelivering());
+
+	queue.Push([&]() {
+		delivering.push_back(queue.IsDelivering());
+		delivering.push_back(otherQueue.IsDelivering());
+
+		// e.g. an event handler that saves another AI
+		otherQueue.Deliver([&]() {
+			delivering.push_back(queue.IsDelivering());
+			delivering.push_back(otherQueue.IsDelivering());
+		});
+
+		delivering.push_back(queue.IsDelivering());
+		delivering.push_back(otherQueue.IsDelivering());
+	});
+	queue.Deliver([&]() { delivering.push_back(queue.IsDelivering()); });
+
+	CHECK(delivering == std::vector<bool>{true, false, false, true, true, false, true});
+	CHECK(!queue.IsDelivering());
+	CHECK(!otherQueue.IsDelivering());
+
+	// delivery is per thread, other threads keep queueing
+	bool otherThreadDelivering = true;
+
+	queue.Deliver([&]() {
+		std::thread t([&]() { otherThreadDelivering = queue.IsDelivering(); });
+		t.join();
+	});
+
+	CHECK(!otherThreadDelivering);
+}
+
+TEST_CASE("SkirmishAIEventQueueSave")
+{
+	CSkirmishAIEventQueue queue;
+	std::vector<std::string> handled;
+
+	queue.Push([&]() { handled.emplace_back("UnitCreated"); });
+	queue.Push([&]() { handled.emplace_back("UnitFinished"); });
+
+	// CSkirmishAIWrapper::Save delivers everything queued before EVENT_SAVE
+	queue.Deliver();
+	handled.emplace_back("Save");
+
+	queue.Push([&]() { handled.emplace_back("UnitIdle"); });
+
+	CHECK(handled == std::vector<std::string>{"UnitCreated", "UnitFinished", "Save"});
+	CHECK(queue.Size() == 1);
+
+	// events after the save go out with the next update
+	queue.Deliver([&]() { handled.emplace_back("Update"); });
+
+	CHECK(handled == std::vector<std::string>{"UnitCreated", "UnitFinished", "Save", "UnitIdle", "Update"});
+
+	// Kill and PreInit drop whatever is left
+	queue.Push([&]() { handled.emplace_back("UnitDestroyed"); });
+	queue.Clear();
+	queue.Deliver();
+
+	CHECK(handled.size() == 5);
+}
+
+TEST_CASE("SkirmishAIEventQueueLuaMessage")
+{
+	CSkirmishAIEventQueue queue;
+	std::string received;
+
+	{
+		// the caller's buffer only lives for the duration of the call
+		auto inData = std::make_unique<char[]>(32);
+		std::strcpy(inData.get(), "lua message");
+
+		// same capture as CSkirmishAIWrapper::SendLuaMessage
+		queue.Push([&received, cpyData = std::string(inData.get())]() { received = cpyData.c_str(); });
+
+		std::strcpy(inData.get(), "overwritten");
+	}
+
+	queue.Deliver();
+	CHECK(received == "lua message");
+}
+
+TEST_CASE("SkirmishAIEventQueueThreads")
+{
+	constexpr int NUM_THREADS = 4;
+	constexpr int NUM_EVENTS = 1000;
+
+	CSkirmishAIEventQueue queue;
+
+	std::array<std::vector<int>, NUM_THREADS> handled;
+	std::vector<std::thread> threads;
+
+	// e.g. other AIs giving orders that raise events for this one
+	for (int t = 0; t < NUM_THREADS; t++) {
+		threads.emplace_back([&, t]() {
+			for (int i = 0; i < NUM_EVENTS; i++) {
+				queue.Push([&, t, i]() { handled[t].push_back(i); });
+			}
+		});
+	}
+
+	for (std::thread& t: threads) {
+		t.join();
+	}
+
+	CHECK(queue.Size() == NUM_THREADS * NUM_EVENTS);
+	queue.Deliver();
+
+	// each thread's events arrive in the order they were pushed
+	for (int t = 0; t < NUM_THREADS; t++) {
+		REQUIRE(handled[t].size() == NUM_EVENTS);
+
+		for (int i = 0; i < NUM_EVENTS; i++) {
+			CHECK(handled[t][i] == i);
+		}
+	}
+}
@@ -0,0 +1,115 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Game/DefsSnapshotFile.h"
+#include "Lua/LuaParser.h"
+#include "System/FileSystem/VFSModes.h"
+
+#include <string>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+
+// stands in for what gamedata/defs.lua returns (with lower-cased keys)
+static const std::string defsChunk = R"(
+local weapon = {name = "Laser", damage = {default = 12.5, vtol = 4}, range = 300}
+
+return {
+	unitdefs = {
+		tank = {name = "Tank", buildcostmetal = 120, canmove = true, weapons = {{def = "laser"}}, customparams = {techlevel = "2"}},
+		wall = {name = "Wall", buildcostmetal = 5, canmove = false},
+	},
+	weapondefs = {laser = weapon, laser2 = weapon},
+	featuredefs = {},
+	[1] = "first",
+	[2.5] = "fraction",
+}
+)";
+
+
+static sha512::raw_digest MakeKey(const std::string& str)
+{
+	sha512::raw_digest key;
+	sha512::calc_digest(reinterpret_cast<const std::uint8_t*>(str.data()), str.size(), key.data());
+	return key;
+}
+
+
+TEST_CASE("DefsSnapshot")
+{
+	LuaParser defsParser(defsChunk, SPRING_VFS_ZIP);
+
+	REQUIRE(defsParser.Execute());
+
+	std::vector<std::uint8_t> rawData;
+	REQUIRE(defsParser.SerializeRoot(rawData));
+
+	const sha512::raw_digest key = MakeKey("game+map+options");
+	const std::vector<std::uint8_t> fileData = DefsSnapshotFile::Pack(key, rawData);
+
+	REQUIRE(!fileData.empty());
+
+	SECTION("RoundTrip") {
+		std::vector<std::uint8_t> loadedData;
+		std::uint32_t checksum = 0;
+
+		REQUIRE(DefsSnapshotFile::Unpack(fileData, key, loadedData, checksum));
+		CHECK(loadedData == rawData);
+		CHECK(checksum != 0);
+
+		// what Load hands to the def handlers in place of running defs.lua
+		LuaParser cachedParser(defsChunk, SPRING_VFS_ZIP);
+		REQUIRE(cachedParser.ExecuteSnapshot(loadedData));
+
+		const LuaTable root = cachedParser.GetRoot();
+
+		const LuaTable tankDef = root.SubTableExpr("unitdefs.tank");
+		const LuaTable wallDef = root.SubTableExpr("unitdefs.wall");
+
+		CHECK(tankDef.GetString("name", "") == "Tank");
+		CHECK(tankDef.GetInt("buildcostmetal", -1) == 120);
+		CHECK(tankDef.GetBool("canmove", false));
+		CHECK(!wallDef.GetBool("canmove", true));
+		CHECK(tankDef.SubTable("customparams").GetString("techlevel", "") == "2");
+		CHECK(tankDef.SubTable("weapons").GetLength() == 1);
+		CHECK(root.SubTableExpr("weapondefs.laser2.damage").GetFloat("default", 0.0f) == 12.5f);
+		CHECK(root.SubTable("featuredefs").IsValid());
+		CHECK(root.GetString(1, "") == "first");
+
+		// the snapshot is canonical, so a save from the loaded tables matches the file
+		std::vector<std::uint8_t> resavedData;
+		REQUIRE(cachedParser.SerializeRoot(resavedData));
+		CHECK(resavedData == rawData);
+		CHECK(DefsSnapshotFile::Pack(key, resavedData) == fileData);
+	}
+
+	SECTION("WrongKey") {
+		std::vector<std::uint8_t> loadedData;
+		std::uint32_t checksum = 0;
+
+		CHECK(!DefsSnapshotFile::Unpack(fileData, MakeKey("game+map+other options"), loadedData, checksum));
+		CHECK(checksum == 0);
+	}
+
+	SECTION("Corrupt") {
+		std::vector<std::uint8_t> loadedData;
+		std::uint32_t checksum = 0;
+
+		// truncated
+		for (size_t size: {size_t(0), size_t(16), fileData.size() / 2, fileData.size() - 1}) {
+			CAPTURE(size);
+			CHECK(!DefsSnapshotFile::Unpack({fileData.begin(), fileData.begin() + size}, key, loadedData, checksum));
+		}
+
+		// any flipped bit in the header or the data
+		for (size_t i = 0; i < fileData.size(); i += 7) {
+			std::vector<std::uint8_t> corruptData = fileData;
+			corruptData[i] ^= 0x10;
+
+			CAPTURE(i);
+			CHECK(!DefsSnapshotFile::Unpack(corruptData, key, loadedData, checksum));
+		}
+
+		CHECK(checksum == 0);
+	}
+}
@@ -0,0 +1,279 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Lua/LuaParser.h"
+#include "System/float3.h"
+#include "System/float4.h"
+#include "System/FileSystem/VFSModes.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+
+// a def-like table; keys are lower-cased by the parser
+static const std::string defsChunk = R"(
+local shared = {1, 2, 3}
+
+return {
+	name = "Tank",
+	cost = 12.5,
+	count = "7",
+	zero = 0,
+	notANumber = "abc",
+	flag = true,
+	flagOff = false,
+	flagStr = "false",
+	flagNum = 1,
+	vec = {1, 2, 3},
+	vecStr = "4 5 6 7",
+
+	[1] = "first",
+	[2] = 2.5,
+	[10] = "sparse",
+	[-3] = "negative",
+	[0.5] = "fraction",
+
+	nested = {
+		inner = {leaf = 42, [2] = "two", deeper = {leaf = "deepest"}},
+		list = {"a", "b", "c"},
+		shared = shared,
+	},
+	other = shared,
+
+	mixed = {10, 20, x = "y", [5] = 50},
+	-- explicit keys live in the hash part, not at their array index
+	hashed = {[3] = "c", [1] = "a", [7] = "g", [2] = "b", [-3] = "m", [0] = "z"},
+	customParams = {techlevel = "2", ["3"] = "numeric string key", [3] = "numeric key"},
+}
+)";
+
+
+static const std::vector<std::string> strKeys = {
+	"name", "cost", "count", "zero", "notanumber", "flag", "flagoff", "flagstr", "flagnum", "vec", "vecstr",
+	"nested", "other", "mixed", "hashed", "customparams", "missing", "NAME", "Cost",
+	// dotted keys
+	"nested.inner.leaf", "nested.inner.2", "nested.inner.deeper", "nested.list", "nested.list.1", "nested.list.4",
+	"nested.missing.leaf", "name.leaf", "customparams.techlevel", "customparams.3", "mixed.x", "mixed.5", "mixed.1",
+};
+
+static const std::vector<int> intKeys = {-3, 0, 1, 2, 3, 5, 7, 10, 11};
+
+
+static void CompareValues(const LuaTable& att, const LuaTable& det, const std::string& key)
+{
+	CAPTURE(att.GetPath(), key);
+
+	CHECK(att.KeyExists(key) == det.KeyExists(key));
+	CHECK(att.GetType(key) == det.GetType(key));
+	CHECK(att.GetLength(key) == det.GetLength(key));
+
+	CHECK(att.GetInt(key, -1) == det.GetInt(key, -1));
+	CHECK(att.GetBool(key, false) == det.GetBool(key, false));
+	CHECK(att.GetBool(key, true) == det.GetBool(key, true));
+	CHECK(att.GetFloat(key, -1.0f) == det.GetFloat(key, -1.0f));
+	CHECK(att.GetString(key, "def") == det.GetString(key, "def"));
+	CHECK(att.GetFloat3(key, float3(-1.0f, -2.0f, -3.0f)) == det.GetFloat3(key, float3(-1.0f, -2.0f, -3.0f)));
+	CHECK(att.GetFloat4(key, float4(-1.0f, -2.0f, -3.0f, -4.0f)) == det.GetFloat4(key, float4(-1.0f, -2.0f, -3.0f, -4.0f)));
+}
+
+static void CompareValues(const LuaTable& att, const LuaTable& det, int key)
+{
+	CAPTURE(att.GetPath(), key);
+
+	CHECK(att.KeyExists(key) == det.KeyExists(key));
+	CHECK(att.GetType(key) == det.GetType(key));
+	CHECK(att.GetLength(key) == det.GetLength(key));
+
+	CHECK(att.GetInt(key, -1) == det.GetInt(key, -1));
+	CHECK(att.GetBool(key, false) == det.GetBool(key, false));
+	CHECK(att.GetBool(key, true) == det.GetBool(key, true));
+	CHECK(att.GetFloat(key, -1.0f) == det.GetFloat(key, -1.0f));
+	CHECK(att.GetString(key, "def") == det.GetString(key, "def"));
+	CHECK(att.GetFloat3(key, float3(-1.0f, -2.0f, -3.0f)) == det.GetFloat3(key, float3(-1.0f, -2.0f, -3.0f)));
+	CHECK(att.GetFloat4(key, float4(-1.0f, -2.0f, -3.0f, -4.0f)) == det.GetFloat4(key, float4(-1.0f, -2.0f, -3.0f, -4.0f)));
+}
+
+template<typename K, typename V>
+static void CompareMaps(const LuaTable& att, const LuaTable& det)
+{
+	spring::unordered_map<K, V> attMap;
+	spring::unordered_map<K, V> detMap;
+
+	CHECK(att.GetMap(attMap) == det.GetMap(detMap));
+	CHECK(attMap.size() == detMap.size());
+
+	for (const auto& [key, value]: attMap) {
+		const auto it = detMap.find(key);
+
+		REQUIRE(it != detMap.end());
+		CHECK(it->second == value);
+	}
+}
+
+template<typename K, typename V>
+static void ComparePairs(const LuaTable& att, const LuaTable& det)
+{
+	std::vector<std::pair<K, V>> attPairs;
+	std::vector<std::pair<K, V>> detPairs;
+
+	CHECK(att.GetPairs(attPairs) == det.GetPairs(detPairs));
+
+	// both are in lua_next order, which is not specified
+	std::sort(attPairs.begin(), attPairs.end());
+	std::sort(detPairs.begin(), detPairs.end());
+
+	CHECK(attPairs == detPairs);
+}
+
+static void CompareTables(const LuaTable& att, const LuaTable& det, int depth = 0)
+{
+	CAPTURE(att.GetPath());
+
+	REQUIRE(att.IsValid());
+	REQUIRE(det.IsValid());
+	REQUIRE(!att.IsDetached());
+	REQUIRE(det.IsDetached());
+
+	CHECK(att.GetPath() == det.GetPath());
+	CHECK(att.GetLength() == det.GetLength());
+
+	std::vector<int> attIntKeys;
+	std::vector<int> detIntKeys;
+	std::vector<std::string> attStrKeys;
+	std::vector<std::string> detStrKeys;
+
+	CHECK(att.GetKeys(attIntKeys) == det.GetKeys(detIntKeys));
+	CHECK(att.GetKeys(attStrKeys) == det.GetKeys(detStrKeys));
+	CHECK(attIntKeys == detIntKeys);
+	CHECK(attStrKeys == detStrKeys);
+
+	CompareMaps<int, float>(att, det);
+	CompareMaps<int, std::string>(att, det);
+	CompareMaps<std::string, float>(att, det);
+	CompareMaps<std::string, std::string>(att, det);
+
+	ComparePairs<int, std::string>(att, det);
+	ComparePairs<std::string, float>(att, det);
+	ComparePairs<std::string, std::string>(att, det);
+
+	for (const std::string& key: strKeys) {
+		CompareValues(att, det, key);
+	}
+	for (int key: intKeys) {
+		CompareValues(att, det, key);
+	}
+
+	if (depth > 4)
+		return;
+
+	// recurse into every subtable, plus lookups that miss
+	for (const std::string& key: attStrKeys) {
+		if (att.GetType(key) != LuaTable::TABLE)
+			continue;
+
+		CompareTables(att.SubTable(key), det.SubTable(key), depth + 1);
+	}
+	for (int key: attIntKeys) {
+		if (att.GetType(key) != LuaTable::TABLE)
+			continue;
+
+		CompareTables(att.SubTable(key), det.SubTable(key), depth + 1);
+	}
+
+	CHECK(att.SubTable("missing").IsValid() == det.SubTable("missing").IsValid());
+	CHECK(att.SubTable("name").IsValid() == det.SubTable("name").IsValid());
+	CHECK(att.SubTable(11).IsValid() == det.SubTable(11).IsValid());
+}
+
+
+TEST_CASE("LuaTableDetach")
+{
+	LuaParser parser(defsChunk, SPRING_VFS_ZIP);
+
+	REQUIRE(parser.Execute());
+
+	const LuaTable root = parser.GetRoot();
+	const LuaTable detachedRoot = root.Detach();
+
+	SECTION("Tables") {
+		CompareTables(root, detachedRoot);
+	}
+
+	SECTION("Nested") {
+		CompareTables(root.SubTable("nested"), detachedRoot.SubTable("nested"));
+		CompareTables(root.SubTable("nested").SubTable("inner"), detachedRoot.SubTable("nested").SubTable("inner"));
+
+		// detaching a subtable gives the same result as descending into the detached root
+		CompareTables(root.SubTable("nested"), root.SubTable("nested").Detach());
+		CompareTables(root.SubTable("nested").SubTable("inner"), root.SubTable("nested").Detach().SubTable("inner"));
+	}
+
+	SECTION("SubTableExpr") {
+		for (const char* expr: {"nested.inner", "nested.inner.deeper", "nested.list", "mixed", "other", "nested.missing", "name"}) {
+			CAPTURE(expr);
+
+			const LuaTable att = root.SubTableExpr(expr);
+			const LuaTable det = detachedRoot.SubTableExpr(expr);
+
+			REQUIRE(att.IsValid() == det.IsValid());
+
+			if (att.IsValid())
+				CompareTables(att, det);
+		}
+	}
+
+	SECTION("Shared") {
+		// tables referenced from more than one place are detached once
+		CompareTables(root.SubTable("other"), detachedRoot.SubTable("other"));
+		CompareTables(root.SubTableExpr("nested.shared"), detachedRoot.SubTableExpr("nested.shared"));
+	}
+
+	SECTION("Lifetime") {
+		// detached tables remain readable once the parser is gone
+		LuaTable detachedCopy;
+
+		{
+			LuaParser tmpParser(defsChunk, SPRING_VFS_ZIP);
+			REQUIRE(tmpParser.Execute());
+
+			detachedCopy = tmpParser.GetRoot().SubTable("nested").Detach();
+		}
+
+		REQUIRE(detachedCopy.IsValid());
+		CHECK(detachedCopy.GetInt("inner.leaf", -1) == 42);
+		CHECK(detachedCopy.SubTable("inner").GetString(2, "") == "two");
+		CHECK(detachedCopy.SubTable("list").GetLength() == 3);
+	}
+}
+
+TEST_CASE("LuaTableDetachMetatables")
+{
+	LuaParser parser(R"(
+		local proxied = setmetatable({}, {__index = {hidden = 1}})
+
+		return {
+			plain = {visible = 1},
+			proxied = proxied,
+			wrapper = {inner = proxied},
+		}
+	)", SPRING_VFS_ZIP);
+
+	REQUIRE(parser.Execute());
+
+	const LuaTable root = parser.GetRoot();
+
+	// metamethods can make lookups differ from a raw traversal, refuse them
+	CHECK(!root.Detach().IsValid());
+	CHECK(!root.SubTable("proxied").Detach().IsValid());
+	CHECK(!root.SubTable("wrapper").Detach().IsValid());
+
+	// the attached table still sees through __index
+	CHECK(root.SubTable("proxied").GetInt("hidden", -1) == 1);
+
+	// tables without one (anywhere below them) still detach
+	const LuaTable plain = root.SubTable("plain");
+
+	CompareTables(plain, plain.Detach());
+}
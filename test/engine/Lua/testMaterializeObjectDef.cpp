@@ -0,0 +1,249 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Lua/LuaUtils.h"
+#include "Lua/LuaDefs.h"
+
+#include <string>
+
+#include <catch_amalgamated.hpp>
+
+
+// stands in for a UnitDef, proxied the same way LuaUnitDefs does
+struct MockDef {
+	int count = 7;
+	float speed = 2.5f;
+	bool canFly = true;
+	std::string name = "mock";
+	float cost = 100.0f; // dynamic
+};
+
+static MockDef mockDef;
+static ParamMap paramMap;
+
+static bool editDefsEnabled = false;
+static int numIndexCalls = 0;
+
+
+static void InitParamMap()
+{
+	const char* start = reinterpret_cast<const char*>(&mockDef);
+
+	paramMap.clear();
+	paramMap["count"] = DataElement(INT_TYPE, reinterpret_cast<const char*>(&mockDef.count) - start);
+	paramMap["speed"] = DataElement(FLOAT_TYPE, reinterpret_cast<const char*>(&mockDef.speed) - start);
+	paramMap["canfly"] = DataElement(BOOL_TYPE, reinterpret_cast<const char*>(&mockDef.canFly) - start);
+	paramMap["name"] = DataElement(STRING_TYPE, reinterpret_cast<const char*>(&mockDef.name) - start);
+	paramMap["cost"] = DataElement(FLOAT_TYPE, reinterpret_cast<const char*>(&mockDef.cost) - start);
+	paramMap["cost"].dynamic = true;
+	paramMap["func"] = DataElement(FUNCTION_TYPE, 0, nullptr);
+	paramMap["old"] = DataElement();
+}
+
+// mirrors UnitDefIndex
+static int MockDefIndex(lua_State* L)
+{
+	numIndexCalls++;
+
+	if (!editDefsEnabled && LuaUtils::MaterializeObjectDef(paramMap, L))
+		return 1;
+
+	if (!lua_isstring(L, 2)) {
+		lua_rawget(L, 1);
+		return 1;
+	}
+
+	const auto it = paramMap.find(lua_tostring(L, 2));
+
+	if (it == paramMap.end() || it->second.deprecated) {
+		lua_rawget(L, 1);
+		return 1;
+	}
+
+	const void* p = static_cast<const char*>(lua_touserdata(L, lua_upvalueindex(1))) + it->second.offset;
+
+	switch (it->second.type) {
+		case INT_TYPE     : { lua_pushnumber(L, *static_cast<const int*>(p)); } break;
+		case BOOL_TYPE    : { lua_pushboolean(L, *static_cast<const bool*>(p)); } break;
+		case FLOAT_TYPE   : { lua_pushnumber(L, *static_cast<const float*>(p)); } break;
+		case STRING_TYPE  : { lua_pushsstring(L, *static_cast<const std::string*>(p)); } break;
+		case FUNCTION_TYPE: { lua_pushliteral(L, "function-value"); } break;
+		default           : { lua_pushnil(L); } break;
+	}
+
+	return 1;
+}
+
+// mirrors UnitDefNewIndex
+static int MockDefNewIndex(lua_State* L)
+{
+	const auto it = paramMap.find(luaL_checkstring(L, 2));
+
+	if (it == paramMap.end()) {
+		lua_rawset(L, 1);
+		return 0;
+	}
+
+	if (!editDefsEnabled)
+		return luaL_error(L, "Attempt to write MockDef.%s", lua_tostring(L, 2));
+
+	void* p = static_cast<char*>(lua_touserdata(L, lua_upvalueindex(1))) + it->second.offset;
+
+	switch (it->second.type) {
+		case INT_TYPE   : { *static_cast<int*>(p) = lua_toint(L, 3); } break;
+		case FLOAT_TYPE : { *static_cast<float*>(p) = lua_tofloat(L, 3); } break;
+		case STRING_TYPE: { *static_cast<std::string*>(p) = lua_tostring(L, 3); } break;
+		default: break;
+	}
+
+	return 0;
+}
+
+static int MockDefMetatable(lua_State* L)
+{
+	return 0;
+}
+
+
+static lua_State* NewState()
+{
+	lua_State* L = luaL_newstate();
+	luaL_openlibs(L);
+
+	// same layout as PushObjectDefProxyTable(..., materialize=true)
+	lua_newtable(L);
+	lua_createtable(L, 0, 3);
+
+	lua_pushliteral(L, "__index");
+	lua_pushlightuserdata(L, &mockDef);
+	lua_pushboolean(L, false);
+	lua_pushcclosure(L, MockDefIndex, 2);
+	lua_rawset(L, -3);
+
+	lua_pushliteral(L, "__newindex");
+	lua_pushlightuserdata(L, &mockDef);
+	lua_pushcclosure(L, MockDefNewIndex, 1);
+	lua_rawset(L, -3);
+
+	lua_pushliteral(L, "__metatable");
+	lua_pushlightuserdata(L, &mockDef);
+	lua_pushcclosure(L, MockDefMetatable, 1);
+	lua_rawset(L, -3);
+
+	lua_setmetatable(L, -2);
+	lua_setglobal(L, "Def");
+	return L;
+}
+
+static bool Run(lua_State* L, const char* code)
+{
+	if (luaL_dostring(L, code) == 0)
+		return true;
+
+	UNSCOPED_INFO(lua_tostring(L, -1));
+	lua_pop(L, 1);
+	return false;
+}
+
+static int CountIndexCalls(lua_State* L, const char* code)
+{
+	const int numCalls = numIndexCalls;
+
+	REQUIRE(Run(L, code));
+	return (numIndexCalls - numCalls);
+}
+
+
+TEST_CASE("MaterializeObjectDef")
+{
+	mockDef = {};
+	editDefsEnabled = false;
+	InitParamMap();
+
+	lua_State* L = NewState();
+
+	SECTION("Reads") {
+		CHECK(Run(L, R"(
+			assert(Def.count == 7)
+			assert(Def.speed == 2.5)
+			assert(Def.canfly == true)
+			assert(Def.name == "mock")
+			assert(Def.cost == 100)
+			assert(Def.func == "function-value")
+			assert(Def.old == nil)
+			assert(Def.missing == nil)
+			assert(Def[1] == nil)
+		)"));
+
+		// plain fields no longer reach the metamethod
+		CHECK(CountIndexCalls(L, "for i = 1, 100 do local x = Def.count + Def.speed; local y = Def.name end") == 0);
+		// fields that are not cached still do, through the fallback closure
+		CHECK(CountIndexCalls(L, "for i = 1, 10 do local x = Def.func end") == 10);
+		CHECK(CountIndexCalls(L, "for i = 1, 10 do local x = Def.missing end") == 10);
+	}
+
+	SECTION("Proxy") {
+		CHECK(Run(L, "assert(Def.count == 7)"));
+
+		// the proxy stays empty and protected
+		CHECK(Run(L, R"(
+			assert(rawget(Def, "count") == nil)
+			assert(next(Def) == nil)
+			assert(type(getmetatable(Def)) == "function")
+			assert(not pcall(function() Def.count = 3 end))
+			assert(Def.count == 7)
+		)"));
+
+		// keys unknown to the param map can still be set
+		CHECK(Run(L, "Def.user = 5; assert(Def.user == 5 and rawget(Def, 'user') == 5)"));
+	}
+
+	SECTION("Dynamic") {
+		CHECK(Run(L, "assert(Def.cost == 100)"));
+
+		// never cached, always the live value
+		mockDef.cost = 0.0f;
+		CHECK(Run(L, "assert(Def.cost == 0)"));
+		CHECK(CountIndexCalls(L, "for i = 1, 10 do local x = Def.cost end") == 10);
+
+		// cached fields are copies
+		mockDef.count = 8;
+		CHECK(Run(L, "assert(Def.count == 7)"));
+	}
+
+	SECTION("EditDefs") {
+		lua_State* L2 = NewState();
+
+		// both handles materialize the def
+		CHECK(Run(L, "assert(Def.count == 7)"));
+		CHECK(Run(L2, "assert(Def.count == 7)"));
+
+		// /editdefs drops the copies in every handle (CLuaHandle::DropMaterializedDefs)
+		editDefsEnabled = true;
+		LuaUtils::DematerializeObjectDefs(L);
+		LuaUtils::DematerializeObjectDefs(L2);
+
+		// an edit made through one handle is seen by all of them
+		CHECK(Run(L, "Def.count = 42; Def.name = 'edited'; assert(Def.count == 42)"));
+		CHECK(Run(L2, "assert(Def.count == 42 and Def.name == 'edited')"));
+		CHECK(mockDef.count == 42);
+
+		// no copies are made while editing
+		CHECK(CountIndexCalls(L2, "for i = 1, 10 do local x = Def.count end") == 10);
+
+		editDefsEnabled = false;
+
+		// and the next read copies the edited def again
+		CHECK(Run(L2, "assert(Def.count == 42 and Def.name == 'edited')"));
+		CHECK(CountIndexCalls(L2, "for i = 1, 10 do local x = Def.count end") == 0);
+		CHECK(Run(L2, "assert(not pcall(function() Def.count = 3 end))"));
+
+		// dematerializing an untouched or already dematerialized state is a no-op
+		LuaUtils::DematerializeObjectDefs(L);
+		LuaUtils::DematerializeObjectDefs(L);
+		CHECK(Run(L, "assert(Def.count == 42)"));
+
+		lua_close(L2);
+	}
+
+	lua_close(L);
+}
@@ -0,0 +1,125 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Map/HeightMapChangeHistory.h"
+
+#include <algorithm>
+
+#include <catch_amalgamated.hpp>
+
+
+static SRectangle MakeRect(int i)
+{
+	return {i, i + 1, i + 2, i + 3};
+}
+
+
+TEST_CASE("HeightMapChangeHistory")
+{
+	CHeightMapChangeHistory history;
+	std::vector<SRectangle> rects;
+
+	SECTION("History") {
+		// nothing changed yet, but everything is known
+		CHECK(history.Get(0, rects));
+		CHECK(rects.empty());
+
+		history.Add(5, MakeRect(0));
+		history.Add(5, MakeRect(1));
+		history.Add(7, MakeRect(2));
+
+		CHECK(history.Get(0, rects));
+		REQUIRE(rects.size() == 3);
+		CHECK(rects[0] == MakeRect(0));
+		CHECK(rects[2] == MakeRect(2));
+
+		// changes made during the frame passed in are included
+		rects.clear();
+		CHECK(history.Get(5, rects));
+		CHECK(rects.size() == 3);
+
+		rects.clear();
+		CHECK(history.Get(6, rects));
+		REQUIRE(rects.size() == 1);
+		CHECK(rects[0] == MakeRect(2));
+
+		rects.clear();
+		CHECK(history.Get(7, rects));
+		CHECK(rects.size() == 1);
+
+		rects.clear();
+		CHECK(history.Get(8, rects));
+		CHECK(rects.empty());
+	}
+
+	SECTION("Polling") {
+		// a consumer polls at the start of every frame, changes are made
+		// later during the same frame; none of them may be missed
+		std::vector<SRectangle> polled;
+		int prevFrame = 0;
+
+		for (int frame = 1; frame < 100; frame++) {
+			rects.clear();
+			REQUIRE(history.Get(prevFrame, rects));
+			polled.insert(polled.end(), rects.begin(), rects.end());
+			prevFrame = frame;
+
+			if ((frame % 3) == 0)
+				history.Add(frame, MakeRect(frame));
+		}
+
+		for (int frame = 3; frame < 99; frame += 3) {
+			CAPTURE(frame);
+			CHECK(std::find(polled.begin(), polled.end(), MakeRect(frame)) != polled.end());
+		}
+	}
+
+	SECTION("Overflow") {
+		const int numChanges = CHeightMapChangeHistory::MAX_CHANGES;
+
+		// two changes per frame, frames 0 to MAX_CHANGES / 2 - 1
+		for (int i = 0; i < numChanges; i++) {
+			history.Add(i / 2, MakeRect(i));
+		}
+
+		CHECK(history.Size() == CHeightMapChangeHistory::MAX_CHANGES);
+		CHECK(history.Get(0, rects));
+		CHECK(rects.size() == CHeightMapChangeHistory::MAX_CHANGES);
+
+		// drops the oldest half, up to and including frame MAX_CHANGES / 4 - 1
+		history.Add(numChanges / 2, MakeRect(numChanges));
+
+		CHECK(history.Size() == (CHeightMapChangeHistory::MAX_CHANGES / 2 + 1));
+
+		rects.clear();
+		CHECK(!history.Get(0, rects));
+		CHECK(!history.Get(numChanges / 4 - 1, rects));
+		CHECK(rects.empty());
+
+		CHECK(history.Get(numChanges / 4, rects));
+		REQUIRE(rects.size() == (CHeightMapChangeHistory::MAX_CHANGES / 2 + 1));
+		CHECK(rects.front() == MakeRect(numChanges / 2));
+		CHECK(rects.back() == MakeRect(numChanges));
+	}
+
+	SECTION("Reset") {
+		history.Add(10, MakeRect(0));
+		history.Add(20, MakeRect(1));
+
+		// what PostLoad does, changes before the save are unknown
+		history.Reset(20);
+
+		CHECK(history.Size() == 0);
+		CHECK(!history.Get(10, rects));
+		CHECK(!history.Get(20, rects));
+		CHECK(rects.empty());
+
+		CHECK(history.Get(21, rects));
+		CHECK(rects.empty());
+
+		history.Add(21, MakeRect(2));
+
+		CHECK(history.Get(21, rects));
+		REQUIRE(rects.size() == 1);
+		CHECK(rects[0] == MakeRect(2));
+	}
+}
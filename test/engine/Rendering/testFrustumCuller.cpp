@@ -0,0 +1,227 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Rendering/Common/FrustumCuller.h"
+#include "Game/Camera.h"
+
+#include <array>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+
+struct TestCameras {
+	std::array<CFrustumCuller::FrustumPlanes, CFrustumCuller::MAX_CAMERAS> planes;
+	std::array<uint8_t, CFrustumCuller::MAX_CAMERAS> planesMasks = {};
+
+	uint32_t camTypeMask = 0;
+};
+
+struct TestSphere {
+	float3 pos;
+	float radius;
+};
+
+static TestCameras MakeCameras(std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> normDist(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> offsetDist(-2000.0f, 2000.0f);
+	std::uniform_int_distribution<uint32_t> maskDist(0, (1 << CCamera::FRUSTUM_PLANE_CNT) - 1);
+
+	TestCameras cams;
+
+	cams.camTypeMask = std::uniform_int_distribution<uint32_t>(0, (1 << CFrustumCuller::MAX_CAMERAS) - 1)(rng);
+
+	for (size_t c = 0; c < CFrustumCuller::MAX_CAMERAS; c++) {
+		for (float4& plane: cams.planes[c]) {
+			const float3 normal = float3(normDist(rng), normDist(rng), normDist(rng)).SafeANormalize();
+			plane = float4(normal, offsetDist(rng));
+		}
+
+		// as CCamera::GetInViewPlanesMask, which can also exclude the far plane
+		cams.planesMasks[c] = maskDist(rng);
+	}
+
+	return cams;
+}
+
+static std::vector<TestSphere> MakeSpheres(size_t numSpheres, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> posDist(-4000.0f, 4000.0f);
+	std::uniform_real_distribution<float> radiusDist(0.0f, 500.0f);
+
+	std::vector<TestSphere> spheres(numSpheres);
+
+	for (TestSphere& s: spheres) {
+		s.pos = {posDist(rng), posDist(rng), posDist(rng)};
+		s.radius = radiusDist(rng);
+	}
+
+	return spheres;
+}
+
+// what the drawers computed per object with CCamera::InView
+static uint8_t ReferenceMask(const TestCameras& cams, const TestSphere& s)
+{
+	uint8_t mask = 0;
+
+	for (uint32_t camType = 0; camType < CFrustumCuller::MAX_CAMERAS; camType++) {
+		if ((cams.camTypeMask & (1 << camType)) == 0)
+			continue;
+
+		CCamera::Frustum frustum;
+		frustum.planes = cams.planes[camType];
+
+		if (frustum.IntersectSphere(s.pos, s.radius, cams.planesMasks[camType]))
+			mask |= (1 << camType);
+	}
+
+	return mask;
+}
+
+static void Cull(CFrustumCuller& culler, const TestCameras& cams, const std::vector<TestSphere>& spheres)
+{
+	culler.SetCameras(cams.camTypeMask, cams.planes, cams.planesMasks);
+	culler.Resize(spheres.size());
+
+	for (size_t block = 0; block < culler.GetNumBlocks(); block++) {
+		for (size_t i = culler.GetBlockBeg(block); i < culler.GetBlockEnd(block); i++) {
+			culler.SetSphere(i, spheres[i].pos, spheres[i].radius);
+		}
+
+		culler.CullBlock(block);
+	}
+}
+
+static void CheckMasks(const CFrustumCuller& culler, const TestCameras& cams, const std::vector<TestSphere>& spheres)
+{
+	for (size_t i = 0; i < spheres.size(); i++) {
+		const uint8_t mask = ReferenceMask(cams, spheres[i]);
+
+		CAPTURE(i, spheres[i].pos.x, spheres[i].pos.y, spheres[i].pos.z, spheres[i].radius);
+		REQUIRE(culler.GetInViewMask(i) == mask);
+
+		for (uint32_t camType = 0; camType < CFrustumCuller::MAX_CAMERAS; camType++) {
+			REQUIRE(culler.InView(i, camType) == ((mask & (1 << camType)) != 0));
+		}
+	}
+}
+
+
+TEST_CASE("FrustumCullerRandom")
+{
+	std::mt19937 rng(1234);
+	CFrustumCuller culler;
+
+	for (int n = 0; n < 100; n++) {
+		const TestCameras cams = MakeCameras(rng);
+		const std::vector<TestSphere> spheres = MakeSpheres(1000, rng);
+
+		Cull(culler, cams, spheres);
+		CheckMasks(culler, cams, spheres);
+	}
+}
+
+TEST_CASE("FrustumCullerEdges")
+{
+	std::mt19937 rng(5678);
+	CFrustumCuller culler;
+
+	TestCameras cams = MakeCameras(rng);
+
+	// all cameras and planes, an axis-aligned box [-100, 100]^3
+	cams.camTypeMask = (1 << CFrustumCuller::MAX_CAMERAS) - 1;
+
+	for (size_t c = 0; c < CFrustumCuller::MAX_CAMERAS; c++) {
+		cams.planes[c] = {{
+			{ 1.0f,  0.0f,  0.0f, 100.0f},
+			{-1.0f,  0.0f,  0.0f, 100.0f},
+			{ 0.0f,  1.0f,  0.0f, 100.0f},
+			{ 0.0f, -1.0f,  0.0f, 100.0f},
+			{ 0.0f,  0.0f,  1.0f, 100.0f},
+			{ 0.0f,  0.0f, -1.0f, 100.0f},
+		}};
+		cams.planesMasks[c] = (1 << CCamera::FRUSTUM_PLANE_CNT) - 1;
+	}
+
+	// only the first camera tests the far plane
+	cams.planesMasks[1] &= ~(1 << CCamera::FRUSTUM_PLANE_FAR);
+
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float inf = std::numeric_limits<float>::infinity();
+
+	const std::vector<TestSphere> spheres = {
+		{{   0.0f,   0.0f,    0.0f},   1.0f}, // inside
+		{{ 150.0f,   0.0f,    0.0f},  49.0f}, // outside
+		{{ 150.0f,   0.0f,    0.0f},  50.0f}, // touching
+		{{ 150.0f,   0.0f,    0.0f},  51.0f}, // intersecting
+		{{   0.0f,   0.0f,  150.0f},  10.0f}, // beyond the far plane
+		{{   0.0f,   0.0f, -150.0f},  10.0f}, // in front of the near plane
+		{{   0.0f,   0.0f,    0.0f},   0.0f}, // zero radius
+		{{ 500.0f,   0.0f,    0.0f}, -10.0f}, // negative radius
+		{{    nan,   0.0f,    0.0f},   1.0f}, // NaN counts as inside
+		{{ 500.0f,    nan,    0.0f},   1.0f},
+		{{ 500.0f,   0.0f,    0.0f},    nan},
+		{{    inf,   0.0f,    0.0f},   1.0f}, // infinite distances
+		{{   -inf,   0.0f,    0.0f},   1.0f},
+		{{ 500.0f,   0.0f,    0.0f},    inf},
+	};
+
+	Cull(culler, cams, spheres);
+	CheckMasks(culler, cams, spheres);
+
+	const uint8_t allCams = (1 << CFrustumCuller::MAX_CAMERAS) - 1;
+
+	CHECK(culler.GetInViewMask(0) == allCams);
+	CHECK(culler.GetInViewMask(1) == 0);
+	CHECK(culler.GetInViewMask(2) == allCams);
+	CHECK(culler.GetInViewMask(4) == (1 << 1));
+	CHECK(culler.GetInViewMask(8) == allCams);
+
+	// no cameras at all
+	cams.camTypeMask = 0;
+
+	Cull(culler, cams, spheres);
+	CheckMasks(culler, cams, spheres);
+}
+
+TEST_CASE("FrustumCullerPadding")
+{
+	std::mt19937 rng(9012);
+	CFrustumCuller culler;
+
+	const TestCameras cams = MakeCameras(rng);
+
+	// partial last blocks, shrinking leaves stale spheres in the padding lanes
+	for (size_t numSpheres: {200, 1, 63, 64, 65, 130, 0, 127, 128, 129, 3}) {
+		CAPTURE(numSpheres);
+
+		const std::vector<TestSphere> spheres = MakeSpheres(numSpheres, rng);
+
+		Cull(culler, cams, spheres);
+
+		CHECK(culler.GetNumBlocks() == (numSpheres + CFrustumCuller::BLOCK_SIZE - 1) / CFrustumCuller::BLOCK_SIZE);
+
+		if (numSpheres > 0)
+			CHECK(culler.GetBlockEnd(culler.GetNumBlocks() - 1) == numSpheres);
+
+		CheckMasks(culler, cams, spheres);
+	}
+
+	// blocks can be culled in any order, e.g. by different threads
+	const std::vector<TestSphere> spheres = MakeSpheres(300, rng);
+
+	culler.SetCameras(cams.camTypeMask, cams.planes, cams.planesMasks);
+	culler.Resize(spheres.size());
+
+	for (size_t block = culler.GetNumBlocks(); block-- > 0; ) {
+		for (size_t i = culler.GetBlockBeg(block); i < culler.GetBlockEnd(block); i++) {
+			culler.SetSphere(i, spheres[i].pos, spheres[i].radius);
+		}
+
+		culler.CullBlock(block);
+	}
+
+	CheckMasks(culler, cams, spheres);
+}
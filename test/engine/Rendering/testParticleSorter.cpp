@@ -0,0 +1,107 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Rendering/Env/Particles/ParticleSorter.h"
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+
+struct TestParticle {
+	int drawOrder;
+	float sortDist;
+};
+
+// the predicates CProjectileDrawer used with std::sort
+static bool DrawOrderSortingPredicate(const TestParticle* p1, const TestParticle* p2) {
+	return std::forward_as_tuple(p2->drawOrder, p1->sortDist, p1) > std::forward_as_tuple(p1->drawOrder, p2->sortDist, p2);
+}
+
+static bool SortingPredicate(const TestParticle* p1, const TestParticle* p2) {
+	return std::forward_as_tuple(p1->sortDist, p1) > std::forward_as_tuple(p2->sortDist, p2);
+}
+
+static std::vector<TestParticle> MakeParticles(size_t numParticles, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> distDist(-64.0f, 4096.0f);
+	std::uniform_int_distribution<int> orderDist(-2, 2);
+	std::uniform_int_distribution<int> tieDist(0, 15);
+
+	std::vector<TestParticle> particles(numParticles);
+
+	for (TestParticle& p: particles) {
+		p.drawOrder = orderDist(rng);
+		p.sortDist = distDist(rng);
+
+		// exact ties (e.g. particles spawned at the same position), incl. signed zeros
+		switch (tieDist(rng)) {
+			case 0: { p.sortDist = 100.0f; } break;
+			case 1: { p.sortDist =   0.0f; } break;
+			case 2: { p.sortDist =  -0.0f; } break;
+			default: {} break;
+		}
+	}
+
+	return particles;
+}
+
+static std::vector<TestParticle*> GetPointers(std::vector<TestParticle>& particles)
+{
+	std::vector<TestParticle*> pointers(particles.size());
+	std::transform(particles.begin(), particles.end(), pointers.begin(), [](TestParticle& p) { return &p; });
+	return pointers;
+}
+
+static void CheckSameOrder(size_t numParticles, bool useDrawOrder)
+{
+	std::mt19937 rng(numParticles);
+	std::vector<TestParticle> particles = MakeParticles(numParticles, rng);
+
+	std::vector<TestParticle*> expected = GetPointers(particles);
+	std::vector<TestParticle*> sorted = expected;
+
+	std::shuffle(sorted.begin(), sorted.end(), rng);
+
+	if (useDrawOrder)
+		std::sort(expected.begin(), expected.end(), DrawOrderSortingPredicate);
+	else
+		std::sort(expected.begin(), expected.end(), SortingPredicate);
+
+	CParticleSorter<TestParticle> sorter;
+	sorter.Sort(sorted, useDrawOrder, [](const TestParticle* p) { return p->drawOrder; }, [](const TestParticle* p) { return p->sortDist; });
+
+	CHECK(sorted == expected);
+}
+
+
+TEST_CASE("ParticleSorter")
+{
+	for (size_t numParticles: {0, 1, 2, 100, 255, 256, 5000, 40000}) {
+		CheckSameOrder(numParticles, false);
+		CheckSameOrder(numParticles, true);
+	}
+}
+
+TEST_CASE("ParticleSorterReuse")
+{
+	std::mt19937 rng(1234);
+	std::vector<TestParticle> particles = MakeParticles(3000, rng);
+
+	CParticleSorter<TestParticle> sorter;
+
+	// per-frame use with shrinking and growing inputs
+	for (size_t numParticles: {3000, 500, 3000, 10}) {
+		std::vector<TestParticle*> expected = GetPointers(particles);
+		expected.resize(numParticles);
+
+		std::vector<TestParticle*> sorted = expected;
+
+		std::sort(expected.begin(), expected.end(), SortingPredicate);
+		sorter.Sort(sorted, false, [](const TestParticle* p) { return p->drawOrder; }, [](const TestParticle* p) { return p->sortDist; });
+
+		CHECK(sorted == expected);
+	}
+}
@@ -0,0 +1,185 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Misc/PieceBVH.h"
+#include "System/float3.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+
+// pieces of a (large) model: a loose chain of limbs around the origin,
+// roughly the layout of a mech or ship with 40-80 pieces
+static std::vector<CPieceBVH::Box> MakePieceBoxes(size_t numPieces, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> offsetDist(-12.0f, 12.0f);
+	std::uniform_real_distribution<float> scaleDist(2.0f, 10.0f);
+
+	std::vector<CPieceBVH::Box> boxes(numPieces);
+	float3 pos;
+
+	for (size_t n = 0; n < numPieces; n++) {
+		// every fourth piece starts a new limb at the root
+		if ((n & 3) == 0)
+			pos = ZeroVector;
+
+		pos += float3(offsetDist(rng), offsetDist(rng) * 0.5f + 4.0f, offsetDist(rng));
+
+		const float3 hs = {scaleDist(rng), scaleDist(rng), scaleDist(rng)};
+
+		boxes[n].mins = pos - hs;
+		boxes[n].maxs = pos + hs;
+	}
+
+	return boxes;
+}
+
+static void MakeSegments(std::vector<float3>& segments, size_t numSegments, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> posDist(-150.0f, 150.0f);
+
+	segments.resize(numSegments * 2);
+
+	for (size_t n = 0; n < numSegments; n++) {
+		segments[n * 2 + 0] = {posDist(rng), posDist(rng) + 50.0f, posDist(rng)};
+		segments[n * 2 + 1] = {posDist(rng), posDist(rng) + 50.0f, posDist(rng)};
+	}
+}
+
+static void BruteForceQuery(const std::vector<CPieceBVH::Box>& boxes, const float3& p0, const float3& p1, std::vector<uint32_t>& hits)
+{
+	hits.clear();
+
+	for (uint32_t n = 0; n < boxes.size(); n++) {
+		if (CPieceBVH::SegmentOverlapsBox(p0, p1 - p0, boxes[n]))
+			hits.push_back(n);
+	}
+}
+
+static void TreeQuery(const CPieceBVH& bvh, const float3& p0, const float3& p1, std::vector<uint32_t>& hits)
+{
+	hits.clear();
+	bvh.Traverse(p0, p1, [&](uint32_t n) { hits.push_back(n); });
+	std::sort(hits.begin(), hits.end());
+}
+
+
+TEST_CASE("PieceBVH")
+{
+	std::mt19937 rng(1234);
+
+	std::vector<float3> segments;
+	std::vector<uint32_t> bruteHits;
+	std::vector<uint32_t> treeHits;
+
+	MakeSegments(segments, 1000, rng);
+
+	for (const size_t numPieces: {1, 2, 3, 7, 40, 80}) {
+		std::vector<CPieceBVH::Box> boxes = MakePieceBoxes(numPieces, rng);
+
+		CPieceBVH bvh;
+		bvh.Build(boxes);
+
+		CHECK(bvh.GetNumLeaves() == numPieces);
+		CHECK(bvh.GetNumNodes() == numPieces * 2 - 1);
+
+		for (size_t n = 0; n < segments.size(); n += 2) {
+			BruteForceQuery(boxes, segments[n], segments[n + 1], bruteHits);
+			TreeQuery(bvh, segments[n], segments[n + 1], treeHits);
+
+			CHECK(bruteHits == treeHits);
+		}
+
+		// animate the pieces; refit must keep the query results exact
+		std::uniform_real_distribution<float> moveDist(-20.0f, 20.0f);
+
+		for (CPieceBVH::Box& box: boxes) {
+			const float3 move = {moveDist(rng), moveDist(rng), moveDist(rng)};
+
+			box.mins += move;
+			box.maxs += move;
+		}
+
+		bvh.Refit(boxes);
+
+		for (size_t n = 0; n < segments.size(); n += 2) {
+			BruteForceQuery(boxes, segments[n], segments[n + 1], bruteHits);
+			TreeQuery(bvh, segments[n], segments[n + 1], treeHits);
+
+			CHECK(bruteHits == treeHits);
+		}
+	}
+}
+
+TEST_CASE("PieceBVHUnboundedLeaf")
+{
+	std::mt19937 rng(4321);
+
+	std::vector<float3> segments;
+	std::vector<uint32_t> treeHits;
+
+	MakeSegments(segments, 1000, rng);
+
+	// pieces with non-rigid matrices get an unbounded box and must always be visited
+	std::vector<CPieceBVH::Box> boxes = MakePieceBoxes(8, rng);
+
+	boxes[5].mins = float3(-std::numeric_limits<float>::max());
+	boxes[5].maxs = float3( std::numeric_limits<float>::max());
+
+	CPieceBVH bvh;
+	bvh.Build(boxes);
+
+	for (size_t n = 0; n < segments.size(); n += 2) {
+		TreeQuery(bvh, segments[n], segments[n + 1], treeHits);
+		CHECK(std::find(treeHits.begin(), treeHits.end(), 5) != treeHits.end());
+	}
+}
+
+
+TEST_CASE("PieceBVHBenchmark")
+{
+	std::mt19937 rng(5678);
+
+	std::vector<float3> segments;
+	std::vector<uint32_t> hits;
+
+	MakeSegments(segments, 256, rng);
+
+	for (const size_t numPieces: {16, 40, 80}) {
+		std::vector<CPieceBVH::Box> boxes = MakePieceBoxes(numPieces, rng);
+
+		CPieceBVH bvh;
+		bvh.Build(boxes);
+
+		// lower bound for the linear scan, which runs a full volume test per piece
+		BENCHMARK("BruteForce" + std::to_string(numPieces)) {
+			size_t numHits = 0;
+
+			for (size_t n = 0; n < segments.size(); n += 2) {
+				BruteForceQuery(boxes, segments[n], segments[n + 1], hits);
+				numHits += hits.size();
+			}
+
+			return numHits;
+		};
+
+		BENCHMARK("Traverse" + std::to_string(numPieces)) {
+			size_t numHits = 0;
+
+			for (size_t n = 0; n < segments.size(); n += 2) {
+				bvh.Traverse(segments[n], segments[n + 1], [&](uint32_t) { numHits++; });
+			}
+
+			return numHits;
+		};
+
+		BENCHMARK("Refit" + std::to_string(numPieces)) {
+			bvh.Refit(boxes);
+			return bvh.GetRootBox().mins.x;
+		};
+	}
+}
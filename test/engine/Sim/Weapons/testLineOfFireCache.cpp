@@ -0,0 +1,116 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Weapons/LineOfFireCache.h"
+#include "System/float3.h"
+
+#include <catch_amalgamated.hpp>
+
+
+static CLineOfFireCache::Query MakeQuery(int targetID, const float3& tgtPos)
+{
+	CLineOfFireCache::Query q;
+	q.srcPos = float3(100.0f, 20.0f, 100.0f);
+	q.tgtPos = tgtPos;
+	q.spread = 0.01f;
+	q.areaOfEffect = 48.0f;
+	q.targetID = targetID;
+	q.allyTeam = 1;
+	q.targetFlags = 1 << 3;
+	q.avoidFlags = 0;
+	q.weaponState = 0;
+	return q;
+}
+
+
+TEST_CASE("LineOfFireCache")
+{
+	CLineOfFireCache cache;
+	CLineOfFireCache::stats.Reset();
+
+	int numTests = 0;
+	bool testResult = true;
+
+	const auto TestFunc = [&]() { numTests++; return testResult; };
+	const auto NumHits = []() { return CLineOfFireCache::stats.numHits.load(); };
+	const auto NumMisses = []() { return CLineOfFireCache::stats.numMisses.load(); };
+
+	const CLineOfFireCache::Query q = MakeQuery(7, float3(500.0f, 30.0f, 500.0f));
+
+	SECTION("Hits") {
+		CHECK(cache.Get(q, 1, TestFunc));
+
+		// the stored result is returned even though a new test would differ
+		testResult = false;
+
+		CHECK(cache.Get(q, 1, TestFunc));
+		CHECK(cache.Get(q, 1, TestFunc));
+		CHECK(numTests == 1);
+		CHECK(NumHits() == 2);
+		CHECK(NumMisses() == 1);
+	}
+
+	SECTION("Misses") {
+		CHECK(cache.Get(q, 1, TestFunc));
+
+		CLineOfFireCache::Query q2 = q;
+
+		// positions are compared exactly
+		q2.tgtPos.x += 0.001f;
+		CHECK(cache.Get(q2, 1, TestFunc));
+
+		q2 = q;
+		q2.targetID = 8;
+		CHECK(cache.Get(q2, 1, TestFunc));
+
+		q2 = q;
+		q2.areaOfEffect = 64.0f;
+		CHECK(cache.Get(q2, 1, TestFunc));
+
+		q2 = q;
+		q2.weaponState = 1;
+		CHECK(cache.Get(q2, 1, TestFunc));
+
+		CHECK(numTests == 5);
+		CHECK(NumHits() == 0);
+		CHECK(NumMisses() == 5);
+	}
+
+	SECTION("Invalidation") {
+		CHECK(cache.Get(q, 1, TestFunc));
+
+		// something moved in between, the blocker now obstructs the line
+		testResult = false;
+
+		CHECK(!cache.Get(q, 2, TestFunc));
+		CHECK(!cache.Get(q, 2, TestFunc));
+		CHECK(numTests == 2);
+		CHECK(NumHits() == 1);
+
+		cache.Clear();
+
+		CHECK(!cache.Get(q, 2, TestFunc));
+		CHECK(numTests == 3);
+	}
+
+	SECTION("Default entries never match") {
+		CLineOfFireCache::Query q0;
+
+		CHECK(cache.Get(q0, 1, TestFunc));
+		CHECK(numTests == 1);
+	}
+
+	SECTION("Eviction") {
+		// the oldest of NUM_ENTRIES + 1 distinct queries is replaced
+		for (size_t n = 0; n <= CLineOfFireCache::NUM_ENTRIES; n++) {
+			cache.Get(MakeQuery(n, float3(500.0f, 30.0f, 500.0f)), 1, TestFunc);
+		}
+
+		CHECK(numTests == (CLineOfFireCache::NUM_ENTRIES + 1));
+
+		cache.Get(MakeQuery(CLineOfFireCache::NUM_ENTRIES, float3(500.0f, 30.0f, 500.0f)), 1, TestFunc);
+		CHECK(numTests == (CLineOfFireCache::NUM_ENTRIES + 1));
+
+		cache.Get(MakeQuery(0, float3(500.0f, 30.0f, 500.0f)), 1, TestFunc);
+		CHECK(numTests == (CLineOfFireCache::NUM_ENTRIES + 2));
+	}
+}
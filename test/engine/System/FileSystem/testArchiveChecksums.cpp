@@ -0,0 +1,117 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirLocater.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Sync/SHA512.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <catch_amalgamated.hpp>
+
+
+static const std::string gameName = "Checksum Test 1";
+
+static std::filesystem::path GetDataDir()
+{
+	return (std::filesystem::temp_directory_path() / "ArchiveChecksums");
+}
+
+static void WriteFile(const std::filesystem::path& path, const std::string& data)
+{
+	std::filesystem::create_directories(path.parent_path());
+	std::ofstream ofs(path, std::ios::binary);
+	ofs << data;
+}
+
+static void CreateDataDir()
+{
+	const std::filesystem::path dataDir = GetDataDir();
+	const std::filesystem::path gameDir = dataDir / "games" / "checksumtest.sdd";
+
+	std::filesystem::remove_all(dataDir);
+
+	// every game implicitly depends on this one
+	WriteFile(dataDir / "base" / "springcontent.sdd" / "modinfo.lua", R"(return {name = "Spring content", version = "v1", modtype = 4})");
+	WriteFile(gameDir / "modinfo.lua", R"(return {name = "Checksum Test", version = "1", modtype = 1})");
+
+	for (int i = 0; i < 16; i++) {
+		WriteFile(gameDir / "units" / ("unit" + std::to_string(i) + ".lua"), std::string(1000 + i * 100, 'a' + i));
+	}
+}
+
+
+TEST_CASE("ArchiveChecksums")
+{
+	CreateDataDir();
+
+	ConfigHandler::Instantiate((GetDataDir() / "springsettings.cfg").string());
+
+	dataDirLocater.SetIsolationMode(true);
+	dataDirLocater.SetIsolationModeDir(GetDataDir().string());
+	dataDirLocater.LocateDataDirs();
+
+	// reference, hashed on this thread by the getter
+	archiveScanner = new CArchiveScanner();
+
+	const sha512::raw_digest refChecksum = archiveScanner->GetArchiveCompleteChecksumBytes(gameName);
+	const std::string cacheFile = archiveScanner->GetFilepath();
+
+	CHECK(refChecksum != sha512::NULL_RAW_DIGEST);
+
+	// start over without the cached checksums
+	delete archiveScanner;
+	std::filesystem::remove(cacheFile);
+
+	archiveScanner = new CArchiveScanner();
+
+	sha512::raw_digest checksum;
+
+	// scanned, but not hashed yet
+	CHECK(archiveScanner->ArchiveFromName(gameName) == "checksumtest.sdd");
+	CHECK(!archiveScanner->TryGetArchiveCompleteChecksumBytes(gameName, checksum));
+
+	archiveScanner->ResetNumFilesHashed();
+	archiveScanner->StartChecksums({gameName});
+
+	// name lookups do not wait for the job
+	CHECK(archiveScanner->ArchiveFromName(gameName) == "checksumtest.sdd");
+	CHECK(archiveScanner->GetAllArchivesUsedBy(gameName).size() == 2);
+
+	archiveScanner->WaitForChecksums();
+
+	const uint32_t numFilesHashed = archiveScanner->GetNumFilesHashed();
+
+	CHECK(numFilesHashed >= 18);
+	REQUIRE(archiveScanner->TryGetArchiveCompleteChecksumBytes(gameName, checksum));
+	CHECK(checksum == refChecksum);
+
+	// the getters use what the job hashed
+	CHECK(archiveScanner->GetArchiveCompleteChecksumBytes(gameName) == refChecksum);
+	CHECK(archiveScanner->GetNumFilesHashed() == numFilesHashed);
+
+	// nothing left to do for a second job, waiting twice is harmless
+	archiveScanner->StartChecksums({gameName});
+	archiveScanner->WaitForChecksums();
+	archiveScanner->WaitForChecksums();
+
+	CHECK(archiveScanner->GetNumFilesHashed() == numFilesHashed);
+	CHECK(archiveScanner->GetArchiveCompleteChecksumBytes(gameName) == refChecksum);
+
+	// the getters also wait for a job still running
+	delete archiveScanner;
+	std::filesystem::remove(cacheFile);
+
+	archiveScanner = new CArchiveScanner();
+	archiveScanner->StartChecksums({gameName});
+
+	CHECK(archiveScanner->GetArchiveCompleteChecksumBytes(gameName) == refChecksum);
+
+	delete archiveScanner;
+	archiveScanner = nullptr;
+
+	ConfigHandler::Deallocate();
+	std::filesystem::remove_all(GetDataDir());
+}
@@ -7,6 +7,7 @@
 #include <catch_amalgamated.hpp>
 
 #include <cstdarg>
+#include <fstream>
 #include <sstream>
 
 
@@ -231,3 +232,97 @@ TEST_CASE("IsEnabled")
 	TLOG_SL(   "other-one-time-section", L_DEBUG, "Testing LOG_IS_ENABLED_S");
 }
 
+
+
+TEST_CASE("AsyncFileSink")
+{
+	LogStream ls;
+
+	log_file_setAsync(true);
+	CHECK(log_file_isAsync());
+
+	// more than the writer can buffer, some records may be dropped
+	constexpr int numRecords = 20000;
+
+	for (int i = 0; i < numRecords; i++) {
+		LOG("async record %d", i);
+	}
+
+	LOG_L(L_ERROR, "async error record");
+
+	// written out synchronously, like on a crash
+	LOG_CLEANUP();
+
+	std::ifstream logFile(ls.logFile);
+	std::string line;
+
+	int numWritten = 0;
+	int numDropped = 0;
+	int lastRecord = -1;
+	bool haveError = false;
+
+	while (std::getline(logFile, line)) {
+		if (line.find("async error record") != std::string::npos) {
+			haveError = true;
+			continue;
+		}
+
+		if (const size_t pos = line.find("log records were dropped"); pos != std::string::npos) {
+			numDropped += std::stoi(line.substr(line.rfind(']', pos) + 2));
+			continue;
+		}
+
+		const size_t pos = line.find("async record ");
+
+		if (pos == std::string::npos)
+			continue;
+
+		const int record = std::stoi(line.substr(pos + 13));
+
+		// order is kept
+		CHECK(record > lastRecord);
+		lastRecord = record;
+		numWritten++;
+	}
+
+	CHECK(haveError);
+	CHECK((numWritten + numDropped) == numRecords);
+
+	log_file_setAsync(false);
+	CHECK_FALSE(log_file_isAsync());
+}
+
+TEST_CASE("AsyncFileSinkAddRemove")
+{
+	LogStream ls;
+
+	log_file_setAsync(true);
+
+	// the writer thread keeps flushing all files while the list changes
+	for (int i = 0; i < 200; i++) {
+		const std::string extraFile = ls.GetTempLogFile();
+
+		log_file_addLogFile(extraFile.c_str());
+
+		for (int j = 0; j < 10; j++) {
+			LOG("extra file %d record %d", i, j);
+		}
+
+		// pending records are written out before the file is closed
+		log_file_removeLogFile(extraFile.c_str());
+
+		std::ifstream logFile(extraFile);
+		std::string line;
+
+		int numWritten = 0;
+
+		while (std::getline(logFile, line)) {
+			numWritten += (line.find("extra file " + std::to_string(i) + " record ") != std::string::npos);
+		}
+
+		CHECK(numWritten == 10);
+		remove(extraFile.c_str());
+	}
+
+	log_file_setAsync(false);
+}
@@ -0,0 +1,159 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/Net/RelayBatch.h"
+#include "System/Net/RawPacket.h"
+#include "Net/Protocol/BaseNetProtocol.h"
+
+#include <catch_amalgamated.hpp>
+
+#include <cstring>
+#include <vector>
+
+using netcode::RawPacket;
+using netcode::RelayBatch;
+
+typedef std::vector<std::uint8_t> Message;
+
+
+static Message ToMessage(const RelayBatch::PacketType& packet)
+{
+	return Message(packet->data, packet->data + packet->length);
+}
+
+// what UDPConnection hands on to the client for the packets relayed to it
+static std::vector<Message> Receive(const std::vector<RelayBatch::PacketType>& packets)
+{
+	std::vector<Message> msgs;
+
+	for (const RelayBatch::PacketType& packet: packets) {
+		if (packet->data[0] != NETMSG_RELAYED_PACKETS) {
+			msgs.push_back(ToMessage(packet));
+			continue;
+		}
+
+		const bool unpacked = RelayBatch::Unpack(packet->data, packet->length, [&](const std::uint8_t* data, unsigned length) {
+			msgs.emplace_back(data, data + length);
+		});
+
+		CHECK(unpacked);
+	}
+
+	return msgs;
+}
+
+static RelayBatch::PacketType MakeLuaMsg(std::uint8_t playerNum, size_t size)
+{
+	std::vector<std::uint8_t> rawData(size);
+
+	for (size_t i = 0; i < size; i++) {
+		rawData[i] = static_cast<std::uint8_t>(i * 7 + playerNum);
+	}
+
+	return CBaseNetProtocol::Get().SendLuaMsg(playerNum, 1, 0, rawData);
+}
+
+
+TEST_CASE("RelayBatch")
+{
+	CBaseNetProtocol& proto = CBaseNetProtocol::Get();
+
+	std::vector<RelayBatch::PacketType> sent;
+	RelayBatch batch([&](RelayBatch::PacketType packet) { sent.push_back(packet); });
+
+	SECTION("PackUnpack") {
+		const std::vector<RelayBatch::PacketType> msgs = {
+			proto.SendKeyFrame(32),
+			proto.SendNewFrame(),
+			proto.SendSystemMessage(0, "relayed"),
+			MakeLuaMsg(3, 500),
+			proto.SendNewFrame(),
+		};
+
+		for (const auto& msg: msgs) {
+			batch.Append(msg);
+		}
+
+		// nothing leaves before the flush
+		CHECK(sent.empty());
+		CHECK(!batch.Empty());
+
+		batch.Flush();
+
+		REQUIRE(sent.size() == 1);
+		CHECK(sent[0]->data[0] == NETMSG_RELAYED_PACKETS);
+		CHECK(batch.Empty());
+
+		const std::vector<Message> received = Receive(sent);
+
+		REQUIRE(received.size() == msgs.size());
+
+		for (size_t i = 0; i < msgs.size(); i++) {
+			CHECK(received[i] == ToMessage(msgs[i]));
+		}
+
+		// flushing an empty batch sends nothing
+		batch.Flush();
+		CHECK(sent.size() == 1);
+	}
+
+	SECTION("Ordering") {
+		std::vector<RelayBatch::PacketType> msgs;
+
+		// fill past the batch size, with a message too large to batch in between
+		for (int i = 0; i < 40; i++) {
+			msgs.push_back(proto.SendKeyFrame(i));
+			msgs.push_back(MakeLuaMsg(i, 1500));
+
+			if (i == 20)
+				msgs.push_back(MakeLuaMsg(i, RelayBatch::MAX_BATCH_SIZE + 100));
+		}
+
+		for (const auto& msg: msgs) {
+			batch.Append(msg);
+		}
+
+		batch.Flush();
+
+		size_t numBatches = 0;
+
+		for (const auto& packet: sent) {
+			numBatches += (packet->data[0] == NETMSG_RELAYED_PACKETS);
+			CHECK(packet->length <= (RelayBatch::MAX_BATCH_SIZE + 1024));
+		}
+
+		CHECK(numBatches >= 2);
+		CHECK(sent.size() == (numBatches + 1));
+
+		const std::vector<Message> received = Receive(sent);
+
+		REQUIRE(received.size() == msgs.size());
+
+		for (size_t i = 0; i < msgs.size(); i++) {
+			CHECK(received[i] == ToMessage(msgs[i]));
+		}
+	}
+
+	SECTION("Malformed") {
+		batch.Append(proto.SendKeyFrame(1));
+		batch.Append(proto.SendNewFrame());
+		batch.Flush();
+
+		REQUIRE(sent.size() == 1);
+
+		const Message packed = ToMessage(sent[0]);
+		size_t numMsgs = 0;
+
+		const auto CountMsgs = [&](const std::uint8_t*, unsigned) { numMsgs++; };
+
+		// truncated deflate stream
+		CHECK(!RelayBatch::Unpack(packed.data(), packed.size() - 4, CountMsgs));
+		// not a relayed batch at all
+		CHECK(!RelayBatch::Unpack(packed.data(), 2, CountMsgs));
+
+		Message corrupt = packed;
+		corrupt[0] = NETMSG_NEWFRAME;
+		CHECK(!RelayBatch::Unpack(corrupt.data(), corrupt.size(), CountMsgs));
+
+		CHECK(numMsgs == 0);
+	}
+}
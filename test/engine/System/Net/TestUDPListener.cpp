@@ -1,9 +1,14 @@
 
+#include "System/Net/UDPBatchIO.h"
 #include "System/Net/UDPListener.h"
+#include "System/Net/Socket.h"
 #include "System/Log/ILog.h"
 
 #include <catch_amalgamated.hpp>
 
+#include <chrono>
+#include <thread>
+
 namespace streflop {
 	template<typename T> inline void streflop_init() {
 		// Do nothing by default, or for unknown types
@@ -93,3 +98,62 @@ TEST_CASE("TryBindSocket")
 	t.TestPort(-1, false);
 }
 
+
+
+TEST_CASE("UDPBatchIO")
+{
+	std::shared_ptr<asio::ip::udp::socket> recvSocket;
+	std::shared_ptr<asio::ip::udp::socket> sendSocket;
+
+	REQUIRE(netcode::UDPListener::TryBindSocket(0, recvSocket, "127.0.0.1").empty());
+	REQUIRE(netcode::UDPListener::TryBindSocket(0, sendSocket, "127.0.0.1").empty());
+
+	recvSocket->non_blocking(true);
+	sendSocket->non_blocking(true);
+
+	netcode::UDPBatchIO recvIO(recvSocket);
+	netcode::UDPBatchIO sendIO(sendSocket);
+
+	// more than one batch worth, sent from inside a deferred section
+	constexpr size_t numDatagrams = netcode::UDPBatchIO::MAX_BATCH_SIZE * 2 + 5;
+
+	const asio::ip::udp::endpoint recvAddr = recvSocket->local_endpoint();
+	const asio::ip::udp::endpoint sendAddr = sendSocket->local_endpoint();
+
+	sendIO.BeginDeferred();
+
+	for (size_t i = 0; i < numDatagrams; i++) {
+		const std::vector<std::uint8_t> payload(i + 1, static_cast<std::uint8_t>(i));
+		asio::error_code err;
+
+		sendIO.Send(payload.data(), payload.size(), recvAddr, err);
+		CHECK(!err);
+	}
+
+	sendIO.EndDeferred();
+
+	size_t numReceived = 0;
+
+	for (int tries = 0; tries < 100 && numReceived < numDatagrams; tries++) {
+		std::vector<netcode::UDPBatchIO::Datagram> datagrams;
+
+		for (bool receiving = true; receiving; ) {
+			datagrams.clear();
+			receiving = recvIO.Receive(datagrams);
+
+			// data is only valid until the next Receive
+			for (const netcode::UDPBatchIO::Datagram& dgram: datagrams) {
+				CHECK(dgram.sender == sendAddr);
+				CHECK(dgram.size == numReceived + 1);
+				CHECK(dgram.data[0] == static_cast<std::uint8_t>(numReceived));
+
+				numReceived += 1;
+			}
+		}
+
+		if (numReceived < numDatagrams)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	CHECK(numReceived == numDatagrams);
+}
@@ -0,0 +1,401 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/Sound/OpenAL/SoundPCMCache.h"
+#include "System/Misc/SpringTime.h"
+#include "System/Platform/Threading.h"
+#include "System/Threading/ThreadPool.h"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <vorbis/vorbisenc.h>
+
+#include <catch_amalgamated.hpp>
+
+
+struct do_once {
+	do_once() { Threading::DetectCores(); } // make GetMaxThreads() work
+};
+
+InitSpringTime ist;
+do_once doonce;
+
+
+static std::string GetFixtureDir()
+{
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "SoundPCMCache";
+
+	std::filesystem::create_directories(dir);
+	return (dir.generic_string() + "/");
+}
+
+static void WriteFile(const std::string& path, const std::vector<std::uint8_t>& data)
+{
+	std::ofstream ofs(path, std::ios::binary);
+	ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+static std::vector<std::uint8_t> ReadFile(const std::string& path)
+{
+	std::ifstream ifs(path, std::ios::binary);
+	return {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+}
+
+template<typename T> static void AppendLE(std::vector<std::uint8_t>& data, T value, size_t numBytes = sizeof(T))
+{
+	for (size_t i = 0; i < numBytes; i++) {
+		data.push_back((static_cast<std::uint64_t>(value) >> (i * 8)) & 0xFF);
+	}
+}
+
+static float SineSample(int frame, int channel, int rate)
+{
+	return (0.5f * std::sin(2.0f * 3.14159265f * (440.0f + channel * 110.0f) * frame / rate));
+}
+
+// 16-bit PCM, in the layout DecodeWAV expects; returns the samples
+static std::vector<std::uint8_t> MakeWAV(const std::string& path, int channels, int rate, int numFrames)
+{
+	std::vector<std::uint8_t> samples;
+	std::vector<std::uint8_t> data;
+
+	for (int f = 0; f < numFrames; f++) {
+		for (int c = 0; c < channels; c++) {
+			AppendLE(samples, static_cast<std::int16_t>(SineSample(f, c, rate) * 32767.0f));
+		}
+	}
+
+	data.insert(data.end(), {'R', 'I', 'F', 'F'});
+	AppendLE(data, std::int32_t(36 + samples.size()));
+	data.insert(data.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+	AppendLE(data, std::int32_t(16));
+	AppendLE(data, std::int16_t(1)); // PCM
+	AppendLE(data, std::int16_t(channels));
+	AppendLE(data, std::int32_t(rate));
+	AppendLE(data, std::int32_t(rate * channels * 2));
+	AppendLE(data, std::int16_t(channels * 2));
+	AppendLE(data, std::int16_t(16));
+	data.insert(data.end(), {'d', 'a', 't', 'a'});
+	AppendLE(data, std::int32_t(samples.size()));
+	data.insert(data.end(), samples.begin(), samples.end());
+
+	WriteFile(path, data);
+	return samples;
+}
+
+static void MakeOgg(const std::string& path, int channels, int rate, int numFrames)
+{
+	vorbis_info vi;
+	vorbis_comment vc;
+	vorbis_dsp_state vd;
+	vorbis_block vb;
+	ogg_stream_state os;
+	ogg_page og;
+	ogg_packet op;
+
+	vorbis_info_init(&vi);
+	REQUIRE(vorbis_encode_init_vbr(&vi, channels, rate, 0.4f) == 0);
+
+	vorbis_comment_init(&vc);
+	vorbis_analysis_init(&vd, &vi);
+	vorbis_block_init(&vd, &vb);
+	ogg_stream_init(&os, 1234);
+
+	std::vector<std::uint8_t> data;
+
+	const auto AppendPage = [&]() {
+		data.insert(data.end(), og.header, og.header + og.header_len);
+		data.insert(data.end(), og.body, og.body + og.body_len);
+	};
+
+	{
+		ogg_packet header;
+		ogg_packet headerComm;
+		ogg_packet headerCode;
+
+		vorbis_analysis_headerout(&vd, &vc, &header, &headerComm, &headerCode);
+		ogg_stream_packetin(&os, &header);
+		ogg_stream_packetin(&os, &headerComm);
+		ogg_stream_packetin(&os, &headerCode);
+
+		while (ogg_stream_flush(&os, &og) != 0) {
+			AppendPage();
+		}
+	}
+
+	for (int frame = 0; frame <= numFrames; ) {
+		if (frame < numFrames) {
+			const int numWrite = std::min(1024, numFrames - frame);
+			float** buffer = vorbis_analysis_buffer(&vd, numWrite);
+
+			for (int f = 0; f < numWrite; f++) {
+				for (int c = 0; c < channels; c++) {
+					buffer[c][f] = SineSample(frame + f, c, rate);
+				}
+			}
+
+			vorbis_analysis_wrote(&vd, numWrite);
+			frame += numWrite;
+		} else {
+			// end of stream
+			vorbis_analysis_wrote(&vd, 0);
+			frame += 1;
+		}
+
+		while (vorbis_analysis_blockout(&vd, &vb) == 1) {
+			vorbis_analysis(&vb, nullptr);
+			vorbis_bitrate_addblock(&vb);
+
+			while (vorbis_bitrate_flushpacket(&vd, &op) != 0) {
+				ogg_stream_packetin(&os, &op);
+
+				while (ogg_stream_pageout(&os, &og) != 0) {
+					AppendPage();
+				}
+			}
+		}
+	}
+
+	while (ogg_stream_flush(&os, &og) != 0) {
+		AppendPage();
+	}
+
+	ogg_stream_clear(&os);
+	vorbis_block_clear(&vb);
+	vorbis_dsp_clear(&vd);
+	vorbis_comment_clear(&vc);
+	vorbis_info_clear(&vi);
+
+	WriteFile(path, data);
+}
+
+
+TEST_CASE("SoundPCMCacheDecodeFile")
+{
+	const std::string dir = GetFixtureDir();
+
+	SECTION("WAV") {
+		const std::vector<std::uint8_t> samples = MakeWAV(dir + "stereo.wav", 2, 22050, 4410);
+
+		SoundPCM pcm;
+		REQUIRE(CSoundPCMCache::DecodeFile(dir + "stereo.wav", pcm));
+
+		CHECK(pcm.channels == 2);
+		CHECK(pcm.bitsPerSample == 16);
+		CHECK(pcm.rate == 22050);
+		CHECK(pcm.length > 0.0f);
+		CHECK(pcm.samples == samples);
+	}
+
+	SECTION("Ogg") {
+		MakeOgg(dir + "mono.ogg", 1, 44100, 22050);
+
+		SoundPCM pcm;
+		REQUIRE(CSoundPCMCache::DecodeFile(dir + "mono.ogg", pcm));
+
+		CHECK(pcm.channels == 1);
+		CHECK(pcm.bitsPerSample == 16);
+		CHECK(pcm.rate == 44100);
+		CHECK(pcm.length == Catch::Approx(0.5f).margin(0.01f));
+		// the granule position trims the last packet to the encoded length
+		CHECK(pcm.samples.size() == 22050 * 2);
+
+		MakeOgg(dir + "stereo.ogg", 2, 22050, 11025);
+		REQUIRE(CSoundPCMCache::DecodeFile(dir + "stereo.ogg", pcm));
+
+		CHECK(pcm.channels == 2);
+		CHECK(pcm.rate == 22050);
+		CHECK(pcm.samples.size() == 11025 * 2 * 2);
+	}
+
+	SECTION("Invalid") {
+		SoundPCM pcm;
+
+		CHECK(!CSoundPCMCache::DecodeFile(dir + "missing.wav", pcm));
+
+		WriteFile(dir + "garbage.wav", std::vector<std::uint8_t>(256, 0x55));
+		WriteFile(dir + "garbage.ogg", std::vector<std::uint8_t>(256, 0x55));
+		WriteFile(dir + "garbage.flac", std::vector<std::uint8_t>(256, 0x55));
+
+		CHECK(!CSoundPCMCache::DecodeFile(dir + "garbage.wav", pcm));
+		CHECK(!CSoundPCMCache::DecodeFile(dir + "garbage.ogg", pcm));
+		CHECK(!CSoundPCMCache::DecodeFile(dir + "garbage.flac", pcm));
+		CHECK(pcm.samples.empty());
+		CHECK(pcm.length <= 0.0f);
+	}
+}
+
+TEST_CASE("SoundPCMCachePredecode")
+{
+	const std::string dir = GetFixtureDir();
+	const std::string wavFile = dir + "predecode.wav";
+	const std::string oggFile = dir + "predecode.ogg";
+	const std::string badFile = dir + "predecode_bad.wav";
+
+	const std::vector<std::uint8_t> samples = MakeWAV(wavFile, 1, 11025, 1000);
+	MakeOgg(oggFile, 2, 44100, 4096);
+	WriteFile(badFile, std::vector<std::uint8_t>(16, 0));
+
+	SoundPCM oggPCM;
+	REQUIRE(CSoundPCMCache::DecodeFile(oggFile, oggPCM));
+
+	CSoundPCMCache cache;
+	SoundPCM pcm;
+
+	// duplicates are decoded once
+	cache.Predecode({wavFile, oggFile, wavFile, badFile});
+
+	REQUIRE(cache.Take(wavFile, pcm));
+	CHECK(pcm.samples == samples);
+	CHECK(pcm.rate == 11025);
+
+	REQUIRE(cache.Take(oggFile, pcm));
+	CHECK(pcm.samples == oggPCM.samples);
+	CHECK(pcm.channels == oggPCM.channels);
+	CHECK(pcm.length == oggPCM.length);
+
+	// failed decodes are taken as well, so the caller can record the failure
+	REQUIRE(cache.Take(badFile, pcm));
+	CHECK(pcm.length <= 0.0f);
+
+	// taking moves the data out
+	CHECK(!cache.Take(wavFile, pcm));
+	CHECK(!cache.Take(dir + "never_decoded.wav", pcm));
+
+	// leftovers nobody took are dropped
+	cache.Predecode({wavFile, oggFile});
+	cache.Drop({wavFile, dir + "never_decoded.wav"});
+
+	CHECK(!cache.Take(wavFile, pcm));
+	CHECK(cache.Take(oggFile, pcm));
+
+	cache.Predecode({wavFile});
+	cache.Clear();
+	CHECK(!cache.Take(wavFile, pcm));
+}
+
+TEST_CASE("SoundPCMCachePredecodeAsync")
+{
+	const std::string dir = GetFixtureDir();
+	const std::string wavFile = dir + "async.wav";
+	const std::string oggFile = dir + "async.ogg";
+
+	const std::vector<std::uint8_t> samples = MakeWAV(wavFile, 2, 44100, 2000);
+	MakeOgg(oggFile, 1, 22050, 8192);
+
+	SoundPCM oggPCM;
+	REQUIRE(CSoundPCMCache::DecodeFile(oggFile, oggPCM));
+
+	// a single worker, so the decode can be held back behind another task
+	ThreadPool::SetThreadCount(2);
+
+	CSoundPCMCache cache;
+	SoundPCM pcm;
+
+	if (ThreadPool::HasThreads()) {
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+
+		ThreadPool::Enqueue([released]() { released.wait(); });
+
+		cache.PredecodeAsync(oggFile);
+		cache.PredecodeAsync(oggFile);
+
+		CHECK(cache.IsDecoding(oggFile));
+		CHECK(!cache.IsDecoding(wavFile));
+
+		release.set_value();
+	} else {
+		// decoded right away without a pool
+		cache.PredecodeAsync(oggFile);
+
+		CHECK(!cache.IsDecoding(oggFile));
+	}
+
+	// waits for the decode if it is still queued
+	REQUIRE(cache.Take(oggFile, pcm));
+	CHECK(!cache.IsDecoding(oggFile));
+	CHECK(pcm.samples == oggPCM.samples);
+	CHECK(pcm.rate == 22050);
+
+	CHECK(!cache.Take(oggFile, pcm));
+
+	// already queued or decoded paths are skipped by Predecode
+	cache.PredecodeAsync(wavFile);
+	cache.Predecode({wavFile});
+
+	REQUIRE(cache.Take(wavFile, pcm));
+	CHECK(pcm.samples == samples);
+	CHECK(!cache.Take(wavFile, pcm));
+
+	// Clear waits for queued decodes before dropping them
+	cache.PredecodeAsync(wavFile);
+	cache.PredecodeAsync(oggFile);
+	cache.Clear();
+
+	CHECK(!cache.IsDecoding(wavFile));
+	CHECK(!cache.IsDecoding(oggFile));
+	CHECK(!cache.Take(wavFile, pcm));
+	CHECK(!cache.Take(oggFile, pcm));
+
+	ThreadPool::SetThreadCount(0);
+}
+
+TEST_CASE("SoundPCMCacheFile")
+{
+	const std::string dir = GetFixtureDir();
+	const std::string oggFile = dir + "cached.ogg";
+	const std::string cacheFile = dir + "cached.pcm";
+
+	MakeOgg(oggFile, 2, 44100, 10000);
+
+	SoundPCM pcm;
+	SoundPCM cachedPCM;
+
+	REQUIRE(CSoundPCMCache::DecodeFile(oggFile, pcm));
+	REQUIRE(CSoundPCMCache::WritePCMFile(cacheFile, pcm));
+
+	SECTION("RoundTrip") {
+		REQUIRE(CSoundPCMCache::ReadPCMFile(cacheFile, cachedPCM));
+
+		CHECK(cachedPCM.samples == pcm.samples);
+		CHECK(cachedPCM.channels == pcm.channels);
+		CHECK(cachedPCM.bitsPerSample == pcm.bitsPerSample);
+		CHECK(cachedPCM.rate == pcm.rate);
+		CHECK(cachedPCM.length == pcm.length);
+	}
+
+	SECTION("CorruptSamples") {
+		std::vector<std::uint8_t> data = ReadFile(cacheFile);
+
+		REQUIRE(data.size() > (pcm.samples.size() / 2));
+		data[data.size() - pcm.samples.size() / 2] ^= 0xFF;
+		WriteFile(cacheFile, data);
+
+		CHECK(!CSoundPCMCache::ReadPCMFile(cacheFile, cachedPCM));
+		CHECK(cachedPCM.samples.empty());
+		CHECK(cachedPCM.length <= 0.0f);
+	}
+
+	SECTION("Truncated") {
+		std::vector<std::uint8_t> data = ReadFile(cacheFile);
+
+		data.resize(data.size() - 1);
+		WriteFile(cacheFile, data);
+		CHECK(!CSoundPCMCache::ReadPCMFile(cacheFile, cachedPCM));
+
+		data.resize(8);
+		WriteFile(cacheFile, data);
+		CHECK(!CSoundPCMCache::ReadPCMFile(cacheFile, cachedPCM));
+	}
+
+	SECTION("NotACacheFile") {
+		CHECK(!CSoundPCMCache::ReadPCMFile(oggFile, cachedPCM));
+		CHECK(!CSoundPCMCache::ReadPCMFile(dir + "missing.pcm", cachedPCM));
+	}
+}
@@ -0,0 +1,66 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/Sync/SubsystemChecksums.h"
+
+#include <catch_amalgamated.hpp>
+
+
+static CSubsystemChecksums::Record MakeRecord(int frameNum)
+{
+	CSubsystemChecksums::Record record;
+	record.frameNum = frameNum;
+	record.unitsPerBucket = 500;
+
+	for (uint32_t i = 0; i < CSubsystemChecksums::SUBSYS_COUNT; i++) {
+		record.subsystems[i] = 0x1000 + i;
+	}
+	for (uint32_t i = 0; i < CSubsystemChecksums::NUM_UNIT_BUCKETS; i++) {
+		record.unitBuckets[i] = 0x2000 + i;
+	}
+
+	return record;
+}
+
+
+TEST_CASE("SubsystemChecksumsPacking")
+{
+	const CSubsystemChecksums::Record record = MakeRecord(1234);
+	const std::vector<uint32_t> words = CSubsystemChecksums::Pack(record);
+
+	CHECK(words.size() == CSubsystemChecksums::PACKED_SIZE);
+
+	CSubsystemChecksums::Record unpacked;
+
+	REQUIRE(CSubsystemChecksums::Unpack(words, unpacked));
+	CHECK(unpacked.frameNum == record.frameNum);
+	CHECK(unpacked.unitsPerBucket == record.unitsPerBucket);
+	CHECK(CSubsystemChecksums::CompareSubsystems(unpacked, record) == 0);
+	CHECK(CSubsystemChecksums::CompareUnitBuckets(unpacked, record) == 0);
+
+	// truncated or empty responses are rejected
+	CHECK(!CSubsystemChecksums::Unpack({words.begin(), words.end() - 1}, unpacked));
+	CHECK(!CSubsystemChecksums::Unpack({}, unpacked));
+}
+
+TEST_CASE("SubsystemChecksumsDivergence")
+{
+	const CSubsystemChecksums::Record a = MakeRecord(100);
+	CSubsystemChecksums::Record b = MakeRecord(100);
+
+	b.subsystems[CSubsystemChecksums::SUBSYS_PATHING] ^= 1;
+	b.subsystems[CSubsystemChecksums::SUBSYS_RNG] ^= 1;
+	b.unitBuckets[3] ^= 1;
+	b.unitBuckets[7] ^= 1;
+
+	const uint32_t subsystemMask = CSubsystemChecksums::CompareSubsystems(a, b);
+	const uint64_t unitBucketMask = CSubsystemChecksums::CompareUnitBuckets(a, b);
+
+	CHECK(subsystemMask == ((1u << CSubsystemChecksums::SUBSYS_PATHING) | (1u << CSubsystemChecksums::SUBSYS_RNG)));
+	CHECK(unitBucketMask == ((1ull << 3) | (1ull << 7)));
+	CHECK(CSubsystemChecksums::GetSubsystemNames(subsystemMask) == "pathing, rng");
+
+	// buckets 3..7 of 500 IDs each
+	CHECK(CSubsystemChecksums::GetUnitIDRange(unitBucketMask, a.unitsPerBucket) == std::make_pair(1500, 3999));
+	CHECK(CSubsystemChecksums::GetUnitIDRange(1ull << 63, 10) == std::make_pair(630, 639));
+	CHECK(CSubsystemChecksums::GetUnitIDRange(0, 10) == std::make_pair(-1, -1));
+}
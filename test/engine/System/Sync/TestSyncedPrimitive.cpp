@@ -3,6 +3,12 @@
 #endif
 #include "System/Sync/SyncedPrimitive.h"
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
 #include <catch_amalgamated.hpp>
 
 
@@ -38,3 +44,68 @@ TEST_CASE("ImplicitConversions")
 
 	LEAVE_SYNCED_CODE();
 }
+
+
+// runs <numJobs> jobs that each sync a few values on <numThreads> threads,
+// handing out job indices in the given order
+static unsigned RunLaneJobs(const std::vector<int>& jobOrder, int numThreads, int valueOffset)
+{
+	CSyncChecker::NewFrame();
+
+	SyncedSint before = 1;
+	(void) before;
+
+	{
+		Sync::ScopedLanes lanes(jobOrder.size());
+
+		std::vector<std::thread> threads;
+
+		for (int t = 0; t < numThreads; t++) {
+			threads.emplace_back([&, t]() {
+				for (size_t n = t; n < jobOrder.size(); n += numThreads) {
+					const int i = jobOrder[n];
+
+					Sync::ScopedLane lane(i);
+					SyncedSint a = i + valueOffset;
+					SyncedFloat b = i * 0.5f;
+					(void) a;
+					(void) b;
+				}
+			});
+		}
+
+		for (std::thread& t: threads) {
+			t.join();
+		}
+	}
+
+	SyncedSint after = 2;
+	(void) after;
+
+	return CSyncChecker::GetChecksum();
+}
+
+TEST_CASE("ChecksumLanes")
+{
+	ENTER_SYNCED_CODE();
+
+	std::vector<int> jobOrder(64);
+	std::iota(jobOrder.begin(), jobOrder.end(), 0);
+
+	const unsigned refChecksum = RunLaneJobs(jobOrder, 1, 0);
+
+	// thread count and scheduling must not matter
+	CHECK(RunLaneJobs(jobOrder, 4, 0) == refChecksum);
+
+	std::reverse(jobOrder.begin(), jobOrder.end());
+	CHECK(RunLaneJobs(jobOrder, 3, 0) == refChecksum);
+
+	std::mt19937 rng(42);
+	std::shuffle(jobOrder.begin(), jobOrder.end(), rng);
+	CHECK(RunLaneJobs(jobOrder, 8, 0) == refChecksum);
+
+	// but the synced values still do
+	CHECK(RunLaneJobs(jobOrder, 8, 1) != refChecksum);
+
+	LEAVE_SYNCED_CODE();
+}
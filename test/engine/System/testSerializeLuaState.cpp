@@ -5,6 +5,9 @@
 
 #include <catch_amalgamated.hpp>
 
+#include <cstring>
+#include <sstream>
+
 
 static int handlepanic(lua_State* L)
 {
@@ -97,4 +100,110 @@ TEST_CASE("SerializeLuaState")
 	CHECK(L_GC == flh.L_GC);
 
 	lua_close(flh.L);
-}
\ No newline at end of file
+}
+
+
+static void SaveLuaHandle(std::stringstream& ss)
+{
+	// same as CLuaStateCollector, gray-lists are not saved
+	lua_gc(flh.L, LUA_GCCOLLECT, 0);
+
+	LuaRoot root;
+	creg::COutputStreamSerializer oser;
+	oser.SavePackage(&ss, &root, root.GetClass());
+}
+
+static void LoadLuaHandle(std::stringstream& ss)
+{
+	creg::CInputStreamSerializer iser;
+	void* loaded;
+	creg::Class* loadedCls;
+	creg::CopyLuaContext(flh.L);
+	LUA_CLOSE(&flh.L);
+	flh.L_GC = nullptr;
+	iser.LoadPackage(&ss, loaded, loadedCls);
+	delete (LuaRoot*) loaded;
+}
+
+static double RunLuaChecksum(lua_State* L)
+{
+	lua_getglobal(L, "checksum");
+	REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+	const double sum = lua_tonumber(L, -1);
+	lua_pop(L, 1);
+	return sum;
+}
+
+
+// resembles synced gadget state: many small records, shared strings,
+// string- and table-keyed lookups and closures holding upvalues
+static const char* largeHeapCode = R"(
+local N = ...
+local heap = {}
+local names = {}
+for i = 1, 64 do names[i] = "unitDefName_" .. i end
+for i = 1, N do
+	local t = {
+		id = i,
+		name = names[(i % 64) + 1],
+		health = i * 0.5,
+		pos = {i, i * 2, i * 3},
+		alive = (i % 3 == 0),
+		tag = "unit" .. i,
+	}
+	heap[i] = t
+	heap["key" .. i] = t
+end
+local byTable = {}
+for i = 1, N, 4 do byTable[heap[i]] = i end
+heap.byTable = byTable
+local counter = 0
+heap.inc = function(n) counter = counter + n; return counter end
+_G.heap = heap
+_G.checksum = function()
+	local sum = 0
+	for i = 1, N do
+		local t = heap[i]
+		assert(heap["key" .. i] == t)
+		sum = sum + t.id + t.health + t.pos[1] + t.pos[2] + t.pos[3] + #t.name + #t.tag
+		if t.alive then sum = sum + 1 end
+		if byTable[t] ~= nil then sum = sum + byTable[t] end
+		-- keep it exact, lua_Number is a float
+		sum = sum % 4096
+	end
+	return sum + heap.inc(1)
+end
+)";
+
+TEST_CASE("SerializeLuaStateLargeHeap")
+{
+	static int context = 1;
+	static constexpr int NUM_RECORDS = 10000;
+
+	flh.L = lua_newstate(l_alloc, &context);
+	lua_atpanic(flh.L, handlepanic);
+	SPRING_LUA_OPEN_LIB(flh.L, luaopen_base);
+	SPRING_LUA_OPEN_LIB(flh.L, luaopen_math);
+	SPRING_LUA_OPEN_LIB(flh.L, luaopen_table);
+	SPRING_LUA_OPEN_LIB(flh.L, luaopen_string);
+
+	lua_settop(flh.L, 0);
+	creg::AutoRegisterCFunctions("Test::", flh.L);
+	flh.L_GC = lua_newthread(flh.L);
+	luaL_ref(flh.L, LUA_REGISTRYINDEX);
+
+	REQUIRE(luaL_loadbuffer(flh.L, largeHeapCode, strlen(largeHeapCode), "largeHeap") == 0);
+	lua_pushnumber(flh.L, NUM_RECORDS);
+	REQUIRE(lua_pcall(flh.L, 1, 0, 0) == 0);
+
+	const double sumPreSave = RunLuaChecksum(flh.L);
+
+	std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+	SaveLuaHandle(ss);
+	LoadLuaHandle(ss);
+
+	// counter upvalue was incremented once more since the save
+	CHECK(RunLuaChecksum(flh.L) == (sumPreSave + 1.0));
+
+	lua_close(flh.L);
+}
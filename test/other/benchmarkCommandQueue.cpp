@@ -0,0 +1,130 @@
+#include "Sim/Units/CommandAI/CommandQueue.h"
+#include "System/Log/ILog.h"
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+
+// normally lives in CommandAI.cpp
+CommandQueueMemPool cmdQueueMemPool;
+
+namespace {
+	// plain deque as used before queues were pool-allocated
+	using StdCommandDeque = std::deque<Command>;
+	using PoolCommandDeque = CCommandQueue::basis;
+
+	Command MakeMoveCommand(int i) {
+		return Command(CMD_MOVE, SHIFT_KEY, float3(i * 8.0f, 0.0f, i * 16.0f));
+	}
+	Command MakeAreaCommand(int i) {
+		Command c(CMD_RECLAIM, SHIFT_KEY, float3(i * 8.0f, 0.0f, i * 16.0f));
+		c.PushParam(256.0f);
+		return c;
+	}
+}
+
+
+// shift-queue N waypoints, then consume them one by one (unit walking its path)
+template <typename TQueue>
+static void BenchWaypointQueue(benchmark::State& state) {
+	const int numCmds = state.range(0);
+
+	for (auto _ : state) {
+		TQueue queue;
+
+		for (int i = 0; i < numCmds; i++) {
+			queue.push_back(MakeMoveCommand(i));
+		}
+		while (!queue.empty()) {
+			benchmark::DoNotOptimize(queue.front().GetID());
+			queue.pop_front();
+		}
+
+		benchmark::ClobberMemory();
+	}
+}
+
+BENCHMARK(BenchWaypointQueue<StdCommandDeque>)->Arg(16)->Arg(128)->Arg(1024);
+BENCHMARK(BenchWaypointQueue<PoolCommandDeque>)->Arg(16)->Arg(128)->Arg(1024);
+
+
+// factory repeat-queue: finished commands are rotated to the back
+template <typename TQueue>
+static void BenchRepeatQueue(benchmark::State& state) {
+	const int numCmds = state.range(0);
+
+	TQueue queue;
+
+	for (int i = 0; i < numCmds; i++) {
+		queue.push_back(Command(-1 - (i % 8), 0));
+	}
+
+	for (auto _ : state) {
+		Command c = std::move(queue.front());
+
+		queue.pop_front();
+		queue.push_back(std::move(c));
+
+		benchmark::DoNotOptimize(queue.back().GetID());
+	}
+}
+
+BENCHMARK(BenchRepeatQueue<StdCommandDeque>)->Arg(16)->Arg(128);
+BENCHMARK(BenchRepeatQueue<PoolCommandDeque>)->Arg(16)->Arg(128);
+
+
+// area-commands pushed to the front by fight/patrol searches and removed
+// again, plus CMD_INSERT / CMD_REMOVE style edits in the middle of the queue
+template <typename TQueue>
+static void BenchInsertEraseQueue(benchmark::State& state) {
+	const int numCmds = state.range(0);
+
+	TQueue queue;
+
+	for (int i = 0; i < numCmds; i++) {
+		queue.push_back(MakeMoveCommand(i));
+	}
+
+	int n = 0;
+
+	for (auto _ : state) {
+		queue.push_front(MakeAreaCommand(n));
+		queue.insert(queue.begin() + (n % queue.size()), MakeMoveCommand(n));
+		queue.erase(queue.begin() + ((n * 7) % queue.size()));
+		queue.pop_front();
+
+		benchmark::DoNotOptimize(queue.size());
+		n++;
+	}
+}
+
+BENCHMARK(BenchInsertEraseQueue<StdCommandDeque>)->Arg(16)->Arg(128)->Arg(1024);
+BENCHMARK(BenchInsertEraseQueue<PoolCommandDeque>)->Arg(16)->Arg(128)->Arg(1024);
+
+
+// mass-ordering: many small queues cleared and refilled at once
+template <typename TQueue>
+static void BenchMassOrderQueues(benchmark::State& state) {
+	const int numUnits = state.range(0);
+
+	std::vector<TQueue> queues(numUnits);
+
+	for (auto _ : state) {
+		for (int u = 0; u < numUnits; u++) {
+			queues[u].clear();
+			queues[u].push_back(MakeMoveCommand(u));
+		}
+		for (int u = 0; u < numUnits; u++) {
+			for (int i = 0; i < 4; i++) {
+				queues[u].push_back(MakeMoveCommand(u + i));
+			}
+		}
+
+		benchmark::ClobberMemory();
+	}
+}
+
+BENCHMARK(BenchMassOrderQueues<StdCommandDeque>)->Arg(1000)->Arg(5000);
+BENCHMARK(BenchMassOrderQueues<PoolCommandDeque>)->Arg(1000)->Arg(5000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+#include "Rendering/Env/Particles/ParticleSorter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+	struct BenchParticle {
+		int drawOrder = 0;
+		float sortDist = 0.0f;
+	};
+
+	// what CProjectileDrawer::DrawAlpha used before CParticleSorter
+	bool DrawOrderSortingPredicate(const BenchParticle* p1, const BenchParticle* p2) noexcept {
+		return std::forward_as_tuple(p2->drawOrder, p1->sortDist, p1) > std::forward_as_tuple(p1->drawOrder, p2->sortDist, p2);
+	}
+
+	// particles around a camera, re-gathered in projectile-handler (spawn) order each frame
+	struct ParticleScene {
+		ParticleScene(size_t numParticles): particles(numParticles), drawParticles(numParticles) {
+			std::mt19937 rng(numParticles);
+			std::uniform_real_distribution<float> distDist(16.0f, 8192.0f);
+
+			for (BenchParticle& p: particles) {
+				p.sortDist = distDist(rng);
+			}
+		}
+
+		void NextFrame() {
+			// camera moves a little, particles drift
+			frame += 1;
+
+			for (size_t i = 0; i < particles.size(); i++) {
+				particles[i].sortDist += ((i + frame) & 7) * 0.25f - 0.875f;
+				drawParticles[i] = &particles[i];
+			}
+		}
+
+		std::vector<BenchParticle> particles;
+		std::vector<BenchParticle*> drawParticles;
+
+		size_t frame = 0;
+	};
+}
+
+
+static void BenchStdSort(benchmark::State& state) {
+	ParticleScene scene(state.range(0));
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		scene.NextFrame();
+		state.ResumeTiming();
+
+		std::sort(scene.drawParticles.begin(), scene.drawParticles.end(), DrawOrderSortingPredicate);
+		benchmark::DoNotOptimize(scene.drawParticles.front());
+	}
+}
+
+static void BenchParticleSorter(benchmark::State& state) {
+	ParticleScene scene(state.range(0));
+	CParticleSorter<BenchParticle> sorter;
+
+	const auto drawOrderFunc = [](const BenchParticle* p) { return p->drawOrder; };
+	const auto sortDistFunc = [](const BenchParticle* p) { return p->sortDist; };
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		scene.NextFrame();
+		state.ResumeTiming();
+
+		sorter.Sort(scene.drawParticles, true, drawOrderFunc, sortDistFunc);
+		benchmark::DoNotOptimize(scene.drawParticles.front());
+	}
+}
+
+BENCHMARK(BenchStdSort)->Arg(1000)->Arg(10000)->Arg(30000)->Arg(100000);
+BENCHMARK(BenchParticleSorter)->Arg(1000)->Arg(10000)->Arg(30000)->Arg(100000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,154 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/creg/Serializer.h"
+#include "System/creg/SerializeLuaState.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+namespace {
+	// from lauxlib.cpp
+	void* l_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+		(void)ud;
+		(void)osize;
+		if (nsize == 0) {
+			free(ptr);
+			return nullptr;
+		}
+		return realloc(ptr, nsize);
+	}
+
+	int handlepanic(lua_State* L) {
+		throw "lua paniced";
+	}
+
+	struct FakeLuaHandle {
+		lua_State* L = nullptr;
+		lua_State* L_GC = nullptr;
+	};
+
+	FakeLuaHandle flh;
+}
+
+
+struct LuaRoot {
+	CR_DECLARE_STRUCT(LuaRoot);
+	void Serialize(creg::ISerializer* s);
+};
+
+CR_BIND(LuaRoot, );
+CR_REG_METADATA(LuaRoot, (
+	CR_SERIALIZER(Serialize)
+))
+
+void LuaRoot::Serialize(creg::ISerializer* s) {
+	creg::SerializeLuaState(s, &flh.L);
+	creg::SerializeLuaThread(s, &flh.L_GC);
+}
+
+
+namespace {
+	// same heap as the SerializeLuaStateLargeHeap test, resembles synced gadget state
+	const char* largeHeapCode = R"(
+local N = ...
+local heap = {}
+local names = {}
+for i = 1, 64 do names[i] = "unitDefName_" .. i end
+for i = 1, N do
+	local t = {
+		id = i,
+		name = names[(i % 64) + 1],
+		health = i * 0.5,
+		pos = {i, i * 2, i * 3},
+		alive = (i % 3 == 0),
+		tag = "unit" .. i,
+	}
+	heap[i] = t
+	heap["key" .. i] = t
+end
+local byTable = {}
+for i = 1, N, 4 do byTable[heap[i]] = i end
+heap.byTable = byTable
+local counter = 0
+heap.inc = function(n) counter = counter + n; return counter end
+_G.heap = heap
+)";
+
+	void SaveLuaHandle(std::stringstream& ss) {
+		// same as CLuaStateCollector, gray-lists are not saved
+		lua_gc(flh.L, LUA_GCCOLLECT, 0);
+
+		LuaRoot root;
+		creg::COutputStreamSerializer oser;
+		oser.SavePackage(&ss, &root, root.GetClass());
+	}
+
+	void LoadLuaHandle(std::stringstream& ss) {
+		creg::CInputStreamSerializer iser;
+		void* loaded;
+		creg::Class* loadedCls;
+		creg::CopyLuaContext(flh.L);
+		LUA_CLOSE(&flh.L);
+		flh.L_GC = nullptr;
+		iser.LoadPackage(&ss, loaded, loadedCls);
+		delete (LuaRoot*) loaded;
+	}
+
+	void CreateLargeHeap(int numRecords) {
+		static int context = 1;
+
+		flh.L = lua_newstate(l_alloc, &context);
+		lua_atpanic(flh.L, handlepanic);
+		SPRING_LUA_OPEN_LIB(flh.L, luaopen_base);
+		SPRING_LUA_OPEN_LIB(flh.L, luaopen_math);
+		SPRING_LUA_OPEN_LIB(flh.L, luaopen_table);
+		SPRING_LUA_OPEN_LIB(flh.L, luaopen_string);
+
+		lua_settop(flh.L, 0);
+		creg::AutoRegisterCFunctions("Test::", flh.L);
+		flh.L_GC = lua_newthread(flh.L);
+		luaL_ref(flh.L, LUA_REGISTRYINDEX);
+
+		luaL_loadbuffer(flh.L, largeHeapCode, strlen(largeHeapCode), "largeHeap");
+		lua_pushnumber(flh.L, numRecords);
+		lua_pcall(flh.L, 1, 0, 0);
+	}
+}
+
+
+static void BenchSaveLuaState(benchmark::State& state) {
+	CreateLargeHeap(state.range(0));
+
+	for (auto _ : state) {
+		std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+		SaveLuaHandle(ss);
+		benchmark::DoNotOptimize(ss.tellp());
+	}
+
+	lua_close(flh.L);
+}
+
+static void BenchLoadLuaState(benchmark::State& state) {
+	CreateLargeHeap(state.range(0));
+
+	std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+	SaveLuaHandle(ss);
+	const std::string data = ss.str();
+
+	for (auto _ : state) {
+		std::stringstream ls(data, std::ios::in | std::ios::out | std::ios::binary);
+		LoadLuaHandle(ls);
+		benchmark::DoNotOptimize(flh.L);
+	}
+
+	lua_close(flh.L);
+}
+
+BENCHMARK(BenchSaveLuaState)->Arg(1000)->Arg(10000);
+BENCHMARK(BenchLoadLuaState)->Arg(1000)->Arg(10000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,522 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "DemoBatch.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <zlib.h>
+
+#include "Game/Players/PlayerStatistics.h"
+#include "Net/Protocol/NetMessageTypes.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/TeamStatistics.h"
+#include "System/LoadSave/demofile.h"
+
+void InitCommandNames();
+const std::map<int, std::string>& GetCommandNames();
+
+
+namespace {
+
+struct DemoRecord {
+	std::string file;
+	std::string error;
+
+	DemoFileHeader header;
+
+	std::vector<unsigned char> winningAllyTeams;
+	std::vector<PlayerStatistics> playerStats;
+	/// last (cumulative) entry of each team
+	std::vector<TeamStatistics> teamStats;
+
+	/// one slot per command column, see CommandColumns
+	std::vector<unsigned> commandCounts;
+
+	unsigned numPackets = 0;
+	unsigned numFrames = 0;
+
+	bool validHeader = false;
+};
+
+
+/**
+ * Maps command IDs to CSV columns: one per registered command,
+ * followed by one for all build commands and one for the rest.
+ */
+class CommandColumns {
+public:
+	CommandColumns() {
+		for (const auto& [cmdId, cmdName]: GetCommandNames()) {
+			columns.emplace(cmdId, names.size());
+			names.push_back(cmdName);
+		}
+
+		names.emplace_back("<BUILD_UNIT>");
+		names.emplace_back("<UNKNOWN>");
+	}
+
+	size_t GetColumn(int cmdId) const {
+		if (cmdId < 0)
+			return (names.size() - 2);
+
+		const auto it = columns.find(cmdId);
+
+		if (it == columns.end())
+			return (names.size() - 1);
+
+		return it->second;
+	}
+
+	const std::vector<std::string>& GetNames() const { return names; }
+
+private:
+	std::map<int, size_t> columns;
+	std::vector<std::string> names;
+};
+
+
+/// bounds-checked little-endian packet reader
+class PacketReader {
+public:
+	PacketReader(const std::vector<std::uint8_t>& packet, size_t offset): data(packet.data()), size(packet.size()), pos(offset) {}
+
+	template<typename T>
+	bool operator >> (T& t) {
+		if ((pos + sizeof(T)) > size)
+			return false;
+
+		std::memcpy(&t, data + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	bool Skip(size_t n) {
+		if ((pos + n) > size)
+			return false;
+
+		pos += n;
+		return true;
+	}
+
+private:
+	const std::uint8_t* data;
+	size_t size;
+	size_t pos;
+};
+
+
+/**
+ * Reads a demo packet by packet straight from the gzip stream,
+ * unlike CDemoReader which first uncompresses the whole file.
+ */
+class DemoStream {
+public:
+	explicit DemoStream(const std::string& path) { file = gzopen(path.c_str(), "rb"); }
+	~DemoStream() {
+		if (file != nullptr)
+			gzclose(file);
+	}
+
+	bool ReadHeader(DemoFileHeader& header, std::string& error) {
+		if (file == nullptr) {
+			error = "unable to open file";
+			return false;
+		}
+
+		gzbuffer(file, 1 << 17);
+
+		if (!Read(&header, sizeof(header))) {
+			error = "truncated header";
+			return false;
+		}
+
+		header.swab();
+
+		if (memcmp(header.magic, DEMOFILE_MAGIC, sizeof(header.magic)) != 0 || header.version != DEMOFILE_VERSION) {
+			error = "not a demo or unsupported demo version";
+			return false;
+		}
+		if (header.headerSize != sizeof(DemoFileHeader) || header.playerStatElemSize != sizeof(PlayerStatistics) || header.teamStatElemSize != sizeof(TeamStatistics)) {
+			error = "unsupported header or statistics layout";
+			return false;
+		}
+
+		streamStart = header.headerSize + header.scriptSize;
+		streamEnd = streamStart + header.demoStreamSize;
+
+		// the setup script is not needed
+		return (gzseek(file, streamStart, SEEK_SET) == streamStart);
+	}
+
+	/// reads the next packet into <packet>, false at the end of the stream
+	bool ReadPacket(std::vector<std::uint8_t>& packet) {
+		DemoStreamChunkHeader chunkHeader;
+
+		// demoStreamSize is 0 if the recording was not finished, read until EOF
+		if (streamEnd != streamStart && gztell(file) >= streamEnd)
+			return false;
+
+		if (!Read(&chunkHeader, sizeof(chunkHeader)))
+			return false;
+
+		chunkHeader.swab();
+		packet.resize(chunkHeader.length);
+
+		return (Read(packet.data(), packet.size()) && !packet.empty());
+	}
+
+	bool ReadStats(DemoRecord& record, std::string& error) {
+		const DemoFileHeader& header = record.header;
+
+		// not written if the recording was not finished
+		if (header.demoStreamSize == 0)
+			return true;
+
+		if (gzseek(file, streamEnd, SEEK_SET) != streamEnd) {
+			error = "truncated demo stream";
+			return false;
+		}
+
+		record.winningAllyTeams.resize(header.winningAllyTeamsSize);
+		record.playerStats.resize(header.numPlayers);
+		record.teamStats.resize(header.numTeams);
+
+		if (!Read(record.winningAllyTeams.data(), record.winningAllyTeams.size())) {
+			error = "truncated winner list";
+			return false;
+		}
+
+		for (PlayerStatistics& stats: record.playerStats) {
+			if (!Read(&stats, sizeof(stats))) {
+				error = "truncated player statistics";
+				return false;
+			}
+
+			stats.swab();
+		}
+
+		if (header.numTeams > MAX_TEAMS) {
+			error = "invalid number of teams";
+			return false;
+		}
+
+		std::array<unsigned int, MAX_TEAMS> numStatsPerTeam = {};
+
+		if (!Read(numStatsPerTeam.data(), header.numTeams * sizeof(unsigned int))) {
+			error = "truncated team statistics";
+			return false;
+		}
+
+		for (int teamNum = 0; teamNum < header.numTeams; ++teamNum) {
+			const unsigned int numStats = swabDWord(numStatsPerTeam[teamNum]);
+
+			if (numStats == 0)
+				continue;
+
+			// stats are cumulative, only the last one is of interest
+			if (gzseek(file, (numStats - 1) * sizeof(TeamStatistics), SEEK_CUR) < 0 || !Read(&record.teamStats[teamNum], sizeof(TeamStatistics))) {
+				error = "truncated team statistics";
+				return false;
+			}
+
+			record.teamStats[teamNum].swab();
+		}
+
+		return true;
+	}
+
+private:
+	bool Read(void* buf, size_t len) {
+		return (len == 0 || gzread(file, buf, len) == static_cast<int>(len));
+	}
+
+private:
+	gzFile file = nullptr;
+
+	z_off_t streamStart = 0;
+	z_off_t streamEnd = 0;
+};
+
+
+void CountCommands(const std::vector<std::uint8_t>& packet, const CommandColumns& cmdColumns, DemoRecord& record)
+{
+	int32_t cmdId = 0;
+
+	switch (packet[0]) {
+		case NETMSG_COMMAND: {
+			// uint16 size, uint8 playerNum
+			if (PacketReader(packet, 4) >> cmdId)
+				record.commandCounts[cmdColumns.GetColumn(cmdId)] += 1;
+		} break;
+
+		case NETMSG_AICOMMAND:
+		case NETMSG_AICOMMAND_TRACKED: {
+			// uint16 size, uint8 playerNum, uint8 aiInstID, uint8 aiTeamID, int16 unitID
+			if (PacketReader(packet, 8) >> cmdId)
+				record.commandCounts[cmdColumns.GetColumn(cmdId)] += 1;
+		} break;
+
+		case NETMSG_AICOMMANDS: {
+			// see the NETMSG_AICOMMANDS handler in NetCommands.cpp
+			PacketReader reader(packet, 6);
+
+			uint32_t sameCmdID = 0;
+			uint8_t sameCmdOpt = 0;
+			uint16_t sameCmdParamSize = 0;
+
+			int16_t unitCount = 0;
+			int16_t commandCount = 0;
+
+			if (!(reader >> sameCmdID) || !(reader >> sameCmdOpt) || !(reader >> sameCmdParamSize))
+				break;
+			if (!(reader >> unitCount) || !reader.Skip(std::max<int16_t>(unitCount, 0) * sizeof(int16_t)))
+				break;
+			if (!(reader >> commandCount))
+				break;
+
+			for (int16_t c = 0; c < commandCount; c++) {
+				uint8_t cmdOpt = 0;
+				uint16_t paramCount = sameCmdParamSize;
+
+				cmdId = sameCmdID;
+
+				if (sameCmdID == 0 && !(reader >> cmdId))
+					break;
+				if (sameCmdOpt == 0xFF && !(reader >> cmdOpt))
+					break;
+				if (sameCmdParamSize == 0xFFFF && !(reader >> paramCount))
+					break;
+				if (!reader.Skip(paramCount * sizeof(float)))
+					break;
+
+				record.commandCounts[cmdColumns.GetColumn(cmdId)] += 1;
+			}
+		} break;
+
+		default: {
+		} break;
+	}
+}
+
+void AnalyzeDemo(const std::string& file, const CommandColumns& cmdColumns, DemoRecord& record)
+{
+	DemoStream stream(file);
+	std::vector<std::uint8_t> packet;
+
+	record.file = file;
+	record.commandCounts.resize(cmdColumns.GetNames().size(), 0);
+
+	if (!(record.validHeader = stream.ReadHeader(record.header, record.error)))
+		return;
+
+	while (stream.ReadPacket(packet)) {
+		record.numPackets += 1;
+		record.numFrames += (packet[0] == NETMSG_NEWFRAME || packet[0] == NETMSG_KEYFRAME);
+
+		CountCommands(packet, cmdColumns, record);
+	}
+
+	stream.ReadStats(record, record.error);
+}
+
+
+void CollectDemoFiles(const std::string& input, std::vector<std::string>& files)
+{
+	namespace fs = std::filesystem;
+
+	std::error_code err;
+
+	if (fs::is_directory(input, err)) {
+		const size_t numFiles = files.size();
+
+		for (const auto& entry: fs::recursive_directory_iterator(input, fs::directory_options::skip_permission_denied, err)) {
+			if (entry.is_regular_file(err) && entry.path().extension() == ".sdfz")
+				files.push_back(entry.path().string());
+		}
+
+		// directory iteration order is unspecified
+		std::sort(files.begin() + numFiles, files.end());
+		return;
+	}
+
+	if (fs::path(input).extension() == ".sdfz") {
+		files.push_back(input);
+		return;
+	}
+
+	// list of demos, one per line
+	std::ifstream list(input);
+	std::string line;
+
+	if (!list.is_open()) {
+		std::cerr << "Unable to open " << input << std::endl;
+		return;
+	}
+
+	while (std::getline(list, line)) {
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		files.push_back(line);
+	}
+}
+
+
+template<typename T, typename F>
+void PrintList(std::ostream& out, const std::vector<T>& values, F getter)
+{
+	for (size_t i = 0; i < values.size(); ++i) {
+		out << ((i == 0)? "": " ") << getter(values[i]);
+	}
+
+	out << ";";
+}
+
+void WriteHeaderRow(std::ostream& out, const CommandColumns& cmdColumns)
+{
+	out << "File;GameID;Version;UnixTime;GameTime;WallclockTime;NumPlayers;NumTeams;WinningAllyTeams;NumPackets;NumFrames;";
+	out << "MousePixels;MouseClicks;KeyPresses;NumCommands;UnitCommands;";
+	out << "MetalUsed;EnergyUsed;MetalProduced;EnergyProduced;MetalExcess;EnergyExcess;"
+	    << "MetalReceived;EnergyReceived;MetalSent;EnergySent;DamageDealt;DamageReceived;"
+	    << "UnitsProduced;UnitsDied;UnitsReceived;UnitsSent;UnitsCaptured;"
+	    << "UnitsOutCaptured;UnitsKilled;";
+
+	for (const std::string& cmdName: cmdColumns.GetNames()) {
+		out << cmdName << ";";
+	}
+
+	out << "Error" << std::endl;
+}
+
+void WriteRecordRow(std::ostream& out, const DemoRecord& record)
+{
+	const DemoFileHeader& header = record.header;
+
+	out << record.file << ";";
+
+	if (record.validHeader) {
+		char gameID[33];
+
+		for (int i = 0; i < 16; ++i) {
+			snprintf(gameID + i * 2, 3, "%02x", header.gameID[i]);
+		}
+
+		out << gameID << ";" << header.versionString << ";" << header.unixTime << ";";
+		out << header.gameTime << ";" << header.wallclockTime << ";" << header.numPlayers << ";" << header.numTeams << ";";
+	} else {
+		out << ";;;;;;;";
+	}
+
+	// per-player and per-team values are space-separated lists, indexed by player resp. team number
+	PrintList(out, record.winningAllyTeams, [](unsigned char a) { return unsigned(a); });
+	out << record.numPackets << ";" << record.numFrames << ";";
+
+	PrintList(out, record.playerStats, [](const PlayerStatistics& s) { return s.mousePixels; });
+	PrintList(out, record.playerStats, [](const PlayerStatistics& s) { return s.mouseClicks; });
+	PrintList(out, record.playerStats, [](const PlayerStatistics& s) { return s.keyPresses; });
+	PrintList(out, record.playerStats, [](const PlayerStatistics& s) { return s.numCommands; });
+	PrintList(out, record.playerStats, [](const PlayerStatistics& s) { return s.unitCommands; });
+
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.metalUsed; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.energyUsed; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.metalProduced; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.energyProduced; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.metalExcess; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.energyExcess; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.metalReceived; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.energyReceived; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.metalSent; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.energySent; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.damageDealt; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.damageReceived; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.unitsProduced; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.unitsDied; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.unitsReceived; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.unitsSent; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.unitsCaptured; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.unitsOutCaptured; });
+	PrintList(out, record.teamStats, [](const TeamStatistics& s) { return s.unitsKilled; });
+
+	for (const unsigned count: record.commandCounts) {
+		out << count << ";";
+	}
+
+	out << record.error << std::endl;
+}
+
+}
+
+
+int RunDemoBatch(const std::vector<std::string>& inputs, const std::string& outFile, unsigned numThreads)
+{
+	const auto t0 = std::chrono::steady_clock::now();
+
+	std::vector<std::string> files;
+
+	for (const std::string& input: inputs) {
+		CollectDemoFiles(input, files);
+	}
+
+	// read-only from here on, shared by all workers
+	InitCommandNames();
+	const CommandColumns cmdColumns;
+
+	std::vector<DemoRecord> records(files.size());
+	std::vector<std::thread> workers;
+	std::atomic<size_t> nextFile = {0};
+
+	numThreads = std::clamp(numThreads, 1u, std::max(1u, unsigned(files.size())));
+	workers.reserve(numThreads);
+
+	for (unsigned i = 0; i < numThreads; ++i) {
+		workers.emplace_back([&]() {
+			for (size_t n = nextFile.fetch_add(1); n < files.size(); n = nextFile.fetch_add(1)) {
+				AnalyzeDemo(files[n], cmdColumns, records[n]);
+			}
+		});
+	}
+
+	for (std::thread& worker: workers) {
+		worker.join();
+	}
+
+	std::ofstream outStream;
+
+	if (!outFile.empty()) {
+		outStream.open(outFile);
+
+		if (!outStream.is_open()) {
+			std::cerr << "Unable to write " << outFile << std::endl;
+			return int(files.size());
+		}
+	}
+
+	std::ostream& out = outFile.empty()? std::cout: outStream;
+	int numFailed = 0;
+
+	WriteHeaderRow(out, cmdColumns);
+
+	// rows are written in input order, independent of the worker count
+	for (const DemoRecord& record: records) {
+		WriteRecordRow(out, record);
+		numFailed += !record.error.empty();
+	}
+
+	const auto t1 = std::chrono::steady_clock::now();
+	const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+
+	std::cerr << "Processed " << files.size() << " demos (" << numFailed << " failed) with " << numThreads << " threads in " << ms << "ms" << std::endl;
+	return numFailed;
+}
@@ -0,0 +1,21 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEMO_BATCH_H
+#define DEMO_BATCH_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Decode many demos in parallel and write one CSV row per demo
+ *
+ * Each input is either a demo, a directory that is searched recursively
+ * for *.sdfz files, or a text file listing one demo path per line. The
+ * demos are streamed through zlib without being decompressed to memory
+ * as a whole, so the number of workers is not bounded by demo size.
+ *
+ * @return number of demos that could not be read
+ */
+int RunDemoBatch(const std::vector<std::string>& inputs, const std::string& outFile, unsigned numThreads);
+
+#endif // DEMO_BATCH_H
@@ -5,8 +5,10 @@
 #include <iostream>
 #include <gflags/gflags.h>
 #include <iomanip> //hex
+#include <thread>
 
 #include "StringSerializer.h"
+#include "DemoBatch.h"
 
 #include "Net/Protocol/BaseNetProtocol.h"
 #include "System/LoadSave/DemoReader.h"
@@ -17,6 +19,10 @@
 Usage:
 Start with the full! path to the demofile as the only argument
 
+With --batch, all arguments are demos, directories containing demos or
+text files listing one demo per line; these are analyzed in parallel and
+written as one csv row per demo (to --batchcsv, or stdout).
+
 Please note that not all NETMSG's are implemented, expand if needed.
 
 When compiling for windows with MinGW, make sure to use the
@@ -32,6 +38,9 @@ no console output (you still could use this.exe > z.tzt though).
 	DEFINE_bool  (teamstats,    false, "Print teamstats");
 	DEFINE_int32 (team,         -1,    "Select team");
 	DEFINE_string(teamsstatcsv, "",    "Write teamstats in a csv file");
+	DEFINE_bool  (batch,        false, "Analyze all given demos, directories or demo lists in parallel");
+	DEFINE_string(batchcsv,     "",    "Write batch results in a csv file instead of stdout");
+	DEFINE_int32 (threads,      0,     "Number of threads used in batch mode (0: one per core)");
 
 
 void TrafficDump(CDemoReader& reader, bool trafficStats);
@@ -43,6 +52,15 @@ int main (int argc, char* argv[])
 
 	gflags::SetUsageMessage(std::string("Usage: ") + argv[0] + " [options] path_to_demo.sdfz");
 	gflags::ParseCommandLineFlags(&argc, &argv, true);
+	if (FLAGS_batch) {
+		std::vector<std::string> inputs(argv + 1, argv + argc);
+
+		if (!FLAGS_demofile.empty())
+			inputs.push_back(FLAGS_demofile);
+
+		const unsigned numThreads = (FLAGS_threads > 0)? FLAGS_threads: std::thread::hardware_concurrency();
+		return (RunDemoBatch(inputs, FLAGS_batchcsv, numThreads) == 0)? 0: 1;
+	}
 	if (!FLAGS_demofile.empty()) {
 		filename = FLAGS_demofile;
 	} else if (argc >= 2) {
@@ -182,6 +200,11 @@ const std::string& GetCommandName(int commandId)
 	return CMD_NAME_UNKNOWN;
 }
 
+const std::map<int, std::string>& GetCommandNames()
+{
+	return cmdIdToName;
+}
+
 void PrintBinary(const unsigned char* const buf, int len)
 {
 	for(int i=0; i<len; i++) {
@@ -372,6 +395,9 @@ void TrafficDump(CDemoReader& reader, bool trafficStats)
 			case NETMSG_PATH_CHECKSUM:
 				std::cout << "NETMSG_PATH_CHECKSUM" << std::endl;
 				break;
+			case NETMSG_DEFS_CHECKSUM:
+				std::cout << "NETMSG_DEFS_CHECKSUM" << std::endl;
+				break;
 			case NETMSG_INTERNAL_SPEED:
 				std::cout << "NETMSG_INTERNAL_SPEED" << std::endl;
 				break;